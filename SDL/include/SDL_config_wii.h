@@ -75,6 +75,11 @@
 #define HAVE_SSCANF	1
 #define HAVE_SETJMP	1
 
+/* Paired single audio mixing hasn't been tried on hardware yet, define
+   both of these to use it */
+/* #define SDL_ASSEMBLY_ROUTINES	1 */
+/* #define SDL_PAIRED_MIXER	1 */
+
 /* Supported audio drivers. */
 #define SDL_AUDIO_DRIVER_WII	1
 
@@ -127,6 +127,7 @@ typedef struct SDL_Surface {
 #define SDL_OPENGLBLIT	0x0000000A	/* Create an OpenGL rendering context and use it for blitting */
 #define SDL_RESIZABLE	0x00000010	/* This video mode may be resized */
 #define SDL_NOFRAME	0x00000020	/* No window caption or edge frame */
+#define SDL_TILEDSURFACE 0x00000040	/* 16-bit pixels are stored in 4x4 tiles */
 /* Used internally (read-only) */
 #define SDL_HWACCEL	0x00000100	/* Blit uses hardware acceleration */
 #define SDL_SRCCOLORKEY	0x00001000	/* Blit uses a source color key */
@@ -337,6 +338,16 @@ extern DECLSPEC SDL_Rect ** SDLCALL SDL_ListModes(SDL_PixelFormat *format, Uint3
  * without any title bar or frame decoration.  Fullscreen video modes have
  * this flag set automatically.
  *
+ * If SDL_TILEDSURFACE is set in 'flags' with a 16 bpp mode, drivers that
+ * display from 4x4 tiled textures may hand out the texture itself as the
+ * framebuffer, saving a conversion on every update.  The pixels are then
+ * not stored in linear rows, so only draw to such a surface with the SDL
+ * blit and fill functions (see SDL_TILED_OFFSET in src/video/SDL_blit.h for
+ * the layout).  The pixels pointer may change after every update.
+ * Copies, 16-bit colorkey blits and 8-bit blits write the tiles directly;
+ * other blits go through a linear row and are slower than to a linear
+ * framebuffer.
+ *
  * This function returns the video framebuffer surface, or NULL if it fails.
  *
  * If you rely on functionality provided by certain video flags, check the
@@ -124,6 +124,44 @@ SDL_AudioDevice *current_audio = NULL;
 int SDL_AudioInit(const char *driver_name);
 void SDL_AudioQuit(void);
 
+/* The resampler makes a frame more or less than a buffer of the device
+   from a buffer of the callback now and then, so the callback is run as
+   many times as it takes to fill the stream, and what is left over waits
+   in convert_fifo for the next one. Called with mixer_lock held, where
+   the driver takes it.
+*/
+void SDL_ConvertAudioStream(SDL_AudioDevice *audio, Uint8 *stream, int len)
+{
+	SDL_AudioCVT *cvt = &audio->convert;
+	int silence = (cvt->src_format == AUDIO_U8) ? 0x80 : 0;
+	int used;
+
+	while ( audio->convert_fifo_len < len ) {
+		SDL_memset(cvt->buf, silence, cvt->len);
+		if ( ! audio->paused ) {
+			(*audio->spec.callback)(audio->spec.userdata,
+			                        cvt->buf, cvt->len);
+		}
+		SDL_ConvertAudio(cvt);
+		if ( cvt->len_cvt <= 0 ) {
+			break;
+		}
+		SDL_memcpy(audio->convert_fifo + audio->convert_fifo_len,
+		           cvt->buf, cvt->len_cvt);
+		audio->convert_fifo_len += cvt->len_cvt;
+	}
+
+	used = audio->convert_fifo_len;
+	if ( used > len ) {
+		used = len;
+	}
+	SDL_memcpy(stream, audio->convert_fifo, used);
+	SDL_memset(stream + used, audio->spec.silence, len - used);
+	audio->convert_fifo_len -= used;
+	SDL_memmove(audio->convert_fifo, audio->convert_fifo + used,
+	            audio->convert_fifo_len);
+}
+
 /* The general mixing thread function */
 int SDLCALL SDL_RunAudio(void *audiop)
 {
@@ -144,17 +182,8 @@ int SDLCALL SDL_RunAudio(void *audiop)
 	fill  = audio->spec.callback;
 	udata = audio->spec.userdata;
 
-	if ( audio->convert.needed ) {
-		if ( audio->convert.src_format == AUDIO_U8 ) {
-			silence = 0x80;
-		} else {
-			silence = 0;
-		}
-		stream_len = audio->convert.len;
-	} else {
-		silence = audio->spec.silence;
-		stream_len = audio->spec.size;
-	}
+	silence = audio->spec.silence;
+	stream_len = audio->spec.size;
 
 #ifdef __OS2__
         /* Increase the priority of this thread to make sure that
@@ -181,36 +210,26 @@ int SDLCALL SDL_RunAudio(void *audiop)
 	while ( audio->enabled ) {
 
 		/* Fill the current buffer with sound */
-		if ( audio->convert.needed ) {
-			if ( audio->convert.buf ) {
-				stream = audio->convert.buf;
-			} else {
-				continue;
-			}
-		} else {
-			stream = audio->GetAudioBuf(audio);
-			if ( stream == NULL ) {
-				stream = audio->fake_stream;
-			}
+		if ( audio->convert.needed && !audio->convert.buf ) {
+			continue;
 		}
-
-		SDL_memset(stream, silence, stream_len);
-
-		if ( ! audio->paused ) {
-			SDL_mutexP(audio->mixer_lock);
-			(*fill)(udata, stream, stream_len);
-			SDL_mutexV(audio->mixer_lock);
+		stream = audio->GetAudioBuf(audio);
+		if ( stream == NULL ) {
+			stream = audio->fake_stream;
 		}
 
 		/* Convert the audio if necessary */
 		if ( audio->convert.needed ) {
-			SDL_ConvertAudio(&audio->convert);
-			stream = audio->GetAudioBuf(audio);
-			if ( stream == NULL ) {
-				stream = audio->fake_stream;
+			SDL_mutexP(audio->mixer_lock);
+			SDL_ConvertAudioStream(audio, stream, stream_len);
+			SDL_mutexV(audio->mixer_lock);
+		} else {
+			SDL_memset(stream, silence, stream_len);
+			if ( ! audio->paused ) {
+				SDL_mutexP(audio->mixer_lock);
+				(*fill)(udata, stream, stream_len);
+				SDL_mutexV(audio->mixer_lock);
 			}
-			SDL_memcpy(stream, audio->convert.buf,
-			               audio->convert.len_cvt);
 		}
 
 		/* Ready current buffer for play and change current buffer */
@@ -535,11 +554,27 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 			return(-1);
 		}
 		if ( audio->convert.needed ) {
-			audio->convert.len = (int) ( ((double) desired->size) /
-                                          audio->convert.len_ratio );
+			/* Whole source frames that convert to about one
+			   buffer of the device, rounded up so the buffer
+			   still holds the conversion. What a buffer makes
+			   past that waits in convert_fifo for the next one. */
+			int frame = ((desired->format & 0xFF) / 8) *
+			            desired->channels;
+			int frames = (int) ( ((double) audio->spec.size) /
+			                     (audio->convert.len_ratio * frame) );
+			if ( (frames * frame * audio->convert.len_ratio) <
+			     audio->spec.size ) {
+				++frames;
+			}
+			audio->convert.len = frames * frame;
 			audio->convert.buf =(Uint8 *)SDL_AllocAudioMem(
 			   audio->convert.len*audio->convert.len_mult);
-			if ( audio->convert.buf == NULL ) {
+			audio->convert_fifo = (Uint8 *)SDL_AllocAudioMem(
+			   audio->spec.size +
+			   audio->convert.len*audio->convert.len_mult);
+			audio->convert_fifo_len = 0;
+			if ( (audio->convert.buf == NULL) ||
+			     (audio->convert_fifo == NULL) ) {
 				SDL_CloseAudio();
 				SDL_OutOfMemory();
 				return(-1);
@@ -639,6 +674,9 @@ void SDL_AudioQuit(void)
 		}
 		if ( audio->convert.needed ) {
 			SDL_FreeAudioMem(audio->convert.buf);
+			if ( audio->convert_fifo != NULL ) {
+				SDL_FreeAudioMem(audio->convert_fifo);
+			}
 
 		}
 		if ( audio->opened ) {
@@ -24,6 +24,7 @@
 /* Functions for audio drivers to perform runtime conversion of audio format */
 
 #include "SDL_audio.h"
+#include "SDL_mutex.h"
 
 
 /* Effectively mix right and left channels into a single channel */
@@ -856,450 +857,500 @@ void SDLCALL SDL_ConvertEndian(SDL_AudioCVT *cvt, Uint16 format)
 	}
 }
 
-/* Convert rate up by multiple of 2 */
-void SDLCALL SDL_RateMUL2(SDL_AudioCVT *cvt, Uint16 format)
+/* Polyphase windowed sinc resampling.
+
+   Every output frame is a dot product of the last taps input frames
+   with one phase of a filter bank: the ideal lowpass (sinc) sampled at the
+   output frame's fractional position between input frames, shaped by a
+   Kaiser window. The bank holds RATE_PHASES + 1 phases in 1.15 fixed
+   point, so any ratio is converted in a single pass, and the better
+   quality levels interpolate between neighbouring phases.
+   The filter is causal: the output lags the input by taps/2 frames, and
+   the input frames it still needs are kept between buffers, along with
+   the position of the next output frame, so a stream converted one buffer
+   at a time has no seams between buffers and keeps exactly to the ratio
+   of the rates. Each buffer so converts to a frame more or less than its
+   len*len_ratio share now and then.
+*/
+#define RATE_PHASE_BITS	8
+#define RATE_PHASES	(1 << RATE_PHASE_BITS)
+#define RATE_BLOCK	64	/* Input frames staged on the stack at a time */
+#define RATE_MAX_TAPS	64
+#define RATE_MAX_CHANNELS	6
+#define RATE_MAX_BANKS	16
+#define RATE_MAX_STREAMS	32
+
+/* Quality levels, picked with the SDL_AUDIO_RESAMPLE_QUALITY variable.
+   When downsampling, the filter is stretched to keep its shape relative to
+   the output rate, up to RATE_MAX_TAPS. The fast level's short filter
+   leaves noise only about 40 dB below a tone.
+*/
+static const struct {
+	int taps;		/* Filter length when not downsampling */
+	int interp;
+	double rolloff;		/* Passband edge, as a fraction of Nyquist */
+	double beta;		/* Kaiser window shape */
+} rate_quality[] = {
+	{  8, 0, 0.80, 4.0 },	/* 0: fast */
+	{ 16, 1, 0.88, 6.0 },	/* 1: medium, the default */
+	{ 32, 1, 0.94, 8.6 }	/* 2: best */
+};
+#define RATE_DEFAULT_QUALITY	1
+
+/* Filter banks are shared by every converter with the same quality and
+   cutoff, and live for the rest of the program. Like the rest of the audio
+   setup, they are built from one thread at a time.
+*/
+static struct {
+	int quality;
+	int cutoff;		/* In thousandths of the input Nyquist */
+	Sint16 *bank;
+} rate_banks[RATE_MAX_BANKS];
+
+/* SDL_AudioCVT has no room for the resampler state, so each converter's
+   lives in one of these, found by the converter's address. SDL_BuildAudioCVT
+   takes the converter's own slot, else a free one, else the one used
+   longest ago. A converter whose slot was taken over starts again on its
+   next buffer, losing only the tail of the previous one.
+*/
+typedef struct {
+	const SDL_AudioCVT *cvt;
+	int busy;		/* A buffer is being converted */
+	Uint32 used;
+	const Sint16 *filter;
+	int taps;
+	int interp;
+	int channels;
+	int step;		/* Input frames per output frame, in 32.32 */
+	Uint32 step_frac;
+	int pos;		/* The next output frame, from the buffer start */
+	Uint32 frac;
+	Sint16 history[(RATE_MAX_TAPS - 1) * RATE_MAX_CHANNELS];
+} SDL_RateState;
+
+static SDL_RateState rate_states[RATE_MAX_STREAMS];
+static Uint32 rate_clock;
+
+/* Guards rate_states, and is made by whichever thread needs it first */
+static SDL_mutex *rate_lock;
+
+#ifdef __GNUC__
+#define RATE_CAS(p, old, new)	__sync_bool_compare_and_swap(p, old, new)
+#else
+#define RATE_CAS(p, old, new)	((*(p) == (old)) ? (*(p) = (new), 1) : 0)
+#endif
+
+static int SDL_LockRate(void)
 {
-	int i;
-	Uint8 *src, *dst;
+	SDL_mutex *lock;
 
-#ifdef DEBUG_CONVERT
-	fprintf(stderr, "Converting audio rate * 2\n");
-#endif
-	src = cvt->buf+cvt->len_cvt;
-	dst = cvt->buf+cvt->len_cvt*2;
-	switch (format & 0xFF) {
-		case 8:
-			for ( i=cvt->len_cvt; i; --i ) {
-				src -= 1;
-				dst -= 2;
-				dst[0] = src[0];
-				dst[1] = src[0];
-			}
-			break;
-		case 16:
-			for ( i=cvt->len_cvt/2; i; --i ) {
-				src -= 2;
-				dst -= 4;
-				dst[0] = src[0];
-				dst[1] = src[1];
-				dst[2] = src[0];
-				dst[3] = src[1];
-			}
-			break;
-	}
-	cvt->len_cvt *= 2;
-	if ( cvt->filters[++cvt->filter_index] ) {
-		cvt->filters[cvt->filter_index](cvt, format);
+	if ( rate_lock == NULL ) {
+		lock = SDL_CreateMutex();
+		if ( lock == NULL ) {
+			return(-1);
+		}
+		if ( !RATE_CAS(&rate_lock, NULL, lock) ) {
+			SDL_DestroyMutex(lock);
+		}
 	}
+	return(SDL_mutexP(rate_lock));
 }
 
+static void SDL_UnlockRate(void)
+{
+	SDL_mutexV(rate_lock);
+}
 
-/* Convert rate up by multiple of 2, for stereo */
-void SDLCALL SDL_RateMUL2_c2(SDL_AudioCVT *cvt, Uint16 format)
+/* sin(x), good to double precision, so the tables don't need libm */
+static double RateSin(double x)
 {
+	const double pi = 3.14159265358979323846;
+	double term, sum;
 	int i;
-	Uint8 *src, *dst;
 
-#ifdef DEBUG_CONVERT
-	fprintf(stderr, "Converting audio rate * 2\n");
-#endif
-	src = cvt->buf+cvt->len_cvt;
-	dst = cvt->buf+cvt->len_cvt*2;
-	switch (format & 0xFF) {
-		case 8:
-			for ( i=cvt->len_cvt/2; i; --i ) {
-				src -= 2;
-				dst -= 4;
-				dst[0] = src[0];
-				dst[1] = src[1];
-				dst[2] = src[0];
-				dst[3] = src[1];
-			}
-			break;
-		case 16:
-			for ( i=cvt->len_cvt/4; i; --i ) {
-				src -= 4;
-				dst -= 8;
-				dst[0] = src[0];
-				dst[1] = src[1];
-				dst[2] = src[2];
-				dst[3] = src[3];
-				dst[4] = src[0];
-				dst[5] = src[1];
-				dst[6] = src[2];
-				dst[7] = src[3];
-			}
-			break;
+	x -= (2.0 * pi) * (int)(x / (2.0 * pi));
+	if ( x > pi ) {
+		x -= 2.0 * pi;
+	} else if ( x < -pi ) {
+		x += 2.0 * pi;
 	}
-	cvt->len_cvt *= 2;
-	if ( cvt->filters[++cvt->filter_index] ) {
-		cvt->filters[cvt->filter_index](cvt, format);
+	term = sum = x;
+	for ( i = 3; i < 40; i += 2 ) {
+		term *= -(x * x) / (i * (i - 1));
+		sum += term;
 	}
+	return sum;
 }
 
-/* Convert rate up by multiple of 2, for quad */
-void SDLCALL SDL_RateMUL2_c4(SDL_AudioCVT *cvt, Uint16 format)
+/* Modified Bessel function I0, given (z*z) */
+static double RateBesselI0(double z2)
 {
-	int i;
-	Uint8 *src, *dst;
+	double term = 1.0, sum = 1.0;
+	int k;
 
-#ifdef DEBUG_CONVERT
-	fprintf(stderr, "Converting audio rate * 2\n");
-#endif
-	src = cvt->buf+cvt->len_cvt;
-	dst = cvt->buf+cvt->len_cvt*2;
-	switch (format & 0xFF) {
-		case 8:
-			for ( i=cvt->len_cvt/4; i; --i ) {
-				src -= 4;
-				dst -= 8;
-				dst[0] = src[0];
-				dst[1] = src[1];
-				dst[2] = src[2];
-				dst[3] = src[3];
-				dst[4] = src[0];
-				dst[5] = src[1];
-				dst[6] = src[2];
-				dst[7] = src[3];
-			}
-			break;
-		case 16:
-			for ( i=cvt->len_cvt/8; i; --i ) {
-				src -= 8;
-				dst -= 16;
-				dst[0] = src[0];
-				dst[1] = src[1];
-				dst[2] = src[2];
-				dst[3] = src[3];
-				dst[4] = src[4];
-				dst[5] = src[5];
-				dst[6] = src[6];
-				dst[7] = src[7];
-				dst[8] = src[0];
-				dst[9] = src[1];
-				dst[10] = src[2];
-				dst[11] = src[3];
-				dst[12] = src[4];
-				dst[13] = src[5];
-				dst[14] = src[6];
-				dst[15] = src[7];
-			}
-			break;
-	}
-	cvt->len_cvt *= 2;
-	if ( cvt->filters[++cvt->filter_index] ) {
-		cvt->filters[cvt->filter_index](cvt, format);
+	for ( k = 1; k < 50; ++k ) {
+		term *= z2 / (4.0 * k * k);
+		sum += term;
 	}
+	return sum;
 }
 
-
-/* Convert rate up by multiple of 2, for 5.1 */
-void SDLCALL SDL_RateMUL2_c6(SDL_AudioCVT *cvt, Uint16 format)
+/* Windowed sinc at x input frames from the center, for a filter whose
+   window reaches half input frames either side */
+static double RateKernel(double x, double cutoff, double beta, double half)
 {
-	int i;
-	Uint8 *src, *dst;
+	const double pi = 3.14159265358979323846;
+	double u = x / half;
+	double sinc;
 
-#ifdef DEBUG_CONVERT
-	fprintf(stderr, "Converting audio rate * 2\n");
-#endif
-	src = cvt->buf+cvt->len_cvt;
-	dst = cvt->buf+cvt->len_cvt*2;
-	switch (format & 0xFF) {
-		case 8:
-			for ( i=cvt->len_cvt/6; i; --i ) {
-				src -= 6;
-				dst -= 12;
-				dst[0] = src[0];
-				dst[1] = src[1];
-				dst[2] = src[2];
-				dst[3] = src[3];
-				dst[4] = src[4];
-				dst[5] = src[5];
-				dst[6] = src[0];
-				dst[7] = src[1];
-				dst[8] = src[2];
-				dst[9] = src[3];
-				dst[10] = src[4];
-				dst[11] = src[5];
-			}
-			break;
-		case 16:
-			for ( i=cvt->len_cvt/12; i; --i ) {
-				src -= 12;
-				dst -= 24;
-				dst[0] = src[0];
-				dst[1] = src[1];
-				dst[2] = src[2];
-				dst[3] = src[3];
-				dst[4] = src[4];
-				dst[5] = src[5];
-				dst[6] = src[6];
-				dst[7] = src[7];
-				dst[8] = src[8];
-				dst[9] = src[9];
-				dst[10] = src[10];
-				dst[11] = src[11];
-				dst[12] = src[0];
-				dst[13] = src[1];
-				dst[14] = src[2];
-				dst[15] = src[3];
-				dst[16] = src[4];
-				dst[17] = src[5];
-				dst[18] = src[6];
-				dst[19] = src[7];
-				dst[20] = src[8];
-				dst[21] = src[9];
-				dst[22] = src[10];
-				dst[23] = src[11];
-			}
-			break;
+	if ( (u <= -1.0) || (u >= 1.0) ) {
+		return 0.0;
 	}
-	cvt->len_cvt *= 2;
-	if ( cvt->filters[++cvt->filter_index] ) {
-		cvt->filters[cvt->filter_index](cvt, format);
+	if ( x == 0.0 ) {
+		sinc = 1.0;
+	} else {
+		sinc = RateSin(pi * cutoff * x) / (pi * cutoff * x);
 	}
+	return cutoff * sinc *
+		RateBesselI0(beta * beta * (1.0 - u * u)) / RateBesselI0(beta * beta);
 }
 
-/* Convert rate down by multiple of 2 */
-void SDLCALL SDL_RateDIV2(SDL_AudioCVT *cvt, Uint16 format)
+/* Filter length for a quality level and cutoff, an even number of frames */
+static int SDL_RateTaps(int quality, int cutoff)
 {
-	int i;
-	Uint8 *src, *dst;
+	const int full = (int)(rate_quality[quality].rolloff * 1000.0);
+	int taps;
 
-#ifdef DEBUG_CONVERT
-	fprintf(stderr, "Converting audio rate / 2\n");
-#endif
-	src = cvt->buf;
-	dst = cvt->buf;
-	switch (format & 0xFF) {
-		case 8:
-			for ( i=cvt->len_cvt/2; i; --i ) {
-				dst[0] = src[0];
-				src += 2;
-				dst += 1;
-			}
-			break;
-		case 16:
-			for ( i=cvt->len_cvt/4; i; --i ) {
-				dst[0] = src[0];
-				dst[1] = src[1];
-				src += 4;
-				dst += 2;
-			}
-			break;
-	}
-	cvt->len_cvt /= 2;
-	if ( cvt->filters[++cvt->filter_index] ) {
-		cvt->filters[cvt->filter_index](cvt, format);
+	taps = (rate_quality[quality].taps * full + cutoff - 1) / cutoff;
+	taps = (taps + 1) & ~1;
+	if ( taps > RATE_MAX_TAPS ) {
+		taps = RATE_MAX_TAPS;
 	}
+	return taps;
 }
 
-
-/* Convert rate down by multiple of 2, for stereo */
-void SDLCALL SDL_RateDIV2_c2(SDL_AudioCVT *cvt, Uint16 format)
+static Sint16 *SDL_BuildRateBank(int quality, int cutoff)
 {
-	int i;
-	Uint8 *src, *dst;
+	const int taps = SDL_RateTaps(quality, cutoff);
+	const double beta = rate_quality[quality].beta;
+	double h[RATE_MAX_TAPS];
+	Sint16 *bank;
+	int i, phase, t;
+
+	/* Use the bank built for an earlier converter, if there is one */
+	for ( i = 0; i < RATE_MAX_BANKS && rate_banks[i].bank; ++i ) {
+		if ( (rate_banks[i].quality == quality) &&
+		     (rate_banks[i].cutoff == cutoff) ) {
+			return rate_banks[i].bank;
+		}
+	}
+	if ( i == RATE_MAX_BANKS ) {
+		SDL_SetError("Too many different audio rate conversions");
+		return NULL;
+	}
 
-#ifdef DEBUG_CONVERT
-	fprintf(stderr, "Converting audio rate / 2\n");
-#endif
-	src = cvt->buf;
-	dst = cvt->buf;
-	switch (format & 0xFF) {
-		case 8:
-			for ( i=cvt->len_cvt/4; i; --i ) {
-				dst[0] = src[0];
-				dst[1] = src[1];
-				src += 4;
-				dst += 2;
-			}
-			break;
-		case 16:
-			for ( i=cvt->len_cvt/8; i; --i ) {
-				dst[0] = src[0];
-				dst[1] = src[1];
-				dst[2] = src[2];
-				dst[3] = src[3];
-				src += 8;
-				dst += 4;
-			}
-			break;
+	bank = (Sint16 *)SDL_malloc((RATE_PHASES + 1) * taps * sizeof(Sint16));
+	if ( bank == NULL ) {
+		SDL_OutOfMemory();
+		return NULL;
 	}
-	cvt->len_cvt /= 2;
-	if ( cvt->filters[++cvt->filter_index] ) {
-		cvt->filters[cvt->filter_index](cvt, format);
+	for ( phase = 0; phase <= RATE_PHASES; ++phase ) {
+		/* Tap t reads the input frame this far before the output */
+		const double frac = (double)phase / RATE_PHASES;
+		double sum = 0.0;
+
+		for ( t = 0; t < taps; ++t ) {
+			h[t] = RateKernel(t + 1 - taps/2 - frac,
+			                  cutoff / 1000.0, beta, taps/2);
+			sum += h[t];
+		}
+		/* Every phase passes DC at exactly unity gain */
+		for ( t = 0; t < taps; ++t ) {
+			double v = h[t] * 32768.0 / sum;
+			v = (v < 0.0) ? (v - 0.5) : (v + 0.5);
+			if ( v > 32767.0 ) {
+				v = 32767.0;
+			} else if ( v < -32768.0 ) {
+				v = -32768.0;
+			}
+			bank[phase * taps + t] = (Sint16)v;
+		}
 	}
+	rate_banks[i].quality = quality;
+	rate_banks[i].cutoff = cutoff;
+	rate_banks[i].bank = bank;
+	return bank;
 }
 
-
-/* Convert rate down by multiple of 2, for quad */
-void SDLCALL SDL_RateDIV2_c4(SDL_AudioCVT *cvt, Uint16 format)
+/* The quality level asked for with SDL_AUDIO_RESAMPLE_QUALITY */
+static int SDL_RateQuality(void)
 {
-	int i;
-	Uint8 *src, *dst;
-
-#ifdef DEBUG_CONVERT
-	fprintf(stderr, "Converting audio rate / 2\n");
-#endif
-	src = cvt->buf;
-	dst = cvt->buf;
-	switch (format & 0xFF) {
-		case 8:
-			for ( i=cvt->len_cvt/8; i; --i ) {
-				dst[0] = src[0];
-				dst[1] = src[1];
-				dst[2] = src[2];
-				dst[3] = src[3];
-				src += 8;
-				dst += 4;
-			}
-			break;
-		case 16:
-			for ( i=cvt->len_cvt/16; i; --i ) {
-				dst[0] = src[0];
-				dst[1] = src[1];
-				dst[2] = src[2];
-				dst[3] = src[3];
-				dst[4] = src[4];
-				dst[5] = src[5];
-				dst[6] = src[6];
-				dst[7] = src[7];
-				src += 16;
-				dst += 8;
-			}
-			break;
-	}
-	cvt->len_cvt /= 2;
-	if ( cvt->filters[++cvt->filter_index] ) {
-		cvt->filters[cvt->filter_index](cvt, format);
+	const char *env;
+	int quality;
+
+	quality = RATE_DEFAULT_QUALITY;
+	env = SDL_getenv("SDL_AUDIO_RESAMPLE_QUALITY");
+	if ( env ) {
+		quality = SDL_atoi(env);
+		if ( quality < 0 ) {
+			quality = 0;
+		}
+		if ( quality >= SDL_arraysize(rate_quality) ) {
+			quality = SDL_arraysize(rate_quality) - 1;
+		}
 	}
+	return(quality);
 }
 
-/* Convert rate down by multiple of 2, for 5.1 */
-void SDLCALL SDL_RateDIV2_c6(SDL_AudioCVT *cvt, Uint16 format)
+/* Take a slot for cvt and set it up to resample channels of audio by
+   cvt->rate_incr from the start. Called with rate_lock held.
+*/
+static SDL_RateState *SDL_SetupRateState(const SDL_AudioCVT *cvt, int channels)
 {
-	int i;
-	Uint8 *src, *dst;
+	SDL_RateState *state = NULL;
+	double cutoff, step_frac;
+	int quality, i;
 
-#ifdef DEBUG_CONVERT
-	fprintf(stderr, "Converting audio rate / 2\n");
-#endif
-	src = cvt->buf;
-	dst = cvt->buf;
-	switch (format & 0xFF) {
-		case 8:
-			for ( i=cvt->len_cvt/12; i; --i ) {
-				dst[0] = src[0];
-				dst[1] = src[1];
-				dst[2] = src[2];
-				dst[3] = src[3];
-				dst[4] = src[4];
-				dst[5] = src[5];
-				src += 12;
-				dst += 6;
-			}
-			break;
-		case 16:
-			for ( i=cvt->len_cvt/24; i; --i ) {
-				dst[0] = src[0];
-				dst[1] = src[1];
-				dst[2] = src[2];
-				dst[3] = src[3];
-				dst[4] = src[4];
-				dst[5] = src[5];
-				dst[6] = src[6];
-				dst[7] = src[7];
-				dst[8] = src[8];
-				dst[9] = src[9];
-				dst[10] = src[10];
-				dst[11] = src[11];
-				src += 24;
-				dst += 12;
-			}
+	for ( i = 0; i < RATE_MAX_STREAMS; ++i ) {
+		if ( rate_states[i].cvt == cvt ) {
+			state = &rate_states[i];
 			break;
+		}
+		if ( !rate_states[i].busy &&
+		     (!state || (rate_states[i].used < state->used)) ) {
+			state = &rate_states[i];
+		}
 	}
-	cvt->len_cvt /= 2;
-	if ( cvt->filters[++cvt->filter_index] ) {
-		cvt->filters[cvt->filter_index](cvt, format);
+	if ( state == NULL ) {
+		SDL_SetError("Too many audio rate conversions at once");
+		return(NULL);
+	}
+
+	/* Downsampling lowers the cutoff to the output Nyquist */
+	quality = SDL_RateQuality();
+	cutoff = rate_quality[quality].rolloff;
+	if ( cvt->rate_incr > 1.0 ) {
+		cutoff /= cvt->rate_incr;
+	}
+	state->filter = SDL_BuildRateBank(quality, (int)(cutoff * 1000.0));
+	if ( state->filter == NULL ) {
+		return(NULL);
 	}
+	state->cvt = cvt;
+	state->used = ++rate_clock;
+	state->taps = SDL_RateTaps(quality, (int)(cutoff * 1000.0));
+	state->interp = rate_quality[quality].interp;
+	state->channels = channels;
+	/* Rounded up, so a stream of whole seconds makes whole seconds */
+	step_frac = (cvt->rate_incr - (int)cvt->rate_incr) * 4294967296.0;
+	state->step = (int)cvt->rate_incr;
+	state->step_frac = (Uint32)step_frac;
+	if ( state->step_frac < step_frac ) {
+		if ( ++state->step_frac == 0 ) {
+			++state->step;
+		}
+	}
+	state->pos = 0;
+	state->frac = 0;
+	SDL_memset(state->history, 0, sizeof(state->history));
+	return(state);
 }
 
-/* Very slow rate conversion routine */
-void SDLCALL SDL_RateSLOW(SDL_AudioCVT *cvt, Uint16 format)
+/* Resample native 16-bit audio in place.
+   A buffer produces every output frame that falls before its end, which
+   is its len*len_ratio share of the output give or take a frame. The
+   position of the next one is carried over to the following buffer.
+*/
+static void SDL_RatePoly(SDL_AudioCVT *cvt, Uint16 format, int channels)
 {
-	double ipos;
-	int i, clen;
-
+	const int frame = channels * 2;
+	Sint16 window[(RATE_MAX_TAPS - 1 + RATE_BLOCK) * RATE_MAX_CHANNELS];
+	Sint16 coefs[RATE_MAX_TAPS];
+	SDL_RateState *state = NULL;
+	const Sint16 *src;
+	Sint16 *dst;
+	int in, out, cap, pos, step, k, i, n, c, t, taps, carry;
+	Uint32 frac, step_frac;
+
+	in = cvt->len_cvt / frame;
+	cap = (cvt->len * cvt->len_mult) / frame;
+
+	/* Claim this converter's state, setting it up again if it was lost */
+	if ( SDL_LockRate() == 0 ) {
+		for ( i = 0; i < RATE_MAX_STREAMS; ++i ) {
+			if ( rate_states[i].cvt == cvt ) {
+				state = &rate_states[i];
+				break;
+			}
+		}
+		if ( state == NULL ) {
+			state = SDL_SetupRateState(cvt, channels);
+		}
+		if ( state ) {
+			state->busy = 1;
+			state->used = ++rate_clock;
+		}
+		SDL_UnlockRate();
+	}
+	if ( state == NULL ) {
+		/* Keep the stream its length, if not its sound */
+		out = (int)(in / cvt->rate_incr + 0.5);
+		if ( out > cap ) {
+			out = cap;
+		}
+		SDL_memset(cvt->buf, 0, out * frame);
+		cvt->len_cvt = out * frame;
+		if ( cvt->filters[++cvt->filter_index] ) {
+			cvt->filters[cvt->filter_index](cvt, format);
+		}
+		return;
+	}
+	taps = state->taps;
+	carry = (taps - 1) * channels;
+
+	/* Output frame k is at input frame pos + frac/2^32, stepping by the
+	   ratio of the rates, and those before the end of the input are due.
+	   out may be a frame or two over their number, which the loop below
+	   counts exactly.
+	*/
+	step = state->step;
+	step_frac = state->step_frac;
+	pos = state->pos;
+	frac = state->frac;
+	out = 0;
+	if ( pos < in ) {
+		out = (int)((in - pos - frac / 4294967296.0) / cvt->rate_incr) + 2;
+	}
+	if ( out > cap ) {
+		out = cap;
+	}
 #ifdef DEBUG_CONVERT
-	fprintf(stderr, "Converting audio rate * %4.4f\n", 1.0/cvt->rate_incr);
+	fprintf(stderr, "Resampling %d frames to %d\n", in, out);
 #endif
-	clen = (int)((double)cvt->len_cvt / cvt->rate_incr);
-	if ( cvt->rate_incr > 1.0 ) {
-		switch (format & 0xFF) {
-			case 8: {
-				Uint8 *output;
-
-				output = cvt->buf;
-				ipos = 0.0;
-				for ( i=clen; i; --i ) {
-					*output = cvt->buf[(int)ipos];
-					ipos += cvt->rate_incr;
-					output += 1;
-				}
-			}
-			break;
 
-			case 16: {
-				Uint16 *output;
+	/* When upsampling, move the input up out of the way of the output */
+	dst = (Sint16 *)cvt->buf;
+	src = dst;
+	if ( out > in ) {
+		src = dst + (out - in) * channels;
+		SDL_memmove((Sint16 *)src, dst, in * frame);
+	}
 
-				clen &= ~1;
-				output = (Uint16 *)cvt->buf;
-				ipos = 0.0;
-				for ( i=clen/2; i; --i ) {
-					*output=((Uint16 *)cvt->buf)[(int)ipos];
-					ipos += cvt->rate_incr;
-					output += 1;
-				}
-			}
-			break;
+	k = 0;
+
+	/* The window holds the tail of the previous input, then a block of
+	   new input. Outputs are only written below the input still unread,
+	   so everything happens in the one buffer.
+	*/
+	SDL_memcpy(window, state->history, carry * sizeof(Sint16));
+	for ( i = 0; i < in; i += n ) {
+		n = in - i;
+		if ( n > RATE_BLOCK ) {
+			n = RATE_BLOCK;
 		}
-	} else {
-		switch (format & 0xFF) {
-			case 8: {
-				Uint8 *output;
-
-				output = cvt->buf+clen;
-				ipos = (double)cvt->len_cvt;
-				for ( i=clen; i; --i ) {
-					ipos -= cvt->rate_incr;
-					output -= 1;
-					*output = cvt->buf[(int)ipos];
+		SDL_memcpy(window + carry, src + i * channels, n * frame);
+
+		for ( ; (k < out) && (pos < i + n); ++k ) {
+			const Sint16 *x = window + (pos - i) * channels;
+			const Sint16 *h = state->filter +
+				(frac >> (32 - RATE_PHASE_BITS)) * taps;
+			Sint32 acc;
+
+			if ( state->interp ) {
+				const Sint32 w = (frac >> (32 - RATE_PHASE_BITS - 15)) & 0x7FFF;
+				for ( t = 0; t < taps; ++t ) {
+					coefs[t] = h[t] + (((h[t + taps] - h[t]) * w) >> 15);
 				}
+				h = coefs;
 			}
-			break;
-
-			case 16: {
-				Uint16 *output;
 
-				clen &= ~1;
-				output = (Uint16 *)(cvt->buf+clen);
-				ipos = (double)cvt->len_cvt/2;
-				for ( i=clen/2; i; --i ) {
-					ipos -= cvt->rate_incr;
-					output -= 1;
-					*output=((Uint16 *)cvt->buf)[(int)ipos];
+			for ( c = 0; c < channels; ++c ) {
+				acc = 1 << 14;
+				for ( t = 0; t < taps; ++t ) {
+					acc += h[t] * x[t * channels + c];
+				}
+				acc >>= 15;
+				if ( acc > 32767 ) {
+					acc = 32767;
+				} else if ( acc < -32768 ) {
+					acc = -32768;
 				}
+				dst[k * channels + c] = (Sint16)acc;
+			}
+
+			pos += step;
+			frac += step_frac;
+			if ( frac < step_frac ) {
+				++pos;
 			}
-			break;
 		}
+		SDL_memmove(window, window + n * channels, carry * sizeof(Sint16));
 	}
-	cvt->len_cvt = clen;
+	SDL_memcpy(state->history, window, carry * sizeof(Sint16));
+	state->pos = (pos > in) ? (pos - in) : 0;
+	state->frac = frac;
+
+	SDL_mutexP(rate_lock);
+	state->busy = 0;
+	SDL_UnlockRate();
+
+	cvt->len_cvt = k * frame;
 	if ( cvt->filters[++cvt->filter_index] ) {
 		cvt->filters[cvt->filter_index](cvt, format);
 	}
 }
 
+/* The filters carry the channel count, so a converter that lost its state
+   can set it up again */
+#define RATE_FILTER(n) \
+static void SDLCALL SDL_RatePoly##n(SDL_AudioCVT *cvt, Uint16 format) \
+{ \
+	SDL_RatePoly(cvt, format, n); \
+}
+RATE_FILTER(1)
+RATE_FILTER(2)
+RATE_FILTER(3)
+RATE_FILTER(4)
+RATE_FILTER(5)
+RATE_FILTER(6)
+
+static void (SDLCALL *rate_filters[RATE_MAX_CHANNELS])(SDL_AudioCVT *cvt, Uint16 format) = {
+	SDL_RatePoly1, SDL_RatePoly2, SDL_RatePoly3,
+	SDL_RatePoly4, SDL_RatePoly5, SDL_RatePoly6
+};
+
+/* Set up the resampler in cvt for native 16-bit samples */
+static int SDL_BuildRateCVT(SDL_AudioCVT *cvt, int channels,
+                            int src_rate, int dst_rate)
+{
+	SDL_RateState *state;
+	int mult;
+
+	if ( (channels < 1) || (channels > RATE_MAX_CHANNELS) ) {
+		SDL_SetError("Can't resample %d channel audio", channels);
+		return(-1);
+	}
+
+	cvt->rate_incr = (double)src_rate / dst_rate;
+	if ( SDL_LockRate() < 0 ) {
+		return(-1);
+	}
+	state = SDL_SetupRateState(cvt, channels);
+	SDL_UnlockRate();
+	if ( state == NULL ) {
+		return(-1);
+	}
+
+	mult = dst_rate / src_rate;
+	if ( (mult * src_rate) < dst_rate ) {
+		++mult;
+	}
+	cvt->len_mult *= mult;
+	cvt->len_ratio /= cvt->rate_incr;
+	cvt->filters[cvt->filter_index++] = rate_filters[channels - 1];
+	return(0);
+}
+
 int SDL_ConvertAudio(SDL_AudioCVT *cvt)
 {
 	/* Make sure there's data to convert */
@@ -1319,36 +1370,22 @@ int SDL_ConvertAudio(SDL_AudioCVT *cvt)
 	return(0);
 }
 
-/* Creates a set of audio filters to convert from one format to another. 
-   Returns -1 if the format conversion is not supported, or 1 if the
-   audio filter is set up.
-*/
-  
-int SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
-	Uint16 src_format, Uint8 src_channels, int src_rate,
-	Uint16 dst_format, Uint8 dst_channels, int dst_rate)
+/* Add the filters converting samples from one format to another */
+static void SDL_BuildFormatCVT(SDL_AudioCVT *cvt,
+	Uint16 src_format, Uint16 dst_format)
 {
-/*printf("Build format %04x->%04x, channels %u->%u, rate %d->%d\n",
-		src_format, dst_format, src_channels, dst_channels, src_rate, dst_rate);*/
-	/* Start off with no conversion necessary */
-	cvt->needed = 0;
-	cvt->filter_index = 0;
-	cvt->filters[0] = NULL;
-	cvt->len_mult = 1;
-	cvt->len_ratio = 1.0;
-
-	/* First filter:  Endian conversion from src to dst */
+	/* Endian conversion from src to dst */
 	if ( (src_format & 0x1000) != (dst_format & 0x1000)
 	     && ((src_format & 0xff) == 16) && ((dst_format & 0xff) == 16)) {
 		cvt->filters[cvt->filter_index++] = SDL_ConvertEndian;
 	}
 	
-	/* Second filter: Sign conversion -- signed/unsigned */
+	/* Sign conversion -- signed/unsigned */
 	if ( (src_format & 0x8000) != (dst_format & 0x8000) ) {
 		cvt->filters[cvt->filter_index++] = SDL_ConvertSign;
 	}
 
-	/* Next filter:  Convert 16 bit <--> 8 bit PCM */
+	/* Convert 16 bit <--> 8 bit PCM */
 	if ( (src_format & 0xFF) != (dst_format & 0xFF) ) {
 		switch (dst_format&0x10FF) {
 			case AUDIO_U8:
@@ -1370,8 +1407,35 @@ int SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
 				break;
 		}
 	}
+}
+
+/* Creates a set of audio filters to convert from one format to another. 
+   Returns -1 if the format conversion is not supported, or 1 if the
+   audio filter is set up.
+*/
+  
+int SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
+	Uint16 src_format, Uint8 src_channels, int src_rate,
+	Uint16 dst_format, Uint8 dst_channels, int dst_rate)
+{
+	int resample;
 
-	/* Last filter:  Mono/Stereo conversion */
+/*printf("Build format %04x->%04x, channels %u->%u, rate %d->%d\n",
+		src_format, dst_format, src_channels, dst_channels, src_rate, dst_rate);*/
+	/* Start off with no conversion necessary */
+	cvt->needed = 0;
+	cvt->filter_index = 0;
+	cvt->filters[0] = NULL;
+	cvt->len_mult = 1;
+	cvt->len_ratio = 1.0;
+
+	/* Resampling works on native 16-bit samples, so when the rate changes
+	   the samples are converted to that first, and to dst_format last. */
+	resample = ((src_rate/100) != (dst_rate/100));
+	SDL_BuildFormatCVT(cvt, src_format,
+	                   resample ? AUDIO_S16SYS : dst_format);
+
+	/* Next filter:  Mono/Stereo conversion */
 	if ( src_channels != dst_channels ) {
 		if ( (src_channels == 1) && (dst_channels > 1) ) {
 			cvt->filters[cvt->filter_index++] = 
@@ -1435,66 +1499,11 @@ int SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
 
 	/* Do rate conversion */
 	cvt->rate_incr = 0.0;
-	if ( (src_rate/100) != (dst_rate/100) ) {
-		Uint32 hi_rate, lo_rate;
-		int len_mult;
-		double len_ratio;
-		void (SDLCALL *rate_cvt)(SDL_AudioCVT *cvt, Uint16 format);
-
-		if ( src_rate > dst_rate ) {
-			hi_rate = src_rate;
-			lo_rate = dst_rate;
-			switch (src_channels) {
-				case 1: rate_cvt = SDL_RateDIV2; break;
-				case 2: rate_cvt = SDL_RateDIV2_c2; break;
-				case 4: rate_cvt = SDL_RateDIV2_c4; break;
-				case 6: rate_cvt = SDL_RateDIV2_c6; break;
-				default: return -1;
-			}
-			len_mult = 1;
-			len_ratio = 0.5;
-		} else {
-			hi_rate = dst_rate;
-			lo_rate = src_rate;
-			switch (src_channels) {
-				case 1: rate_cvt = SDL_RateMUL2; break;
-				case 2: rate_cvt = SDL_RateMUL2_c2; break;
-				case 4: rate_cvt = SDL_RateMUL2_c4; break;
-				case 6: rate_cvt = SDL_RateMUL2_c6; break;
-				default: return -1;
-			}
-			len_mult = 2;
-			len_ratio = 2.0;
-		}
-		/* If hi_rate = lo_rate*2^x then conversion is easy */
-		while ( ((lo_rate*2)/100) <= (hi_rate/100) ) {
-			cvt->filters[cvt->filter_index++] = rate_cvt;
-			cvt->len_mult *= len_mult;
-			lo_rate *= 2;
-			cvt->len_ratio *= len_ratio;
-		}
-		/* We may need a slow conversion here to finish up */
-		if ( (lo_rate/100) != (hi_rate/100) ) {
-#if 1
-			/* The problem with this is that if the input buffer is
-			   say 1K, and the conversion rate is say 1.1, then the
-			   output buffer is 1.1K, which may not be an acceptable
-			   buffer size for the audio driver (not a power of 2)
-			*/
-			/* For now, punt and hope the rate distortion isn't great.
-			*/
-#else
-			if ( src_rate < dst_rate ) {
-				cvt->rate_incr = (double)lo_rate/hi_rate;
-				cvt->len_mult *= 2;
-				cvt->len_ratio /= cvt->rate_incr;
-			} else {
-				cvt->rate_incr = (double)hi_rate/lo_rate;
-				cvt->len_ratio *= cvt->rate_incr;
-			}
-			cvt->filters[cvt->filter_index++] = SDL_RateSLOW;
-#endif
+	if ( resample ) {
+		if ( SDL_BuildRateCVT(cvt, src_channels, src_rate, dst_rate) < 0 ) {
+			return(-1);
 		}
+		SDL_BuildFormatCVT(cvt, AUDIO_S16SYS, dst_format);
 	}
 
 	/* Set up the filter information */
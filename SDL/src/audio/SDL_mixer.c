@@ -30,6 +30,7 @@
 #include "SDL_mixer_MMX.h"
 #include "SDL_mixer_MMX_VC.h"
 #include "SDL_mixer_m68k.h"
+#include "SDL_mixer_SIMD.h"
 
 /* This table is used to add two sound values together and pin
  * the value to avoid overflow.  (used with permission from ARDI)
@@ -195,6 +196,13 @@ void SDL_MixAudio (Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
 			int dst_sample;
 			const int max_audioval = ((1<<(16-1))-1);
 			const int min_audioval = -(1<<(16-1));
+			Uint32 done;
+
+			/* The vector unit takes what it can, we do the rest */
+			done = SDL_MixAudio_SIMD_S16LSB(dst, src, len, volume);
+			dst += done;
+			src += done;
+			len -= done;
 
 			len /= 2;
 			while ( len-- ) {
@@ -227,6 +235,13 @@ void SDL_MixAudio (Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
 			int dst_sample;
 			const int max_audioval = ((1<<(16-1))-1);
 			const int min_audioval = -(1<<(16-1));
+			Uint32 done;
+
+			/* The vector unit takes what it can, we do the rest */
+			done = SDL_MixAudio_SIMD_S16MSB(dst, src, len, volume);
+			dst += done;
+			src += done;
+			len -= done;
 
 			len /= 2;
 			while ( len-- ) {
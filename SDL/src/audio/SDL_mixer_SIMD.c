@@ -0,0 +1,119 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2009 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Vector kernels for the 16-bit SDL_MixAudio formats */
+
+#include "SDL_audio.h"
+#include "SDL_mixer_SIMD.h"
+
+#ifdef MIXVEC_SAMPLES
+static Uint32 SDL_MixVec_S16(Uint8 *dst, const Uint8 *src, Uint32 len,
+                             int volume, int swap)
+{
+	const Uint32 step = MIXVEC_SAMPLES * 2;
+	mixvec_t vol;
+	Uint32 done;
+
+	if ( !MIXVEC_AVAILABLE() ||
+	     ((((size_t)dst) | ((size_t)src)) & (MIXVEC_ALIGN - 1)) ) {
+		return 0;
+	}
+	vol = MIXVEC_VOLUME(volume);
+	for ( done = 0; done + step <= len; done += step ) {
+		mixvec_t s = MIXVEC_LOAD(src + done);
+		mixvec_t d = MIXVEC_LOAD(dst + done);
+
+		if ( swap ) {
+			s = MIXVEC_SWAP(s);
+			d = MIXVEC_SWAP(d);
+		}
+		d = MIXVEC_ADDS(d, MIXVEC_SCALE(s, vol));
+		if ( swap ) {
+			d = MIXVEC_SWAP(d);
+		}
+		MIXVEC_STORE(dst + done, d);
+	}
+	return done;
+}
+#endif /* MIXVEC_SAMPLES */
+
+#if SDL_MIXVEC_PAIRED
+/* Broadway's quantized loads turn a pair of big endian samples into a
+   pair of floats, and quantized stores clamp a pair back to 16 bits, so
+   mixing two samples takes four instructions. GQR7 is borrowed for the
+   16-bit format and restored afterwards. The sum is only truncated once,
+   so samples may not match the scalar loop's exactly.
+*/
+static Uint32 SDL_MixPaired_S16MSB(Uint8 *dst, const Uint8 *src, Uint32 len,
+                                   int volume)
+{
+	const float scale = (float)volume / SDL_MIX_MAXVOLUME;
+	Uint32 gqr, done;
+
+	if ( (((Uint32)dst) | ((Uint32)src)) & 3 ) {
+		return 0;
+	}
+	len &= ~7;
+	__asm__ __volatile__ ("mfspr %0, 919" : "=r" (gqr));
+	__asm__ __volatile__ ("mtspr 919, %0" : : "r" (0x00070007));
+	for ( done = 0; done < len; done += 8 ) {
+		double s0, s1, d0, d1;
+		__asm__ __volatile__ (
+			"psq_l		%0, 0(%4), 0, 7\n\t"
+			"psq_l		%1, 4(%4), 0, 7\n\t"
+			"psq_l		%2, 0(%5), 0, 7\n\t"
+			"psq_l		%3, 4(%5), 0, 7\n\t"
+			"ps_madds0	%2, %0, %6, %2\n\t"
+			"ps_madds0	%3, %1, %6, %3\n\t"
+			"psq_st		%2, 0(%5), 0, 7\n\t"
+			"psq_st		%3, 4(%5), 0, 7"
+			: "=&f" (s0), "=&f" (s1), "=&f" (d0), "=&f" (d1)
+			: "b" (src + done), "b" (dst + done), "f" (scale)
+			: "memory");
+	}
+	__asm__ __volatile__ ("mtspr 919, %0" : : "r" (gqr));
+	return len;
+}
+#endif /* SDL_MIXVEC_PAIRED */
+
+Uint32 SDL_MixAudio_SIMD_S16LSB(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+#ifdef MIXVEC_SAMPLES
+	return SDL_MixVec_S16(dst, src, len, volume,
+	                      (SDL_BYTEORDER == SDL_BIG_ENDIAN));
+#else
+	return 0;
+#endif
+}
+
+Uint32 SDL_MixAudio_SIMD_S16MSB(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+#if SDL_MIXVEC_PAIRED
+	return SDL_MixPaired_S16MSB(dst, src, len, volume);
+#elif defined(MIXVEC_SAMPLES)
+	return SDL_MixVec_S16(dst, src, len, volume,
+	                      (SDL_BYTEORDER == SDL_LIL_ENDIAN));
+#else
+	return 0;
+#endif
+}
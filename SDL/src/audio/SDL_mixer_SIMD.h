@@ -0,0 +1,146 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2009 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_mixer_SIMD_h
+#define _SDL_mixer_SIMD_h
+
+/* Vector versions of the 16-bit SDL_MixAudio loops.
+
+   The kernels are written once against a small vector abstraction, which
+   each instruction set fills in:
+
+     mixvec_t			a vector of signed 16-bit samples
+     MIXVEC_SAMPLES		the number of samples in a vector
+     MIXVEC_ALIGN		the alignment MIXVEC_LOAD and MIXVEC_STORE need
+     MIXVEC_AVAILABLE()		whether the CPU running us has the unit
+     MIXVEC_LOAD(p), MIXVEC_STORE(p, v)
+     MIXVEC_SWAP(v)		swap the bytes of every sample
+     MIXVEC_VOLUME(volume)	a 0-128 volume, ready for MIXVEC_SCALE
+     MIXVEC_SCALE(v, vol)	every sample times volume / 128, as C rounds it
+     MIXVEC_ADDS(a, b)		add, clamping to the 16-bit range
+
+   The SSE2 results match the scalar loops exactly, testmixaudio checks
+   that. The Wii's paired singles can't hold integer lanes across C
+   statements, so they get a kernel of their own in SDL_mixer_SIMD.c.
+
+   The AltiVec and paired single kernels have never been run, so they're
+   only built when SDL_ALTIVEC_MIXER or SDL_PAIRED_MIXER is defined along
+   with SDL_ASSEMBLY_ROUTINES.
+*/
+#include "SDL_stdinc.h"
+#include "SDL_cpuinfo.h"
+
+#if SDL_ASSEMBLY_ROUTINES
+#  if defined(__GNUC__) && defined(__SSE2__)
+#    define SDL_MIXVEC_SSE2	1
+#  elif SDL_ALTIVEC_BLITTERS && SDL_ALTIVEC_MIXER
+#    define SDL_MIXVEC_ALTIVEC	1
+#  endif
+#  if defined(__GNUC__) && defined(GEKKO) && SDL_PAIRED_MIXER
+#    define SDL_MIXVEC_PAIRED	1
+#  endif
+#endif
+
+#if SDL_MIXVEC_SSE2
+#include <emmintrin.h>
+
+typedef __m128i mixvec_t;
+
+#define MIXVEC_SAMPLES		8
+#define MIXVEC_ALIGN		1
+#define MIXVEC_AVAILABLE()	SDL_HasSSE2()
+#define MIXVEC_LOAD(p)		_mm_loadu_si128((const __m128i *)(p))
+#define MIXVEC_STORE(p, v)	_mm_storeu_si128((__m128i *)(p), v)
+#define MIXVEC_SWAP(v)		_mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8))
+#define MIXVEC_VOLUME(volume)	_mm_set1_epi16((short)(volume))
+#define MIXVEC_ADDS(a, b)	_mm_adds_epi16(a, b)
+#define MIXVEC_SCALE(v, vol)	MixVec_Scale(v, vol)
+
+static __inline__ mixvec_t MixVec_Scale(mixvec_t v, mixvec_t vol)
+{
+	const __m128i lo = _mm_mullo_epi16(v, vol);
+	const __m128i hi = _mm_mulhi_epi16(v, vol);
+	const __m128i round = _mm_set1_epi32(SDL_MIX_MAXVOLUME - 1);
+	__m128i a = _mm_unpacklo_epi16(lo, hi);
+	__m128i b = _mm_unpackhi_epi16(lo, hi);
+
+	/* Divide negative products toward zero, like C does */
+	a = _mm_add_epi32(a, _mm_and_si128(_mm_srai_epi32(a, 31), round));
+	b = _mm_add_epi32(b, _mm_and_si128(_mm_srai_epi32(b, 31), round));
+	return _mm_packs_epi32(_mm_srai_epi32(a, 7), _mm_srai_epi32(b, 7));
+}
+
+#elif SDL_MIXVEC_ALTIVEC
+#if __MWERKS__
+#pragma altivec_model on
+#endif
+#ifdef HAVE_ALTIVEC_H
+#include <altivec.h>
+#endif
+
+typedef vector signed short mixvec_t;
+
+#define MIXVEC_SAMPLES		8
+#define MIXVEC_ALIGN		16
+#define MIXVEC_AVAILABLE()	SDL_HasAltiVec()
+#define MIXVEC_LOAD(p)		vec_ld(0, (const short *)(p))
+#define MIXVEC_STORE(p, v)	vec_st(v, 0, (short *)(p))
+#define MIXVEC_SWAP(v)		((mixvec_t)vec_rl((vector unsigned short)(v), vec_splat_u16(8)))
+#define MIXVEC_VOLUME(volume)	MixVec_Volume(volume)
+#define MIXVEC_ADDS(a, b)	vec_adds(a, b)
+#define MIXVEC_SCALE(v, vol)	MixVec_Scale(v, vol)
+
+static __inline__ mixvec_t MixVec_Volume(int volume)
+{
+	union {
+		mixvec_t v;
+		short s[8];
+	} u;
+	u.s[0] = (short)volume;
+	return vec_splat(u.v, 0);
+}
+
+static __inline__ mixvec_t MixVec_Scale(mixvec_t v, mixvec_t vol)
+{
+	const vector unsigned int seven = vec_splat_u32(7);
+	const vector unsigned int sign = vec_splat_u32(-1);	/* Shift by 31 */
+	const vector signed int round = (vector signed int)
+		vec_sr(vec_splat_u32(-1), vec_splat_u32(-7));	/* 127 */
+	vector signed int even = vec_mule(v, vol);
+	vector signed int odd = vec_mulo(v, vol);
+
+	/* Divide negative products toward zero, like C does */
+	even = vec_sra(vec_add(even, vec_and(vec_sra(even, sign), round)), seven);
+	odd = vec_sra(vec_add(odd, vec_and(vec_sra(odd, sign), round)), seven);
+	return vec_packs(vec_mergeh(even, odd), vec_mergel(even, odd));
+}
+#endif
+
+/* Mix as much of src into dst as the vector unit can, starting at the
+   beginning. Returns the number of bytes mixed, the rest is left to the
+   scalar loop.
+*/
+extern Uint32 SDL_MixAudio_SIMD_S16LSB(Uint8 *dst, const Uint8 *src, Uint32 len, int volume);
+extern Uint32 SDL_MixAudio_SIMD_S16MSB(Uint8 *dst, const Uint8 *src, Uint32 len, int volume);
+
+#endif /* _SDL_mixer_SIMD_h */
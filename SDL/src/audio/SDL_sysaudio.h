@@ -68,6 +68,11 @@ struct SDL_AudioDevice {
 	/* An audio conversion block for audio format emulation */
 	SDL_AudioCVT convert;
 
+	/* Converted audio waiting for the next buffer of the device, as the
+	   resampler makes a frame more or less than a buffer now and then */
+	Uint8 *convert_fifo;
+	int convert_fifo_len;
+
 	/* Current state flags */
 	int enabled;
 	int paused;
@@ -184,4 +189,8 @@ extern AudioBootStrap EPOCAudio_bootstrap;
 /* This is the current audio device */
 extern SDL_AudioDevice *current_audio;
 
+/* Fill len bytes, at most a buffer of the device, from the callback
+   through the audio conversion block */
+extern void SDL_ConvertAudioStream(SDL_AudioDevice *audio, Uint8 *stream, int len);
+
 #endif /* _SDL_sysaudio_h */
@@ -109,11 +109,8 @@ static void FillSound(void *device, void *stream, size_t len,
 	if ( ! audio->paused ) {
 		if ( audio->convert.needed ) {
 			SDL_mutexP(audio->mixer_lock);
-			(*audio->spec.callback)(audio->spec.userdata,
-				(Uint8 *)audio->convert.buf,audio->convert.len);
+			SDL_ConvertAudioStream(audio, stream, len);
 			SDL_mutexV(audio->mixer_lock);
-			SDL_ConvertAudio(&audio->convert);
-			SDL_memcpy(stream,audio->convert.buf,audio->convert.len_cvt);
 		} else {
 			SDL_mutexP(audio->mixer_lock);
 			(*audio->spec.callback)(audio->spec.userdata,
@@ -125,13 +125,7 @@ static void mix_buffer(SDL_AudioDevice *audio, UInt8 *buffer)
         SDL_mutexP(audio->mixer_lock);
 #endif
         if ( audio->convert.needed ) {
-            audio->spec.callback(audio->spec.userdata,
-                    (Uint8 *)audio->convert.buf,audio->convert.len);
-            SDL_ConvertAudio(&audio->convert);
-            if ( audio->convert.len_cvt != audio->spec.size ) {
-                /* Uh oh... probably crashes here */;
-            }
-            SDL_memcpy(buffer, audio->convert.buf, audio->convert.len_cvt);
+            SDL_ConvertAudioStream(audio, buffer, audio->spec.size);
         } else {
             audio->spec.callback(audio->spec.userdata, buffer, audio->spec.size);
         }
@@ -343,16 +337,8 @@ void sndDoubleBackProc (SndChannelPtr chan, SndDoubleBufferPtr newbuf)
     newbuf->dbNumFrames = audio->spec.samples;
     if ( ! audio->paused ) {
         if ( audio->convert.needed ) {
-            audio->spec.callback(audio->spec.userdata,
-                (Uint8 *)audio->convert.buf,audio->convert.len);
-            SDL_ConvertAudio(&audio->convert);
-#if 0
-            if ( audio->convert.len_cvt != audio->spec.size ) {
-                /* Uh oh... probably crashes here */;
-            }
-#endif
-            SDL_memcpy(newbuf->dbSoundData, audio->convert.buf,
-                            audio->convert.len_cvt);
+            SDL_ConvertAudioStream(audio, (Uint8 *)newbuf->dbSoundData,
+                                   audio->spec.size);
         } else {
             audio->spec.callback(audio->spec.userdata,
                 (Uint8 *)newbuf->dbSoundData, audio->spec.size);
@@ -69,18 +69,7 @@ void SDL_MintAudio_Callback(void)
 		return;
 
 	if (audio->convert.needed) {
-		int silence;
-
-		if ( audio->convert.src_format == AUDIO_U8 ) {
-			silence = 0x80;
-		} else {
-			silence = 0;
-		}
-		SDL_memset(audio->convert.buf, silence, audio->convert.len);
-		audio->spec.callback(audio->spec.userdata,
-			(Uint8 *)audio->convert.buf,audio->convert.len);
-		SDL_ConvertAudio(&audio->convert);
-		SDL_memcpy(buffer, audio->convert.buf, audio->convert.len_cvt);
+		SDL_ConvertAudioStream(audio, buffer, audio->spec.size);
 	} else {
 		audio->spec.callback(audio->spec.userdata, buffer, audio->spec.size);
 	}
@@ -128,11 +128,8 @@ void SoundMixCallback(void *stream,u32 len)
 		if ( audio->convert.needed ) {
 			//fprintf(stderr,"converting audio\n");
 			SDL_mutexP(audio->mixer_lock);
-			(*audio->spec.callback)(audio->spec.userdata,
-				(Uint8 *)audio->convert.buf,audio->convert.len);
+			SDL_ConvertAudioStream(audio, stream, len);
 			SDL_mutexV(audio->mixer_lock);
-			SDL_ConvertAudio(&audio->convert);
-			SDL_memcpy(stream,audio->convert.buf,audio->convert.len_cvt);
 		} else {
 			SDL_mutexP(audio->mixer_lock);
 			(*audio->spec.callback)(audio->spec.userdata,
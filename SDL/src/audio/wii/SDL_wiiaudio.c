@@ -34,14 +34,19 @@
 #include <ogcsys.h>
 #include <ogc/audio.h>
 #include <ogc/cache.h>
+#include <malloc.h>
 #include "SDL_wiiaudio.h"
+#include "SDL_wiiaudioring_c.h"
 
-#define SAMPLES_PER_DMA_BUFFER (512)
+// Period sizes, in sample frames; DMA lengths are multiples of 32 bytes
+#define MIN_SAMPLES_PER_DMA_BUFFER (128)
+#define MAX_SAMPLES_PER_DMA_BUFFER (8192)
 
 static const char WIIAUD_DRIVER_NAME[] = "wii";
-static Uint32 dma_buffers[2][SAMPLES_PER_DMA_BUFFER*8] __attribute__((aligned(32)));
-static int dma_buffers_size[2] = { SAMPLES_PER_DMA_BUFFER*4, SAMPLES_PER_DMA_BUFFER*4 };
-static Uint8 whichab = 0;
+static Uint8 *dma_memory = NULL;
+static WII_AudioRing dma_ring;
+static int dma_buffer_count = WII_AUDIO_DEFAULT_BUFFERS;
+static Uint32 dma_period = 0;
 
 #define AUDIOSTACK 16384*2
 static lwpq_t audioqueue;
@@ -50,6 +55,46 @@ static Uint8 astack[AUDIOSTACK];
 static bool stopaudio = false;
 static int currentfreq;
 
+/****************************************************************************
+ * RenderAudio
+ * Produce one period of audio into a DMA buffer
+ ***************************************************************************/
+static Uint32
+RenderAudio (void *userdata, Uint8 *buf, Uint32 len)
+{
+	Uint32 used = len;
+
+	// Is the device ready?
+	if (!current_audio || current_audio->paused)
+	{
+		memset(buf, 0, len);
+	}
+	else if (current_audio->convert.needed) // Is conversion required?
+	{
+		// SDL_OpenAudio may not have made the conversion buffers yet
+		if (!current_audio->convert.buf || !current_audio->convert_fifo)
+			memset(buf, 0, len);
+		else
+		{
+			SDL_mutexP(current_audio->mixer_lock);
+			SDL_ConvertAudioStream(current_audio, buf, len);
+			SDL_mutexV(current_audio->mixer_lock);
+		}
+	}
+	else
+	{
+		// The DMA buffer still holds its last trip round the ring
+		SDL_memset(buf, current_audio->spec.silence, len);
+
+		SDL_mutexP(current_audio->mixer_lock);
+		current_audio->spec.callback(
+			current_audio->spec.userdata, buf, len);
+		SDL_mutexV(current_audio->mixer_lock);
+	}
+	DCFlushRange(buf, used);
+	return used;
+}
+
 /****************************************************************************
  * Audio Threading
  ***************************************************************************/
@@ -61,43 +106,9 @@ AudioThread (void *arg)
 		if(stopaudio)
 			break;
 
-		memset(dma_buffers[whichab], 0, SAMPLES_PER_DMA_BUFFER*4);
-
-		// Is the device ready?
-		if (!current_audio || current_audio->paused)
-		{
-			DCFlushRange(dma_buffers[whichab], SAMPLES_PER_DMA_BUFFER*4);
-			dma_buffers_size[whichab] = SAMPLES_PER_DMA_BUFFER*4;
-		}
-		else if (current_audio->convert.needed) // Is conversion required?
-		{
-			SDL_mutexP(current_audio->mixer_lock);
-			// Get the client to produce audio
-			current_audio->spec.callback(
-				current_audio->spec.userdata,
-				current_audio->convert.buf,
-				current_audio->convert.len);
-			SDL_mutexV(current_audio->mixer_lock);
-
-			// Convert the audio
-			SDL_ConvertAudio(&current_audio->convert);
+		// Render as far ahead of the DMA as the ring allows
+		WII_AudioRingFill(&dma_ring, RenderAudio, NULL);
 
-			// Copy from SDL buffer to DMA buffer
-			memcpy(dma_buffers[whichab], current_audio->convert.buf, current_audio->convert.len_cvt);
-			DCFlushRange(dma_buffers[whichab], current_audio->convert.len_cvt);
-			dma_buffers_size[whichab] = current_audio->convert.len_cvt;
-		}
-		else
-		{
-			SDL_mutexP(current_audio->mixer_lock);
-			current_audio->spec.callback(
-				current_audio->spec.userdata,
-				(Uint8 *)dma_buffers[whichab],
-				SAMPLES_PER_DMA_BUFFER*4);
-			DCFlushRange(dma_buffers[whichab], SAMPLES_PER_DMA_BUFFER*4);
-			dma_buffers_size[whichab] = SAMPLES_PER_DMA_BUFFER*4;
-			SDL_mutexV(current_audio->mixer_lock);
-		}
 		LWP_ThreadSleep (audioqueue);
 	}
 	return NULL;
@@ -110,8 +121,10 @@ AudioThread (void *arg)
 static void
 DMACallback()
 {
-	whichab ^= 1;
-	AUDIO_InitDMA ((Uint32)dma_buffers[whichab], dma_buffers_size[whichab]);
+	Uint32 len;
+	const Uint8 *buf = WII_AudioRingNext(&dma_ring, &len);
+
+	AUDIO_InitDMA ((Uint32)buf, len);
 	LWP_ThreadSignal (audioqueue);
 }
 
@@ -133,6 +146,10 @@ void WII_AudioStart()
 	else
 		AUDIO_SetDSPSampleRate(AI_SAMPLERATE_48KHZ);
 
+	// Have the ring full before the DMA starts playing it
+	WII_AudioRingInit(&dma_ring, dma_memory, dma_buffer_count, dma_period);
+	WII_AudioRingFill(&dma_ring, RenderAudio, NULL);
+
 	// startup conversion thread
 	stopaudio = false;
 	LWP_InitQueue (&audioqueue);
@@ -146,18 +163,38 @@ void WII_AudioStart()
 
 static int WIIAUD_OpenAudio(_THIS, SDL_AudioSpec *spec)
 {
+	const char *env;
+
 	if (spec->freq != 32000 && spec->freq != 48000)
 		spec->freq = 32000;
 
+	// The period is whatever the application asked for, in whole cache lines
+	if (spec->samples < MIN_SAMPLES_PER_DMA_BUFFER)
+		spec->samples = MIN_SAMPLES_PER_DMA_BUFFER;
+	if (spec->samples > MAX_SAMPLES_PER_DMA_BUFFER)
+		spec->samples = MAX_SAMPLES_PER_DMA_BUFFER;
+	spec->samples &= ~7;
+
 	// Set up actual spec.
 	spec->format	= AUDIO_S16MSB;
 	spec->channels	= 2;
-	spec->samples	= SAMPLES_PER_DMA_BUFFER;
 	spec->padding	= 0;
 	SDL_CalculateAudioSpec(spec);
 
-	memset(dma_buffers[0], 0, sizeof(dma_buffers[0]));
-	memset(dma_buffers[1], 0, sizeof(dma_buffers[0]));
+	// More buffers ride out longer hitches, at the cost of latency
+	env = SDL_getenv("SDL_WII_AUDIO_BUFFERS");
+	dma_buffer_count = env ? SDL_atoi(env) : WII_AUDIO_DEFAULT_BUFFERS;
+	dma_buffer_count = SDL_max(dma_buffer_count, WII_AUDIO_MIN_BUFFERS);
+	dma_buffer_count = SDL_min(dma_buffer_count, WII_AUDIO_MAX_BUFFERS);
+	dma_period = spec->size;
+
+	free(dma_memory);
+	dma_memory = memalign(32, WII_AUDIO_RING_BYTES(dma_buffer_count, dma_period));
+	if (!dma_memory)
+	{
+		SDL_OutOfMemory();
+		return -1;
+	}
 
 	currentfreq = spec->freq;
 	WII_AudioStart();
@@ -182,23 +219,19 @@ static Uint8 *WIIAUD_GetAudioBuf(_THIS)
 
 static void WIIAUD_CloseAudio(_THIS)
 {
-	// Stop any DMA going on
-	AUDIO_StopDMA();
+	// Stop any DMA going on and terminate conversion thread
+	if (athread != LWP_THREAD_NULL)
+		WII_AudioStop();
 
-	// terminate conversion thread
-	LWP_ThreadSignal(audioqueue);
+	free(dma_memory);
+	dma_memory = NULL;
 }
 
 static void WIIAUD_DeleteDevice(SDL_AudioDevice *device)
 {
-	// Forget the DMA callback
-	AUDIO_RegisterDMACallback(0);
-
-	// Stop any DMA going on
-	AUDIO_StopDMA();
-
-	// terminate conversion thread
-	LWP_ThreadSignal(audioqueue);
+	// Stop any DMA going on and terminate conversion thread
+	if (athread != LWP_THREAD_NULL)
+		WII_AudioStop();
 
 	SDL_free(device->hidden);
 	SDL_free(device);
@@ -247,3 +280,10 @@ AudioBootStrap WIIAUD_bootstrap = {
 	WIIAUD_DRIVER_NAME, "SDL Wii audio driver",
 	WIIAUD_Available, WIIAUD_CreateDevice
 };
+
+void WII_GetAudioStats(Uint32 *played, Uint32 *underruns, Uint32 *late)
+{
+	*played = dma_ring.played;
+	*underruns = dma_ring.underruns;
+	*late = dma_ring.late;
+}
@@ -37,4 +37,11 @@ struct SDL_PrivateAudioData {
 	Uint32 initial_calls;
 };
 
+void WII_AudioStart();
+void WII_AudioStop();
+
+/* Periods handed to the DMA, periods of silence played because nothing
+   was ready, and callbacks that were still running when that happened */
+void WII_GetAudioStats(Uint32 *played, Uint32 *underruns, Uint32 *late);
+
 #endif /* _SDL_dummyaudio_h */
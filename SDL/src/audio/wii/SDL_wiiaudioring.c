@@ -0,0 +1,102 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2006 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#include "SDL_wiiaudioring_c.h"
+
+#define RING_BUFFER(ring, n)	((ring)->mem + (((n) % (ring)->count) * (ring)->period))
+#define RING_SILENCE(ring)		((ring)->mem + ((ring)->count * (ring)->period))
+
+int WII_AudioRingInit(WII_AudioRing *ring, Uint8 *mem, int nbuffers, Uint32 period)
+{
+	if (nbuffers < WII_AUDIO_MIN_BUFFERS)
+		nbuffers = WII_AUDIO_MIN_BUFFERS;
+	if (nbuffers > WII_AUDIO_MAX_BUFFERS)
+		nbuffers = WII_AUDIO_MAX_BUFFERS;
+
+	// One more than asked for, to render into while the DMA holds two
+	ring->mem = mem;
+	ring->count = nbuffers + 1;
+	ring->period = period;
+	ring->rendered = 0;
+	ring->queued = 0;
+	ring->finished = 0;
+	ring->playing = 0;
+	ring->next = 0;
+	ring->played = 0;
+	ring->underruns = 0;
+	ring->late = 0;
+
+	SDL_memset(mem, 0, WII_AUDIO_RING_BYTES(nbuffers, period));
+	return nbuffers;
+}
+
+int WII_AudioRingFill(WII_AudioRing *ring, WII_AudioRender render, void *userdata)
+{
+	int total = 0;
+
+	while ((Uint32) (ring->rendered - ring->finished) < (Uint32) ring->count)
+	{
+		const Uint32 n = ring->rendered;
+		const Uint32 underruns = ring->underruns;
+
+		ring->len[n % ring->count] = render(userdata, RING_BUFFER(ring, n), ring->period);
+
+		// The DMA ran dry while this period was being rendered
+		if (ring->underruns != underruns)
+			++ring->late;
+
+		// The buffer has to be complete before the DMA can see it
+		__sync_synchronize();
+		ring->rendered = n + 1;
+		++total;
+	}
+	return total;
+}
+
+const Uint8 *WII_AudioRingNext(WII_AudioRing *ring, Uint32 *len)
+{
+	const Uint8 *buf;
+
+	// Whatever played before the buffer starting now is done with
+	if (ring->playing)
+		++ring->finished;
+	ring->playing = ring->next;
+	++ring->played;
+
+	if (ring->queued != ring->rendered)
+	{
+		__sync_synchronize();
+		buf = RING_BUFFER(ring, ring->queued);
+		*len = ring->len[ring->queued % ring->count];
+		++ring->queued;
+		ring->next = 1;
+	}
+	else
+	{
+		buf = RING_SILENCE(ring);
+		*len = ring->period;
+		++ring->underruns;
+		ring->next = 0;
+	}
+	return buf;
+}
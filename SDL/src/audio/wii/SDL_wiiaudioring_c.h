@@ -0,0 +1,86 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2006 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_wiiaudioring_c_h
+#define _SDL_wiiaudioring_c_h
+
+/* Ring of DMA buffers between the audio thread, which renders periods
+   ahead of time, and the DMA interrupt, which plays them.
+   The DMA always owns two buffers: the one playing and the one queued to
+   play next. With nbuffers periods in the ring, up to nbuffers - 1 more
+   can be rendered ahead, so a late callback only causes an underrun once
+   everything rendered ahead has played.
+   This file has no libogc dependencies so it can be built and tested on
+   any host.
+*/
+#include "SDL_stdinc.h"
+
+#define WII_AUDIO_MIN_BUFFERS		2
+#define WII_AUDIO_MAX_BUFFERS		8
+#define WII_AUDIO_DEFAULT_BUFFERS	3
+
+/* Memory needed for a ring: the buffers themselves plus the silence the
+   DMA plays when it runs dry */
+#define WII_AUDIO_RING_BYTES(nbuffers, period)	(((nbuffers) + 2) * (period))
+
+/* Fills buf (len bytes) with the next period, returns the bytes to play */
+typedef Uint32 (*WII_AudioRender)(void *userdata, Uint8 *buf, Uint32 len);
+
+typedef struct WII_AudioRing
+{
+	Uint8*			mem;
+	int				count;		/* buffers in the ring */
+	Uint32			period;		/* bytes per buffer */
+	Uint32			len[WII_AUDIO_MAX_BUFFERS + 1];
+
+	/* Running totals; buffer n lives in slot n % count */
+	volatile Uint32	rendered;	/* by the audio thread */
+	volatile Uint32	queued;		/* handed to the DMA */
+	volatile Uint32	finished;	/* done playing, free to render again */
+
+	/* Whether the DMA's current and next buffers come from the ring */
+	int				playing;
+	int				next;
+
+	volatile Uint32	played;		/* periods handed to the DMA, including silence */
+	volatile Uint32	underruns;	/* periods of silence because nothing was ready */
+	volatile Uint32	late;		/* periods that were still rendering when the DMA ran dry */
+} WII_AudioRing;
+
+/* Set up a ring of nbuffers (clamped to 2..8) periods in mem, which must
+   hold WII_AUDIO_RING_BYTES(nbuffers, period) bytes. Returns the number
+   of buffers used.
+*/
+extern int WII_AudioRingInit(WII_AudioRing *ring, Uint8 *mem, int nbuffers, Uint32 period);
+
+/* Audio thread: render into every free buffer. Returns how many were
+   rendered.
+*/
+extern int WII_AudioRingFill(WII_AudioRing *ring, WII_AudioRender render, void *userdata);
+
+/* DMA interrupt: the queued buffer has started playing; return the one to
+   queue after it and its length. Plays silence if nothing is ready.
+*/
+extern const Uint8 *WII_AudioRingNext(WII_AudioRing *ring, Uint32 *len);
+
+#endif /* _SDL_wiiaudioring_c_h */
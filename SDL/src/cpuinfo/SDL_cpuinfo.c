@@ -143,12 +143,22 @@ done:
 	return has_CPUID;
 }
 
+/* CPUID overwrites ebx, which may hold the PIC register. On x86_64 all
+   of rbx has to be kept, or the caller's pointers lose their top half. */
+#if defined(__GNUC__) && defined(__x86_64__)
+#define CPUID_SAVE_EBX		"        movq    %%rbx,%%rdi\n"
+#define CPUID_RESTORE_EBX	"        movq    %%rdi,%%rbx\n"
+#else
+#define CPUID_SAVE_EBX		"        movl    %%ebx,%%edi\n"
+#define CPUID_RESTORE_EBX	"        movl    %%edi,%%ebx\n"
+#endif
+
 static __inline__ int CPU_getCPUIDFeatures(void)
 {
 	int features = 0;
 #if defined(__GNUC__) && ( defined(i386) || defined(__x86_64__) )
 	__asm__ (
-"        movl    %%ebx,%%edi\n"
+CPUID_SAVE_EBX
 "        xorl    %%eax,%%eax         # Set up for CPUID instruction    \n"
 "        cpuid                       # Get and save vendor ID          \n"
 "        cmpl    $1,%%eax            # Make sure 1 is valid input for CPUID\n"
@@ -158,7 +168,7 @@ static __inline__ int CPU_getCPUIDFeatures(void)
 "        cpuid                       # Get family/model/stepping/features\n"
 "        movl    %%edx,%0                                              \n"
 "1:                                                                    \n"
-"        movl    %%edi,%%ebx\n"
+CPUID_RESTORE_EBX
 	: "=m" (features)
 	:
 	: "%eax", "%ecx", "%edx", "%edi"
@@ -201,7 +211,7 @@ static __inline__ int CPU_getCPUIDFeaturesExt(void)
 	int features = 0;
 #if defined(__GNUC__) && (defined(i386) || defined (__x86_64__) )
 	__asm__ (
-"        movl    %%ebx,%%edi\n"
+CPUID_SAVE_EBX
 "        movl    $0x80000000,%%eax   # Query for extended functions    \n"
 "        cpuid                       # Get extended function limit     \n"
 "        cmpl    $0x80000001,%%eax                                     \n"
@@ -210,7 +220,7 @@ static __inline__ int CPU_getCPUIDFeaturesExt(void)
 "        cpuid                       # and get the information         \n"
 "        movl    %%edx,%0                                              \n"
 "1:                                                                    \n"
-"        movl    %%edi,%%ebx\n"
+CPUID_RESTORE_EBX
 	: "=m" (features)
 	:
 	: "%eax", "%ecx", "%edx", "%edi"
@@ -39,6 +39,11 @@
 #include "mmx.h"
 #endif
 
+static void SDL_TiledBlit(SDL_Surface *src, SDL_Rect *srcrect,
+			SDL_Surface *dst, SDL_Rect *dstrect,
+			SDL_BlitInfo *info, SDL_loblit RunBlit,
+			SDL_tiledblit RunTiledBlit);
+
 /* The general purpose software blit routine */
 static int SDL_SoftBlit(SDL_Surface *src, SDL_Rect *srcrect,
 			SDL_Surface *dst, SDL_Rect *dstrect)
@@ -94,7 +99,12 @@ static int SDL_SoftBlit(SDL_Surface *src, SDL_Rect *srcrect,
 		RunBlit = src->map->sw_data->blit;
 
 		/* Run the actual software blit */
-		RunBlit(&info);
+		if ( (src->flags | dst->flags) & SDL_TILEDSURFACE ) {
+			SDL_TiledBlit(src, srcrect, dst, dstrect, &info, RunBlit,
+				      src->map->sw_data->tiled_blit);
+		} else {
+			RunBlit(&info);
+		}
 	}
 
 	/* We need to unlock the surfaces if they're locked */
@@ -229,6 +239,125 @@ static void SDL_BlitCopyOverlap(SDL_BlitInfo *info)
 	}
 }
 
+/* Copy w pixels starting at x,y between a tiled surface and a linear row */
+void SDL_LoadTiledRow(SDL_Surface *surface, int x, int y, int w, Uint8 *row)
+{
+	Uint8 *line = (Uint8 *)surface->pixels + SDL_TILED_OFFSET(surface->pitch, 0, y);
+
+	while ( w > 0 ) {
+		int n = 4 - (x & 3);
+		if ( n > w ) {
+			n = w;
+		}
+		SDL_memcpy(row, line + SDL_TILED_OFFSET(0, x, 0), n << 1);
+		row += n << 1;
+		x += n;
+		w -= n;
+	}
+}
+
+void SDL_StoreTiledRow(SDL_Surface *surface, int x, int y, int w, const Uint8 *row)
+{
+	Uint8 *line = (Uint8 *)surface->pixels + SDL_TILED_OFFSET(surface->pitch, 0, y);
+
+	while ( w > 0 ) {
+		int n = 4 - (x & 3);
+		if ( n > w ) {
+			n = w;
+		}
+		SDL_memcpy(line + SDL_TILED_OFFSET(0, x, 0), row, n << 1);
+		row += n << 1;
+		x += n;
+		w -= n;
+	}
+}
+
+void SDL_FillTiledRect(SDL_Surface *surface, SDL_Rect *rect, Uint32 color)
+{
+	Uint16 *row;
+	int x, y;
+
+	row = SDL_stack_alloc(Uint16, rect->w);
+	for ( x = 0; x < rect->w; ++x ) {
+		row[x] = (Uint16)color;
+	}
+	for ( y = rect->y; y < rect->y + rect->h; ++y ) {
+		SDL_StoreTiledRow(surface, rect->x, y, rect->w, (Uint8 *)row);
+	}
+	SDL_stack_free(row);
+}
+
+/*
+ * Blits from 8 and 16-bit linear surfaces that have a tiled blitter
+ * write straight into the destination tiles.  Anything else is blitted
+ * a row at a time: tiled rows are gathered into linear scratch rows,
+ * blitted with the regular blitter, and scattered back.  Plain copies go
+ * straight from the source row into the destination tiles.
+ */
+static void SDL_TiledBlit(SDL_Surface *src, SDL_Rect *srcrect,
+			SDL_Surface *dst, SDL_Rect *dstrect,
+			SDL_BlitInfo *info, SDL_loblit RunBlit,
+			SDL_tiledblit RunTiledBlit)
+{
+	SDL_BlitInfo row;
+	Uint8 *srow = NULL;
+	Uint8 *drow = NULL;
+	int copy;
+	int i, y, step;
+
+	if ( RunTiledBlit ) {
+		RunTiledBlit(info, dst, dstrect);
+		return;
+	}
+
+	copy = (RunBlit == SDL_BlitCopy || RunBlit == SDL_BlitCopyOverlap);
+	if ( src->flags & SDL_TILEDSURFACE ) {
+		srow = SDL_stack_alloc(Uint8, srcrect->w*src->format->BytesPerPixel);
+	}
+	if ( (dst->flags & SDL_TILEDSURFACE) && !copy ) {
+		drow = SDL_stack_alloc(Uint8, dstrect->w*dst->format->BytesPerPixel);
+	}
+
+	/* Work from the bottom up when scrolling a surface down */
+	y = 0;
+	step = 1;
+	if ( (src == dst) && (dstrect->y > srcrect->y) ) {
+		y = srcrect->h - 1;
+		step = -1;
+	}
+
+	row = *info;
+	row.s_height = 1;
+	row.d_height = 1;
+	for ( i = srcrect->h; i; --i, y += step ) {
+		if ( srow ) {
+			SDL_LoadTiledRow(src, srcrect->x, srcrect->y+y, srcrect->w, srow);
+			row.s_pixels = srow;
+		} else {
+			row.s_pixels = info->s_pixels + y*src->pitch;
+		}
+
+		if ( !(dst->flags & SDL_TILEDSURFACE) ) {
+			row.d_pixels = info->d_pixels + y*dst->pitch;
+			RunBlit(&row);
+		} else if ( copy ) {
+			SDL_StoreTiledRow(dst, dstrect->x, dstrect->y+y, dstrect->w, row.s_pixels);
+		} else {
+			SDL_LoadTiledRow(dst, dstrect->x, dstrect->y+y, dstrect->w, drow);
+			row.d_pixels = drow;
+			RunBlit(&row);
+			SDL_StoreTiledRow(dst, dstrect->x, dstrect->y+y, dstrect->w, drow);
+		}
+	}
+
+	if ( srow ) {
+		SDL_stack_free(srow);
+	}
+	if ( drow ) {
+		SDL_stack_free(drow);
+	}
+}
+
 /* Figure out which of many blit routines to set up on a surface */
 int SDL_CalculateBlit(SDL_Surface *surface)
 {
@@ -337,9 +466,24 @@ int SDL_CalculateBlit(SDL_Surface *surface)
 		return(-1);
 	}
 
+	/* Some blits from linear surfaces can write tiles directly */
+	surface->map->sw_data->tiled_blit = NULL;
+	if ( (surface->map->dst->flags & SDL_TILEDSURFACE)
+	     && !(surface->flags & SDL_TILEDSURFACE) ) {
+		if ( surface->format->BitsPerPixel == 8 ) {
+			surface->map->sw_data->tiled_blit =
+			    SDL_CalculateTiledBlit1(surface, blit_index);
+		} else if ( surface->format->BytesPerPixel == 2 ) {
+			surface->map->sw_data->tiled_blit =
+			    SDL_CalculateTiledBlitN(surface, blit_index);
+		}
+	}
+
 	/* Choose software blitting function */
+	/* (the RLE blitters write straight to linear pixels) */
 	if(surface->flags & SDL_RLEACCELOK
-	   && (surface->flags & SDL_HWACCEL) != SDL_HWACCEL) {
+	   && (surface->flags & SDL_HWACCEL) != SDL_HWACCEL
+	   && !((surface->flags | surface->map->dst->flags) & SDL_TILEDSURFACE)) {
 
 	        if(surface->map->identity
 		   && (blit_index == 1
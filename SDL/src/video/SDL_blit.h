@@ -45,10 +45,17 @@ typedef struct {
 /* The type definition for the low level blit functions */
 typedef void (*SDL_loblit)(SDL_BlitInfo *info);
 
+/* Blit functions that write straight into a tiled destination.  The
+   tiles can't be walked with d_pixels and d_skip, so they get the
+   destination surface and rectangle instead. */
+typedef void (*SDL_tiledblit)(SDL_BlitInfo *info,
+			SDL_Surface *dst, SDL_Rect *dstrect);
+
 /* This is the private info structure for software accelerated blits */
 struct private_swaccel {
 	SDL_loblit blit;
 	void *aux_data;
+	SDL_tiledblit tiled_blit;	/* NULL unless blitting to tiles */
 };
 
 /* Blit mapping definition */
@@ -69,12 +76,54 @@ typedef struct SDL_BlitMap {
 
 /* Functions found in SDL_blit.c */
 extern int SDL_CalculateBlit(SDL_Surface *surface);
+extern void SDL_LoadTiledRow(SDL_Surface *surface, int x, int y, int w, Uint8 *row);
+extern void SDL_StoreTiledRow(SDL_Surface *surface, int x, int y, int w, const Uint8 *row);
+extern void SDL_FillTiledRect(SDL_Surface *surface, SDL_Rect *rect, Uint32 color);
 
 /* Functions found in SDL_blit_{0,1,N,A}.c */
 extern SDL_loblit SDL_CalculateBlit0(SDL_Surface *surface, int complex);
 extern SDL_loblit SDL_CalculateBlit1(SDL_Surface *surface, int complex);
 extern SDL_loblit SDL_CalculateBlitN(SDL_Surface *surface, int complex);
 extern SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int complex);
+extern SDL_tiledblit SDL_CalculateTiledBlit1(SDL_Surface *surface, int complex);
+extern SDL_tiledblit SDL_CalculateTiledBlitN(SDL_Surface *surface, int complex);
+
+/*
+ * Surfaces with SDL_TILEDSURFACE keep 16-bit pixels in 4x4 tiles of 32
+ * bytes, the same layout as a GX RGB565 texture.  The tiles are stored
+ * row after row; pitch is still the size of one row of pixels, so a row
+ * of tiles takes up four pitches.
+ */
+#define SDL_TILED_OFFSET(pitch, x, y)					\
+	((((y) >> 2) * ((pitch) << 2)) + (((x) >> 2) << 5) +		\
+	 (((y) & 3) << 3) + (((x) & 3) << 1))
+
+/*
+ * Run pixel_copy_increment for width pixels of row y of a tiled surface,
+ * starting at x.  dstp (a Uint16 *) starts at the first pixel and
+ * pixel_copy_increment advances it; at the end of each tile it skips
+ * the other three rows of the tile to the same row of the next one.
+ */
+#define TILED_ROW_LOOP(pixel_copy_increment, dstp, surface, x, y, width) \
+{ int tiled_w = (width);						\
+  int tiled_n = 4 - ((x) & 3);						\
+	dstp = (Uint16 *)((Uint8 *)(surface)->pixels +			\
+			  SDL_TILED_OFFSET((surface)->pitch, (x), (y)));	\
+	while ( tiled_w > 0 ) {						\
+		if ( tiled_n > tiled_w ) {				\
+			tiled_n = tiled_w;				\
+		}							\
+		tiled_w -= tiled_n;					\
+		switch (tiled_n) {					\
+		case 4:	pixel_copy_increment;				\
+		case 3:	pixel_copy_increment;				\
+		case 2:	pixel_copy_increment;				\
+		case 1:	pixel_copy_increment;				\
+		}							\
+		dstp += 12;						\
+		tiled_n = 4;						\
+	}								\
+}
 
 /*
  * Useful macros for blitting routines
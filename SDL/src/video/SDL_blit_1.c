@@ -344,6 +344,54 @@ static void Blit1to2Key(SDL_BlitInfo *info)
 	}
 }
 
+/* Blit1to2 and Blit1to2Key into a tiled destination */
+static void Blit1to2Tiled(SDL_BlitInfo *info,
+			SDL_Surface *dst, SDL_Rect *dstrect)
+{
+	int width = info->d_width;
+	int height = info->d_height;
+	Uint8 *src = info->s_pixels;
+	int srcskip = info->s_skip;
+	Uint16 *dstp;
+	Uint16 *map = (Uint16 *)info->table;
+	int y;
+
+	for ( y = dstrect->y; y < dstrect->y + height; ++y ) {
+		TILED_ROW_LOOP(
+		{
+			*dstp++ = map[*src++];
+		},
+		dstp, dst, dstrect->x, y, width);
+		src += srcskip;
+	}
+}
+
+static void Blit1to2KeyTiled(SDL_BlitInfo *info,
+			SDL_Surface *dst, SDL_Rect *dstrect)
+{
+	int width = info->d_width;
+	int height = info->d_height;
+	Uint8 *src = info->s_pixels;
+	int srcskip = info->s_skip;
+	Uint16 *dstp;
+	Uint16 *palmap = (Uint16 *)info->table;
+	Uint32 ckey = info->src->colorkey;
+	int y;
+
+	for ( y = dstrect->y; y < dstrect->y + height; ++y ) {
+		TILED_ROW_LOOP(
+		{
+			if ( *src != ckey ) {
+				*dstp=palmap[*src];
+			}
+			src++;
+			dstp++;
+		},
+		dstp, dst, dstrect->x, y, width);
+		src += srcskip;
+	}
+}
+
 static void Blit1to3Key(SDL_BlitInfo *info)
 {
 	int width = info->d_width;
@@ -521,3 +569,16 @@ SDL_loblit SDL_CalculateBlit1(SDL_Surface *surface, int blit_index)
 	}
 	return NULL;
 }
+
+SDL_tiledblit SDL_CalculateTiledBlit1(SDL_Surface *surface, int blit_index)
+{
+	/* Tiled surfaces are always 16-bit */
+	switch(blit_index) {
+	case 0:			/* copy */
+	    return Blit1to2Tiled;
+
+	case 1:			/* colorkey */
+	    return Blit1to2KeyTiled;
+	}
+	return NULL;
+}
@@ -2186,6 +2186,37 @@ static void Blit2to2Key(SDL_BlitInfo *info)
 	}
 }
 
+/* Blit2to2Key into a tiled destination */
+static void Blit2to2KeyTiled(SDL_BlitInfo *info,
+			SDL_Surface *dst, SDL_Rect *dstrect)
+{
+	int width = info->d_width;
+	int height = info->d_height;
+	Uint16 *srcp = (Uint16 *)info->s_pixels;
+	int srcskip = info->s_skip;
+	Uint16 *dstp;
+	Uint32 ckey = info->src->colorkey;
+	Uint32 rgbmask = ~info->src->Amask;
+	int y;
+
+	/* Set up some basic variables */
+        srcskip /= 2;
+	ckey &= rgbmask;
+
+	for ( y = dstrect->y; y < dstrect->y + height; ++y ) {
+		TILED_ROW_LOOP(
+		{
+			if ( (*srcp & rgbmask) != ckey ) {
+				*dstp = *srcp;
+			}
+			dstp++;
+			srcp++;
+		},
+		dstp, dst, dstrect->x, y, width);
+		srcp += srcskip;
+	}
+}
+
 static void BlitNtoNKey(SDL_BlitInfo *info)
 {
 	int width = info->d_width;
@@ -2488,3 +2519,14 @@ SDL_loblit SDL_CalculateBlitN(SDL_Surface *surface, int blit_index)
 
 	return(blitfun);
 }
+
+SDL_tiledblit SDL_CalculateTiledBlitN(SDL_Surface *surface, int blit_index)
+{
+	/* Colorkeyed sprites are what gets drawn most; everything else goes
+	   through a linear scratch row */
+	if ( blit_index == 1 && surface->format->BytesPerPixel == 2
+	     && surface->map->identity ) {
+		return Blit2to2KeyTiled;
+	}
+	return NULL;
+}
@@ -602,6 +602,11 @@ void SDL_DrawCursorNoLock(SDL_Surface *screen)
 		return;
 	}
 
+	/* The software cursor only knows about linear surfaces */
+	if ( screen->flags & SDL_TILEDSURFACE ) {
+		return;
+	}
+
 	/* Copy mouse background */
 	{ int w, h, screenbpp;
 	  Uint8 *src, *dst;
@@ -680,6 +685,11 @@ void SDL_EraseCursorNoLock(SDL_Surface *screen)
 		return;
 	}
 
+	/* The software cursor only knows about linear surfaces */
+	if ( screen->flags & SDL_TILEDSURFACE ) {
+		return;
+	}
+
 	/* Copy mouse background */
 	{ int w, h, screenbpp;
 	  Uint8 *src, *dst;
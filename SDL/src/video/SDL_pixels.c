@@ -24,12 +24,104 @@
 /* General (mostly internal) pixel/color manipulation routines for SDL */
 
 #include "SDL_endian.h"
+#include "SDL_mutex.h"
 #include "SDL_video.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_pixels_c.h"
 #include "SDL_RLEaccel_c.h"
 
+/*
+ * Palettes made by SDL_AllocFormat are one block: the SDL_Palette, the data
+ * below, then the colors.  The data is an inverse colormap that SDL_FindColor
+ * fills in as it goes.  RGB space is cut into 16x16x16 cells, and the first
+ * lookup in a cell lists the palette entries that can be nearest to some
+ * color inside it -- those no further from the cell than the closest worst
+ * case of any entry.  Later lookups there only measure those few, in palette
+ * order, so the answer is the same as a search of the whole palette.
+ *
+ * The cells go stale when the colors change: SDL_SetPalette invalidates them,
+ * and anyone writing to palette->colors of a surface that has already been
+ * mapped must call SDL_SetColors afterwards, as for blits.
+ *
+ * Several threads may map colors with the same palette at once.  Cells are
+ * listed under invpal_lock, into blocks that never move, and a cell is only
+ * set once its list is in place, so a lookup in a listed cell takes no lock.
+ */
+#define INVPAL_MAGIC	0x53444C50	/* 'SDLP' */
+#define INVPAL_BITS	4		/* cells per channel is 1<<INVPAL_BITS */
+#define INVPAL_SHIFT	(8-INVPAL_BITS)
+#define INVPAL_CELLS	(1<<(3*INVPAL_BITS))
+#define INVPAL_WARMUP	256		/* full searches before building cells */
+#define INVPAL_MAXCAND	32		/* more candidates and we search it all */
+#define INVPAL_FULL	0xFFFFFFFF
+#define INVPAL_CHUNK	4096		/* bytes of candidate lists in a block */
+#define INVPAL_CHUNKS	(INVPAL_CELLS*INVPAL_MAXCAND/INVPAL_CHUNK + 1)
+
+typedef struct SDL_PaletteData {
+	SDL_Palette palette;
+	SDL_Palette *self;
+	Uint32 magic;
+	int ncolors;		/* palette size the cells were listed for */
+	int searches;		/* full searches since the last invalidation */
+	Uint32 *cells;		/* offset<<9 | count into chunks, 0 if unseen */
+	Uint8 *chunks[INVPAL_CHUNKS];	/* the candidate lists, kept till freed */
+	int ncandidates;	/* offset of the next list */
+} SDL_PaletteData;
+
+/* Guards listing the cells of every palette, and is made by whichever thread
+   needs it first */
+static SDL_mutex *invpal_lock;
+
+/* What is read without the lock is written with these, so a reader that
+   sees a cell or pointer also sees what it leads to */
+#if defined(__GNUC__) && defined(__ATOMIC_ACQUIRE)
+#define INVPAL_CAS(p, old, new)	__sync_bool_compare_and_swap(p, old, new)
+#define INVPAL_GET(p)		__atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define INVPAL_SET(p, v)	__atomic_store_n(p, v, __ATOMIC_RELEASE)
+#elif defined(__GNUC__)
+#define INVPAL_CAS(p, old, new)	__sync_bool_compare_and_swap(p, old, new)
+#define INVPAL_GET(p)		(*(p))
+#define INVPAL_SET(p, v)	(__sync_synchronize(), *(p) = (v))
+#else
+#define INVPAL_CAS(p, old, new)	((*(p) == (old)) ? (*(p) = (new), 1) : 0)
+#define INVPAL_GET(p)		(*(p))
+#define INVPAL_SET(p, v)	(*(p) = (v))
+#endif
+
+static int SDL_LockInvPal(void)
+{
+	SDL_mutex *lock;
+
+	if ( INVPAL_GET(&invpal_lock) == NULL ) {
+		lock = SDL_CreateMutex();
+		if ( lock == NULL ) {
+			return(-1);
+		}
+		if ( !INVPAL_CAS(&invpal_lock, NULL, lock) ) {
+			SDL_DestroyMutex(lock);
+		}
+	}
+	return(SDL_mutexP(invpal_lock));
+}
+
+static void SDL_UnlockInvPal(void)
+{
+	SDL_mutexV(invpal_lock);
+}
+
+/* Find the private data of a palette, if SDL_AllocFormat made it */
+static SDL_PaletteData *SDL_GetPaletteData(SDL_Palette *pal)
+{
+	SDL_PaletteData *data = (SDL_PaletteData *)pal;
+
+	if ( (pal->colors != (SDL_Color *)(data+1)) ||
+	     (data->magic != INVPAL_MAGIC) || (data->self != pal) ) {
+		return(NULL);
+	}
+	return(data);
+}
+
 /* Helper functions */
 /*
  * Allocate a pixel format structure and fill it according to the given info.
@@ -120,23 +212,24 @@ SDL_PixelFormat *SDL_AllocFormat(int bpp,
 	}
 	if ( bpp <= 8 ) {			/* Palettized mode */
 		int ncolors = 1<<bpp;
+		SDL_PaletteData *data;
 #ifdef DEBUG_PALETTE
 		fprintf(stderr,"bpp=%d ncolors=%d\n",bpp,ncolors);
 #endif
-		format->palette = (SDL_Palette *)SDL_malloc(sizeof(SDL_Palette));
-		if ( format->palette == NULL ) {
+		data = (SDL_PaletteData *)SDL_malloc(sizeof(*data) +
+					ncolors*sizeof(SDL_Color));
+		if ( data == NULL ) {
 			SDL_FreeFormat(format);
 			SDL_OutOfMemory();
 			return(NULL);
 		}
+		SDL_memset(data, 0, sizeof(*data));
+		data->self = &data->palette;
+		data->magic = INVPAL_MAGIC;
+		data->ncolors = ncolors;
+		format->palette = &data->palette;
 		(format->palette)->ncolors = ncolors;
-		(format->palette)->colors = (SDL_Color *)SDL_malloc(
-				(format->palette)->ncolors*sizeof(SDL_Color));
-		if ( (format->palette)->colors == NULL ) {
-			SDL_FreeFormat(format);
-			SDL_OutOfMemory();
-			return(NULL);
-		}
+		(format->palette)->colors = (SDL_Color *)(data+1);
 		if ( Rmask || Bmask || Gmask ) {
 			/* create palette according to masks */
 			int i;
@@ -252,7 +345,21 @@ void SDL_FreeFormat(SDL_PixelFormat *format)
 {
 	if ( format ) {
 		if ( format->palette ) {
-			if ( format->palette->colors ) {
+			SDL_PaletteData *data;
+
+			data = SDL_GetPaletteData(format->palette);
+			if ( data ) {
+				int i;
+
+				if ( data->cells ) {
+					SDL_free(data->cells);
+				}
+				for ( i=0; i<INVPAL_CHUNKS; ++i ) {
+					if ( data->chunks[i] ) {
+						SDL_free(data->chunks[i]);
+					}
+				}
+			} else if ( format->palette->colors ) {
 				SDL_free(format->palette->colors);
 			}
 			SDL_free(format->palette);
@@ -307,6 +414,152 @@ Uint16 SDL_CalculatePitch(SDL_Surface *surface)
 	pitch = (pitch + 3) & ~3;	/* 4-byte aligning */
 	return(pitch);
 }
+/*
+ * Forget the inverse colormap of a palette whose colors have changed
+ */
+void SDL_InvalidatePalette(SDL_Palette *pal)
+{
+	SDL_PaletteData *data;
+
+	if ( pal == NULL ) {
+		return;
+	}
+	data = SDL_GetPaletteData(pal);
+	if ( data ) {
+		data->ncolors = pal->ncolors;
+		data->searches = 0;
+		if ( INVPAL_GET(&data->cells) && (SDL_LockInvPal() == 0) ) {
+			data->ncandidates = 0;
+			SDL_memset(data->cells, 0,
+				INVPAL_CELLS*sizeof(*data->cells));
+			SDL_UnlockInvPal();
+		}
+	}
+}
+
+/*
+ * List the palette entries that can be nearest to some color in a cell.
+ * Called with invpal_lock held.
+ */
+static Uint32 SDL_FindCandidates(SDL_PaletteData *data, int cell)
+{
+	const SDL_Color *colors = data->palette.colors;
+	int ncolors = data->palette.ncolors;
+	unsigned int nearest[256];
+	unsigned int farthest;
+	unsigned int nd, fd;
+	int lo[3], v[3], d;
+	int i, j, c;
+	int n, chunk, offset;
+	Uint8 list[INVPAL_MAXCAND];
+
+	lo[0] = ((cell >> (2*INVPAL_BITS)) & ((1<<INVPAL_BITS)-1)) << INVPAL_SHIFT;
+	lo[1] = ((cell >> INVPAL_BITS) & ((1<<INVPAL_BITS)-1)) << INVPAL_SHIFT;
+	lo[2] = (cell & ((1<<INVPAL_BITS)-1)) << INVPAL_SHIFT;
+
+	/* Every color in the cell is at most 'farthest' from some entry */
+	farthest = ~0;
+	for ( i=0; i<ncolors; ++i ) {
+		v[0] = colors[i].r;
+		v[1] = colors[i].g;
+		v[2] = colors[i].b;
+		nd = 0;
+		fd = 0;
+		for ( c=0; c<3; ++c ) {
+			d = v[c] - lo[c];
+			if ( d < 0 ) {
+				nd += d*d;
+				fd += (d-(1<<INVPAL_SHIFT)+1)*(d-(1<<INVPAL_SHIFT)+1);
+			} else if ( d >= (1<<INVPAL_SHIFT) ) {
+				nd += (d-(1<<INVPAL_SHIFT)+1)*(d-(1<<INVPAL_SHIFT)+1);
+				fd += d*d;
+			} else if ( 2*d < (1<<INVPAL_SHIFT) ) {
+				fd += (d-(1<<INVPAL_SHIFT)+1)*(d-(1<<INVPAL_SHIFT)+1);
+			} else {
+				fd += d*d;
+			}
+		}
+		nearest[i] = nd;
+		if ( fd < farthest ) {
+			farthest = fd;
+		}
+	}
+
+	/* Keep those that can beat it, but only the first of equal colors */
+	n = 0;
+	for ( i=0; i<ncolors; ++i ) {
+		if ( nearest[i] > farthest ) {
+			continue;
+		}
+		for ( j=0; j<n; ++j ) {
+			if ( (colors[list[j]].r == colors[i].r) &&
+			     (colors[list[j]].g == colors[i].g) &&
+			     (colors[list[j]].b == colors[i].b) ) {
+				break;
+			}
+		}
+		if ( j < n ) {
+			continue;
+		}
+		if ( n == INVPAL_MAXCAND ) {
+			return(INVPAL_FULL);
+		}
+		list[n++] = i;
+	}
+
+	/* Lookups read lists without the lock, so a list never moves and
+	   never straddles two blocks */
+	offset = data->ncandidates;
+	if ( (offset % INVPAL_CHUNK) + n > INVPAL_CHUNK ) {
+		offset += INVPAL_CHUNK - (offset % INVPAL_CHUNK);
+	}
+	chunk = offset / INVPAL_CHUNK;
+	if ( chunk >= INVPAL_CHUNKS ) {
+		return(INVPAL_FULL);
+	}
+	if ( data->chunks[chunk] == NULL ) {
+		data->chunks[chunk] = (Uint8 *)SDL_malloc(INVPAL_CHUNK);
+		if ( data->chunks[chunk] == NULL ) {
+			return(INVPAL_FULL);
+		}
+	}
+	SDL_memcpy(data->chunks[chunk] + (offset % INVPAL_CHUNK), list, n);
+	data->ncandidates = offset + n;
+	return(((Uint32)offset << 9) | n);
+}
+
+/*
+ * Find the candidate list of a cell, listing it first if it is new
+ */
+static Uint32 SDL_FindCell(SDL_PaletteData *data, int cell)
+{
+	Uint32 *cells;
+	Uint32 found;
+
+	cells = INVPAL_GET(&data->cells);
+	if ( cells && (found = INVPAL_GET(&cells[cell])) != 0 ) {
+		return(found);
+	}
+	if ( SDL_LockInvPal() < 0 ) {
+		return(INVPAL_FULL);
+	}
+	cells = data->cells;
+	if ( cells == NULL ) {
+		cells = (Uint32 *)SDL_calloc(INVPAL_CELLS, sizeof(Uint32));
+		INVPAL_SET(&data->cells, cells);
+	}
+	found = INVPAL_FULL;
+	if ( cells ) {
+		found = cells[cell];
+		if ( found == 0 ) {
+			found = SDL_FindCandidates(data, cell);
+			INVPAL_SET(&cells[cell], found);
+		}
+	}
+	SDL_UnlockInvPal();
+	return(found);
+}
+
 /*
  * Match an RGB value to a particular palette index
  */
@@ -318,7 +571,49 @@ Uint8 SDL_FindColor(SDL_Palette *pal, Uint8 r, Uint8 g, Uint8 b)
 	int rd, gd, bd;
 	int i;
 	Uint8 pixel=0;
-		
+	SDL_PaletteData *data;
+
+	data = SDL_GetPaletteData(pal);
+	if ( data && (pal->ncolors <= 256) ) {
+		if ( data->ncolors != pal->ncolors ) {
+			SDL_InvalidatePalette(pal);
+		}
+		/* The count is only a hint, so threads may lose updates */
+		i = INVPAL_GET(&data->searches);
+		if ( i < INVPAL_WARMUP ) {
+			INVPAL_SET(&data->searches, i+1);
+		} else {
+			Uint32 cell;
+			const Uint8 *list;
+			int n;
+
+			cell = SDL_FindCell(data,
+				((r >> INVPAL_SHIFT) << (2*INVPAL_BITS)) |
+				((g >> INVPAL_SHIFT) << INVPAL_BITS) |
+				(b >> INVPAL_SHIFT));
+			if ( cell != INVPAL_FULL ) {
+				list = data->chunks[(cell >> 9) / INVPAL_CHUNK] +
+				       ((cell >> 9) % INVPAL_CHUNK);
+				n = cell & 0x1FF;
+				smallest = ~0;
+				for ( i=0; i<n; ++i ) {
+					rd = pal->colors[list[i]].r - r;
+					gd = pal->colors[list[i]].g - g;
+					bd = pal->colors[list[i]].b - b;
+					distance = (rd*rd)+(gd*gd)+(bd*bd);
+					if ( distance < smallest ) {
+						pixel = list[i];
+						if ( distance == 0 ) {
+							break;
+						}
+						smallest = distance;
+					}
+				}
+				return(pixel);
+			}
+		}
+	}
+
 	smallest = ~0;
 	for ( i=0; i<pal->ncolors; ++i ) {
 		rd = pal->colors[i].r - r;
@@ -600,6 +600,11 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
 	if ( SDL_LockSurface(dst) != 0 ) {
 		return(-1);
 	}
+	if ( dst->flags & SDL_TILEDSURFACE ) {
+		SDL_FillTiledRect(dst, dstrect, color);
+		SDL_UnlockSurface(dst);
+		return(0);
+	}
 	row = (Uint8 *)dst->pixels+dstrect->y*dst->pitch+
 			dstrect->x*dst->format->BytesPerPixel;
 	if ( dst->format->palette || (color == 0) ) {
@@ -705,6 +705,7 @@ SDL_Surface * SDL_SetVideoMode (int width, int height, int bpp, Uint32 flags)
 		if ( mode->format->palette ) {
 			SDL_PixelFormat *vf = mode->format;
 			SDL_DitherColors(vf->palette->colors, vf->BitsPerPixel);
+			SDL_InvalidatePalette(vf->palette);
 			video->SetColors(this, 0, vf->palette->ncolors,
 			                           vf->palette->colors);
 		}
@@ -1158,8 +1159,10 @@ static void SetPalette_logical(SDL_Surface *screen, SDL_Color *colors,
 			 */
 			SDL_memcpy(vidpal->colors + firstcolor, colors,
 			       ncolors * sizeof(*colors));
+			SDL_InvalidatePalette(vidpal);
 		}
 	}
+	SDL_InvalidatePalette(pal);
 	SDL_FormatChanged(screen);
 }
 
@@ -1228,7 +1231,7 @@ static int SetPalette_physical(SDL_Surface *screen,
 			   the video driver is responsible for copying back the
 			   correct colors into the video surface palette.
 			*/
-			;
+			SDL_InvalidatePalette(screen->format->palette);
 		}
 		SDL_CursorPaletteChanged();
 	}
@@ -161,11 +161,23 @@ SDL_Rect **DUMMY_ListModes(_THIS, SDL_PixelFormat *format, Uint32 flags)
 SDL_Surface *DUMMY_SetVideoMode(_THIS, SDL_Surface *current,
 				int width, int height, int bpp, Uint32 flags)
 {
+	int pitch, rows;
+
 	if ( this->hidden->buffer ) {
 		SDL_free( this->hidden->buffer );
 	}
 
-	this->hidden->buffer = SDL_malloc(width * height * (bpp / 8));
+	/* Tiled 16-bit framebuffers are padded out to whole 4x4 tiles */
+	if ( (flags & SDL_TILEDSURFACE) && (bpp == 16) ) {
+		pitch = ((width + 3) & ~3) * 2;
+		rows = (height + 3) & ~3;
+	} else {
+		flags &= ~SDL_TILEDSURFACE;
+		pitch = width * (bpp / 8);
+		rows = height;
+	}
+
+	this->hidden->buffer = SDL_malloc(pitch * rows);
 	if ( ! this->hidden->buffer ) {
 		SDL_SetError("Couldn't allocate buffer for requested mode");
 		return(NULL);
@@ -173,7 +185,7 @@ SDL_Surface *DUMMY_SetVideoMode(_THIS, SDL_Surface *current,
 
 /* 	printf("Setting mode %dx%d\n", width, height); */
 
-	SDL_memset(this->hidden->buffer, 0, width * height * (bpp / 8));
+	SDL_memset(this->hidden->buffer, 0, pitch * rows);
 
 	/* Allocate the new pixel format for the screen */
 	if ( ! SDL_ReallocFormat(current, bpp, 0, 0, 0, 0) ) {
@@ -184,10 +196,10 @@ SDL_Surface *DUMMY_SetVideoMode(_THIS, SDL_Surface *current,
 	}
 
 	/* Set up the new mode framebuffer */
-	current->flags = flags & SDL_FULLSCREEN;
+	current->flags = flags & (SDL_FULLSCREEN | SDL_TILEDSURFACE);
 	this->hidden->w = current->w = width;
 	this->hidden->h = current->h = height;
-	current->pitch = current->w * (bpp / 8);
+	current->pitch = pitch;
 	current->pixels = this->hidden->buffer;
 
 	/* We're done */
@@ -0,0 +1,95 @@
+/*
+	SDL - Simple DirectMedia Layer
+	Copyright (C) 1997-2006 Sam Lantinga
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 2.1 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+	Tantric, 2009
+*/
+#include "SDL_config.h"
+
+#include "SDL_error.h"
+#include "SDL_wiitiles_c.h"
+#include "SDL_wiimodes_c.h"
+
+int WII_SelectMode(WII_Mode *mode, int width, int height, int bpp)
+{
+	if (width <= 0 || height <= 0 || width > WII_MAX_WIDTH || height > WII_MAX_HEIGHT)
+	{
+		SDL_SetError("Display mode (%dx%d) is unsupported (up to %dx%d only).",
+			width, height, WII_MAX_WIDTH, WII_MAX_HEIGHT);
+		return -1;
+	}
+
+	if (bpp != 8 && bpp != 16 && bpp != 24 && bpp != 32)
+	{
+		SDL_SetError("Resolution (%d bpp) is unsupported (8/16/24/32 bpp only).",
+			bpp);
+		return -1;
+	}
+
+	mode->width = width;
+	mode->height = height;
+	mode->bpp = bpp;
+
+	// GX textures are made of whole tiles
+	mode->tex_width = (width + WII_TILE_DIM - 1) & ~(WII_TILE_DIM - 1);
+	mode->tex_height = (height + WII_TILE_DIM - 1) & ~(WII_TILE_DIM - 1);
+
+	// 8 and 16 bpp modes are shown as RGB565, the others as RGBA8
+	mode->tex_bytes = mode->tex_width * mode->tex_height * ((bpp <= 16) ? 2 : 4);
+	return 0;
+}
+
+void WII_ScaleSquare(const WII_Mode *mode, int scaling,
+                     int screen_w, int screen_h, int half_w, int half_h,
+                     int *xscale, int *yscale)
+{
+	const Sint64 w = mode->width;
+	const Sint64 h = mode->height;
+
+	if (scaling == WII_SCALE_INTEGER)
+	{
+		const int factor = SDL_min(screen_w / mode->width, screen_h / mode->height);
+
+		// Modes bigger than the screen can only be shrunk to fit
+		if (factor >= 1)
+		{
+			*xscale = (int) ((half_w * w * factor + screen_w / 2) / screen_w);
+			*yscale = (int) ((half_h * h * factor + screen_h / 2) / screen_h);
+			return;
+		}
+		scaling = WII_SCALE_ASPECT;
+	}
+
+	if (scaling == WII_SCALE_ASPECT)
+	{
+		// Fill whichever direction runs out of room first
+		if (w * screen_h >= h * screen_w)
+		{
+			*xscale = half_w;
+			*yscale = (int) ((half_h * h * screen_w + (w * screen_h) / 2) / (w * screen_h));
+		}
+		else
+		{
+			*xscale = (int) ((half_w * w * screen_h + (h * screen_w) / 2) / (h * screen_w));
+			*yscale = half_h;
+		}
+		return;
+	}
+
+	*xscale = half_w;
+	*yscale = half_h;
+}
@@ -0,0 +1,63 @@
+/*
+	SDL - Simple DirectMedia Layer
+	Copyright (C) 1997-2006 Sam Lantinga
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 2.1 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+	Tantric, 2009
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_wiimodes_c_h
+#define _SDL_wiimodes_c_h
+
+/* Video mode selection and on-screen scaling for the Wii backend.
+   This file has no libogc dependencies so it can be built and tested on
+   any host.
+*/
+#include "SDL_stdinc.h"
+
+/* Ways of fitting the SDL screen onto the TV, for WII_SetScaling */
+#define WII_SCALE_STRETCH	0	/* fill the whole TV screen (the default) */
+#define WII_SCALE_ASPECT	1	/* as large as fits, keeping square pixels */
+#define WII_SCALE_INTEGER	2	/* largest whole multiple of the mode that fits */
+
+typedef struct WII_Mode
+{
+	int			width;
+	int			height;
+	int			bpp;
+
+	/* The texture holding the mode, padded out to whole 4x4 tiles */
+	int			tex_width;
+	int			tex_height;
+	Uint32		tex_bytes;
+} WII_Mode;
+
+/* Check that a mode can be displayed and work out its texture size.
+   Any size up to 1024x1024 at 8, 16, 24 or 32 bpp will do.
+   Returns -1 with the SDL error set if the mode is unsupported.
+*/
+extern int WII_SelectMode(WII_Mode *mode, int width, int height, int bpp);
+
+/* Size of the textured quad showing the mode, as the half width and half
+   height that WII_ChangeSquare takes. The TV screen is screen_w x
+   screen_h pixels and is covered by a quad of half size half_w x half_h.
+*/
+extern void WII_ScaleSquare(const WII_Mode *mode, int scaling,
+                            int screen_w, int screen_h, int half_w, int half_h,
+                            int *xscale, int *yscale);
+
+#endif /* _SDL_wiimodes_c_h */
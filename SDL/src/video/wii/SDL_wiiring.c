@@ -0,0 +1,76 @@
+/*
+	SDL - Simple DirectMedia Layer
+	Copyright (C) 1997-2006 Sam Lantinga
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 2.1 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+	Tantric, 2009
+*/
+#include "SDL_config.h"
+
+#include "SDL_wiiring_c.h"
+
+#define WII_RING_FRESH		4
+#define WII_RING_SLOT(x)	((x) & 3)
+
+// Atomically replace *ptr with value, returning the previous contents
+static int Exchange(volatile int *ptr, int value)
+{
+	int old;
+	do
+	{
+		old = *ptr;
+	} while (!__sync_bool_compare_and_swap(ptr, old, value));
+	return old;
+}
+
+void WII_RingInit(WII_FrameRing *ring)
+{
+	ring->back = 0;
+	ring->latest = 1;
+	ring->front = 2;
+	ring->produced = 0;
+	ring->presented = 0;
+	ring->dropped = 0;
+}
+
+int WII_RingPublish(WII_FrameRing *ring)
+{
+	const int old = Exchange(&ring->latest, ring->back | WII_RING_FRESH);
+
+	// The consumer never saw the frame we just replaced
+	if (old & WII_RING_FRESH)
+		++ring->dropped;
+	++ring->produced;
+
+	ring->back = WII_RING_SLOT(old);
+	return ring->back;
+}
+
+int WII_RingAcquire(WII_FrameRing *ring, int *fresh)
+{
+	int old;
+
+	*fresh = 0;
+	if (!(ring->latest & WII_RING_FRESH))
+		return ring->front;
+
+	// Only the producer can set the fresh bit, so it is still set here
+	old = Exchange(&ring->latest, ring->front);
+	ring->front = WII_RING_SLOT(old);
+	++ring->presented;
+	*fresh = 1;
+	return ring->front;
+}
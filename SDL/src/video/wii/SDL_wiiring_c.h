@@ -0,0 +1,59 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2006 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Tantric, 2009
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_wiiring_c_h
+#define _SDL_wiiring_c_h
+
+/* Triple buffered handoff between one producer (the application thread)
+   and one consumer (the flip thread). The producer always owns a back
+   slot, the consumer always owns a front slot, and the third slot holds
+   the latest complete frame. Neither side ever waits for the other.
+*/
+#include "SDL_stdinc.h"
+
+#define WII_RING_SLOTS		3
+
+typedef struct WII_FrameRing
+{
+	/* Latest complete slot, with WII_RING_FRESH set until it is taken */
+	volatile int	latest;
+	int				back;		/* owned by the producer */
+	int				front;		/* owned by the consumer */
+
+	volatile Uint32	produced;	/* frames published */
+	volatile Uint32	presented;	/* frames picked up for display */
+	volatile Uint32	dropped;	/* frames replaced before display */
+} WII_FrameRing;
+
+extern void WII_RingInit(WII_FrameRing *ring);
+
+/* Producer: hand the back slot over as the latest frame and return the
+   slot to draw the next frame into.
+*/
+extern int WII_RingPublish(WII_FrameRing *ring);
+
+/* Consumer: return the slot to display. If a newer frame was published
+   it becomes the front slot and *fresh is set to 1.
+*/
+extern int WII_RingAcquire(WII_FrameRing *ring, int *fresh);
+
+#endif /* _SDL_wiiring_c_h */
@@ -0,0 +1,521 @@
+/*
+	SDL - Simple DirectMedia Layer
+	Copyright (C) 1997-2006 Sam Lantinga
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 2.1 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+	Tantric, 2009
+*/
+#include "SDL_config.h"
+
+#include "SDL_endian.h"
+#include "SDL_wiitiles_c.h"
+
+#define TEST_BIT(map, i)	((map)[(i) >> 5] & (1u << ((i) & 31)))
+#define IS_DIRTY(tex, i)	TEST_BIT((tex)->dirty, i)
+#define IS_STALE(tex, i)	TEST_BIT((tex)->stale, i)
+
+static void MarkDirty(WII_TileTexture *tex, int i)
+{
+	if (!IS_DIRTY(tex, i))
+	{
+		tex->dirty[i >> 5] |= 1u << (i & 31);
+		++tex->dirty_count;
+	}
+}
+
+static int CountBits(Uint32 bits)
+{
+	bits = bits - ((bits >> 1) & 0x55555555);
+	bits = (bits & 0x33333333) + ((bits >> 2) & 0x33333333);
+	bits = (bits + (bits >> 4)) & 0x0F0F0F0F;
+	return (bits * 0x01010101) >> 24;
+}
+
+/* Clear the bits of tiles first to first+n-1 a word at a time */
+static void ClearRun(Uint32 *map, int first, int n)
+{
+	while (n > 0)
+	{
+		const int bit = first & 31;
+		const int len = SDL_min(n, 32 - bit);
+		const Uint32 mask = (len == 32) ? 0xFFFFFFFF : (((1u << len) - 1) << bit);
+		map[first >> 5] &= ~mask;
+		first += len;
+		n -= len;
+	}
+}
+
+/* One row of a tile: four RGB565 pixels, or four AR or GB pairs */
+typedef union
+{
+	Uint64	q;
+	Uint16	h[4];
+	Uint8	b[8];
+} TileRow;
+
+/* Store a tile row, remembering whether the tile actually changed */
+#define STORE_ROW(dst, row, changed, i) \
+	if (*(dst) != (row).q) \
+	{ \
+		*(dst) = (row).q; \
+		(changed)[i] = 1; \
+	}
+
+/* The span converters translate one source row into the matching row of
+   count consecutive tiles, four pixels at a time. Only the last tile can
+   be partial; its missing pixels are left black.
+*/
+static void Span_8(const Uint8 *src, Uint64 *dst, int count, int lastw,
+                   const Uint16 *palette, Uint8 *changed)
+{
+	int i, x;
+	for (i = 0; i < count; i++, src += 4, dst += 4)
+	{
+		TileRow row;
+		if (i == count - 1 && lastw < WII_TILE_DIM)
+		{
+			row.q = 0;
+			for (x = 0; x < lastw; x++)
+				row.h[x] = SDL_SwapBE16(palette[src[x]]);
+		}
+		else
+		{
+			row.h[0] = SDL_SwapBE16(palette[src[0]]);
+			row.h[1] = SDL_SwapBE16(palette[src[1]]);
+			row.h[2] = SDL_SwapBE16(palette[src[2]]);
+			row.h[3] = SDL_SwapBE16(palette[src[3]]);
+		}
+		STORE_ROW(dst, row, changed, i);
+	}
+}
+
+static void Span_16(const Uint8 *src, Uint64 *dst, int count, int lastw, Uint8 *changed)
+{
+	int i;
+	for (i = 0; i < count; i++, src += 8, dst += 4)
+	{
+		TileRow row;
+		if (i == count - 1 && lastw < WII_TILE_DIM)
+		{
+			row.q = 0;
+			SDL_memcpy(row.b, src, lastw << 1);
+		}
+		else
+			SDL_memcpy(&row.q, src, 8);
+		STORE_ROW(dst, row, changed, i);
+	}
+}
+
+/* Count whole RGB565 tiles. Source rows are already tile rows, so each
+   tile is compared and stored as a whole, and the texture is walked in
+   order as the old full frame flip did.
+*/
+static void Tiles_16(const Uint8 *src, int pitch, Uint64 *dst, int count, Uint8 *changed)
+{
+	const Uint8 *s0 = src;
+	const Uint8 *s1 = src + pitch;
+	const Uint8 *s2 = src + (pitch * 2);
+	const Uint8 *s3 = src + (pitch * 3);
+	Uint64 r0, r1, r2, r3;
+	int i;
+
+	for (i = 0; i < count; i++, dst += 4)
+	{
+		SDL_memcpy(&r0, s0 + (i << 3), 8);
+		SDL_memcpy(&r1, s1 + (i << 3), 8);
+		SDL_memcpy(&r2, s2 + (i << 3), 8);
+		SDL_memcpy(&r3, s3 + (i << 3), 8);
+		if ((dst[0] ^ r0) | (dst[1] ^ r1) | (dst[2] ^ r2) | (dst[3] ^ r3))
+		{
+			dst[0] = r0;
+			dst[1] = r1;
+			dst[2] = r2;
+			dst[3] = r3;
+			changed[i] = 1;
+		}
+	}
+}
+
+static void Span_24(const Uint8 *src, Uint64 *dst, int count, int lastw, Uint8 *changed)
+{
+	int i, x;
+	for (i = 0; i < count; i++, src += 12, dst += 8)
+	{
+		TileRow ar, gb;
+		if (i == count - 1 && lastw < WII_TILE_DIM)
+		{
+			ar.q = gb.q = 0;
+			for (x = 0; x < lastw; x++)
+			{
+				ar.b[(x << 1)] = 0xFF;
+				ar.b[(x << 1) + 1] = src[(x * 3)];
+				gb.b[(x << 1)] = src[(x * 3) + 1];
+				gb.b[(x << 1) + 1] = src[(x * 3) + 2];
+			}
+		}
+		else
+		{
+			ar.b[0] = 0xFF; ar.b[1] = src[0];  gb.b[0] = src[1];  gb.b[1] = src[2];
+			ar.b[2] = 0xFF; ar.b[3] = src[3];  gb.b[2] = src[4];  gb.b[3] = src[5];
+			ar.b[4] = 0xFF; ar.b[5] = src[6];  gb.b[4] = src[7];  gb.b[5] = src[8];
+			ar.b[6] = 0xFF; ar.b[7] = src[9];  gb.b[6] = src[10]; gb.b[7] = src[11];
+		}
+		STORE_ROW(dst, ar, changed, i);
+		STORE_ROW(dst + 4, gb, changed, i);
+	}
+}
+
+static void Span_32(const Uint8 *src, Uint64 *dst, int count, int lastw, Uint8 *changed)
+{
+	int i, x;
+	for (i = 0; i < count; i++, src += 16, dst += 8)
+	{
+		TileRow ar, gb;
+		if (i == count - 1 && lastw < WII_TILE_DIM)
+		{
+			ar.q = gb.q = 0;
+			for (x = 0; x < lastw; x++)
+			{
+				SDL_memcpy(&ar.h[x], src + (x << 2), 2);
+				SDL_memcpy(&gb.h[x], src + (x << 2) + 2, 2);
+			}
+		}
+		else
+		{
+			// ARGB pixels split straight into their AR and GB halves
+			Uint16 argb[8];
+			SDL_memcpy(argb, src, 16);
+			ar.h[0] = argb[0]; gb.h[0] = argb[1];
+			ar.h[1] = argb[2]; gb.h[1] = argb[3];
+			ar.h[2] = argb[4]; gb.h[2] = argb[5];
+			ar.h[3] = argb[6]; gb.h[3] = argb[7];
+		}
+		STORE_ROW(dst, ar, changed, i);
+		STORE_ROW(dst + 4, gb, changed, i);
+	}
+}
+
+/* Rows below the surface in the last tile row are kept black */
+static void Span_Clear(Uint64 *dst, int count, int words, Uint8 *changed)
+{
+	int i, j;
+	for (i = 0; i < count; i++, dst += words << 2)
+	{
+		for (j = 0; j < words; j++)
+		{
+			if (dst[j << 2] != 0)
+			{
+				dst[j << 2] = 0;
+				changed[i] = 1;
+			}
+		}
+	}
+}
+
+int WII_InitTiles(WII_TileTexture *tex, Uint8 *texture, int width, int height, int bytesperpixel)
+{
+	int y;
+
+	if (width <= 0 || height <= 0 || width > WII_MAX_WIDTH || height > WII_MAX_HEIGHT)
+		return -1;
+	if (bytesperpixel < 1 || bytesperpixel > 4)
+		return -1;
+
+	tex->texture = texture;
+	tex->width = width;
+	tex->height = height;
+	tex->bytesperpixel = bytesperpixel;
+	tex->tiles_w = (width + WII_TILE_DIM - 1) / WII_TILE_DIM;
+	tex->tiles_h = (height + WII_TILE_DIM - 1) / WII_TILE_DIM;
+	tex->tile_bytes = (bytesperpixel <= 2) ? WII_TILE_BYTES_565 : WII_TILE_BYTES_RGBA;
+
+	// Where each row starts inside the first tile of its tile row
+	for (y = 0; y < tex->tiles_h * WII_TILE_DIM; y++)
+		tex->rowbase[y] = ((y / WII_TILE_DIM) * tex->tiles_w * tex->tile_bytes) + ((y % WII_TILE_DIM) << 3);
+
+	// Nothing in the texture can be trusted yet
+	WII_InvalidateTiles(tex);
+	SDL_memcpy(tex->stale, tex->dirty, sizeof(tex->stale));
+	return 0;
+}
+
+void WII_InvalidateTiles(WII_TileTexture *tex)
+{
+	const int ntiles = tex->tiles_w * tex->tiles_h;
+	int i;
+
+	SDL_memset(tex->dirty, 0, sizeof(tex->dirty));
+	for (i = 0; i < ntiles; i++)
+		tex->dirty[i >> 5] |= 1u << (i & 31);
+	tex->dirty_count = ntiles;
+}
+
+/* Convert tiles x0 to x1-1 of tile row ty and clear their stale bits.
+   Only tiles that come out different from the texture are stored and
+   marked dirty.
+*/
+static int ConvertTiles(WII_TileTexture *tex, const Uint8 *src, int pitch,
+                        const Uint16 *palette, int ty, int x0, int x1)
+{
+	Uint8 changed[WII_MAX_WIDTH / WII_TILE_DIM];
+	const int words = tex->tile_bytes >> 5;
+	const int count = x1 - x0;
+	const int lastw = SDL_min(WII_TILE_DIM, tex->width - ((x1 - 1) * WII_TILE_DIM));
+	const int first = (ty * tex->tiles_w) + x0;
+	int tx, y, len;
+	int done = 0;
+	int total = 0;
+
+	SDL_memset(changed, 0, count);
+
+	// Whole 16-bit tiles don't need the row walk
+	if (tex->bytesperpixel == 2 && (ty + 1) * WII_TILE_DIM <= tex->height)
+	{
+		done = (lastw < WII_TILE_DIM) ? count - 1 : count;
+		Tiles_16(src + (ty * WII_TILE_DIM * pitch) + (x0 * WII_TILE_DIM * 2), pitch,
+			(Uint64 *) (tex->texture + (first * tex->tile_bytes)),
+			done, changed);
+	}
+
+	// Walk the source a row at a time, filling one row of every tile
+	for (y = ty * WII_TILE_DIM; y < (ty + 1) * WII_TILE_DIM && done < count; y++)
+	{
+		const int x = x0 + done;
+		const int n = count - done;
+		Uint8 *c = changed + done;
+		Uint64 *d = (Uint64 *) (tex->texture + tex->rowbase[y] + (x * tex->tile_bytes));
+		const Uint8 *s = src + (y * pitch) + (x * WII_TILE_DIM * tex->bytesperpixel);
+
+		if (y >= tex->height)
+		{
+			Span_Clear(d, n, words, c);
+			continue;
+		}
+
+		switch (tex->bytesperpixel)
+		{
+		case 1:
+			Span_8(s, d, n, lastw, palette, c);
+			break;
+		case 2:
+			Span_16(s, d, n, lastw, c);
+			break;
+		case 3:
+			Span_24(s, d, n, lastw, c);
+			break;
+		case 4:
+			Span_32(s, d, n, lastw, c);
+			break;
+		}
+	}
+
+	// Fold the changed tiles into the dirty bits a word at a time
+	ClearRun(tex->stale, first, count);
+	for (tx = 0; tx < count; tx += len)
+	{
+		const int i = first + tx;
+		Uint32 bits = 0;
+		int b;
+
+		len = SDL_min(count - tx, 32 - (i & 31));
+		for (b = 0; b < len; b++)
+			bits |= (Uint32) changed[tx + b] << b;
+		bits <<= i & 31;
+		tex->dirty_count += CountBits(bits & ~tex->dirty[i >> 5]);
+		tex->dirty[i >> 5] |= bits;
+		total += CountBits(bits);
+	}
+	return total;
+}
+
+/* Clip rect to the texture and widen it to whole tiles */
+static int TileBounds(const WII_TileTexture *tex, const SDL_Rect *rect,
+                      int *x0, int *y0, int *x1, int *y1)
+{
+	*x0 = SDL_max(rect->x, 0);
+	*y0 = SDL_max(rect->y, 0);
+	*x1 = SDL_min(rect->x + rect->w, tex->width);
+	*y1 = SDL_min(rect->y + rect->h, tex->height);
+	if (*x0 >= *x1 || *y0 >= *y1)
+		return 0;
+	*x0 /= WII_TILE_DIM;
+	*y0 /= WII_TILE_DIM;
+	*x1 = (*x1 + WII_TILE_DIM - 1) / WII_TILE_DIM;
+	*y1 = (*y1 + WII_TILE_DIM - 1) / WII_TILE_DIM;
+	return 1;
+}
+
+int WII_UpdateTiles(WII_TileTexture *tex, const Uint8 *src, int pitch,
+                    const Uint16 *palette, const SDL_Rect *rect)
+{
+	int x0, y0, x1, y1;
+	int ty;
+	int total = 0;
+
+	if (!TileBounds(tex, rect, &x0, &y0, &x1, &y1))
+		return 0;
+	for (ty = y0; ty < y1; ty++)
+		total += ConvertTiles(tex, src, pitch, palette, ty, x0, x1);
+	return total;
+}
+
+void WII_MarkTiles(WII_TileTexture *tex, const SDL_Rect *rect)
+{
+	int x0, y0, x1, y1;
+	int tx, ty;
+
+	if (!TileBounds(tex, rect, &x0, &y0, &x1, &y1))
+		return;
+	for (ty = y0; ty < y1; ty++)
+	{
+		for (tx = x0; tx < x1; tx++)
+		{
+			const int i = (ty * tex->tiles_w) + tx;
+			tex->stale[i >> 5] |= 1u << (i & 31);
+		}
+	}
+}
+
+int WII_UpdateMarkedTiles(WII_TileTexture *tex, const Uint8 *src, int pitch,
+                          const Uint16 *palette)
+{
+	int tx, ty;
+	int total = 0;
+
+	for (ty = 0; ty < tex->tiles_h; ty++)
+	{
+		const int row = ty * tex->tiles_w;
+
+		tx = 0;
+		while (tx < tex->tiles_w)
+		{
+			int start;
+
+			if (!IS_STALE(tex, row + tx))
+			{
+				++tx;
+				continue;
+			}
+			start = tx;
+			while (tx < tex->tiles_w && IS_STALE(tex, row + tx))
+				++tx;
+			total += ConvertTiles(tex, src, pitch, palette, ty, start, tx);
+		}
+	}
+	return total;
+}
+
+void WII_MarkDirtyTiles(WII_TileTexture *tex, const SDL_Rect *rect)
+{
+	int x0, y0, x1, y1;
+	int tx, ty;
+
+	if (!TileBounds(tex, rect, &x0, &y0, &x1, &y1))
+		return;
+	for (ty = y0; ty < y1; ty++)
+	{
+		for (tx = x0; tx < x1; tx++)
+		{
+			const int i = (ty * tex->tiles_w) + tx;
+			tex->stale[i >> 5] &= ~(1u << (i & 31));
+			MarkDirty(tex, i);
+		}
+	}
+}
+
+int WII_CopyMarkedTiles(WII_TileTexture *tex, const WII_TileTexture *from)
+{
+	int tx, ty;
+	int total = 0;
+
+	for (ty = 0; ty < tex->tiles_h; ty++)
+	{
+		const int row = ty * tex->tiles_w;
+
+		tx = 0;
+		while (tx < tex->tiles_w)
+		{
+			int start, i;
+
+			if (!IS_STALE(tex, row + tx))
+			{
+				++tx;
+				continue;
+			}
+			start = tx;
+			while (tx < tex->tiles_w && IS_STALE(tex, row + tx))
+				++tx;
+
+			// A run of tiles within a tile row is one block in both textures
+			SDL_memcpy(tex->texture + ((row + start) * tex->tile_bytes),
+				from->texture + ((row + start) * tex->tile_bytes),
+				(tx - start) * tex->tile_bytes);
+			for (i = row + start; i < row + tx; i++)
+			{
+				tex->stale[i >> 5] &= ~(1u << (i & 31));
+				MarkDirty(tex, i);
+			}
+			total += tx - start;
+		}
+	}
+	return total;
+}
+
+Uint32 WII_FlushTiles(WII_TileTexture *tex, WII_FlushFunc flush)
+{
+	const int ntiles = tex->tiles_w * tex->tiles_h;
+	Uint32 flushed = 0;
+	int i = 0;
+
+	if (tex->dirty_count == 0)
+		return 0;
+
+	while (i < ntiles)
+	{
+		int start;
+
+		// Skip over clean words quickly
+		if (tex->dirty[i >> 5] == 0)
+		{
+			i = (i | 31) + 1;
+			continue;
+		}
+		if (!IS_DIRTY(tex, i))
+		{
+			++i;
+			continue;
+		}
+
+		// Tiles are stored row after row, so a run of dirty tiles is
+		// one contiguous block of texture memory
+		start = i;
+		while (i < ntiles && IS_DIRTY(tex, i))
+		{
+			// Whole words at a time after a full frame update
+			if (!(i & 31) && tex->dirty[i >> 5] == 0xFFFFFFFF)
+				i += 32;
+			else
+				++i;
+		}
+
+		flush(tex->texture + (start * tex->tile_bytes), (i - start) * tex->tile_bytes);
+		flushed += (i - start) * tex->tile_bytes;
+	}
+
+	SDL_memset(tex->dirty, 0, ((ntiles + 31) / 32) * sizeof(Uint32));
+	tex->dirty_count = 0;
+	return flushed;
+}
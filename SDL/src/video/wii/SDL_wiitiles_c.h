@@ -0,0 +1,117 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2006 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Tantric, 2009
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_wiitiles_c_h
+#define _SDL_wiitiles_c_h
+
+/* Conversion of the linear SDL framebuffer into GX 4x4 tiled textures.
+   This file has no libogc dependencies so it can be built and tested on
+   any host.
+*/
+#include "SDL_stdinc.h"
+#include "SDL_video.h"
+
+#define WII_TILE_DIM		4
+
+/* The largest texture GX can sample from */
+#define WII_MAX_WIDTH		1024
+#define WII_MAX_HEIGHT		1024
+#define WII_MAX_TILES		((WII_MAX_WIDTH / WII_TILE_DIM) * (WII_MAX_HEIGHT / WII_TILE_DIM))
+
+/* RGB565 tiles are 32 bytes, RGBA8 tiles are 64 bytes (the AR plane
+   followed by the GB plane). Both are a multiple of a 32 byte cache line.
+*/
+#define WII_TILE_BYTES_565	32
+#define WII_TILE_BYTES_RGBA	64
+
+/* Called for every run of modified texture memory */
+typedef void (*WII_FlushFunc)(void *start, Uint32 len);
+
+typedef struct WII_TileTexture
+{
+	Uint8*		texture;
+	int			width;
+	int			height;
+	int			bytesperpixel;	/* of the source surface */
+	int			tiles_w;
+	int			tiles_h;
+	int			tile_bytes;
+
+	/* Byte offset of each source row within its first tile */
+	Uint32		rowbase[WII_MAX_HEIGHT];
+
+	/* One bit per tile whose texture bytes changed since the last flush */
+	Uint32		dirty[(WII_MAX_TILES + 31) / 32];
+	int			dirty_count;
+
+	/* One bit per tile that is out of date with the source surface */
+	Uint32		stale[(WII_MAX_TILES + 31) / 32];
+} WII_TileTexture;
+
+/* Prepare a texture for a width x height source of the given depth.
+   All tiles start out stale and dirty, so the first update converts and
+   the first flush covers the whole texture.
+   Returns -1 if the mode doesn't fit.
+*/
+extern int WII_InitTiles(WII_TileTexture *tex, Uint8 *texture,
+                         int width, int height, int bytesperpixel);
+
+/* Mark every tile of the texture as needing a cache flush */
+extern void WII_InvalidateTiles(WII_TileTexture *tex);
+
+/* Convert the tiles covered by rect from the linear source buffer.
+   Only tiles whose converted contents differ from the texture are written
+   and marked dirty, so redrawing an unchanged screen flushes nothing, and
+   the converted tiles are no longer stale.
+   palette is only used for 8-bit sources.
+   Returns the number of tiles that changed.
+*/
+extern int WII_UpdateTiles(WII_TileTexture *tex, const Uint8 *src, int pitch,
+                           const Uint16 *palette, const SDL_Rect *rect);
+
+/* Remember that the source changed under rect, without converting yet */
+extern void WII_MarkTiles(WII_TileTexture *tex, const SDL_Rect *rect);
+
+/* Convert every tile marked with WII_MarkTiles, comparing as
+   WII_UpdateTiles does.
+   Returns the number of tiles that changed.
+*/
+extern int WII_UpdateMarkedTiles(WII_TileTexture *tex, const Uint8 *src, int pitch,
+                                 const Uint16 *palette);
+
+/* For textures drawn to directly: the tiles under rect were written in
+   place, so mark them dirty and no longer stale.
+*/
+extern void WII_MarkDirtyTiles(WII_TileTexture *tex, const SDL_Rect *rect);
+
+/* Bring the stale tiles of a directly drawn texture up to date by copying
+   them from another texture of the same mode. Returns the number of tiles
+   copied.
+*/
+extern int WII_CopyMarkedTiles(WII_TileTexture *tex, const WII_TileTexture *from);
+
+/* Call flush for each contiguous run of dirty tiles and clear the dirty
+   set. Returns the number of bytes handed to flush.
+*/
+extern Uint32 WII_FlushTiles(WII_TileTexture *tex, WII_FlushFunc flush);
+
+#endif /* _SDL_wiitiles_c_h */
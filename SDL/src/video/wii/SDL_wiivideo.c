@@ -37,39 +37,32 @@
 #include <wiiuse/wpad.h>
 #include "SDL_wiivideo.h"
 #include "SDL_wiievents_c.h"
+#include "SDL_wiitiles_c.h"
+#include "SDL_wiiring_c.h"
+#include "SDL_wiimodes_c.h"
 
 static const char	WIIVID_DRIVER_NAME[] = "wii";
 static lwp_t videothread = LWP_THREAD_NULL;
 static SDL_mutex * videomutex = 0;
 
-/*** SDL ***/
-static SDL_Rect mode_320;
-static SDL_Rect mode_640;
-
-static SDL_Rect* modes_descending[] =
-{
-	&mode_640,
-	&mode_320,
-	NULL
-};
-
 /*** 2D Video ***/
 #define HASPECT 			320
 #define VASPECT 			240
-#define TEXTUREMEM_SIZE 	(640*480*4)
 
 unsigned int *xfb[2] = { NULL, NULL }; // Double buffered
 int whichfb = 0; // Switch
 GXRModeObj* vmode = 0;
 u8 * screenTex = NULL; // screen capture
 static int quit_flip_thread = 0;
-static unsigned char texturemem[TEXTUREMEM_SIZE] __attribute__((aligned(32))); // GX texture
-static unsigned char textureconvert[TEXTUREMEM_SIZE] __attribute__((aligned(32))); // 565 mem
+static unsigned char *texturemem[WII_RING_SLOTS] = { NULL }; // GX textures
+static Uint32 texturebytes = 0; // size of each of them
+static WII_TileTexture tiles[WII_RING_SLOTS]; // dirty tile tracking for each texture
+static WII_FrameRing ring; // hands finished textures to the flip thread
 
 /*** GX ***/
 #define DEFAULT_FIFO_SIZE 256 * 1024
 static unsigned char gp_fifo[DEFAULT_FIFO_SIZE] __attribute__((aligned(32)));
-static GXTexObj texobj;
+static GXTexObj texobj[WII_RING_SLOTS];
 static Mtx view;
 
 /* New texture based scaler */
@@ -110,6 +103,23 @@ static camera cam = {
 static int currentwidth;
 static int currentheight;
 static int currentbpp;
+static WII_Mode currentmode;
+static int currentscaling = -1; // not chosen with WII_SetScaling
+static f32 tex_s = 1.0, tex_t = 1.0; // the part of the padded texture in use
+
+static void
+init_texobjs ()
+{
+	int i;
+
+	for (i = 0; i < WII_RING_SLOTS; i++)
+	{
+		if (currentbpp == 8 || currentbpp == 16)
+			GX_InitTexObj (&texobj[i], texturemem[i], currentmode.tex_width, currentmode.tex_height, GX_TF_RGB565, GX_CLAMP, GX_CLAMP, GX_FALSE);
+		else
+			GX_InitTexObj (&texobj[i], texturemem[i], currentmode.tex_width, currentmode.tex_height, GX_TF_RGBA8, GX_CLAMP, GX_CLAMP, GX_FALSE);
+	}
+}
 
 static void
 draw_init ()
@@ -139,13 +149,10 @@ draw_init ()
 
 	GX_InvVtxCache ();	// update vertex cache
 
-	// initialize the texture obj we are going to use
-	if (currentbpp == 8 || currentbpp == 16)
-		GX_InitTexObj (&texobj, texturemem, currentwidth, currentheight, GX_TF_RGB565, GX_CLAMP, GX_CLAMP, GX_FALSE);
-	else
-		GX_InitTexObj (&texobj, texturemem, currentwidth, currentheight, GX_TF_RGBA8, GX_CLAMP, GX_CLAMP, GX_FALSE);
+	// initialize the texture objs we are going to use
+	init_texobjs();
 
-	GX_LoadTexObj (&texobj, GX_TEXMAP0);	// load texture object so its ready to use
+	GX_LoadTexObj (&texobj[ring.front], GX_TEXMAP0);	// load texture object so its ready to use
 }
 
 static inline void
@@ -169,9 +176,9 @@ draw_square (Mtx v)
 	GX_LoadPosMtxImm (mv, GX_PNMTX0);
 	GX_Begin (GX_QUADS, GX_VTXFMT0, 4);
 	draw_vert (0, 0, 0.0, 0.0);
-	draw_vert (1, 0, 1.0, 0.0);
-	draw_vert (2, 0, 1.0, 1.0);
-	draw_vert (3, 0, 0.0, 1.0);
+	draw_vert (1, 0, tex_s, 0.0);
+	draw_vert (2, 0, tex_s, tex_t);
+	draw_vert (3, 0, 0.0, tex_t);
 	GX_End ();
 }
 
@@ -195,8 +202,15 @@ static void TakeScreenshot()
 	DCFlushRange(screenTex, texSize);
 }
 
+static void FlushTexture(void *start, Uint32 len)
+{
+	DCFlushRange(start, len);
+}
+
 static void * flip_thread (void *arg)
 {
+	int slot, fresh;
+
 	while(1)
 	{
 		if(quit_flip_thread == 2)
@@ -206,12 +220,12 @@ static void * flip_thread (void *arg)
 		GX_InvVtxCache();
 		GX_InvalidateTexAll();
 		
+		// only held against mode changes, never against the application
 		SDL_mutexP(videomutex);
 
-		// load texture into GX
-		DCFlushRange(texturemem, TEXTUREMEM_SIZE);
-
-		GX_LoadTexObj(&texobj, GX_TEXMAP0);
+		// load the newest finished texture into GX
+		slot = WII_RingAcquire(&ring, &fresh);
+		GX_LoadTexObj(&texobj[slot], GX_TEXMAP0);
 
 		draw_square(view); // render textured quad
 		GX_SetColorUpdate(GX_TRUE);
@@ -275,11 +289,9 @@ StartVideoThread()
 
 static int WII_VideoInit(_THIS, SDL_PixelFormat *vformat)
 {
-	// Set up the modes.
-	mode_640.w = vmode->fbWidth;
-	mode_640.h = vmode->efbHeight;
-	mode_320.w = mode_640.w / 2;
-	mode_320.h = mode_640.h / 2;
+	// Any mode is scaled to the TV; default to its native size
+	this->info.current_w = vmode->fbWidth;
+	this->info.current_h = vmode->efbHeight;
 
 	// Set the current format.
 	vformat->BitsPerPixel	= 16;
@@ -296,42 +308,24 @@ static int WII_VideoInit(_THIS, SDL_PixelFormat *vformat)
 
 static SDL_Rect **WII_ListModes(_THIS, SDL_PixelFormat *format, Uint32 flags)
 {
-	return &modes_descending[0];
+	// WII_SetVideoMode turns down anything too large for a texture
+	return (SDL_Rect **) -1;
 }
 
 static SDL_Surface *WII_SetVideoMode(_THIS, SDL_Surface *current,
 								   int width, int height, int bpp, Uint32 flags)
 {
-	SDL_Rect* 		mode;
+	WII_Mode		mode;
+	unsigned char*	newtexture[WII_RING_SLOTS] = { NULL };
 	size_t			bytes_per_pixel;
 	Uint32			r_mask = 0;
 	Uint32			b_mask = 0;
 	Uint32			g_mask = 0;
+	int				i;
 
-	// Find a mode big enough to store the requested resolution
-	mode = modes_descending[0];
-	while (mode)
-	{
-		if (mode->w == width && mode->h == height)
-			break;
-		else
-			++mode;
-	}
-
-	// Didn't find a mode?
-	if (!mode)
-	{
-		SDL_SetError("Display mode (%dx%d) is unsupported.",
-			width, height);
+	// Any size that fits in a texture will do, the flip thread scales it
+	if (WII_SelectMode(&mode, width, height, bpp) < 0)
 		return NULL;
-	}
-
-	if(bpp != 8 && bpp != 16 && bpp != 24 && bpp != 32)
-	{
-		SDL_SetError("Resolution (%d bpp) is unsupported (8/16/24/32 bpp only).",
-			bpp);
-		return NULL;
-	}
 
 	bytes_per_pixel = bpp / 8;
 
@@ -342,17 +336,48 @@ static SDL_Surface *WII_SetVideoMode(_THIS, SDL_Surface *current,
 		this->hidden->buffer = NULL;
 	}
 
+	// RGB565 is already the texture format, so tiled 16-bit modes draw
+	// straight into the textures and need no buffer of their own
+	this->hidden->tiled = (flags & SDL_TILEDSURFACE) && bpp == 16;
+
 	// Allocate the new buffer.
-	this->hidden->buffer = memalign(32, width * height * bytes_per_pixel);
-	if (!this->hidden->buffer )
+	if (!this->hidden->tiled)
 	{
-		SDL_SetError("Couldn't allocate buffer for requested mode");
-		return(NULL);
+		this->hidden->buffer = memalign(32, width * height * bytes_per_pixel);
+		if (!this->hidden->buffer )
+		{
+			SDL_SetError("Couldn't allocate buffer for requested mode");
+			return(NULL);
+		}
+	}
+
+	// Grow the textures if the new mode needs more room
+	if (mode.tex_bytes > texturebytes)
+	{
+		for (i = 0; i < WII_RING_SLOTS; i++)
+		{
+			newtexture[i] = memalign(32, mode.tex_bytes);
+			if (!newtexture[i])
+			{
+				while (i--)
+					free(newtexture[i]);
+				free(this->hidden->buffer);
+				this->hidden->buffer = NULL;
+
+				SDL_SetError("Couldn't allocate textures for requested mode");
+				return(NULL);
+			}
+		}
 	}
 
 	// Allocate the new pixel format for the screen
 	if (!SDL_ReallocFormat(current, bpp, r_mask, g_mask, b_mask, 0))
 	{
+		if (newtexture[0])
+		{
+			for (i = 0; i < WII_RING_SLOTS; i++)
+				free(newtexture[i]);
+		}
 		free(this->hidden->buffer);
 		this->hidden->buffer = NULL;
 
@@ -360,15 +385,49 @@ static SDL_Surface *WII_SetVideoMode(_THIS, SDL_Surface *current,
 		return(NULL);
 	}
 
-	// Clear the buffer
-	SDL_memset(this->hidden->buffer, 0, width * height * bytes_per_pixel);
-
 	// Set up the new mode framebuffer
 	current->flags = (flags & SDL_DOUBLEBUF) | (flags & SDL_FULLSCREEN) | (flags & SDL_HWPALETTE);
 	current->w = width;
 	current->h = height;
-	current->pitch = current->w * bytes_per_pixel;
-	current->pixels = this->hidden->buffer;
+
+	// The flip thread is kept off the textures until they are ready
+	SDL_mutexP(videomutex);
+	if (newtexture[0])
+	{
+		for (i = 0; i < WII_RING_SLOTS; i++)
+		{
+			free(texturemem[i]);
+			texturemem[i] = newtexture[i];
+		}
+		texturebytes = mode.tex_bytes;
+	}
+	currentmode = mode;
+	currentbpp = bpp;
+	tex_s = (f32) mode.width / mode.tex_width;
+	tex_t = (f32) mode.height / mode.tex_height;
+	init_texobjs();
+
+	WII_RingInit(&ring);
+	for (i = 0; i < WII_RING_SLOTS; i++)
+		WII_InitTiles(&tiles[i], texturemem[i], current->w, current->h, bytes_per_pixel);
+
+	if (this->hidden->tiled)
+	{
+		for (i = 0; i < WII_RING_SLOTS; i++)
+			SDL_memset(texturemem[i], 0, mode.tex_bytes);
+		current->flags |= SDL_TILEDSURFACE;
+		// SDL_TILED_OFFSET takes the pitch of the padded linear surface
+		current->pitch = mode.tex_width * bytes_per_pixel;
+		current->pixels = texturemem[ring.back];
+	}
+	else
+	{
+		// Clear the buffer
+		SDL_memset(this->hidden->buffer, 0, width * height * bytes_per_pixel);
+		current->pitch = current->w * bytes_per_pixel;
+		current->pixels = this->hidden->buffer;
+	}
+	SDL_mutexV(videomutex);
 
 	/* Set the hidden data */
 	this->hidden->width = current->w;
@@ -377,7 +436,11 @@ static SDL_Surface *WII_SetVideoMode(_THIS, SDL_Surface *current,
 
 	currentwidth = current->w;
 	currentheight = current->h;
-	currentbpp = bpp;
+
+	// Keep the scaling the application asked for with the new size
+	if (currentscaling >= 0)
+		WII_SetScaling(currentscaling);
+
 	WPAD_SetVRes(WPAD_CHAN_ALL, currentwidth*1.5, currentheight*1.5);
 	draw_init();
 	StartVideoThread();
@@ -406,269 +469,83 @@ static void WII_UnlockHWSurface(_THIS, SDL_Surface *surface)
 	return;
 }
 
-static inline void Set_RGBAPixel(_THIS, int x, int y, u32 color)
-{
-	u8 *truc = (u8*) texturemem;
-	int width = this->hidden->width;
-	u32 offset;
-
-	offset = (((y >> 2) << 4) * width) + ((x >> 2) << 6) + (((y % 4 << 2) + x % 4) << 1);
-
-	*(truc + offset) = color & 0xFF;
-	*(truc + offset + 1) = (color >> 24) & 0xFF;
-	*(truc + offset + 32) = (color >> 16) & 0xFF;
-	*(truc + offset + 33) = (color >> 8) & 0xFF;
-}
-
-static inline void Set_RGB565Pixel(_THIS, int x, int y, u16 color)
+/* Bring the back texture up to date, flush it and hand it to the flip thread */
+static void PublishFrame(_THIS)
 {
-	u8 *truc = (u8*) texturemem;
-	int width = this->hidden->width;
-	u32 offset;
+	WII_TileTexture *back = &tiles[ring.back];
 
-	offset = (((y >> 2) << 3) * width) + ((x >> 2) << 5) + (((y % 4 << 2) + x % 4) << 1);
-
-	*(truc + offset) = (color >> 8) & 0xFF;
-	*(truc + offset + 1) = color & 0xFF;
+	WII_UpdateMarkedTiles(back, this->hidden->buffer, this->hidden->pitch,
+		this->hidden->palette);
+	WII_FlushTiles(back, FlushTexture);
+	WII_RingPublish(&ring);
 }
 
-static void UpdateRect_8(_THIS, SDL_Rect *rect)
+static void MarkRect(SDL_Rect *rect)
 {
-	u8 *src;
-	u8 *ptr;
-	u16 color;
-	int i, j;
-	Uint16 *palette = this->hidden->palette;
-	for (i = 0; i < rect->h; i++)
-	{
-		src = (this->hidden->buffer + (this->hidden->width * (i + rect->y)) + (rect->x));
-		for (j = 0; j < rect->w; j++)
-		{
-			ptr = src + j;
-			color = palette[*ptr];
-			Set_RGB565Pixel(this, rect->x + j, rect->y + i, color);
-		}
-	}
-}
-
-static void UpdateRect_16(_THIS, SDL_Rect *rect)
-{
-	u8 *src;
-	u8 *ptr;
-	u16 color;
-	int i, j;
-	for (i = 0; i < rect->h; i++)
-	{
-		src = (this->hidden->buffer + (this->hidden->width * 2 * (i + rect->y)) + (rect->x * 2));
-		for (j = 0; j < rect->w; j++)
-		{
-			ptr = src + (j * 2);
-			color = (ptr[0] << 8) | ptr[1];
-			Set_RGB565Pixel(this, rect->x + j, rect->y + i, color);
-		}
-	}
+	int i;
+	// Every texture in the ring has to catch up with this change
+	for (i = 0; i < WII_RING_SLOTS; i++)
+		WII_MarkTiles(&tiles[i], rect);
 }
 
-static void UpdateRect_24(_THIS, SDL_Rect *rect)
+/* The application drew into the back texture itself: flush what it
+   touched, hand it over and start drawing into the next one */
+static void PublishTiledFrame(_THIS, int numrects, SDL_Rect *rects, int keep)
 {
-	u8 *src;
-	u8 *ptr;
-	u32 color;
+	const int published = ring.back;
 	int i, j;
-	for (i = 0; i < rect->h; i++)
-	{
-		src = (this->hidden->buffer + (this->hidden->width * 3 * (i + rect->y)) + (rect->x * 3));
-		for (j = 0; j < rect->w; j++)
-		{
-			ptr = src + (j * 3);
-			color = (ptr[0] << 24) | (ptr[1] << 16) | (ptr[2] << 8) | 0xff;
-			Set_RGBAPixel(this, rect->x + j, rect->y + i, color);
-		}
-	}
-}
 
-static void UpdateRect_32(_THIS, SDL_Rect *rect)
-{
-	u8 *src;
-	u8 *ptr;
-	u32 color;
-	int i, j;
-	for (i = 0; i < rect->h; i++)
+	for (i = 0; i < numrects; i++)
 	{
-		src = (this->hidden->buffer + (this->hidden->width * 4 * (i + rect->y)) + (rect->x * 4));
-		for (j = 0; j < rect->w; j++)
+		WII_MarkDirtyTiles(&tiles[published], &rects[i]);
+		for (j = 0; j < WII_RING_SLOTS; j++)
 		{
-			ptr = src + (j * 4);
-			color = (ptr[1] << 24) | (ptr[2] << 16) | (ptr[3] << 8) | ptr[0];
-			Set_RGBAPixel(this, rect->x + j, rect->y + i, color);
+			if (j != published)
+				WII_MarkTiles(&tiles[j], &rects[i]);
 		}
 	}
-}
+	WII_FlushTiles(&tiles[published], FlushTexture);
+	WII_RingPublish(&ring);
 
-static void WII_UpdateRect(_THIS, SDL_Rect *rect)
-{
-	const SDL_Surface* const screen = this->screen;
-	SDL_mutexP(videomutex);
-	switch(screen->format->BytesPerPixel) {
-	case 1:
-		UpdateRect_8(this, rect);
-		break;
-	case 2:
-		UpdateRect_16(this, rect);
-		break;
-	case 3:
-		UpdateRect_24(this, rect);
-		break;
-	case 4:
-		UpdateRect_32(this, rect);
-		break;
-	default:
-		fprintf(stderr, "Invalid BPP %d\n", screen->format->BytesPerPixel);
-		break;
-	}
-	SDL_mutexV(videomutex);
+	// The new back texture is behind by whatever changed since it was
+	// last drawn to; copy that over unless the application redraws anyway
+	if (keep)
+		WII_CopyMarkedTiles(&tiles[ring.back], &tiles[published]);
+	this->screen->pixels = texturemem[ring.back];
 }
 
 static void WII_UpdateRects(_THIS, int numrects, SDL_Rect *rects)
 {
 	int i;
-	for (i = 0; i < numrects; i++)
-	{
-		WII_UpdateRect(this, &rects[i]);
-	}
-}
-
-static void flipHWSurface_8_16(_THIS, SDL_Surface *surface)
-{
-	int new_pitch = this->hidden->width * 2;
-	long long int *dst = (long long int *) texturemem;
-	long long int *src1 = (long long int *) textureconvert;
-	long long int *src2 = (long long int *) (textureconvert + new_pitch);
-	long long int *src3 = (long long int *) (textureconvert + (new_pitch * 2));
-	long long int *src4 = (long long int *) (textureconvert + (new_pitch * 3));
-	int rowpitch = (new_pitch >> 3) * 3;
-	int rowadjust = (new_pitch % 8) * 4;
-	Uint16 *palette = this->hidden->palette;
-	char *ra = NULL;
-	int h, w;
-
-	// crude convert
-	Uint16 * ptr_cv = (Uint16 *) textureconvert;
-	Uint8 *ptr = (Uint8 *)this->hidden->buffer;
 
-	for (h = 0; h < this->hidden->height; h++)
+	if (this->hidden->tiled)
 	{
-		for (w = 0; w < this->hidden->width; w++)
-		{
-			Uint16 v = palette[*ptr];
-
-			*ptr_cv++ = v;
-			ptr++;
-		}
+		PublishTiledFrame(this, numrects, rects, 1);
+		return;
 	}
-
-	// same as 16bit
-	for (h = 0; h < this->hidden->height; h += 4)
-	{
-		for (w = 0; w < (this->hidden->width >> 2); w++)
-		{
-			*dst++ = *src1++;
-			*dst++ = *src2++;
-			*dst++ = *src3++;
-			*dst++ = *src4++;
-		}
-
-		src1 += rowpitch;
-		src2 += rowpitch;
-		src3 += rowpitch;
-		src4 += rowpitch;
-
-		if ( rowadjust )
-		{
-			ra = (char *)src1;
-			src1 = (long long int *)(ra + rowadjust);
-			ra = (char *)src2;
-			src2 = (long long int *)(ra + rowadjust);
-			ra = (char *)src3;
-			src3 = (long long int *)(ra + rowadjust);
-			ra = (char *)src4;
-			src4 = (long long int *)(ra + rowadjust);
-		}
-	}
-}
-
-static void flipHWSurface_16_16(_THIS, SDL_Surface *surface)
-{
-	int h, w;
-	long long int *dst = (long long int *) texturemem;
-	long long int *src1 = (long long int *) this->hidden->buffer;
-	long long int *src2 = (long long int *) (this->hidden->buffer + this->hidden->pitch);
-	long long int *src3 = (long long int *) (this->hidden->buffer + (this->hidden->pitch * 2));
-	long long int *src4 = (long long int *) (this->hidden->buffer + (this->hidden->pitch * 3));
-	int rowpitch = (this->hidden->pitch >> 3) * 3;
-	int rowadjust = (this->hidden->pitch % 8) * 4;
-	char *ra = NULL;
-
-	for (h = 0; h < this->hidden->height; h += 4)
+	for (i = 0; i < numrects; i++)
 	{
-		for (w = 0; w < this->hidden->width; w += 4)
-		{
-			*dst++ = *src1++;
-			*dst++ = *src2++;
-			*dst++ = *src3++;
-			*dst++ = *src4++;
-		}
-
-		src1 += rowpitch;
-		src2 += rowpitch;
-		src3 += rowpitch;
-		src4 += rowpitch;
-
-		if ( rowadjust )
-		{
-			ra = (char *)src1;
-			src1 = (long long int *)(ra + rowadjust);
-			ra = (char *)src2;
-			src2 = (long long int *)(ra + rowadjust);
-			ra = (char *)src3;
-			src3 = (long long int *)(ra + rowadjust);
-			ra = (char *)src4;
-			src4 = (long long int *)(ra + rowadjust);
-		}
+		MarkRect(&rects[i]);
 	}
+	PublishFrame(this);
 }
 
-static void flipHWSurface_24_16(_THIS, SDL_Surface *surface)
-{
-	SDL_Rect screen_rect = {0, 0, this->hidden->width, this->hidden->height};
-	WII_UpdateRect(this, &screen_rect);
-}
-
-static void flipHWSurface_32_16(_THIS, SDL_Surface *surface)
+static int WII_FlipHWSurface(_THIS, SDL_Surface *surface)
 {
 	SDL_Rect screen_rect = {0, 0, this->hidden->width, this->hidden->height};
-	WII_UpdateRect(this, &screen_rect);
-}
 
-static int WII_FlipHWSurface(_THIS, SDL_Surface *surface)
-{
-	switch(surface->format->BytesPerPixel)
+	// Like any double buffered surface, the back buffer is undefined
+	// after a flip
+	if (this->hidden->tiled)
 	{
-		case 1:
-			flipHWSurface_8_16(this, surface);
-			break;
-		case 2:
-			flipHWSurface_16_16(this, surface);
-			break;
-		case 3:
-			flipHWSurface_24_16(this, surface);
-			break;
-		case 4:
-			flipHWSurface_32_16(this, surface);
-			break;
-		default:
-			return -1;
+		PublishTiledFrame(this, 1, &screen_rect, 0);
+		return 1;
 	}
+
+	// Every tile is compared with the back texture, so only those that
+	// changed since it was last shown are rewritten and flushed
+	MarkRect(&screen_rect);
+	PublishFrame(this);
 	return 1;
 }
 
@@ -677,6 +554,7 @@ static int WII_SetColors(_THIS, int first_color, int color_count, SDL_Color *col
 	const int last_color = first_color + color_count;
 	Uint16* const palette = this->hidden->palette;
 	int     component;
+	SDL_Rect screen_rect;
 
 	/* Build the RGB565 palette. */
 	for (component = first_color; component != last_color; ++component)
@@ -689,6 +567,13 @@ static int WII_SetColors(_THIS, int first_color, int color_count, SDL_Color *col
 		palette[component] = (r << 11) | (g << 5) | b;
 	}
 
+	/* The whole screen needs converting with the new colours */
+	screen_rect.x = 0;
+	screen_rect.y = 0;
+	screen_rect.w = this->hidden->width;
+	screen_rect.h = this->hidden->height;
+	MarkRect(&screen_rect);
+
 	return(1);
 }
 
@@ -842,6 +727,12 @@ void WII_SetWidescreen(int wide)
 
 void WII_VideoStart()
 {
+	int i;
+
+	SDL_mutexP(videomutex);
+	for (i = 0; i < WII_RING_SLOTS; i++)
+		WII_InvalidateTiles(&tiles[i]);
+	SDL_mutexV(videomutex);
 	SetupGX();
 	draw_init();
 	StartVideoThread();
@@ -863,4 +754,29 @@ void WII_ChangeSquare(int xscale, int yscale, int xshift, int yshift)
 	square[4] = square[1]  =  yscale - yshift;
 	square[7] = square[10] = -yscale - yshift;
 	DCFlushRange (square, 32); // update memory BEFORE the GPU accesses it!
+	currentscaling = -1;
+}
+
+void WII_SetScaling(int scaling)
+{
+	int xscale, yscale;
+
+	// Without a mode yet, it is applied by WII_SetVideoMode
+	if (currentmode.width == 0)
+	{
+		currentscaling = scaling;
+		return;
+	}
+
+	WII_ScaleSquare(&currentmode, scaling, vmode->fbWidth, vmode->efbHeight,
+		HASPECT, VASPECT, &xscale, &yscale);
+	WII_ChangeSquare(xscale, yscale, 0, 0);
+	currentscaling = scaling;
+}
+
+void WII_GetFrameStats(Uint32 *produced, Uint32 *presented, Uint32 *dropped)
+{
+	*produced = ring.produced;
+	*presented = ring.presented;
+	*dropped = ring.dropped;
 }
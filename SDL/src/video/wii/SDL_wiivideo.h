@@ -26,6 +26,8 @@
 /* SDL internal includes */
 #include "../SDL_sysvideo.h"
 
+#include "SDL_wiimodes_c.h"
+
 /* OGC includes */
 #include <ogc/gx_struct.h>
 
@@ -39,6 +41,7 @@ struct SDL_PrivateVideoData
 	int						width;
 	int						height;
 	int						pitch;
+	int						tiled;	/* drawing straight into the GX textures */
 
 	Uint16             palette[256];
 };
@@ -48,4 +51,12 @@ void WII_VideoStart();
 void WII_VideoStop();
 void WII_ChangeSquare(int xscale, int yscale, int xshift, int yshift);
 
+/* Fit the screen to the TV with one of the WII_SCALE_* modes. The choice
+   is kept across mode changes until WII_ChangeSquare overrides it. */
+void WII_SetScaling(int scaling);
+
+/* Frames handed to the flip thread, frames it displayed, and frames that
+   were replaced by a newer one before it got to them */
+void WII_GetFrameStats(Uint32 *produced, Uint32 *presented, Uint32 *dropped);
+
 #endif /* _SDL_wiivideo_h */
@@ -0,0 +1,413 @@
+/* Test and benchmark the audio rate conversion in SDL_BuildAudioCVT.
+   Sine waves are resampled at every quality level, both in one go and as
+   a stream of odd sized buffers, and compared against the ideal output
+   to give a signal to noise ratio. Streams of many small buffers are
+   checked for drifting away from the ideal phase. Needs no audio device.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "SDL.h"
+
+#define SECONDS		2
+#define AMPLITUDE	16384.0
+#define BENCH_SECONDS	10
+#define BENCH_BUFFER	4096
+
+static const int rates[][2] = {
+	{ 44100, 32000 },
+	{ 22050, 32000 },
+	{ 44100, 48000 },
+	{ 48000, 32000 },
+	{ 11025, 48000 },
+	{ 32000, 16000 }
+};
+
+/* Minimum SNR in dB at each quality level, for a tone well inside the
+   passband */
+static const double min_snr[] = { 35.0, 70.0, 75.0 };
+
+/* Rates and buffer sizes in frames for the phase test */
+static const int phase_rates[][2] = {
+	{ 44100, 48000 },
+	{ 22050, 32000 }
+};
+static const int phase_buffers[] = { 17, 64, 100, 441, 512 };
+
+/* Most a tone may drift from its ideal phase, in degrees */
+#define MAX_PHASE_ERROR	1.0
+
+static Sint16 *input;
+static Sint16 *output;
+
+static void SetQuality(int quality)
+{
+	static char env[64];
+	SDL_snprintf(env, sizeof(env), "SDL_AUDIO_RESAMPLE_QUALITY=%d", quality);
+	SDL_putenv(env);
+}
+
+static void MakeSine(int frames, int rate, double freq)
+{
+	int i;
+	for (i = 0; i < frames; i++)
+	{
+		const Sint16 v = (Sint16) (AMPLITUDE * sin(2.0 * M_PI * freq * i / rate));
+		input[i * 2] = v;
+		input[i * 2 + 1] = -v;
+	}
+}
+
+/* Convert frames of stereo input in buffers of minchunk to maxchunk
+   frames, or in one go if maxchunk is 0. Each output frame's ideal
+   position in the input, in frames, goes into positions. Returns the
+   number of output frames, or -1.
+*/
+static int Convert(int src_rate, int dst_rate, int frames,
+                   int minchunk, int maxchunk, double *positions)
+{
+	SDL_AudioCVT cvt;
+	Uint8 *buf;
+	int done = 0, produced = 0;
+
+	if (SDL_BuildAudioCVT(&cvt, AUDIO_S16SYS, 2, src_rate,
+	                      AUDIO_S16SYS, 2, dst_rate) < 0)
+	{
+		printf("SDL_BuildAudioCVT failed: %s\n", SDL_GetError());
+		return -1;
+	}
+	buf = (Uint8 *) malloc(frames * 4 * cvt.len_mult);
+	while (done < frames)
+	{
+		int chunk = frames - done;
+		int i, out;
+
+		if (maxchunk && chunk > minchunk)
+			chunk = minchunk + rand() % (maxchunk - minchunk + 1);
+		if (chunk > frames - done)
+			chunk = frames - done;
+		cvt.buf = buf;
+		cvt.len = chunk * 4;
+		SDL_memcpy(buf, input + done * 2, cvt.len);
+		SDL_ConvertAudio(&cvt);
+
+		// A buffer may convert to a frame more than its share
+		out = cvt.len_cvt / 4;
+		if (out > (int) (cvt.len * cvt.len_ratio / 4) + 1 || out * 4 > cvt.len * cvt.len_mult)
+		{
+			printf("%d frames converted to %d frames, more than promised\n", chunk, out);
+			free(buf);
+			return -1;
+		}
+		SDL_memcpy(output + produced * 2, buf, out * 4);
+		for (i = 0; i < out; i++)
+			positions[produced + i] = ((double) (produced + i) * src_rate) / dst_rate;
+		produced += out;
+		done += chunk;
+	}
+	free(buf);
+	return produced;
+}
+
+/* Signal to noise ratio of the output against the ideal resampled sine */
+static double SNR(int frames, int rate, double freq, const double *positions, int taps)
+{
+	double signal = 0.0, noise = 0.0;
+	int i, c;
+
+	for (i = 0; i < frames; i++)
+	{
+		// The filter is causal, so the output lags by half its length
+		const double t = positions[i] - taps / 2;
+		double ideal;
+
+		if (t < taps)
+			continue;
+		ideal = AMPLITUDE * sin(2.0 * M_PI * freq * t / rate);
+		for (c = 0; c < 2; c++)
+		{
+			const double err = output[i * 2 + c] - (c ? -ideal : ideal);
+			signal += ideal * ideal;
+			noise += err * err;
+		}
+	}
+	if (noise == 0.0)
+		return 200.0;
+	return 10.0 * log10(signal / noise);
+}
+
+/* The filter length, found as the lag that best lines the output up
+   with the ideal sine
+*/
+static int FindTaps(int frames, int rate, double freq, const double *positions)
+{
+	double snr, best_snr = -1000.0;
+	int taps, best = 2;
+
+	for (taps = 2; taps <= 64; taps += 2)
+	{
+		snr = SNR(frames, rate, freq, positions, taps);
+		if (snr > best_snr)
+		{
+			best_snr = snr;
+			best = taps;
+		}
+	}
+	return best;
+}
+
+/* Attenuation in dB of a tone above the output Nyquist frequency */
+static double Rejection(int frames, const double *positions, int taps)
+{
+	double power = 0.0;
+	int i, n = 0;
+
+	for (i = 0; i < frames; i++)
+	{
+		if (positions[i] - taps / 2 < taps)
+			continue;
+		power += (double) output[i * 2] * output[i * 2];
+		++n;
+	}
+	if (power == 0.0)
+		return 200.0;
+	return 10.0 * log10((AMPLITUDE * AMPLITUDE / 2.0) / (power / n));
+}
+
+static int TestQuality(int quality)
+{
+	const int frames = 48000 * SECONDS;
+	double *positions = (double *) malloc(sizeof(double) * frames * 5);
+	int i, taps, errors = 0;
+
+	SetQuality(quality);
+	for (i = 0; i < SDL_arraysize(rates); i++)
+	{
+		const int src = rates[i][0], dst = rates[i][1];
+		const int in = src * SECONDS;
+		double whole, streamed, rejection = 0.0;
+		int out;
+
+		// A tone at a fifth of the lower Nyquist frequency
+		const double freq = (src < dst ? src : dst) / 10.0;
+		MakeSine(in, src, freq);
+		out = Convert(src, dst, in, 0, 0, positions);
+		if (out < 0)
+			return 1;
+		if (out != dst * SECONDS)
+		{
+			printf("%d -> %d: %d frames became %d, expected %d\n", src, dst, in, out, dst * SECONDS);
+			++errors;
+		}
+		taps = FindTaps(out, src, freq, positions);
+		whole = SNR(out, src, freq, positions, taps);
+
+		out = Convert(src, dst, in, 1, 1500, positions);
+		if (out < 0)
+			return 1;
+		streamed = SNR(out, src, freq, positions, taps);
+
+		if (dst < src)
+		{
+			// Three quarters of the way from the output Nyquist to the input's
+			MakeSine(in, src, (dst / 2.0) + 0.75 * (src - dst) / 2.0);
+			out = Convert(src, dst, in, 0, 0, positions);
+			rejection = Rejection(out, positions, taps);
+		}
+
+		printf("quality %d, %5d -> %5d: SNR %5.1f dB, streamed %5.1f dB", quality, src, dst, whole, streamed);
+		if (dst < src)
+			printf(", alias rejection %5.1f dB", rejection);
+		printf("\n");
+
+		if (whole < min_snr[quality] || streamed < min_snr[quality])
+		{
+			printf("  SNR below %.0f dB\n", min_snr[quality]);
+			++errors;
+		}
+	}
+	free(positions);
+	return errors;
+}
+
+/* Phase of the tone in the last tenth of the output against the ideal,
+   in degrees */
+static double PhaseError(int frames, int rate, double freq,
+                         const double *positions, int taps)
+{
+	double re = 0.0, im = 0.0;
+	int i;
+
+	for (i = frames - frames / 10; i < frames; i++)
+	{
+		const double w = 2.0 * M_PI * freq * (positions[i] - taps / 2) / rate;
+		re += output[i * 2] * sin(w);
+		im += output[i * 2] * cos(w);
+	}
+	return atan2(im, re) * 180.0 / M_PI;
+}
+
+/* A stream of many small buffers has to keep to the ratio of the rates,
+   or its tone drifts in pitch and phase and it runs long or short */
+static int TestPhase(void)
+{
+	double *positions = (double *) malloc(sizeof(double) * 48000 * SECONDS * 5);
+	int i, b, taps, errors = 0;
+
+	SetQuality(1);
+	for (i = 0; i < SDL_arraysize(phase_rates); i++)
+	{
+		const int src = phase_rates[i][0], dst = phase_rates[i][1];
+		const int in = src * SECONDS;
+		const double freq = src / 10.0;
+		int out;
+
+		MakeSine(in, src, freq);
+		out = Convert(src, dst, in, 0, 0, positions);
+		if (out < 0)
+			return 1;
+		taps = FindTaps(out, src, freq, positions);
+
+		for (b = 0; b < SDL_arraysize(phase_buffers); b++)
+		{
+			const int size = phase_buffers[b];
+			double phase;
+
+			out = Convert(src, dst, in, size, size, positions);
+			if (out < 0)
+				return 1;
+			phase = PhaseError(out, src, freq, positions, taps);
+			printf("%5d -> %5d in %3d frame buffers: %d frames, phase error %6.3f degrees\n",
+				src, dst, size, out, phase);
+			if (out != dst * SECONDS)
+			{
+				printf("  expected %d frames\n", dst * SECONDS);
+				++errors;
+			}
+			if (fabs(phase) > MAX_PHASE_ERROR)
+			{
+				printf("  phase error over %.1f degrees\n", MAX_PHASE_ERROR);
+				++errors;
+			}
+		}
+	}
+	free(positions);
+	return errors;
+}
+
+/* Conversions that go through other formats and channel counts */
+static int TestFormats(void)
+{
+	static const Uint16 formats[] = { AUDIO_U8, AUDIO_S8, AUDIO_U16LSB, AUDIO_S16LSB, AUDIO_U16MSB, AUDIO_S16MSB };
+	static const Uint8 channels[] = { 1, 2, 4, 6 };
+	Uint8 buf[1024 * 6 * 2 * 4];
+	int f, g, c, d, errors = 0;
+
+	SetQuality(1);
+	for (f = 0; f < SDL_arraysize(formats); f++)
+	for (g = 0; g < SDL_arraysize(formats); g++)
+	for (c = 0; c < SDL_arraysize(channels); c++)
+	for (d = 0; d < SDL_arraysize(channels); d++)
+	{
+		const int src_frame = (formats[f] & 0xFF) / 8 * channels[c];
+		const int dst_frame = (formats[g] & 0xFF) / 8 * channels[d];
+		SDL_AudioCVT cvt;
+		int expected;
+
+		if (channels[c] == 4 && channels[d] == 6)
+			continue;	// Not a supported layout change
+		if (SDL_BuildAudioCVT(&cvt, formats[f], channels[c], 22050,
+		                      formats[g], channels[d], 32000) < 0)
+		{
+			printf("Couldn't build %04x/%d -> %04x/%d: %s\n",
+				formats[f], channels[c], formats[g], channels[d], SDL_GetError());
+			++errors;
+			continue;
+		}
+		cvt.buf = buf;
+		cvt.len = 1000 * src_frame;
+		if (cvt.len * cvt.len_mult > sizeof(buf))
+		{
+			printf("Conversion needs a %d byte buffer\n", cvt.len * cvt.len_mult);
+			++errors;
+			continue;
+		}
+		SDL_memset(buf, (formats[f] & 0x8000) ? 0 : 0x80, cvt.len);
+		SDL_ConvertAudio(&cvt);
+		// Within a frame of its share of the output
+		expected = (int) (cvt.len * cvt.len_ratio / dst_frame + 0.5) * dst_frame;
+		if (abs(cvt.len_cvt - expected) > dst_frame || cvt.len_cvt % dst_frame)
+		{
+			printf("%04x/%d -> %04x/%d: converted to %d bytes, expected %d\n",
+				formats[f], channels[c], formats[g], channels[d], cvt.len_cvt, expected);
+			++errors;
+		}
+	}
+	return errors;
+}
+
+static void Benchmark(int quality, int src, int dst)
+{
+	const int frames = src * BENCH_SECONDS;
+	SDL_AudioCVT cvt;
+	Uint8 *buf;
+	Uint32 start, ms;
+	int done, produced = 0;
+
+	SetQuality(quality);
+	MakeSine(frames, src, 440.0);
+	SDL_BuildAudioCVT(&cvt, AUDIO_S16SYS, 2, src, AUDIO_S16SYS, 2, dst);
+	buf = (Uint8 *) malloc(BENCH_BUFFER * cvt.len_mult);
+
+	start = SDL_GetTicks();
+	for (done = 0; done + BENCH_BUFFER / 4 <= frames; done += BENCH_BUFFER / 4)
+	{
+		cvt.buf = buf;
+		cvt.len = BENCH_BUFFER;
+		SDL_memcpy(buf, input + done * 2, BENCH_BUFFER);
+		SDL_ConvertAudio(&cvt);
+		produced += cvt.len_cvt / 2;
+	}
+	ms = SDL_GetTicks() - start;
+	printf("quality %d, %5d -> %5d: %7.2f Msamples/s out (%.0fx realtime)\n",
+		quality, src, dst, produced / ((ms ? ms : 1) * 1000.0),
+		(BENCH_SECONDS * 1000.0) / (ms ? ms : 1));
+	free(buf);
+}
+
+int main(int argc, char *argv[])
+{
+	int errors = 0;
+	int quality;
+
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	input = (Sint16 *) malloc(48000 * BENCH_SECONDS * 4);
+	output = (Sint16 *) malloc(48000 * SECONDS * 5 * 4);
+
+	for (quality = 0; quality < 3; quality++)
+		errors += TestQuality(quality);
+	errors += TestPhase();
+	errors += TestFormats();
+
+	if (errors)
+		printf("%d resampling tests failed\n", errors);
+	else
+		printf("All resampling tests passed.\n");
+
+	for (quality = 0; quality < 3; quality++)
+	{
+		Benchmark(quality, 44100, 32000);
+		Benchmark(quality, 22050, 48000);
+	}
+
+	free(input);
+	free(output);
+	SDL_Quit();
+	return (errors ? 1 : 0);
+}
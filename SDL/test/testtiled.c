@@ -0,0 +1,231 @@
+/* Test drawing to a tiled 16-bit framebuffer (SDL_TILEDSURFACE).
+   Every blit and fill is done to the tiled screen and to a linear surface
+   of the same format, and the two must always hold the same pixels.
+   Runs on the dummy video driver.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+/* Not a multiple of the tile size, to cover the padding */
+#define WIDTH	317
+#define HEIGHT	235
+#define ROUNDS	2000
+#define SPRITES	20000
+
+static SDL_Surface *screen;
+static SDL_Surface *reference;
+
+/* Where a pixel lives in the tiled screen: 4x4 tiles of 32 bytes, stored
+   left to right, top to bottom */
+static Uint16 TiledPixel(int x, int y)
+{
+	Uint8 *tiles = (Uint8 *) screen->pixels;
+	int offset = ((y >> 2) * (screen->pitch << 2)) + ((x >> 2) << 5) +
+	             ((y & 3) << 3) + ((x & 3) << 1);
+	return *(Uint16 *) (tiles + offset);
+}
+
+static int Compare(const char *what, int round)
+{
+	int x, y;
+
+	for (y = 0; y < HEIGHT; y++)
+	{
+		Uint16 *row = (Uint16 *) ((Uint8 *) reference->pixels + y * reference->pitch);
+		for (x = 0; x < WIDTH; x++)
+		{
+			if (TiledPixel(x, y) != row[x])
+			{
+				printf("%s (round %d): pixel %d,%d is %04x, expected %04x\n",
+					what, round, x, y, TiledPixel(x, y), row[x]);
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+static void RandomRect(SDL_Rect *r, int w, int h)
+{
+	r->x = (rand() % (w + 20)) - 10;
+	r->y = (rand() % (h + 20)) - 10;
+	r->w = 1 + rand() % w;
+	r->h = 1 + rand() % h;
+}
+
+static SDL_Surface *RandomSurface(int bpp, Uint32 flags)
+{
+	SDL_Surface *surface;
+	Uint8 *pixels;
+	int i;
+
+	if (bpp == 32)
+		surface = SDL_CreateRGBSurface(SDL_SWSURFACE, 64, 48, 32,
+			0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+	else
+		surface = SDL_CreateRGBSurface(SDL_SWSURFACE, 64, 48, bpp,
+			screen->format->Rmask, screen->format->Gmask,
+			screen->format->Bmask, 0);
+	if (!surface)
+		return NULL;
+
+	pixels = (Uint8 *) surface->pixels;
+	for (i = 0; i < surface->pitch * surface->h; i++)
+		pixels[i] = rand() & 0xFF;
+	if (bpp == 8)
+	{
+		SDL_Color colors[256];
+		for (i = 0; i < 256; i++)
+		{
+			colors[i].r = rand() & 0xFF;
+			colors[i].g = rand() & 0xFF;
+			colors[i].b = rand() & 0xFF;
+		}
+		SDL_SetColors(surface, colors, 0, 256);
+	}
+
+	if (flags & SDL_SRCCOLORKEY)
+	{
+		// Mostly transparent, with random opaque blocks
+		Uint32 key = 0;
+		SDL_memcpy(&key, pixels, surface->format->BytesPerPixel);
+		SDL_FillRect(surface, NULL, key);
+		SDL_SetColorKey(surface, flags, key);
+		for (i = 0; i < 200; i++)
+		{
+			SDL_Rect r;
+			RandomRect(&r, surface->w, surface->h);
+			SDL_FillRect(surface, &r, rand());
+		}
+	}
+	if (flags & SDL_SRCALPHA)
+		SDL_SetAlpha(surface, SDL_SRCALPHA, 128);
+	return surface;
+}
+
+static int TestDrawing(void)
+{
+	SDL_Surface *sources[7];
+	SDL_Surface *linear;
+	int i, errors = 0;
+
+	sources[0] = RandomSurface(16, 0);
+	sources[1] = RandomSurface(16, SDL_SRCCOLORKEY);
+	sources[2] = RandomSurface(16, SDL_SRCCOLORKEY | SDL_RLEACCEL);
+	sources[3] = RandomSurface(32, SDL_SRCALPHA);
+	sources[4] = RandomSurface(8, 0);
+	sources[5] = RandomSurface(16, SDL_SRCALPHA);
+	sources[6] = RandomSurface(8, SDL_SRCCOLORKEY);
+
+	for (i = 0; i < ROUNDS && !errors; i++)
+	{
+		SDL_Rect r, d1, d2;
+		const int op = rand() % 9;
+
+		RandomRect(&r, WIDTH, HEIGHT);
+		d1 = d2 = r;
+		if (op == 0)
+		{
+			Uint32 color = rand() & 0xFFFF;
+			SDL_FillRect(screen, &d1, color);
+			SDL_FillRect(reference, &d2, color);
+			errors += Compare("FillRect", i);
+		}
+		else if (op < 8)
+		{
+			SDL_Surface *src = sources[op - 1];
+			SDL_Rect s;
+			RandomRect(&s, src->w, src->h);
+			SDL_BlitSurface(src, &s, screen, &d1);
+			SDL_BlitSurface(src, &s, reference, &d2);
+			errors += Compare("Blit", i);
+		}
+		else
+		{
+			// Scroll part of the screen onto itself
+			SDL_Rect s = r;
+			s.x += (rand() % 9) - 4;
+			s.y += (rand() % 9) - 4;
+			SDL_BlitSurface(screen, &s, screen, &d1);
+			SDL_BlitSurface(reference, &s, reference, &d2);
+			errors += Compare("Screen to screen blit", i);
+		}
+		SDL_UpdateRect(screen, 0, 0, 0, 0);
+	}
+
+	// Reading a tiled surface back into a linear one
+	linear = SDL_CreateRGBSurface(SDL_SWSURFACE, WIDTH, HEIGHT, 16,
+		screen->format->Rmask, screen->format->Gmask, screen->format->Bmask, 0);
+	SDL_BlitSurface(screen, NULL, linear, NULL);
+	if (SDL_memcmp(linear->pixels, reference->pixels, reference->pitch * HEIGHT) != 0)
+	{
+		printf("Tiled to linear blit differs from reference\n");
+		++errors;
+	}
+
+	SDL_FreeSurface(linear);
+	for (i = 0; i < SDL_arraysize(sources); i++)
+		SDL_FreeSurface(sources[i]);
+	return errors;
+}
+
+static Uint32 TimeSprites(SDL_Surface *dst, SDL_Surface *sprite)
+{
+	Uint32 start = SDL_GetTicks();
+	int i;
+
+	srand(1);
+	for (i = 0; i < SPRITES; i++)
+	{
+		SDL_Rect d;
+		d.x = rand() % WIDTH;
+		d.y = rand() % HEIGHT;
+		SDL_BlitSurface(sprite, NULL, dst, &d);
+	}
+	return SDL_GetTicks() - start;
+}
+
+int main(int argc, char *argv[])
+{
+	SDL_Surface *sprite;
+	int errors;
+
+	SDL_putenv("SDL_VIDEODRIVER=dummy");
+	if ( SDL_Init(SDL_INIT_VIDEO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	screen = SDL_SetVideoMode(WIDTH, HEIGHT, 16, SDL_SWSURFACE | SDL_TILEDSURFACE);
+	if ( !screen ) {
+		fprintf(stderr, "Couldn't set video mode: %s\n", SDL_GetError());
+		SDL_Quit();
+		return(1);
+	}
+	if ( !(screen->flags & SDL_TILEDSURFACE) ) {
+		fprintf(stderr, "The video driver doesn't support tiled surfaces\n");
+		SDL_Quit();
+		return(1);
+	}
+	reference = SDL_CreateRGBSurface(SDL_SWSURFACE, WIDTH, HEIGHT, 16,
+		screen->format->Rmask, screen->format->Gmask, screen->format->Bmask, 0);
+	SDL_FillRect(reference, NULL, 0);
+
+	errors = TestDrawing();
+	if (errors)
+		printf("%d tiled drawing tests failed\n", errors);
+	else
+		printf("All tiled drawing tests passed.\n");
+
+	sprite = RandomSurface(16, SDL_SRCCOLORKEY);
+	printf("%d colorkeyed 64x48 sprites: tiled %u ms, linear %u ms\n", SPRITES,
+		TimeSprites(screen, sprite), TimeSprites(reference, sprite));
+	SDL_FreeSurface(sprite);
+
+	SDL_FreeSurface(reference);
+	SDL_Quit();
+	return (errors ? 1 : 0);
+}
@@ -0,0 +1,177 @@
+/* Test the Wii audio driver's DMA buffer ring against a simulated DMA
+   clock. The ring has no libogc dependencies, so it is compiled straight
+   into this program and runs on any host.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "SDL_thread.h"
+#include "../src/audio/wii/SDL_wiiaudioring.c"
+
+#define SAMPLES		512
+#define PERIOD		(SAMPLES * 4)	/* 16-bit stereo */
+#define PERIOD_MS	2
+#define PERIODS		400
+
+static WII_AudioRing ring;
+static Uint8 memory[WII_AUDIO_RING_BYTES(WII_AUDIO_MAX_BUFFERS, PERIOD)];
+static SDL_sem *dma_signal;
+static volatile int done;
+static volatile int stall_ms;
+static Uint16 next_sample;
+static int errors;
+
+/* Stand-in for the application callback: a counting ramp, so anything
+   played out of order, twice or while being rendered shows up */
+static Uint32 SDLCALL Render(void *userdata, Uint8 *buf, Uint32 len)
+{
+	Uint16 *samples = (Uint16 *) buf;
+	Uint32 i;
+
+	if (stall_ms)
+	{
+		SDL_Delay(stall_ms);
+		stall_ms = 0;
+	}
+	for (i = 0; i < len / 2; i++)
+		samples[i] = ++next_sample;
+	return len;
+}
+
+static int SDLCALL AudioThread(void *data)
+{
+	while (!done)
+	{
+		WII_AudioRingFill(&ring, Render, NULL);
+		SDL_SemWait(dma_signal);
+	}
+	return 0;
+}
+
+static int CheckBuffer(const Uint8 *buf, Uint32 len, Uint16 first)
+{
+	const Uint16 *samples = (const Uint16 *) buf;
+	Uint32 i;
+
+	for (i = 0; i < len / 2; i++)
+	{
+		if (samples[i] != (Uint16) (first + i))
+			return 0;
+	}
+	return 1;
+}
+
+/* Play PERIODS periods, stalling the audio thread for stall periods
+   every so often. Returns the number of underruns. */
+static Uint32 Play(int nbuffers, int stall)
+{
+	SDL_Thread *thread;
+	const Uint8 *playing = NULL, *queued = NULL;
+	Uint16 playing_first = 0, queued_first = 0;
+	Uint16 expected = 1;
+	Uint32 len;
+	int i;
+
+	next_sample = 0;
+	done = 0;
+	stall_ms = 0;
+	WII_AudioRingInit(&ring, memory, nbuffers, PERIOD);
+	WII_AudioRingFill(&ring, Render, NULL);
+
+	dma_signal = SDL_CreateSemaphore(0);
+	thread = SDL_CreateThread(AudioThread, NULL);
+
+	for (i = 0; i < PERIODS; i++)
+	{
+		const Uint8 *buf;
+		int silence;
+
+		if (stall && (i % 50) == 25)
+			stall_ms = stall * PERIOD_MS;
+
+		// The buffer that finishes now must not have been touched
+		if (playing && !CheckBuffer(playing, PERIOD, playing_first))
+		{
+			printf("%d buffers: period %d was overwritten while playing\n", nbuffers, i);
+			++errors;
+		}
+		playing = queued;
+		playing_first = queued_first;
+
+		buf = WII_AudioRingNext(&ring, &len);
+		silence = (buf == memory + (ring.count * PERIOD));
+		if (silence)
+		{
+			queued = NULL;
+		}
+		else
+		{
+			// Periods are played in the order they were rendered
+			if (!CheckBuffer(buf, len, expected))
+			{
+				printf("%d buffers: period %d is out of order\n", nbuffers, i);
+				++errors;
+			}
+			queued = buf;
+			queued_first = expected;
+			expected += len / 2;
+		}
+
+		SDL_SemPost(dma_signal);
+		SDL_Delay(PERIOD_MS);
+	}
+
+	done = 1;
+	SDL_SemPost(dma_signal);
+	SDL_WaitThread(thread, NULL);
+	SDL_DestroySemaphore(dma_signal);
+
+	if (ring.played != ring.queued + ring.underruns)
+	{
+		printf("%d buffers: %u periods played, %u queued and %u underruns\n",
+			nbuffers, ring.played, ring.queued, ring.underruns);
+		++errors;
+	}
+	printf("%d buffers, %2d ms stalls: %u periods, %u underruns, %u late\n",
+		nbuffers, stall * PERIOD_MS, ring.played, ring.underruns, ring.late);
+	return ring.underruns;
+}
+
+int main(int argc, char *argv[])
+{
+	if ( SDL_Init(SDL_INIT_TIMER) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	// Init clamps the buffer count
+	if (WII_AudioRingInit(&ring, memory, 1, PERIOD) != WII_AUDIO_MIN_BUFFERS ||
+	    WII_AudioRingInit(&ring, memory, 100, PERIOD) != WII_AUDIO_MAX_BUFFERS)
+	{
+		printf("Buffer count wasn't clamped\n");
+		++errors;
+	}
+
+	// A long stall underruns a short ring but not a long one
+	Play(WII_AUDIO_DEFAULT_BUFFERS, 0);
+	if (Play(2, 5) == 0 || ring.late == 0)
+	{
+		printf("A 2 buffer ring should underrun on long stalls\n");
+		++errors;
+	}
+	if (Play(WII_AUDIO_MAX_BUFFERS, 5) != 0)
+	{
+		printf("An 8 buffer ring shouldn't underrun on stalls it can cover\n");
+		++errors;
+	}
+
+	if (errors)
+		printf("%d audio ring errors\n", errors);
+	else
+		printf("Audio ring test passed.\n");
+
+	SDL_Quit();
+	return (errors ? 1 : 0);
+}
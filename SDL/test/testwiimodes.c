@@ -0,0 +1,140 @@
+/* Test the Wii video backend's mode selection and on-screen scaling.
+   The mode code has no libogc dependencies, so it is compiled straight
+   into this program and runs on any host.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "../src/video/wii/SDL_wiimodes.c"
+
+/* The textured quad covers -320..320 x -240..240 when filling the TV */
+#define HALF_W	320
+#define HALF_H	240
+
+static int TestSelection(void)
+{
+	static const struct
+	{
+		int width, height, bpp;
+		int ok, tex_width, tex_height;
+		Uint32 tex_bytes;
+	} cases[] = {
+		{ 640, 480, 16, 1, 640, 480, 640 * 480 * 2 },
+		{ 320, 240, 8, 1, 320, 240, 320 * 240 * 2 },
+		{ 256, 224, 16, 1, 256, 224, 256 * 224 * 2 },
+		{ 384, 288, 32, 1, 384, 288, 384 * 288 * 4 },
+		{ 512, 448, 24, 1, 512, 448, 512 * 448 * 4 },
+		{ 1024, 1024, 32, 1, 1024, 1024, 1024 * 1024 * 4 },
+		{ 1, 1, 16, 1, 4, 4, 4 * 4 * 2 },
+		{ 317, 235, 16, 1, 320, 236, 320 * 236 * 2 },
+		{ 1021, 1022, 24, 1, 1024, 1024, 1024 * 1024 * 4 },
+		{ 1025, 768, 16, 0 },
+		{ 768, 1025, 16, 0 },
+		{ 0, 480, 16, 0 },
+		{ 640, -1, 16, 0 },
+		{ 640, 480, 15, 0 },
+		{ 640, 480, 0, 0 },
+	};
+	int i, errors = 0;
+
+	for (i = 0; i < SDL_arraysize(cases); i++)
+	{
+		WII_Mode mode;
+		int ok = (WII_SelectMode(&mode, cases[i].width, cases[i].height, cases[i].bpp) == 0);
+
+		if (ok != cases[i].ok)
+		{
+			printf("%dx%dx%d was %s\n", cases[i].width, cases[i].height, cases[i].bpp,
+				ok ? "accepted" : "rejected");
+			++errors;
+			continue;
+		}
+		if (!ok)
+			continue;
+		if (mode.tex_width != cases[i].tex_width ||
+		    mode.tex_height != cases[i].tex_height ||
+		    mode.tex_bytes != cases[i].tex_bytes)
+		{
+			printf("%dx%dx%d got a %dx%d texture of %u bytes, expected %dx%d of %u\n",
+				cases[i].width, cases[i].height, cases[i].bpp,
+				mode.tex_width, mode.tex_height, mode.tex_bytes,
+				cases[i].tex_width, cases[i].tex_height, cases[i].tex_bytes);
+			++errors;
+		}
+	}
+	return errors;
+}
+
+static int TestScaling(void)
+{
+	static const struct
+	{
+		int width, height, scaling;
+		int screen_w, screen_h;
+		int xscale, yscale;
+	} cases[] = {
+		// Stretching always fills the screen
+		{ 256, 224, WII_SCALE_STRETCH, 640, 480, 320, 240 },
+		{ 1024, 1024, WII_SCALE_STRETCH, 640, 528, 320, 240 },
+
+		// Whole multiples, centred
+		{ 320, 240, WII_SCALE_INTEGER, 640, 480, 320, 240 },
+		{ 256, 224, WII_SCALE_INTEGER, 640, 480, 256, 224 },
+		{ 384, 288, WII_SCALE_INTEGER, 640, 480, 192, 144 },
+		{ 200, 150, WII_SCALE_INTEGER, 640, 480, 300, 225 },
+		{ 256, 224, WII_SCALE_INTEGER, 640, 528, 256, 204 },
+
+		// Too big for any multiple: shrunk to fit instead
+		{ 1024, 1024, WII_SCALE_INTEGER, 640, 480, 240, 240 },
+
+		// Square pixels, touching two edges of the screen
+		{ 320, 240, WII_SCALE_ASPECT, 640, 480, 320, 240 },
+		{ 256, 224, WII_SCALE_ASPECT, 640, 480, 274, 240 },
+		{ 512, 448, WII_SCALE_ASPECT, 640, 480, 274, 240 },
+		{ 640, 200, WII_SCALE_ASPECT, 640, 480, 320, 100 },
+		{ 1024, 1024, WII_SCALE_ASPECT, 640, 480, 240, 240 },
+	};
+	int i, errors = 0;
+
+	for (i = 0; i < SDL_arraysize(cases); i++)
+	{
+		WII_Mode mode;
+		int xscale, yscale;
+
+		WII_SelectMode(&mode, cases[i].width, cases[i].height, 16);
+		WII_ScaleSquare(&mode, cases[i].scaling, cases[i].screen_w, cases[i].screen_h,
+			HALF_W, HALF_H, &xscale, &yscale);
+		if (xscale != cases[i].xscale || yscale != cases[i].yscale)
+		{
+			printf("%dx%d with scaling %d on %dx%d: square %dx%d, expected %dx%d\n",
+				cases[i].width, cases[i].height, cases[i].scaling,
+				cases[i].screen_w, cases[i].screen_h, xscale, yscale,
+				cases[i].xscale, cases[i].yscale);
+			++errors;
+		}
+	}
+	return errors;
+}
+
+int main(int argc, char *argv[])
+{
+	int errors = 0;
+
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	errors += TestSelection();
+	errors += TestScaling();
+
+	if (errors)
+		printf("%d mode tests failed\n", errors);
+	else
+		printf("All mode tests passed.\n");
+
+	SDL_Quit();
+	return (errors ? 1 : 0);
+}
@@ -0,0 +1,419 @@
+/* Test and benchmark the Wii video backend's tiled texture conversion.
+   The conversion core has no libogc dependencies, so it is compiled
+   straight into this program and runs on any host.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "../src/video/wii/SDL_wiitiles.c"
+#include "../src/video/wii/SDL_wiiring.c"
+
+#define WIDTH	640
+#define HEIGHT	480
+#define FRAMES	100
+
+static Uint8 frames[2][WIDTH * HEIGHT * 4];
+static Uint8 *source = frames[0];
+static Uint8 texture[WIDTH * HEIGHT * 4];
+static Uint8 reference[WIDTH * HEIGHT * 4];
+static Uint16 palette[256];
+static Uint32 flushed_bytes;
+static int flushed_runs;
+
+/* The per-pixel conversion the backend used to do */
+static void Ref_RGBAPixel(int width, int x, int y, Uint32 color)
+{
+	Uint32 offset = (((y >> 2) << 4) * width) + ((x >> 2) << 6) + (((y % 4 << 2) + x % 4) << 1);
+
+	reference[offset] = color & 0xFF;
+	reference[offset + 1] = (color >> 24) & 0xFF;
+	reference[offset + 32] = (color >> 16) & 0xFF;
+	reference[offset + 33] = (color >> 8) & 0xFF;
+}
+
+static void Ref_RGB565Pixel(int width, int x, int y, Uint16 color)
+{
+	Uint32 offset = (((y >> 2) << 3) * width) + ((x >> 2) << 5) + (((y % 4 << 2) + x % 4) << 1);
+
+	reference[offset] = (color >> 8) & 0xFF;
+	reference[offset + 1] = color & 0xFF;
+}
+
+/* width is that of the source; tile rows span it rounded up to whole tiles */
+static void Ref_UpdateRect(int bpp, int width, SDL_Rect *rect)
+{
+	int tiled = (width + 3) & ~3;
+	int i, j;
+	for (i = 0; i < rect->h; i++)
+	{
+		Uint8 *src = source + (width * bpp * (i + rect->y)) + (rect->x * bpp);
+		for (j = 0; j < rect->w; j++)
+		{
+			Uint8 *ptr = src + (j * bpp);
+			int x = rect->x + j, y = rect->y + i;
+			switch (bpp)
+			{
+			case 1:
+				Ref_RGB565Pixel(tiled, x, y, palette[*ptr]);
+				break;
+			case 2:
+				Ref_RGB565Pixel(tiled, x, y, (ptr[0] << 8) | ptr[1]);
+				break;
+			case 3:
+				Ref_RGBAPixel(tiled, x, y, (ptr[0] << 24) | (ptr[1] << 16) | (ptr[2] << 8) | 0xff);
+				break;
+			case 4:
+				Ref_RGBAPixel(tiled, x, y, (ptr[1] << 24) | (ptr[2] << 16) | (ptr[3] << 8) | ptr[0]);
+				break;
+			}
+		}
+	}
+}
+
+/* The full frame 16-bit retiling done by the old flipHWSurface_16_16 */
+static void Ref_Flip16(int width, int height)
+{
+	int h, w;
+	int pitch = width * 2;
+	Uint64 *dst = (Uint64 *) reference;
+	Uint64 *src1 = (Uint64 *) source;
+	Uint64 *src2 = (Uint64 *) (source + pitch);
+	Uint64 *src3 = (Uint64 *) (source + (pitch * 2));
+	Uint64 *src4 = (Uint64 *) (source + (pitch * 3));
+	int rowpitch = (pitch >> 3) * 3;
+
+	for (h = 0; h < height; h += 4)
+	{
+		for (w = 0; w < width; w += 4)
+		{
+			*dst++ = *src1++;
+			*dst++ = *src2++;
+			*dst++ = *src3++;
+			*dst++ = *src4++;
+		}
+		src1 += rowpitch;
+		src2 += rowpitch;
+		src3 += rowpitch;
+		src4 += rowpitch;
+	}
+}
+
+static void CountFlush(void *start, Uint32 len)
+{
+	flushed_bytes += len;
+	++flushed_runs;
+}
+
+static void RandomFill(Uint8 *buf, int len)
+{
+	int i;
+	for (i = 0; i < len; i++)
+		buf[i] = rand() & 0xFF;
+}
+
+static int TestConversion(int bpp, int width, int height)
+{
+	WII_TileTexture tex;
+	SDL_Rect full = { 0, 0, width, height };
+	int tilebytes = (bpp <= 2) ? 2 : 4;
+	int size = ((width + 3) & ~3) * ((height + 3) & ~3) * tilebytes;
+	int i, errors = 0;
+
+	RandomFill(source, width * height * bpp);
+	SDL_memset(texture, 0, sizeof(texture));
+	SDL_memset(reference, 0, sizeof(reference));
+
+	if (WII_InitTiles(&tex, texture, width, height, bpp) < 0)
+	{
+		printf("WII_InitTiles(%dx%d, %d) failed\n", width, height, bpp);
+		return 1;
+	}
+
+	Ref_UpdateRect(bpp, width, &full);
+	WII_UpdateTiles(&tex, source, width * bpp, palette, &full);
+	if (SDL_memcmp(texture, reference, size) != 0)
+	{
+		printf("%d bpp %dx%d: full frame differs from reference\n", bpp * 8, width, height);
+		++errors;
+	}
+
+	// Random partial updates must touch exactly the same bytes
+	for (i = 0; i < 200; i++)
+	{
+		SDL_Rect r;
+		r.x = rand() % width;
+		r.y = rand() % height;
+		r.w = 1 + rand() % (width - r.x);
+		r.h = 1 + rand() % (height - r.y);
+		RandomFill(source, width * height * bpp);
+
+		// The backend converts whole tiles, so feed the reference the same area
+		r.w = SDL_min((r.x + r.w + 3) & ~3, width) - (r.x & ~3);
+		r.h = SDL_min((r.y + r.h + 3) & ~3, height) - (r.y & ~3);
+		r.x &= ~3;
+		r.y &= ~3;
+
+		Ref_UpdateRect(bpp, width, &r);
+		WII_UpdateTiles(&tex, source, width * bpp, palette, &r);
+		if (SDL_memcmp(texture, reference, size) != 0)
+		{
+			printf("%d bpp %dx%d: rect %d,%d %dx%d differs from reference\n",
+				bpp * 8, width, height, r.x, r.y, r.w, r.h);
+			++errors;
+			break;
+		}
+	}
+	return errors;
+}
+
+static int TestDirtyTracking(void)
+{
+	WII_TileTexture tex;
+	SDL_Rect full = { 0, 0, WIDTH, HEIGHT };
+	int errors = 0;
+	int changed;
+
+	RandomFill(source, WIDTH * HEIGHT * 2);
+	SDL_memset(texture, 0, sizeof(texture));
+	WII_InitTiles(&tex, texture, WIDTH, HEIGHT, 2);
+
+	// A fresh texture flushes everything once
+	flushed_bytes = 0;
+	WII_UpdateTiles(&tex, source, WIDTH * 2, palette, &full);
+	WII_FlushTiles(&tex, CountFlush);
+	if (flushed_bytes != WIDTH * HEIGHT * 2)
+	{
+		printf("Initial flush covered %u bytes, expected %d\n", flushed_bytes, WIDTH * HEIGHT * 2);
+		++errors;
+	}
+
+	// An unchanged full frame touches nothing
+	flushed_bytes = 0;
+	changed = WII_UpdateTiles(&tex, source, WIDTH * 2, palette, &full);
+	WII_FlushTiles(&tex, CountFlush);
+	if (changed != 0 || flushed_bytes != 0)
+	{
+		printf("Static frame changed %d tiles, flushed %u bytes\n", changed, flushed_bytes);
+		++errors;
+	}
+
+	// Nor does an unchanged area
+	{
+		SDL_Rect r = { 100, 100, 64, 64 };
+		flushed_bytes = 0;
+		changed = WII_UpdateTiles(&tex, source, WIDTH * 2, palette, &r);
+		WII_FlushTiles(&tex, CountFlush);
+		if (changed != 0 || flushed_bytes != 0)
+		{
+			printf("Static area changed %d tiles, flushed %u bytes\n", changed, flushed_bytes);
+			++errors;
+		}
+	}
+
+	// One pixel dirties one tile, which is one cache line
+	source[(123 * WIDTH + 321) * 2] ^= 0xFF;
+	{
+		SDL_Rect r = { 300, 100, 64, 64 };
+		flushed_bytes = 0;
+		changed = WII_UpdateTiles(&tex, source, WIDTH * 2, palette, &r);
+		WII_FlushTiles(&tex, CountFlush);
+		if (changed != 1 || flushed_bytes != WII_TILE_BYTES_565)
+		{
+			printf("Single pixel changed %d tiles, flushed %u bytes\n", changed, flushed_bytes);
+			++errors;
+		}
+	}
+
+	// Neighbouring tiles are flushed as a single run
+	source[(200 * WIDTH + 4) * 2] ^= 0xFF;
+	source[(200 * WIDTH + 8) * 2] ^= 0xFF;
+	source[(200 * WIDTH + 12) * 2] ^= 0xFF;
+	{
+		SDL_Rect r = { 0, 196, 64, 8 };
+		flushed_runs = 0;
+		WII_UpdateTiles(&tex, source, WIDTH * 2, palette, &r);
+		WII_FlushTiles(&tex, CountFlush);
+		if (flushed_runs != 1)
+		{
+			printf("Adjacent tiles were flushed in %d runs\n", flushed_runs);
+			++errors;
+		}
+	}
+
+	// Marked tiles are converted later, and only once
+	source[(300 * WIDTH + 40) * 2] ^= 0xFF;
+	source[(400 * WIDTH + 600) * 2] ^= 0xFF;
+	{
+		SDL_Rect r1 = { 40, 300, 1, 1 };
+		SDL_Rect r2 = { 600, 400, 1, 1 };
+		WII_MarkTiles(&tex, &r1);
+		WII_MarkTiles(&tex, &r2);
+	}
+	changed = WII_UpdateMarkedTiles(&tex, source, WIDTH * 2, palette);
+	changed += WII_UpdateMarkedTiles(&tex, source, WIDTH * 2, palette);
+	if (changed != 2)
+	{
+		printf("Marked tiles changed %d tiles, expected 2\n", changed);
+		++errors;
+	}
+
+	// Marking the whole frame only stores the tiles that changed
+	WII_FlushTiles(&tex, CountFlush);
+	source[(10 * WIDTH + 10) * 2] ^= 0xFF;
+	WII_MarkTiles(&tex, &full);
+	flushed_bytes = 0;
+	changed = WII_UpdateMarkedTiles(&tex, source, WIDTH * 2, palette);
+	WII_FlushTiles(&tex, CountFlush);
+	if (changed != 1 || flushed_bytes != WII_TILE_BYTES_565)
+	{
+		printf("Marked frame changed %d tiles, flushed %u bytes\n", changed, flushed_bytes);
+		++errors;
+	}
+	return errors;
+}
+
+static double MPixels(Uint32 ms)
+{
+	return ((double) WIDTH * HEIGHT * FRAMES) / ((ms ? ms : 1) * 1000.0);
+}
+
+static void Benchmark(int bpp)
+{
+	WII_TileTexture tex;
+	SDL_Rect full = { 0, 0, WIDTH, HEIGHT };
+	Uint32 start, ref_ms, changed_ms, static_ms;
+	int i;
+
+	RandomFill(frames[0], WIDTH * HEIGHT * bpp);
+	RandomFill(frames[1], WIDTH * HEIGHT * bpp);
+	WII_InitTiles(&tex, texture, WIDTH, HEIGHT, bpp);
+
+	// Alternate between two frames so every tile changes every time
+	start = SDL_GetTicks();
+	for (i = 0; i < FRAMES; i++)
+	{
+		source = frames[i & 1];
+		if (bpp == 2)
+			Ref_Flip16(WIDTH, HEIGHT);
+		else
+			Ref_UpdateRect(bpp, WIDTH, &full);
+	}
+	ref_ms = SDL_GetTicks() - start;
+
+	start = SDL_GetTicks();
+	for (i = 0; i < FRAMES; i++)
+	{
+		source = frames[i & 1];
+		WII_UpdateTiles(&tex, source, WIDTH * bpp, palette, &full);
+		WII_FlushTiles(&tex, CountFlush);
+	}
+	changed_ms = SDL_GetTicks() - start;
+
+	flushed_bytes = 0;
+	source = frames[(FRAMES - 1) & 1];
+	start = SDL_GetTicks();
+	for (i = 0; i < FRAMES; i++)
+	{
+		WII_UpdateTiles(&tex, source, WIDTH * bpp, palette, &full);
+		WII_FlushTiles(&tex, CountFlush);
+	}
+	static_ms = SDL_GetTicks() - start;
+
+	printf("%2d bpp: old %7.1f MPix/s, changing frames %7.1f MPix/s, static frames %7.1f MPix/s (%u bytes flushed)\n",
+		bpp * 8, MPixels(ref_ms), MPixels(changed_ms), MPixels(static_ms), flushed_bytes);
+}
+
+/* What SDL_Flip does with a linear screen: mark all of it in every
+   texture of the ring, bring the back texture up to date, flush it and
+   hand it to the flip thread, which picks it up.
+*/
+static void Flip(WII_TileTexture *ringtiles, WII_FrameRing *ring, int bpp)
+{
+	SDL_Rect full = { 0, 0, WIDTH, HEIGHT };
+	int i, fresh;
+
+	for (i = 0; i < WII_RING_SLOTS; i++)
+		WII_MarkTiles(&ringtiles[i], &full);
+	WII_UpdateMarkedTiles(&ringtiles[ring->back], source, WIDTH * bpp, palette);
+	WII_FlushTiles(&ringtiles[ring->back], CountFlush);
+	WII_RingPublish(ring);
+	WII_RingAcquire(ring, &fresh);
+}
+
+/* Flipping an unchanged screen must flush next to nothing */
+static int BenchmarkFlip(int bpp)
+{
+	static Uint8 textures[WII_RING_SLOTS][WIDTH * HEIGHT * 4];
+	static WII_TileTexture ringtiles[WII_RING_SLOTS];
+	WII_FrameRing ring;
+	Uint32 start, ms;
+	int i;
+
+	RandomFill(frames[0], WIDTH * HEIGHT * bpp);
+	source = frames[0];
+	for (i = 0; i < WII_RING_SLOTS; i++)
+		WII_InitTiles(&ringtiles[i], textures[i], WIDTH, HEIGHT, bpp);
+	WII_RingInit(&ring);
+
+	// The first flip into each texture converts and flushes all of it
+	for (i = 0; i < WII_RING_SLOTS; i++)
+		Flip(ringtiles, &ring, bpp);
+
+	flushed_bytes = 0;
+	start = SDL_GetTicks();
+	for (i = 0; i < FRAMES; i++)
+		Flip(ringtiles, &ring, bpp);
+	ms = SDL_GetTicks() - start;
+
+	printf("%2d bpp: SDL_Flip of an unchanged screen %7.1f MPix/s (%u bytes flushed)\n",
+		bpp * 8, MPixels(ms), flushed_bytes);
+	if (flushed_bytes != 0)
+	{
+		printf("Flipping an unchanged screen flushed %u bytes\n", flushed_bytes);
+		return 1;
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	int errors = 0;
+	int bpp, i;
+
+	if ( SDL_Init(SDL_INIT_TIMER) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	for (i = 0; i < 256; i++)
+		palette[i] = (Uint16) (i * 257);
+
+	for (bpp = 1; bpp <= 4; bpp++)
+	{
+		errors += TestConversion(bpp, WIDTH, HEIGHT);
+		errors += TestConversion(bpp, WIDTH / 2, HEIGHT / 2);
+
+		// Sizes that end partway through a tile
+		errors += TestConversion(bpp, WIDTH - 3, HEIGHT - 1);
+		errors += TestConversion(bpp, 13, 7);
+		errors += TestConversion(bpp, 5, 3);
+		errors += TestConversion(bpp, 1, 1);
+	}
+	errors += TestDirtyTracking();
+
+	printf("%d frames of %dx%d:\n", FRAMES, WIDTH, HEIGHT);
+	for (bpp = 1; bpp <= 4; bpp++)
+		Benchmark(bpp);
+	for (bpp = 1; bpp <= 4; bpp++)
+		errors += BenchmarkFlip(bpp);
+
+	if (errors)
+		printf("%d tiled conversion tests failed\n", errors);
+	else
+		printf("All tiled conversion tests passed.\n");
+
+	SDL_Quit();
+	return (errors ? 1 : 0);
+}
@@ -414,15 +414,22 @@ int _filledRectAlpha(SDL_Surface * surface, Sint16 x1, Sint16 y1, Sint16 x2, Sin
     case 1:{			/* Assuming 8-bpp */
 	    Uint8 *row, *pixel;
 	    Uint8 dR, dG, dB;
+	    Uint8 blended[256], known[256];
 
 	    Uint8 sR = surface->format->palette->colors[color].r;
 	    Uint8 sG = surface->format->palette->colors[color].g;
 	    Uint8 sB = surface->format->palette->colors[color].b;
 
+	    /* Every pixel of one index blends to the same index, so map each once */
+	    memset(known, 0, sizeof(known));
 	    for (y = y1; y <= y2; y++) {
 		row = (Uint8 *) surface->pixels + y * surface->pitch;
 		for (x = x1; x <= x2; x++) {
 		    pixel = row + x;
+		    if (known[*pixel]) {
+			*pixel = blended[*pixel];
+			continue;
+		    }
 
 		    dR = surface->format->palette->colors[*pixel].r;
 		    dG = surface->format->palette->colors[*pixel].g;
@@ -432,7 +439,9 @@ int _filledRectAlpha(SDL_Surface * surface, Sint16 x1, Sint16 y1, Sint16 x2, Sin
 		    dG = dG + ((sG - dG) * alpha >> 8);
 		    dB = dB + ((sB - dB) * alpha >> 8);
 
-		    *pixel = SDL_MapRGB(surface->format, dR, dG, dB);
+		    known[*pixel] = 1;
+		    blended[*pixel] = SDL_MapRGB(surface->format, dR, dG, dB);
+		    *pixel = blended[*pixel];
 		}
 	    }
 	}
@@ -776,7 +785,7 @@ int hlineColorStore(SDL_Surface * dst, Sint16 x1, Sint16 x2, Sint16 y, Uint32 co
 	 */
 	switch (dst->format->BytesPerPixel) {
 	case 1:
-	    memset(pixel, color, dx);
+	    memset(pixel, color, dx + 1);
 	    break;
 	case 2:
 	    pixellast = pixel + dx + dx;
@@ -925,7 +934,7 @@ int hlineColor(SDL_Surface * dst, Sint16 x1, Sint16 x2, Sint16 y, Uint32 color)
 	 */
 	switch (dst->format->BytesPerPixel) {
 	case 1:
-	    memset(pixel, color, dx);
+	    memset(pixel, color, dx + 1);
 	    break;
 	case 2:
 	    pixellast = pixel + dx + dx;
@@ -1537,7 +1546,10 @@ int boxRGBA(SDL_Surface * dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8
 
 #define ABS(a) (((a)<0) ? -(a) : (a))
 
-int lineColor(SDL_Surface * dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint32 color)
+/* Line between clipped end points that are not on one row or column,   */
+/* color in destination format. The surface has to be locked already.  */
+
+static void _drawLine(SDL_Surface * dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint32 color, Uint8 alpha)
 {
     int pixx, pixy;
     int x, y;
@@ -1546,34 +1558,6 @@ int lineColor(SDL_Surface * dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uin
     int sx, sy;
     int swaptmp;
     Uint8 *pixel;
-    Uint8 *colorptr;
-
-    /*
-     * Clip line and test if we have to draw 
-     */
-    if (!(clipLine(dst, &x1, &y1, &x2, &y2))) {
-	return (0);
-    }
-
-    /*
-     * Test for special cases of straight lines or single point 
-     */
-    if (x1 == x2) {
-	if (y1 < y2) {
-	    return (vlineColor(dst, x1, y1, y2, color));
-	} else if (y1 > y2) {
-	    return (vlineColor(dst, x1, y2, y1, color));
-	} else {
-	    return (pixelColor(dst, x1, y1, color));
-	}
-    }
-    if (y1 == y2) {
-	if (x1 < x2) {
-	    return (hlineColor(dst, x1, x2, y1, color));
-	} else if (x1 > x2) {
-	    return (hlineColor(dst, x2, x1, y1, color));
-	}
-    }
 
     /*
      * Variable setup 
@@ -1583,32 +1567,15 @@ int lineColor(SDL_Surface * dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uin
     sx = (dx >= 0) ? 1 : -1;
     sy = (dy >= 0) ? 1 : -1;
 
-    /* Lock surface */
-    if (SDL_MUSTLOCK(dst)) {
-	if (SDL_LockSurface(dst) < 0) {
-	    return (-1);
-	}
-    }
-
     /*
      * Check for alpha blending 
      */
-    if ((color & 255) == 255) {
+    if (alpha == 255) {
 
 	/*
 	 * No alpha blending - use fast pixel routines 
 	 */
 
-	/*
-	 * Setup color 
-	 */
-	colorptr = (Uint8 *) & color;
-	if (SDL_BYTEORDER == SDL_BIG_ENDIAN) {
-	    color = SDL_MapRGBA(dst->format, colorptr[0], colorptr[1], colorptr[2], colorptr[3]);
-	} else {
-	    color = SDL_MapRGBA(dst->format, colorptr[3], colorptr[2], colorptr[1], colorptr[0]);
-	}
-
 	/*
 	 * More variable setup 
 	 */
@@ -1698,7 +1665,7 @@ int lineColor(SDL_Surface * dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uin
 	    int d = ay - (ax >> 1);
 
 	    while (x != x2) {
-		pixelColorNolock (dst, x, y, color);
+		_putPixelAlpha(dst, x, y, color, alpha);
 		if (d > 0 || (d == 0 && sx == 1)) {
 		    y += sy;
 		    d -= ax;
@@ -1710,7 +1677,7 @@ int lineColor(SDL_Surface * dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uin
 	    int d = ax - (ay >> 1);
 
 	    while (y != y2) {
-		pixelColorNolock (dst, x, y, color);
+		_putPixelAlpha(dst, x, y, color, alpha);
 		if (d > 0 || ((d == 0) && (sy == 1))) {
 		    x += sx;
 		    d -= ay;
@@ -1719,9 +1686,62 @@ int lineColor(SDL_Surface * dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uin
 		d += ax;
 	    }
 	}
-	pixelColorNolock (dst, x, y, color);
+	_putPixelAlpha(dst, x, y, color, alpha);
 
     }
+}
+
+int lineColor(SDL_Surface * dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint32 color)
+{
+    Uint8 alpha;
+    Uint32 mcolor;
+
+    /*
+     * Clip line and test if we have to draw 
+     */
+    if (!(clipLine(dst, &x1, &y1, &x2, &y2))) {
+	return (0);
+    }
+
+    /*
+     * Test for special cases of straight lines or single point 
+     */
+    if (x1 == x2) {
+	if (y1 < y2) {
+	    return (vlineColor(dst, x1, y1, y2, color));
+	} else if (y1 > y2) {
+	    return (vlineColor(dst, x1, y2, y1, color));
+	} else {
+	    return (pixelColor(dst, x1, y1, color));
+	}
+    }
+    if (y1 == y2) {
+	if (x1 < x2) {
+	    return (hlineColor(dst, x1, x2, y1, color));
+	} else if (x1 > x2) {
+	    return (hlineColor(dst, x2, x1, y1, color));
+	}
+    }
+
+    /* Lock surface */
+    if (SDL_MUSTLOCK(dst)) {
+	if (SDL_LockSurface(dst) < 0) {
+	    return (-1);
+	}
+    }
+
+    /*
+     * Setup color 
+     */
+    alpha = color & 0x000000ff;
+    mcolor =
+	SDL_MapRGBA(dst->format, (color & 0xff000000) >> 24,
+		    (color & 0x00ff0000) >> 16, (color & 0x0000ff00) >> 8, alpha);
+
+    /*
+     * Draw 
+     */
+    _drawLine(dst, x1, y1, x2, y2, mcolor, alpha);
 
     /* Unlock surface */
     if (SDL_MUSTLOCK(dst)) {
@@ -3815,146 +3835,255 @@ int aapolygonRGBA(SDL_Surface * dst, const Sint16 * vx, const Sint16 * vy, int n
 
 /* ---- Filled Polygon */
 
-int gfxPrimitivesCompareInt(const void *a, const void *b);
+/* Polygon edge for the scanline fill */
 
-/* Global vertex array to use if optional parameters are not given in polygon calls. */
-static int *gfxPrimitivesPolyIntsGlobal = NULL;
-static int gfxPrimitivesPolyAllocatedGlobal = 0;
+typedef struct {
+    int y1, y2;			/* First and last scanline crossed */
+    int x;			/* Crossing on the current scanline (16.16) */
+    int xstep;			/* (65536 / dy) * dx, added every scanline */
+    int dx, dy;
+    int rem, remstep;		/* 65536 * (y - y1) % dy and 65536 % dy */
+} gfxPrimitivesEdge;
 
-/* (Note: The last two parameters are optional; but required for multithreaded operation.) */  
+int _texturedHLine(SDL_Surface * dst, Sint16 x1, Sint16 x2, Sint16 y,SDL_Surface *texture,int texture_dx,int texture_dy);
 
-int filledPolygonColorMT(SDL_Surface * dst, const Sint16 * vx, const Sint16 * vy, int n, Uint32 color, int **polyInts, int *polyAllocated)
+/* Number of edges for which no memory needs to be allocated */
+#define GFX_POLYGON_STACK_EDGES 64
+
+/* Helper qsort callback sorting edges by their first scanline */
+
+static int gfxPrimitivesCompareEdge(const void *a, const void *b)
+{
+    return ((const gfxPrimitivesEdge *) a)->y1 - ((const gfxPrimitivesEdge *) b)->y1;
+}
+
+/*
+ * Get room for n edges: in the caller's cache if given, grown as needed,
+ * else on the stack or from the heap. Returns NULL when out of memory.
+ */
+static gfxPrimitivesEdge *_polygonEdges(int n, gfxPrimitivesEdge *local, int **polyInts, int *polyAllocated)
+{
+    int size = n * (sizeof(gfxPrimitivesEdge) / sizeof(int));
+    int *ints;
+
+    if ((polyInts == NULL) || (polyAllocated == NULL)) {
+	if (n <= GFX_POLYGON_STACK_EDGES) {
+	    return (local);
+	}
+	return ((gfxPrimitivesEdge *) malloc(sizeof(gfxPrimitivesEdge) * n));
+    }
+
+    /*
+     * Only grow the cache 
+     */
+    ints = *polyInts;
+    if ((ints == NULL) || (*polyAllocated < size)) {
+	ints = (int *) realloc(ints, sizeof(int) * size);
+	if (ints == NULL) {
+	    free(*polyInts);
+	    *polyInts = NULL;
+	    *polyAllocated = 0;
+	    return (NULL);
+	}
+	*polyInts = ints;
+	*polyAllocated = size;
+    }
+    return ((gfxPrimitivesEdge *) ints);
+}
+
+/*
+ * Fill a polygon one scanline at a time with a sorted edge table and a list of
+ * the edges crossing the scanline, kept sorted by x. The crossings are those
+ * the old per-scanline intersection gave, ((65536 * (y - y1)) / dy) * dx + 65536 * x1,
+ * stepped exactly, so spans and pixels are the same. Spans go to hlineColor, or to
+ * _texturedHLine if a texture is given.
+ */
+static int _scanPolygon(SDL_Surface * dst, const Sint16 * vx, const Sint16 * vy, int n, gfxPrimitivesEdge * edges,
+			Uint32 color, SDL_Surface * texture, int texture_dx, int texture_dy)
 {
     int result;
-    int i;
+    int i, j;
     int y, xa, xb;
-    int miny, maxy;
+    int miny, maxy, top, bottom;
     int x1, y1;
     int x2, y2;
     int ind1, ind2;
-    int ints;
-    int *gfxPrimitivesPolyInts = NULL;
-    int gfxPrimitivesPolyAllocated = 0;
+    int nedges, next, active;
+    int num;
+    gfxPrimitivesEdge edge;
 
     /*
-     * Check visibility of clipping rectangle
+     * Determine Y maxima 
      */
-    if ((dst->clip_rect.w==0) || (dst->clip_rect.h==0)) {
-     return(0);
+    miny = vy[0];
+    maxy = vy[0];
+    for (i = 1; (i < n); i++) {
+	if (vy[i] < miny) {
+	    miny = vy[i];
+	} else if (vy[i] > maxy) {
+	    maxy = vy[i];
+	}
     }
 
     /*
-     * Sanity check number of edges
+     * Edge table: each edge covers y1 up to the scanline before y2, or up to
+     * y2 itself on the last scanline of the polygon; horizontal edges are left out 
      */
-    if (n < 3) {
-	return -1;
+    nedges = 0;
+    for (i = 0; (i < n); i++) {
+	if (!i) {
+	    ind1 = n - 1;
+	    ind2 = 0;
+	} else {
+	    ind1 = i - 1;
+	    ind2 = i;
+	}
+	y1 = vy[ind1];
+	y2 = vy[ind2];
+	if (y1 < y2) {
+	    x1 = vx[ind1];
+	    x2 = vx[ind2];
+	} else if (y1 > y2) {
+	    y2 = vy[ind1];
+	    y1 = vy[ind2];
+	    x2 = vx[ind1];
+	    x1 = vx[ind2];
+	} else {
+	    continue;
+	}
+	edges[nedges].y1 = y1;
+	edges[nedges].y2 = (y2 == maxy) ? y2 : y2 - 1;
+	edges[nedges].x = 65536 * x1;
+	edges[nedges].dx = x2 - x1;
+	edges[nedges].dy = y2 - y1;
+	edges[nedges].xstep = (65536 / (y2 - y1)) * (x2 - x1);
+	edges[nedges].rem = 0;
+	edges[nedges].remstep = 65536 % (y2 - y1);
+	nedges++;
     }
-     
+    qsort(edges, nedges, sizeof(gfxPrimitivesEdge), gfxPrimitivesCompareEdge);
+
     /*
-     * Map polygon cache  
+     * Only scanlines inside the clipping rectangle draw anything 
      */
-    if ((polyInts==NULL) || (polyAllocated==NULL)) {
-       /* Use global cache */
-       gfxPrimitivesPolyInts = gfxPrimitivesPolyIntsGlobal;
-       gfxPrimitivesPolyAllocated = gfxPrimitivesPolyAllocatedGlobal;
-    } else {
-       /* Use local cache */
-       gfxPrimitivesPolyInts = *polyInts;
-       gfxPrimitivesPolyAllocated = *polyAllocated;
+    top = dst->clip_rect.y;
+    bottom = dst->clip_rect.y + dst->clip_rect.h - 1;
+    if (top < miny) {
+	top = miny;
+    }
+    if (bottom > maxy) {
+	bottom = maxy;
     }
 
     /*
-     * Allocate temp array, only grow array 
+     * Draw, scanning y. The active edges are edges[0..active), the ones
+     * still to come edges[next..nedges). 
      */
-    if (!gfxPrimitivesPolyAllocated) {
-	gfxPrimitivesPolyInts = (int *) malloc(sizeof(int) * n);
-	gfxPrimitivesPolyAllocated = n;
-    } else {
-	if (gfxPrimitivesPolyAllocated < n) {
-	    gfxPrimitivesPolyInts = (int *) realloc(gfxPrimitivesPolyInts, sizeof(int) * n);
-	    gfxPrimitivesPolyAllocated = n;
+    result = 0;
+    next = 0;
+    active = 0;
+    for (y = top; (y <= bottom); y++) {
+	/*
+	 * Drop the edges that ended, keeping the order 
+	 */
+	for (i = 0, j = 0; (i < active); i++) {
+	    if (edges[i].y2 >= y) {
+		edges[j++] = edges[i];
+	    }
 	}
-    }
+	active = j;
 
-    /*
-     * Check temp array
-     */
-    if (gfxPrimitivesPolyInts==NULL) {        
-      gfxPrimitivesPolyAllocated = 0;
+	/*
+	 * Add the edges starting here, or above the clipping rectangle 
+	 */
+	while ((next < nedges) && (edges[next].y1 <= y)) {
+	    edge = edges[next++];
+	    if (edge.y2 < y) {
+		continue;
+	    }
+	    if (edge.y1 < y) {
+		num = 65536 * (y - edge.y1);
+		edge.x += (num / edge.dy) * edge.dx;
+		edge.rem = num % edge.dy;
+	    }
+	    edges[active++] = edge;
+	}
+
+	/*
+	 * Insertion sort by x, the order changes little between scanlines 
+	 */
+	for (i = 1; (i < active); i++) {
+	    if (edges[i].x < edges[i - 1].x) {
+		edge = edges[i];
+		for (j = i; (j > 0) && (edges[j - 1].x > edge.x); j--) {
+		    edges[j] = edges[j - 1];
+		}
+		edges[j] = edge;
+	    }
+	}
+
+	for (i = 0; (i + 1 < active); i += 2) {
+	    xa = edges[i].x + 1;
+	    xa = (xa >> 16) + ((xa & 32768) >> 15);
+	    xb = edges[i + 1].x - 1;
+	    xb = (xb >> 16) + ((xb & 32768) >> 15);
+	    if (texture) {
+		result |= _texturedHLine(dst, xa, xb, y, texture, texture_dx, texture_dy);
+	    } else {
+		result |= hlineColor(dst, xa, xb, y, color);
+	    }
+	}
+
+	/*
+	 * Step to the next scanline 
+	 */
+	for (i = 0; (i < active); i++) {
+	    edges[i].x += edges[i].xstep;
+	    edges[i].rem += edges[i].remstep;
+	    if (edges[i].rem >= edges[i].dy) {
+		edges[i].rem -= edges[i].dy;
+		edges[i].x += edges[i].dx;
+	    }
+	}
     }
 
+    return (result);
+}
+
+/* (Note: The last two parameters are optional; they keep the edge memory between calls.) */  
+
+int filledPolygonColorMT(SDL_Surface * dst, const Sint16 * vx, const Sint16 * vy, int n, Uint32 color, int **polyInts, int *polyAllocated)
+{
+    int result;
+    gfxPrimitivesEdge local[GFX_POLYGON_STACK_EDGES];
+    gfxPrimitivesEdge *edges;
+
     /*
-     * Update cache variables
+     * Check visibility of clipping rectangle
      */
-    if ((polyInts==NULL) || (polyAllocated==NULL)) { 
-     gfxPrimitivesPolyIntsGlobal =  gfxPrimitivesPolyInts;
-     gfxPrimitivesPolyAllocatedGlobal = gfxPrimitivesPolyAllocated;
-    } else {
-     *polyInts = gfxPrimitivesPolyInts;
-     *polyAllocated = gfxPrimitivesPolyAllocated;
+    if ((dst->clip_rect.w==0) || (dst->clip_rect.h==0)) {
+     return(0);
     }
 
     /*
-     * Check temp array again
+     * Sanity check number of edges
      */
-    if (gfxPrimitivesPolyInts==NULL) {        
-	return(-1);
+    if (n < 3) {
+	return -1;
     }
-
+     
     /*
-     * Determine Y maxima 
+     * Get edge memory 
      */
-    miny = vy[0];
-    maxy = vy[0];
-    for (i = 1; (i < n); i++) {
-	if (vy[i] < miny) {
-	    miny = vy[i];
-	} else if (vy[i] > maxy) {
-	    maxy = vy[i];
-	}
+    edges = _polygonEdges(n, local, polyInts, polyAllocated);
+    if (edges == NULL) {
+	return (-1);
     }
 
-    /*
-     * Draw, scanning y 
-     */
-    result = 0;
-    for (y = miny; (y <= maxy); y++) {
-	ints = 0;
-	for (i = 0; (i < n); i++) {
-	    if (!i) {
-		ind1 = n - 1;
-		ind2 = 0;
-	    } else {
-		ind1 = i - 1;
-		ind2 = i;
-	    }
-	    y1 = vy[ind1];
-	    y2 = vy[ind2];
-	    if (y1 < y2) {
-		x1 = vx[ind1];
-		x2 = vx[ind2];
-	    } else if (y1 > y2) {
-		y2 = vy[ind1];
-		y1 = vy[ind2];
-		x2 = vx[ind1];
-		x1 = vx[ind2];
-	    } else {
-		continue;
-	    }
-	    if ( ((y >= y1) && (y < y2)) || ((y == maxy) && (y > y1) && (y <= y2)) ) {
-		gfxPrimitivesPolyInts[ints++] = ((65536 * (y - y1)) / (y2 - y1)) * (x2 - x1) + (65536 * x1);
-	    } 	    
-	}
-	
-	qsort(gfxPrimitivesPolyInts, ints, sizeof(int), gfxPrimitivesCompareInt);
+    result = _scanPolygon(dst, vx, vy, n, edges, color, NULL, 0, 0);
 
-	for (i = 0; (i < ints); i += 2) {
-	    xa = gfxPrimitivesPolyInts[i] + 1;
-	    xa = (xa >> 16) + ((xa & 32768) >> 15);
-	    xb = gfxPrimitivesPolyInts[i+1] - 1;
-	    xb = (xb >> 16) + ((xb & 32768) >> 15);
-	    result |= hlineColor(dst, xa, xb, y, color);
-	}
+    if ((edges != local) && ((polyInts == NULL) || (polyAllocated == NULL))) {
+	free(edges);
     }
 
     return (result);
@@ -4120,14 +4249,9 @@ int texturedPolygonMT(SDL_Surface * dst, const Sint16 * vx, const Sint16 * vy, i
 {
     int result;
     int i;
-    int y, xa, xb;
     int minx,maxx,miny, maxy;
-    int x1, y1;
-    int x2, y2;
-    int ind1, ind2;
-    int ints;
-    int *gfxPrimitivesPolyInts = NULL;
-    int gfxPrimitivesPolyAllocated = 0;
+    gfxPrimitivesEdge local[GFX_POLYGON_STACK_EDGES];
+    gfxPrimitivesEdge *edges;
 
     /*
      * Check visibility of clipping rectangle
@@ -4142,57 +4266,6 @@ int texturedPolygonMT(SDL_Surface * dst, const Sint16 * vx, const Sint16 * vy, i
     if (n < 3) {
 	return -1;
     }
-     
-    /*
-     * Map polygon cache  
-     */
-    if ((polyInts==NULL) || (polyAllocated==NULL)) {
-       /* Use global cache */
-       gfxPrimitivesPolyInts = gfxPrimitivesPolyIntsGlobal;
-       gfxPrimitivesPolyAllocated = gfxPrimitivesPolyAllocatedGlobal;
-    } else {
-       /* Use local cache */
-       gfxPrimitivesPolyInts = *polyInts;
-       gfxPrimitivesPolyAllocated = *polyAllocated;
-    }
-
-    /*
-     * Allocate temp array, only grow array 
-     */
-    if (!gfxPrimitivesPolyAllocated) {
-	gfxPrimitivesPolyInts = (int *) malloc(sizeof(int) * n);
-	gfxPrimitivesPolyAllocated = n;
-    } else {
-	if (gfxPrimitivesPolyAllocated < n) {
-	    gfxPrimitivesPolyInts = (int *) realloc(gfxPrimitivesPolyInts, sizeof(int) * n);
-	    gfxPrimitivesPolyAllocated = n;
-	}
-    }
-
-    /*
-     * Check temp array
-     */
-    if (gfxPrimitivesPolyInts==NULL) {        
-      gfxPrimitivesPolyAllocated = 0;
-    }
-
-    /*
-     * Update cache variables
-     */
-    if ((polyInts==NULL) || (polyAllocated==NULL)) { 
-     gfxPrimitivesPolyIntsGlobal =  gfxPrimitivesPolyInts;
-     gfxPrimitivesPolyAllocatedGlobal = gfxPrimitivesPolyAllocated;
-    } else {
-     *polyInts = gfxPrimitivesPolyInts;
-     *polyAllocated = gfxPrimitivesPolyAllocated;
-    }
-
-    /*
-     * Check temp array again
-     */
-    if (gfxPrimitivesPolyInts==NULL) {        
-	return(-1);
-    }
 
     /*
      * Determine X,Y minima,maxima 
@@ -4219,49 +4292,19 @@ int texturedPolygonMT(SDL_Surface * dst, const Sint16 * vx, const Sint16 * vy, i
     if (maxy <0 || miny > dst->h){
       return -1;
     }
-    
+
     /*
-     * Draw, scanning y 
+     * Get edge memory 
      */
-    result = 0;
-    for (y = miny; (y <= maxy); y++) {
-	ints = 0;
-	for (i = 0; (i < n); i++) {
-	    if (!i) {
-		ind1 = n - 1;
-		ind2 = 0;
-	    } else {
-		ind1 = i - 1;
-		ind2 = i;
-	    }
-	    y1 = vy[ind1];
-	    y2 = vy[ind2];
-	    if (y1 < y2) {
-		x1 = vx[ind1];
-		x2 = vx[ind2];
-	    } else if (y1 > y2) {
-		y2 = vy[ind1];
-		y1 = vy[ind2];
-		x2 = vx[ind1];
-		x1 = vx[ind2];
-	    } else {
-		continue;
-	    }
-	    if ( ((y >= y1) && (y < y2)) || ((y == maxy) && (y > y1) && (y <= y2)) ) {
-		gfxPrimitivesPolyInts[ints++] = ((65536 * (y - y1)) / (y2 - y1)) * (x2 - x1) + (65536 * x1);
-	    } 
-	    
-	}
-	
-	qsort(gfxPrimitivesPolyInts, ints, sizeof(int), gfxPrimitivesCompareInt);
+    edges = _polygonEdges(n, local, polyInts, polyAllocated);
+    if (edges == NULL) {
+	return (-1);
+    }
 
-	for (i = 0; (i < ints); i += 2) {
-	    xa = gfxPrimitivesPolyInts[i] + 1;
-	    xa = (xa >> 16) + ((xa & 32768) >> 15);
-	    xb = gfxPrimitivesPolyInts[i+1] - 1;
-	    xb = (xb >> 16) + ((xb & 32768) >> 15);
-	    result |= _texturedHLine(dst, xa, xb, y, texture,texture_dx,texture_dy);
-	}
+    result = _scanPolygon(dst, vx, vy, n, edges, 0, texture, texture_dx, texture_dy);
+
+    if ((edges != local) && ((polyInts == NULL) || (polyAllocated == NULL))) {
+	free(edges);
     }
 
     return (result);
@@ -4277,13 +4320,6 @@ int texturedPolygon(SDL_Surface * dst, const Sint16 * vx, const Sint16 * vy, int
    return (texturedPolygonMT(dst, vx, vy, n, texture, texture_dx, texture_dy, NULL, NULL));
 }
 
-/* Helper qsort callback for polygon drawing */
-
-int gfxPrimitivesCompareInt(const void *a, const void *b)
-{
-    return (*(const int *) a) - (*(const int *) b);
-}
-
 
 
 /* ---- Character */
@@ -4615,3 +4651,417 @@ int bezierRGBA(SDL_Surface * dst, const Sint16 * vx, const Sint16 * vy, int n, i
      */
     return (bezierColor(dst, vx, vy, n, s, ((Uint32) r << 24) | ((Uint32) g << 16) | ((Uint32) b << 8) | (Uint32) a));
 }
+
+/* ----- Batched primitives */
+
+/* Kinds of recorded commands */
+#define GFX_BATCH_PIXEL		0
+#define GFX_BATCH_HLINE		1
+#define GFX_BATCH_VLINE		2
+#define GFX_BATCH_BOX		3
+#define GFX_BATCH_LINE		4
+
+/* Sorting: 64x64 screen tiles, 16x16 of them, the outer ones taking in anything beyond */
+#define GFX_BATCH_TILE_SHIFT	6
+#define GFX_BATCH_TILES		16
+
+void gfxPrimitivesBatchInit(gfxPrimitivesBatch * batch)
+{
+    batch->commands = NULL;
+    batch->count = 0;
+    batch->allocated = 0;
+    batch->sorted = NULL;
+    batch->sortedAllocated = 0;
+}
+
+void gfxPrimitivesBatchClear(gfxPrimitivesBatch * batch)
+{
+    batch->count = 0;
+}
+
+void gfxPrimitivesBatchFree(gfxPrimitivesBatch * batch)
+{
+    free(batch->commands);
+    free(batch->sorted);
+    gfxPrimitivesBatchInit(batch);
+}
+
+static int _batchAdd(gfxPrimitivesBatch * batch, int kind, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint32 color)
+{
+    gfxPrimitivesCommand *command;
+    int allocated;
+
+    /*
+     * Grow the command array if needed 
+     */
+    if (batch->count >= batch->allocated) {
+	allocated = (batch->allocated) ? 2 * batch->allocated : 256;
+	command = (gfxPrimitivesCommand *) realloc(batch->commands, sizeof(gfxPrimitivesCommand) * allocated);
+	if (command == NULL) {
+	    return (-1);
+	}
+	batch->commands = command;
+	batch->allocated = allocated;
+    }
+
+    /*
+     * Store the command 
+     */
+    command = &batch->commands[batch->count++];
+    command->kind = kind;
+    command->color = color;
+    command->x1 = x1;
+    command->y1 = y1;
+    command->x2 = x2;
+    command->y2 = y2;
+
+    return (0);
+}
+
+int pixelColorBatch(gfxPrimitivesBatch * batch, Sint16 x, Sint16 y, Uint32 color)
+{
+    return (_batchAdd(batch, GFX_BATCH_PIXEL, x, y, x, y, color));
+}
+
+int pixelRGBABatch(gfxPrimitivesBatch * batch, Sint16 x, Sint16 y, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    return (pixelColorBatch(batch, x, y, ((Uint32) r << 24) | ((Uint32) g << 16) | ((Uint32) b << 8) | (Uint32) a));
+}
+
+int hlineColorBatch(gfxPrimitivesBatch * batch, Sint16 x1, Sint16 x2, Sint16 y, Uint32 color)
+{
+    return (_batchAdd(batch, GFX_BATCH_HLINE, x1, y, x2, y, color));
+}
+
+int hlineRGBABatch(gfxPrimitivesBatch * batch, Sint16 x1, Sint16 x2, Sint16 y, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    return (hlineColorBatch(batch, x1, x2, y, ((Uint32) r << 24) | ((Uint32) g << 16) | ((Uint32) b << 8) | (Uint32) a));
+}
+
+int vlineColorBatch(gfxPrimitivesBatch * batch, Sint16 x, Sint16 y1, Sint16 y2, Uint32 color)
+{
+    return (_batchAdd(batch, GFX_BATCH_VLINE, x, y1, x, y2, color));
+}
+
+int vlineRGBABatch(gfxPrimitivesBatch * batch, Sint16 x, Sint16 y1, Sint16 y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    return (vlineColorBatch(batch, x, y1, y2, ((Uint32) r << 24) | ((Uint32) g << 16) | ((Uint32) b << 8) | (Uint32) a));
+}
+
+int rectangleColorBatch(gfxPrimitivesBatch * batch, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint32 color)
+{
+    int result;
+    Sint16 tmp;
+
+    /*
+     * Record the lines rectangleColor would draw 
+     */
+    if (x1 > x2) {
+	tmp = x1;
+	x1 = x2;
+	x2 = tmp;
+    }
+    if (y1 > y2) {
+	tmp = y1;
+	y1 = y2;
+	y2 = tmp;
+    }
+    if (x1 == x2) {
+	if (y1 == y2) {
+	    return (pixelColorBatch(batch, x1, y1, color));
+	} else {
+	    return (vlineColorBatch(batch, x1, y1, y2, color));
+	}
+    } else {
+	if (y1 == y2) {
+	    return (hlineColorBatch(batch, x1, x2, y1, color));
+	}
+    }
+    result = 0;
+    result |= hlineColorBatch(batch, x1, x2, y1, color);
+    result |= hlineColorBatch(batch, x1, x2, y2, color);
+    y1 += 1;
+    y2 -= 1;
+    if (y1 <= y2) {
+	result |= vlineColorBatch(batch, x1, y1, y2, color);
+	result |= vlineColorBatch(batch, x2, y1, y2, color);
+    }
+    return (result);
+}
+
+int rectangleRGBABatch(gfxPrimitivesBatch * batch, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    return (rectangleColorBatch(batch, x1, y1, x2, y2, ((Uint32) r << 24) | ((Uint32) g << 16) | ((Uint32) b << 8) | (Uint32) a));
+}
+
+int boxColorBatch(gfxPrimitivesBatch * batch, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint32 color)
+{
+    return (_batchAdd(batch, GFX_BATCH_BOX, x1, y1, x2, y2, color));
+}
+
+int boxRGBABatch(gfxPrimitivesBatch * batch, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    return (boxColorBatch(batch, x1, y1, x2, y2, ((Uint32) r << 24) | ((Uint32) g << 16) | ((Uint32) b << 8) | (Uint32) a));
+}
+
+int lineColorBatch(gfxPrimitivesBatch * batch, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint32 color)
+{
+    return (_batchAdd(batch, GFX_BATCH_LINE, x1, y1, x2, y2, color));
+}
+
+int lineRGBABatch(gfxPrimitivesBatch * batch, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    return (lineColorBatch(batch, x1, y1, x2, y2, ((Uint32) r << 24) | ((Uint32) g << 16) | ((Uint32) b << 8) | (Uint32) a));
+}
+
+/* Tile of the top left corner of a command */
+
+static int _batchTile(gfxPrimitivesCommand * command)
+{
+    int x, y;
+
+    x = ((command->x1 < command->x2) ? command->x1 : command->x2) >> GFX_BATCH_TILE_SHIFT;
+    y = ((command->y1 < command->y2) ? command->y1 : command->y2) >> GFX_BATCH_TILE_SHIFT;
+    x = (x < 0) ? 0 : ((x >= GFX_BATCH_TILES) ? GFX_BATCH_TILES - 1 : x);
+    y = (y < 0) ? 0 : ((y >= GFX_BATCH_TILES) ? GFX_BATCH_TILES - 1 : y);
+    return (y * GFX_BATCH_TILES + x);
+}
+
+/* Counting sort of the commands by tile into the scratch array of the batch, */
+/* keeping the recorded order within each tile                                */
+
+static gfxPrimitivesCommand *_batchSort(gfxPrimitivesBatch * batch)
+{
+    gfxPrimitivesCommand *sorted;
+    int start[GFX_BATCH_TILES * GFX_BATCH_TILES];
+    int i, tile, count;
+
+    if (batch->sortedAllocated < batch->count) {
+	sorted = (gfxPrimitivesCommand *) realloc(batch->sorted, sizeof(gfxPrimitivesCommand) * batch->allocated);
+	if (sorted == NULL) {
+	    return (NULL);
+	}
+	batch->sorted = sorted;
+	batch->sortedAllocated = batch->allocated;
+    }
+
+    /*
+     * Count the commands of each tile, then place them
+     */
+    memset(start, 0, sizeof(start));
+    for (i = 0; i < batch->count; i++) {
+	start[_batchTile(&batch->commands[i])]++;
+    }
+    count = 0;
+    for (tile = 0; tile < GFX_BATCH_TILES * GFX_BATCH_TILES; tile++) {
+	i = start[tile];
+	start[tile] = count;
+	count += i;
+    }
+    sorted = batch->sorted;
+    for (i = 0; i < batch->count; i++) {
+	sorted[start[_batchTile(&batch->commands[i])]++] = batch->commands[i];
+    }
+
+    return (sorted);
+}
+
+/* Opaque pixel or filled rectangle inside the clipping rectangle, color in destination format */
+
+static void _batchFill(SDL_Surface * dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint32 color)
+{
+    Uint8 *pixel, *pixellast;
+    int x, dx;
+    int pixx, pixy;
+
+    dx = x2 - x1 + 1;
+    pixx = dst->format->BytesPerPixel;
+    pixy = dst->pitch;
+    pixel = ((Uint8 *) dst->pixels) + pixx * (int) x1 + pixy * (int) y1;
+    pixellast = pixel + pixy * (y2 - y1);
+
+    switch (pixx) {
+    case 1:
+	if (dx == 1) {
+	    for (; pixel <= pixellast; pixel += pixy) {
+		*pixel = color;
+	    }
+	} else {
+	    for (; pixel <= pixellast; pixel += pixy) {
+		memset(pixel, (Uint8) color, dx);
+	    }
+	}
+	break;
+    case 2:
+	for (; pixel <= pixellast; pixel += pixy) {
+	    for (x = 0; x < dx; x++) {
+		((Uint16 *) pixel)[x] = color;
+	    }
+	}
+	break;
+    case 3:
+	for (; pixel <= pixellast; pixel += pixy) {
+	    for (x = 0; x < 3 * dx; x += 3) {
+		if (SDL_BYTEORDER == SDL_BIG_ENDIAN) {
+		    pixel[x] = (color >> 16) & 0xff;
+		    pixel[x + 1] = (color >> 8) & 0xff;
+		    pixel[x + 2] = color & 0xff;
+		} else {
+		    pixel[x] = color & 0xff;
+		    pixel[x + 1] = (color >> 8) & 0xff;
+		    pixel[x + 2] = (color >> 16) & 0xff;
+		}
+	    }
+	}
+	break;
+    default:			/* case 4 */
+	for (; pixel <= pixellast; pixel += pixy) {
+	    for (x = 0; x < dx; x++) {
+		((Uint32 *) pixel)[x] = color;
+	    }
+	}
+	break;
+    }
+}
+
+int gfxPrimitivesBatchDraw(SDL_Surface * dst, gfxPrimitivesBatch * batch, int flags)
+{
+    gfxPrimitivesCommand *command, *last;
+    Sint16 left, right, top, bottom;
+    Sint16 x1, y1, x2, y2, tmp;
+    Uint32 color = 0, mcolor = 0;
+    Uint8 alpha = 0;
+    Uint8 *pixel;
+    int kind, mapped = 0;
+
+    /*
+     * Check visibility of clipping rectangle
+     */
+    if ((batch->count == 0) || (dst->clip_rect.w == 0) || (dst->clip_rect.h == 0)) {
+	return (0);
+    }
+
+    /*
+     * Sort by screen tile if asked to 
+     */
+    command = batch->commands;
+    if (flags & GFX_BATCH_SORT) {
+	command = _batchSort(batch);
+	if (command == NULL) {
+	    return (-1);
+	}
+    }
+    last = command + batch->count;
+
+    /*
+     * Lock the surface once for all commands 
+     */
+    if (SDL_MUSTLOCK(dst)) {
+	if (SDL_LockSurface(dst) < 0) {
+	    return (-1);
+	}
+    }
+
+    /*
+     * Get clipping boundary 
+     */
+    left = dst->clip_rect.x;
+    right = dst->clip_rect.x + dst->clip_rect.w - 1;
+    top = dst->clip_rect.y;
+    bottom = dst->clip_rect.y + dst->clip_rect.h - 1;
+
+    for (; command < last; command++) {
+
+	/*
+	 * Setup color, reusing the last one if it did not change 
+	 */
+	if ((!mapped) || (command->color != color)) {
+	    color = command->color;
+	    alpha = color & 0x000000ff;
+	    mcolor =
+		SDL_MapRGBA(dst->format, (color & 0xff000000) >> 24,
+			    (color & 0x00ff0000) >> 16, (color & 0x0000ff00) >> 8, alpha);
+	    mapped = 1;
+	}
+
+	kind = command->kind;
+	x1 = command->x1;
+	y1 = command->y1;
+	x2 = command->x2;
+	y2 = command->y2;
+
+	/*
+	 * Order and clip the coordinates the way
+	 * the single call of each primitive does 
+	 */
+	switch (kind) {
+	case GFX_BATCH_PIXEL:
+	    if ((x1 < left) || (x1 > right) || (y1 < top) || (y1 > bottom)) {
+		break;
+	    }
+	    pixel = (Uint8 *) dst->pixels + y1 * dst->pitch;
+	    if (alpha != 255) {
+		_putPixelAlpha(dst, x1, y1, mcolor, alpha);
+	    } else if (dst->format->BytesPerPixel == 1) {
+		pixel[x1] = mcolor;
+	    } else if (dst->format->BytesPerPixel == 2) {
+		((Uint16 *) pixel)[x1] = mcolor;
+	    } else if (dst->format->BytesPerPixel == 4) {
+		((Uint32 *) pixel)[x1] = mcolor;
+	    } else {
+		_putPixelAlpha(dst, x1, y1, mcolor, alpha);
+	    }
+	    break;
+	case GFX_BATCH_LINE:
+	    if (!(clipLine(dst, &x1, &y1, &x2, &y2))) {
+		break;
+	    }
+	    if ((x1 != x2) && (y1 != y2)) {
+		_drawLine(dst, x1, y1, x2, y2, mcolor, alpha);
+		break;
+	    }
+	    /* Straight lines and single points are filled like boxes */
+	default:
+	    if (x1 > x2) {
+		tmp = x1;
+		x1 = x2;
+		x2 = tmp;
+	    }
+	    if (y1 > y2) {
+		tmp = y1;
+		y1 = y2;
+		y2 = tmp;
+	    }
+	    if ((x2 < left) || (x1 > right) || (y2 < top) || (y1 > bottom)) {
+		break;
+	    }
+	    if (x1 < left) {
+		x1 = left;
+	    }
+	    if (x2 > right) {
+		x2 = right;
+	    }
+	    if (y1 < top) {
+		y1 = top;
+	    }
+	    if (y2 > bottom) {
+		y2 = bottom;
+	    }
+	    if (alpha == 255) {
+		_batchFill(dst, x1, y1, x2, y2, mcolor);
+	    } else {
+		_filledRectAlpha(dst, x1, y1, x2, y2, mcolor, alpha);
+	    }
+	    break;
+	}
+    }
+
+    /*
+     * Unlock the surface 
+     */
+    if (SDL_MUSTLOCK(dst)) {
+	SDL_UnlockSurface(dst);
+    }
+
+    return (0);
+}
@@ -174,7 +174,7 @@ extern "C" {
 				       const Sint16 * vy, int n, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
     DLLINTERFACE int texturedPolygon(SDL_Surface * dst, const Sint16 * vx, const Sint16 * vy, int n, SDL_Surface * texture,int texture_dx,int texture_dy);
 
-/* (Note: These MT versions are required for multi-threaded operation.) */
+/* (Note: The MT versions take a cache of edge memory that is kept between calls.) */
 
     DLLINTERFACE int filledPolygonColorMT(SDL_Surface * dst, const Sint16 * vx, const Sint16 * vy, int n, Uint32 color, int **polyInts, int *polyAllocated);
     DLLINTERFACE int filledPolygonRGBAMT(SDL_Surface * dst, const Sint16 * vx,
@@ -189,6 +189,49 @@ extern "C" {
     DLLINTERFACE int bezierRGBA(SDL_Surface * dst, const Sint16 * vx, const Sint16 * vy,
 				 int n, int s, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 
+/* Batched primitives */
+/* (Commands are recorded into a batch, then gfxPrimitivesBatchDraw locks the surface */
+/*  once and draws them all, with the same pixels as the single calls would give. */
+/*  GFX_BATCH_SORT draws them grouped by 64x64 tile instead of in recorded order, */
+/*  which only gives the same pixels if overlapping commands are opaque and of one color.) */
+
+#define GFX_BATCH_SORT	1
+
+    typedef struct {
+	Uint32 kind;
+	Uint32 color;
+	Sint16 x1, y1, x2, y2;
+    } gfxPrimitivesCommand;
+
+    typedef struct {
+	gfxPrimitivesCommand *commands;
+	int count;
+	int allocated;
+	gfxPrimitivesCommand *sorted;
+	int sortedAllocated;
+    } gfxPrimitivesBatch;
+
+    DLLINTERFACE void gfxPrimitivesBatchInit(gfxPrimitivesBatch * batch);
+    DLLINTERFACE void gfxPrimitivesBatchClear(gfxPrimitivesBatch * batch);
+    DLLINTERFACE void gfxPrimitivesBatchFree(gfxPrimitivesBatch * batch);
+    DLLINTERFACE int gfxPrimitivesBatchDraw(SDL_Surface * dst, gfxPrimitivesBatch * batch, int flags);
+
+    DLLINTERFACE int pixelColorBatch(gfxPrimitivesBatch * batch, Sint16 x, Sint16 y, Uint32 color);
+    DLLINTERFACE int pixelRGBABatch(gfxPrimitivesBatch * batch, Sint16 x, Sint16 y, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+    DLLINTERFACE int hlineColorBatch(gfxPrimitivesBatch * batch, Sint16 x1, Sint16 x2, Sint16 y, Uint32 color);
+    DLLINTERFACE int hlineRGBABatch(gfxPrimitivesBatch * batch, Sint16 x1, Sint16 x2, Sint16 y, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+    DLLINTERFACE int vlineColorBatch(gfxPrimitivesBatch * batch, Sint16 x, Sint16 y1, Sint16 y2, Uint32 color);
+    DLLINTERFACE int vlineRGBABatch(gfxPrimitivesBatch * batch, Sint16 x, Sint16 y1, Sint16 y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+    DLLINTERFACE int rectangleColorBatch(gfxPrimitivesBatch * batch, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint32 color);
+    DLLINTERFACE int rectangleRGBABatch(gfxPrimitivesBatch * batch, Sint16 x1, Sint16 y1,
+					Sint16 x2, Sint16 y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+    DLLINTERFACE int boxColorBatch(gfxPrimitivesBatch * batch, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint32 color);
+    DLLINTERFACE int boxRGBABatch(gfxPrimitivesBatch * batch, Sint16 x1, Sint16 y1,
+				  Sint16 x2, Sint16 y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+    DLLINTERFACE int lineColorBatch(gfxPrimitivesBatch * batch, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint32 color);
+    DLLINTERFACE int lineRGBABatch(gfxPrimitivesBatch * batch, Sint16 x1, Sint16 y1,
+				   Sint16 x2, Sint16 y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
 
 /* Characters/Strings */
 
@@ -1,7 +1,8 @@
 /*
  
  SDL_imageFilter - bytes-image "filter" routines 
- (uses inline x86 MMX optimizations if available)
+ (uses inline x86 MMX optimizations if available,
+ or an SSE2, AVX2, NEON or AltiVec unit)
  
  LGPL (c) A. Schiffler
 
@@ -13,6 +14,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "SDL_imageFilter.h"
 
@@ -20,7 +22,7 @@
 
 /* ------ Static variables ----- */
 
-/* Toggle the use of the MMX routines - ON by default */
+/* Toggle the use of the MMX and vector routines - ON by default */
 
 static int SDL_imageFilterUseMMX = 1;
 
@@ -68,6 +70,521 @@ void SDL_imageFilterMMXon()
     SDL_imageFilterUseMMX = 1;
 }
 
+/* ------------------------------------------------------------------------------------ */
+/* Vector routines                                                                      */
+/*                                                                                      */
+/* Where there is no MMX code to run, the byte-wise filters do the whole blocks with a  */
+/* vector unit and leave the bytes after the last block to the C routine. The unit is   */
+/* picked when the library is compiled: SSE2 on x86, NEON on ARM, AltiVec on PowerPC.   */
+/* On x86 an AVX2 copy is compiled too, which the first call switches to if the CPU     */
+/* has AVX2. Without a unit, a 32 bit word holds 4 bytes, which beats the C routines at */
+/* adding, subtracting, shifting and bit operations, though not at comparing bytes or   */
+/* multiplying them. Every filter has one loop, written with this small vector          */
+/* abstraction:                                                                         */
+/*                                                                                      */
+/*   ifvec_t                 IFVEC_SIZE unsigned bytes                                  */
+/*   IFVEC_LOAD(p)           the bytes at p, which need not be aligned                  */
+/*   IFVEC_STORE(p, v)       the bytes of v to p                                        */
+/*   IFVEC_SPLAT(c)          c in every byte                                            */
+/*   IFVEC_ADDS(a, b)        saturation255(a + b)                                       */
+/*   IFVEC_SUBS(a, b)        saturation0(a - b)                                         */
+/*   IFVEC_AND/OR/XOR(a, b)  bitwise operations                                         */
+/*   IFVEC_SRL/SLL(a, n)     bytes shifted 0 to 7 bits, the bits shifted out lost       */
+/*   IFVEC_SRL32/SLL32(a, n) native 32 bit words shifted 1 to 31 bits                   */
+/*                                                                                      */
+/* and, with IFVEC_WIDE, compares and 16 bit lanes for the products:                    */
+/*                                                                                      */
+/*   IFVEC_MIN/MAX(a, b)     the smaller or larger byte                                 */
+/*   IFVEC_CMPEQ(a, b)       255 where a and b are the same, 0 elsewhere                */
+/*                                                                                      */
+/*   ifvec16_t               IFVEC_SIZE / 2 unsigned 16 bit lanes                       */
+/*   IFVEC_WIDEN_LO/HI(a)    half the bytes of a, one a lane; which half is up to the   */
+/*                           unit, as long as IFVEC_PACK puts them back                 */
+/*   IFVEC_PACK(lo, hi)      the 0-255 lanes of the two halves back into bytes          */
+/*   IFVEC16_SPLAT(c)        c in every lane                                            */
+/*   IFVEC16_ADD/SUB/MUL     wrapping around at 65536                                   */
+/*   IFVEC16_SRL/SLL(a, n)   lanes shifted 1 to 8 bits                                  */
+/*   IFVEC16_MIN255(a)       saturation255(a)                                           */
+/*   IFVEC16_LOWBYTE(a)      a & 255                                                    */
+/*   IFVEC16_SATHIGH(a)      255 where a is a signed 256 to 32767, a & 255 elsewhere    */
+/*                                                                                      */
+/* They give exactly what the C routines give.                                          */
+
+#if defined(__GNUC__) && defined(__AVX2__)
+#include <immintrin.h>
+#define IFVEC_AVX2	1
+#elif defined(__GNUC__) && defined(__SSE2__) && \
+      (defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+#include <immintrin.h>
+#define IFVEC_SSE2	1
+#define IFVEC_AVX2_CPU	1	/* AVX2 is built with a target attribute, used if the CPU has it */
+#elif defined(__GNUC__) && defined(__SSE2__)
+#include <emmintrin.h>
+#define IFVEC_SSE2	1
+#elif defined(__GNUC__) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#include <arm_neon.h>
+#define IFVEC_NEON	1
+#elif defined(__GNUC__) && defined(__ALTIVEC__)
+#include <altivec.h>
+#define IFVEC_ALTIVEC	1
+#else
+#define IFVEC_WORD	1
+#endif
+
+#if IFVEC_AVX2 || IFVEC_SSE2
+
+/* SSE2 and AVX2 share the macros, IFVEC_MM(op) and IFVEC_SI(op) name the intrinsics */
+
+#if IFVEC_AVX2
+#define ifvec_t			__m256i
+#define IFVEC_SIZE		32
+#define IFVEC_MM(op)		_mm256_##op
+#define IFVEC_SI(op)		_mm256_##op##_si256
+#else
+#define ifvec_t			__m128i
+#define IFVEC_SIZE		16
+#define IFVEC_MM(op)		_mm_##op
+#define IFVEC_SI(op)		_mm_##op##_si128
+#endif
+
+#define ifvec16_t		ifvec_t
+#define IFVEC_WIDE		1
+#define IFVEC_LOAD(p)		IFVEC_SI(loadu)((const ifvec_t *) (p))
+#define IFVEC_STORE(p, v)	IFVEC_SI(storeu)((ifvec_t *) (p), v)
+#define IFVEC_SPLAT(c)		IFVEC_MM(set1_epi8)((char) (c))
+#define IFVEC_ADDS(a, b)	IFVEC_MM(adds_epu8)(a, b)
+#define IFVEC_SUBS(a, b)	IFVEC_MM(subs_epu8)(a, b)
+#define IFVEC_AND(a, b)		IFVEC_SI(and)(a, b)
+#define IFVEC_OR(a, b)		IFVEC_SI(or)(a, b)
+#define IFVEC_XOR(a, b)		IFVEC_SI(xor)(a, b)
+#define IFVEC_MIN(a, b)		IFVEC_MM(min_epu8)(a, b)
+#define IFVEC_MAX(a, b)		IFVEC_MM(max_epu8)(a, b)
+#define IFVEC_CMPEQ(a, b)	IFVEC_MM(cmpeq_epi8)(a, b)
+#define IFVEC_SRL(a, n)		IFVEC_SI(and)(IFVEC_MM(srl_epi16)(a, _mm_cvtsi32_si128(n)), IFVEC_MM(set1_epi8)((char) (0xff >> (n))))
+#define IFVEC_SLL(a, n)		IFVEC_SI(and)(IFVEC_MM(sll_epi16)(a, _mm_cvtsi32_si128(n)), IFVEC_MM(set1_epi8)((char) (0xff << (n))))
+#define IFVEC_SRL32(a, n)	IFVEC_MM(srl_epi32)(a, _mm_cvtsi32_si128(n))
+#define IFVEC_SLL32(a, n)	IFVEC_MM(sll_epi32)(a, _mm_cvtsi32_si128(n))
+#define IFVEC_WIDEN_LO(a)	IFVEC_MM(unpacklo_epi8)(a, IFVEC_SI(setzero)())
+#define IFVEC_WIDEN_HI(a)	IFVEC_MM(unpackhi_epi8)(a, IFVEC_SI(setzero)())
+#define IFVEC_PACK(lo, hi)	IFVEC_MM(packus_epi16)(lo, hi)
+#define IFVEC16_SPLAT(c)	IFVEC_MM(set1_epi16)((short) (c))
+#define IFVEC16_ADD(a, b)	IFVEC_MM(add_epi16)(a, b)
+#define IFVEC16_SUB(a, b)	IFVEC_MM(sub_epi16)(a, b)
+#define IFVEC16_MUL(a, b)	IFVEC_MM(mullo_epi16)(a, b)
+#define IFVEC16_SRL(a, n)	IFVEC_MM(srl_epi16)(a, _mm_cvtsi32_si128(n))
+#define IFVEC16_SLL(a, n)	IFVEC_MM(sll_epi16)(a, _mm_cvtsi32_si128(n))
+#define IFVEC16_MIN255(a)	IFVEC_MM(sub_epi16)(a, IFVEC_MM(subs_epu16)(a, IFVEC_MM(set1_epi16)(255)))
+#define IFVEC16_LOWBYTE(a)	IFVEC_SI(and)(a, IFVEC_MM(set1_epi16)(255))
+#define IFVEC16_SATHIGH(a)	IFVEC_SI(and)(IFVEC_SI(or)(a, IFVEC_MM(cmpgt_epi16)(a, IFVEC_MM(set1_epi16)(255))), IFVEC_MM(set1_epi16)(255))
+
+#elif IFVEC_NEON
+
+typedef uint8x16_t ifvec_t;
+typedef uint16x8_t ifvec16_t;
+
+#define IFVEC_SIZE		16
+#define IFVEC_WIDE		1
+#define IFVEC_LOAD(p)		vld1q_u8((const uint8_t *) (p))
+#define IFVEC_STORE(p, v)	vst1q_u8((uint8_t *) (p), v)
+#define IFVEC_SPLAT(c)		vdupq_n_u8((uint8_t) (c))
+#define IFVEC_ADDS(a, b)	vqaddq_u8(a, b)
+#define IFVEC_SUBS(a, b)	vqsubq_u8(a, b)
+#define IFVEC_AND(a, b)		vandq_u8(a, b)
+#define IFVEC_OR(a, b)		vorrq_u8(a, b)
+#define IFVEC_XOR(a, b)		veorq_u8(a, b)
+#define IFVEC_MIN(a, b)		vminq_u8(a, b)
+#define IFVEC_MAX(a, b)		vmaxq_u8(a, b)
+#define IFVEC_CMPEQ(a, b)	vceqq_u8(a, b)
+#define IFVEC_SRL(a, n)		vshlq_u8(a, vdupq_n_s8((int8_t) -(n)))
+#define IFVEC_SLL(a, n)		vshlq_u8(a, vdupq_n_s8((int8_t) (n)))
+#define IFVEC_SRL32(a, n)	vreinterpretq_u8_u32(vshlq_u32(vreinterpretq_u32_u8(a), vdupq_n_s32(-(n))))
+#define IFVEC_SLL32(a, n)	vreinterpretq_u8_u32(vshlq_u32(vreinterpretq_u32_u8(a), vdupq_n_s32(n)))
+#define IFVEC_WIDEN_LO(a)	vmovl_u8(vget_low_u8(a))
+#define IFVEC_WIDEN_HI(a)	vmovl_u8(vget_high_u8(a))
+#define IFVEC_PACK(lo, hi)	vcombine_u8(vmovn_u16(lo), vmovn_u16(hi))
+#define IFVEC16_SPLAT(c)	vdupq_n_u16((uint16_t) (c))
+#define IFVEC16_ADD(a, b)	vaddq_u16(a, b)
+#define IFVEC16_SUB(a, b)	vsubq_u16(a, b)
+#define IFVEC16_MUL(a, b)	vmulq_u16(a, b)
+#define IFVEC16_SRL(a, n)	vshlq_u16(a, vdupq_n_s16((int16_t) -(n)))
+#define IFVEC16_SLL(a, n)	vshlq_u16(a, vdupq_n_s16((int16_t) (n)))
+#define IFVEC16_MIN255(a)	vminq_u16(a, vdupq_n_u16(255))
+#define IFVEC16_LOWBYTE(a)	vandq_u16(a, vdupq_n_u16(255))
+#define IFVEC16_SATHIGH(a)	vandq_u16(vorrq_u16(a, vcgtq_s16(vreinterpretq_s16_u16(a), vdupq_n_s16(255))), vdupq_n_u16(255))
+
+#elif IFVEC_ALTIVEC
+
+typedef vector unsigned char ifvec_t;
+typedef vector unsigned short ifvec16_t;
+
+#define IFVEC_SIZE		16
+#define IFVEC_WIDE		1
+#define IFVEC_LOAD(p)		vec_perm(vec_ld(0, (const unsigned char *) (p)), vec_ld(15, (const unsigned char *) (p)), vec_lvsl(0, (const unsigned char *) (p)))
+#define IFVEC_STORE(p, v)	SDL_imageFilterVecStore(p, v)
+#define IFVEC_SPLAT(c)		SDL_imageFilterVecSplat(c)
+#define IFVEC_ADDS(a, b)	vec_adds(a, b)
+#define IFVEC_SUBS(a, b)	vec_subs(a, b)
+#define IFVEC_AND(a, b)		vec_and(a, b)
+#define IFVEC_OR(a, b)		vec_or(a, b)
+#define IFVEC_XOR(a, b)		vec_xor(a, b)
+#define IFVEC_MIN(a, b)		vec_min(a, b)
+#define IFVEC_MAX(a, b)		vec_max(a, b)
+#define IFVEC_CMPEQ(a, b)	((ifvec_t) vec_cmpeq(a, b))
+#define IFVEC_SRL(a, n)		vec_sr(a, SDL_imageFilterVecSplat(n))
+#define IFVEC_SLL(a, n)		vec_sl(a, SDL_imageFilterVecSplat(n))
+#define IFVEC_SRL32(a, n)	((ifvec_t) vec_sr((vector unsigned int) (a), (vector unsigned int) SDL_imageFilterVecSplat(n)))
+#define IFVEC_SLL32(a, n)	((ifvec_t) vec_sl((vector unsigned int) (a), (vector unsigned int) SDL_imageFilterVecSplat(n)))
+#define IFVEC_WIDEN_LO(a)	((ifvec16_t) vec_mergeh(vec_splat_u8(0), a))
+#define IFVEC_WIDEN_HI(a)	((ifvec16_t) vec_mergel(vec_splat_u8(0), a))
+#define IFVEC_PACK(lo, hi)	vec_pack(lo, hi)
+#define IFVEC16_SPLAT(c)	SDL_imageFilterVec16Splat(c)
+#define IFVEC16_ADD(a, b)	vec_add(a, b)
+#define IFVEC16_SUB(a, b)	vec_sub(a, b)
+#define IFVEC16_MUL(a, b)	vec_mladd(a, b, vec_splat_u16(0))
+#define IFVEC16_SRL(a, n)	vec_sr(a, SDL_imageFilterVec16Splat(n))
+#define IFVEC16_SLL(a, n)	vec_sl(a, SDL_imageFilterVec16Splat(n))
+#define IFVEC16_MIN255(a)	vec_min(a, SDL_imageFilterVec16Splat(255))
+#define IFVEC16_LOWBYTE(a)	vec_and(a, SDL_imageFilterVec16Splat(255))
+#define IFVEC16_SATHIGH(a)	vec_and(vec_or(a, (ifvec16_t) vec_cmpgt((vector signed short) (a), (vector signed short) SDL_imageFilterVec16Splat(255))), SDL_imageFilterVec16Splat(255))
+
+static __inline__ void SDL_imageFilterVecStore(unsigned char *p, ifvec_t v)
+{
+    union {
+	ifvec_t v;
+	unsigned char b[16];
+    } u;
+
+    u.v = v;
+    memcpy(p, u.b, 16);
+}
+
+static __inline__ ifvec_t SDL_imageFilterVecSplat(int c)
+{
+    union {
+	ifvec_t v;
+	unsigned char b[16];
+    } u;
+
+    memset(u.b, c, 16);
+    return (u.v);
+}
+
+static __inline__ ifvec16_t SDL_imageFilterVec16Splat(int c)
+{
+    union {
+	ifvec16_t v;
+	unsigned short s[8];
+    } u;
+    int i;
+
+    for (i = 0; i < 8; i++) {
+	u.s[i] = (unsigned short) c;
+    }
+    return (u.v);
+}
+
+#else
+
+/* 4 bytes in a word, kept from carrying into each other */
+
+typedef unsigned int ifvec_t;
+
+#define IFVEC_SIZE		4
+#define IFVEC_LOAD(p)		SDL_imageFilterWordLoad(p)
+#define IFVEC_STORE(p, v)	SDL_imageFilterWordStore(p, v)
+#define IFVEC_SPLAT(c)		(0x01010101u * (unsigned char) (c))
+#define IFVEC_ADDS(a, b)	SDL_imageFilterWordAdds(a, b)
+#define IFVEC_SUBS(a, b)	SDL_imageFilterWordSubs(a, b)
+#define IFVEC_AND(a, b)		((a) & (b))
+#define IFVEC_OR(a, b)		((a) | (b))
+#define IFVEC_XOR(a, b)		((a) ^ (b))
+#define IFVEC_SRL(a, n)		(((a) >> (n)) & (0x01010101u * (0xff >> (n))))
+#define IFVEC_SLL(a, n)		(((a) << (n)) & (0x01010101u * ((0xff << (n)) & 0xff)))
+#define IFVEC_SRL32(a, n)	((a) >> (n))
+#define IFVEC_SLL32(a, n)	((a) << (n))
+
+static ifvec_t SDL_imageFilterWordLoad(const unsigned char *p)
+{
+    ifvec_t v;
+
+    memcpy(&v, p, 4);
+    return (v);
+}
+
+static void SDL_imageFilterWordStore(unsigned char *p, ifvec_t v)
+{
+    memcpy(p, &v, 4);
+}
+
+/* 0xff in the bytes with their top bit set, 0 in the others */
+#define IFVEC_WORD_MASK(t)	((((t) & 0x80808080u) >> 7) * 0xff)
+
+static ifvec_t SDL_imageFilterWordAdds(ifvec_t a, ifvec_t b)
+{
+    ifvec_t low = (a & 0x7f7f7f7fu) + (b & 0x7f7f7f7fu);
+    ifvec_t carry = (a & b) | ((a | b) & low);
+
+    return ((low ^ ((a ^ b) & 0x80808080u)) | IFVEC_WORD_MASK(carry));
+}
+
+static ifvec_t SDL_imageFilterWordSubs(ifvec_t a, ifvec_t b)
+{
+    ifvec_t diff = ((a | 0x80808080u) - (b & 0x7f7f7f7fu)) ^ ((a ^ b ^ 0x80808080u) & 0x80808080u);
+    ifvec_t borrow = (~a & b) | (~(a ^ b) & diff);
+
+    return (diff & ~IFVEC_WORD_MASK(borrow));
+}
+
+#endif
+
+/* The filters SDL_imageFilterVector() does */
+enum {
+    IFOP_ADD, IFOP_MEAN, IFOP_SUB, IFOP_ABSDIFF, IFOP_MULT, IFOP_MULTNOR, IFOP_MULTDIVBY2, IFOP_MULTDIVBY4,
+    IFOP_BITAND, IFOP_BITOR, IFOP_BITNEGATION, IFOP_ADDBYTE, IFOP_ADDUINT, IFOP_ADDBYTETOHALF, IFOP_SUBBYTE,
+    IFOP_SUBUINT, IFOP_SHIFTRIGHT, IFOP_SHIFTRIGHTUINT, IFOP_MULTBYBYTE, IFOP_SHIFTRIGHTANDMULTBYBYTE,
+    IFOP_SHIFTLEFTBYTE, IFOP_SHIFTLEFTUINT, IFOP_SHIFTLEFT, IFOP_BINARIZE, IFOP_CLIPTORANGE,
+    IFOP_NORMALIZELINEAR
+};
+
+/* Loops doing 'op' to every block of Src1, or Src1 and Src2 */
+#define IFVEC_UNARY(op) \
+    for (i = 0; i < n; i += IFVEC_SIZE) { \
+	a = IFVEC_LOAD(Src1 + i); \
+	IFVEC_STORE(Dest + i, op); \
+    }
+#define IFVEC_BINARY(op) \
+    for (i = 0; i < n; i += IFVEC_SIZE) { \
+	a = IFVEC_LOAD(Src1 + i); \
+	b = IFVEC_LOAD(Src2 + i); \
+	IFVEC_STORE(Dest + i, op); \
+    }
+
+/* 'op' on both halves of a and b in 16 bit lanes, packed back into bytes */
+#define IFVEC_WIDE_UNARY(op) \
+    IFVEC_PACK(op(IFVEC_WIDEN_LO(a)), op(IFVEC_WIDEN_HI(a)))
+#define IFVEC_WIDE_BINARY(op) \
+    IFVEC_PACK(op(IFVEC_WIDEN_LO(a), IFVEC_WIDEN_LO(b)), op(IFVEC_WIDEN_HI(a), IFVEC_WIDEN_HI(b)))
+
+#define IFVEC16_MULT(x, y)		IFVEC16_MIN255(IFVEC16_MUL(x, y))
+#define IFVEC16_MULTNOR(x, y)		IFVEC16_LOWBYTE(IFVEC16_MUL(x, y))
+#define IFVEC16_MULTDIVBY2(x, y)	IFVEC16_MIN255(IFVEC16_MUL(IFVEC16_SRL(x, 1), y))
+#define IFVEC16_MULTDIVBY4(x, y)	IFVEC16_MIN255(IFVEC16_MUL(IFVEC16_SRL(x, 1), IFVEC16_SRL(y, 1)))
+#define IFVEC16_MULTBYBYTE(x)		IFVEC16_MIN255(IFVEC16_MUL(x, w))
+#define IFVEC16_SHIFTRIGHTANDMULT(x)	IFVEC16_MIN255(IFVEC16_MUL(IFVEC16_SRL(x, A), w))
+#define IFVEC16_SHIFTLEFT(x)		IFVEC16_MIN255(IFVEC16_SLL(x, A))
+#define IFVEC16_NORMALIZE(x)		IFVEC16_SATHIGH(IFVEC16_ADD(IFVEC16_MUL(IFVEC16_SUB(x, k16), w), n16))
+
+/* The cases of the switch in IFVEC_FILTER(): filters on bytes, then, with IFVEC_WIDE,
+   compares and filters on 16 bit lanes */
+#define IFVEC_BYTE_CASES \
+    case IFOP_ADD: \
+	IFVEC_BINARY(IFVEC_ADDS(a, b)); \
+	break; \
+    case IFOP_MEAN: \
+	IFVEC_BINARY(IFVEC_ADDS(IFVEC_SRL(a, 1), IFVEC_SRL(b, 1))); \
+	break; \
+    case IFOP_SUB: \
+	IFVEC_BINARY(IFVEC_SUBS(a, b)); \
+	break; \
+    case IFOP_BITAND: \
+	IFVEC_BINARY(IFVEC_AND(a, b)); \
+	break; \
+    case IFOP_BITOR: \
+	IFVEC_BINARY(IFVEC_OR(a, b)); \
+	break; \
+    case IFOP_BITNEGATION: \
+	k1 = IFVEC_SPLAT(0xff); \
+	IFVEC_UNARY(IFVEC_XOR(a, k1)); \
+	break; \
+    case IFOP_ADDBYTE: \
+	k1 = IFVEC_SPLAT(A); \
+	IFVEC_UNARY(IFVEC_ADDS(a, k1)); \
+	break; \
+    case IFOP_ADDBYTETOHALF: \
+	k1 = IFVEC_SPLAT(A); \
+	IFVEC_UNARY(IFVEC_ADDS(IFVEC_SRL(a, 1), k1)); \
+	break; \
+    case IFOP_SUBBYTE: \
+	k1 = IFVEC_SPLAT(A); \
+	IFVEC_UNARY(IFVEC_SUBS(a, k1)); \
+	break; \
+    case IFOP_ADDUINT: \
+    case IFOP_SUBUINT: \
+	/* Byte j of every 4 takes byte j of A, counting from the least significant */ \
+	for (i = 0; i < IFVEC_SIZE; i++) { \
+	    pattern[i] = (unsigned char) ((unsigned int) A >> (8 * (i & 3))); \
+	} \
+	k1 = IFVEC_LOAD(pattern); \
+	if (op == IFOP_ADDUINT) { \
+	    IFVEC_UNARY(IFVEC_ADDS(a, k1)); \
+	} else { \
+	    IFVEC_UNARY(IFVEC_SUBS(a, k1)); \
+	} \
+	break; \
+    case IFOP_SHIFTRIGHT: \
+	if (A > 7) { \
+	    k1 = IFVEC_SPLAT(0); \
+	    IFVEC_UNARY(k1); \
+	} else { \
+	    IFVEC_UNARY(IFVEC_SRL(a, A)); \
+	} \
+	break; \
+    case IFOP_SHIFTLEFTBYTE: \
+	if (A > 7) { \
+	    k1 = IFVEC_SPLAT(0); \
+	    IFVEC_UNARY(k1); \
+	} else { \
+	    IFVEC_UNARY(IFVEC_SLL(a, A)); \
+	} \
+	break; \
+    case IFOP_SHIFTRIGHTUINT: \
+	/* A shift of 32 bits is left to the C routine, whatever it makes of it */ \
+	if (A > 31) { \
+	    return (0); \
+	} \
+	IFVEC_UNARY(IFVEC_SRL32(a, A)); \
+	break; \
+    case IFOP_SHIFTLEFTUINT: \
+	if (A > 31) { \
+	    return (0); \
+	} \
+	IFVEC_UNARY(IFVEC_SLL32(a, A)); \
+	break;
+
+#if IFVEC_WIDE
+#define IFVEC_WIDE_LOCALS \
+    ifvec_t k2; \
+    ifvec16_t w, k16, n16; \
+    double reach;
+#define IFVEC_WIDE_CASES \
+    case IFOP_ABSDIFF: \
+	IFVEC_BINARY(IFVEC_OR(IFVEC_SUBS(a, b), IFVEC_SUBS(b, a))); \
+	break; \
+    case IFOP_BINARIZE: \
+	k1 = IFVEC_SPLAT(A); \
+	IFVEC_UNARY(IFVEC_CMPEQ(IFVEC_MAX(a, k1), a)); \
+	break; \
+    case IFOP_CLIPTORANGE: \
+	/* Tmin below it, else Tmax above it: with Tmin over Tmax that is Tmin or Tmax */ \
+	k1 = IFVEC_SPLAT(A); \
+	k2 = IFVEC_SPLAT(B); \
+	IFVEC_UNARY(IFVEC_XOR(k1, IFVEC_AND(IFVEC_CMPEQ(IFVEC_MAX(a, k1), a), IFVEC_XOR(IFVEC_MIN(a, k2), k1)))); \
+	break; \
+    case IFOP_MULT: \
+	IFVEC_BINARY(IFVEC_WIDE_BINARY(IFVEC16_MULT)); \
+	break; \
+    case IFOP_MULTNOR: \
+	IFVEC_BINARY(IFVEC_WIDE_BINARY(IFVEC16_MULTNOR)); \
+	break; \
+    case IFOP_MULTDIVBY2: \
+	IFVEC_BINARY(IFVEC_WIDE_BINARY(IFVEC16_MULTDIVBY2)); \
+	break; \
+    case IFOP_MULTDIVBY4: \
+	IFVEC_BINARY(IFVEC_WIDE_BINARY(IFVEC16_MULTDIVBY4)); \
+	break; \
+    case IFOP_MULTBYBYTE: \
+	w = IFVEC16_SPLAT(A); \
+	IFVEC_UNARY(IFVEC_WIDE_UNARY(IFVEC16_MULTBYBYTE)); \
+	break; \
+    case IFOP_SHIFTRIGHTANDMULTBYBYTE: \
+	w = IFVEC16_SPLAT(B); \
+	IFVEC_UNARY(IFVEC_WIDE_UNARY(IFVEC16_SHIFTRIGHTANDMULT)); \
+	break; \
+    case IFOP_SHIFTLEFT: \
+	IFVEC_UNARY(IFVEC_WIDE_UNARY(IFVEC16_SHIFTLEFT)); \
+	break; \
+    case IFOP_NORMALIZELINEAR: \
+	/* factor * (S - Cmin) + Nmin in 16 bits, when it cannot leave them */ \
+	reach = (double) abs(A) * ((B > 127) ? abs(B) : abs(255 - B)) + abs(C); \
+	if ((reach > 32767.0) || (abs(B) > 32767)) { \
+	    return (0); \
+	} \
+	w = IFVEC16_SPLAT(A); \
+	k16 = IFVEC16_SPLAT(B); \
+	n16 = IFVEC16_SPLAT(C); \
+	IFVEC_UNARY(IFVEC_WIDE_UNARY(IFVEC16_NORMALIZE)); \
+	break;
+#else
+#define IFVEC_WIDE_LOCALS
+#define IFVEC_WIDE_CASES
+#endif
+
+/* IFVEC_FILTER(name) defines 'name', with the IFVEC macros as they are where it is used
+   and IFVEC_TARGET in front, doing 'op' to the whole blocks of length bytes as the C
+   routines do, with the byte, shift, threshold or factor the op takes in A, and a second
+   one in B and a third in C. It returns the number of bytes done, 0 if the op has no
+   vector routine for these arguments or the MMX and vector routines are off. */
+#define IFVEC_TARGET
+#define IFVEC_FILTER(name) \
+static IFVEC_TARGET int name(int op, unsigned char *Src1, unsigned char *Src2, unsigned char *Dest, int length, \
+			     int A, int B, int C) \
+{ \
+    unsigned char pattern[IFVEC_SIZE]; \
+    ifvec_t a, b, k1; \
+    IFVEC_WIDE_LOCALS \
+    int i, n; \
+ \
+    if ((SDL_imageFilterUseMMX == 0) || (length < IFVEC_SIZE)) { \
+	return (0); \
+    } \
+    n = length & ~(IFVEC_SIZE - 1); \
+ \
+    switch (op) { \
+    IFVEC_BYTE_CASES \
+    IFVEC_WIDE_CASES \
+    default: \
+	return (0); \
+    } \
+ \
+    return (n); \
+}
+
+#if IFVEC_AVX2_CPU
+
+typedef int (*SDL_imageFilterVectorFunc) (int op, unsigned char *Src1, unsigned char *Src2, unsigned char *Dest,
+					  int length, int A, int B, int C);
+
+IFVEC_FILTER(SDL_imageFilterVectorSSE2)
+
+/* The same routine again, on AVX2 */
+#undef ifvec_t
+#undef IFVEC_SIZE
+#undef IFVEC_MM
+#undef IFVEC_SI
+#undef IFVEC_TARGET
+#define ifvec_t			__m256i
+#define IFVEC_SIZE		32
+#define IFVEC_MM(op)		_mm256_##op
+#define IFVEC_SI(op)		_mm256_##op##_si256
+#define IFVEC_TARGET		__attribute__ ((target("avx2")))
+
+IFVEC_FILTER(SDL_imageFilterVectorAVX2)
+
+static int SDL_imageFilterVectorFirst(int op, unsigned char *Src1, unsigned char *Src2, unsigned char *Dest, int length,
+				      int A, int B, int C);
+
+/* The routine for this CPU, once the first call has looked. Threads racing on the
+   first call store the same one. */
+static SDL_imageFilterVectorFunc SDL_imageFilterVector = SDL_imageFilterVectorFirst;
+
+static int SDL_imageFilterVectorFirst(int op, unsigned char *Src1, unsigned char *Src2, unsigned char *Dest, int length,
+				      int A, int B, int C)
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+	SDL_imageFilterVector = SDL_imageFilterVectorAVX2;
+    } else {
+	SDL_imageFilterVector = SDL_imageFilterVectorSSE2;
+    }
+    return (SDL_imageFilterVector(op, Src1, Src2, Dest, length, A, B, C));
+}
+
+#else
+
+IFVEC_FILTER(SDL_imageFilterVector)
+
+#endif
+
 /* ------------------------------------------------------------------------------------ */
 
 /*  SDL_imageFilterAdd: D = saturation255(S1 + S2) */
@@ -122,11 +639,11 @@ int SDL_imageFilterAdd(unsigned char *Src1, unsigned char *Src2, unsigned char *
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	cursrc2 = Src2;
-	curdst = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_ADD, Src1, Src2, Dest, length, 0, 0, 0);
+	cursrc1 = &Src1[istart];
+	cursrc2 = &Src2[istart];
+	curdst = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -210,11 +727,11 @@ int SDL_imageFilterMean(unsigned char *Src1, unsigned char *Src2, unsigned char
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	cursrc2 = Src2;
-	curdst = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_MEAN, Src1, Src2, Dest, length, 0, 0, 0);
+	cursrc1 = &Src1[istart];
+	cursrc2 = &Src2[istart];
+	curdst = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -280,11 +797,11 @@ int SDL_imageFilterSub(unsigned char *Src1, unsigned char *Src2, unsigned char *
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	cursrc2 = Src2;
-	curdst = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_SUB, Src1, Src2, Dest, length, 0, 0, 0);
+	cursrc1 = &Src1[istart];
+	cursrc2 = &Src2[istart];
+	curdst = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -356,11 +873,11 @@ int SDL_imageFilterAbsDiff(unsigned char *Src1, unsigned char *Src2, unsigned ch
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	cursrc2 = Src2;
-	curdst = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_ABSDIFF, Src1, Src2, Dest, length, 0, 0, 0);
+	cursrc1 = &Src1[istart];
+	cursrc2 = &Src2[istart];
+	curdst = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -446,11 +963,11 @@ int SDL_imageFilterMult(unsigned char *Src1, unsigned char *Src2, unsigned char
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	cursrc2 = Src2;
-	curdst = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_MULT, Src1, Src2, Dest, length, 0, 0, 0);
+	cursrc1 = &Src1[istart];
+	cursrc2 = &Src2[istart];
+	curdst = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -525,11 +1042,11 @@ int SDL_imageFilterMultNor(unsigned char *Src1, unsigned char *Src2, unsigned ch
 	return (0);
     }
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	cursrc2 = Src2;
-	curdst = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_MULTNOR, Src1, Src2, Dest, length, 0, 0, 0);
+	cursrc1 = &Src1[istart];
+	cursrc2 = &Src2[istart];
+	curdst = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -608,11 +1125,11 @@ int SDL_imageFilterMultDivby2(unsigned char *Src1, unsigned char *Src2, unsigned
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	cursrc2 = Src2;
-	curdst = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_MULTDIVBY2, Src1, Src2, Dest, length, 0, 0, 0);
+	cursrc1 = &Src1[istart];
+	cursrc2 = &Src2[istart];
+	curdst = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -695,11 +1212,11 @@ int SDL_imageFilterMultDivby4(unsigned char *Src1, unsigned char *Src2, unsigned
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	cursrc2 = Src2;
-	curdst = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_MULTDIVBY4, Src1, Src2, Dest, length, 0, 0, 0);
+	cursrc1 = &Src1[istart];
+	cursrc2 = &Src2[istart];
+	curdst = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -770,11 +1287,11 @@ int SDL_imageFilterBitAnd(unsigned char *Src1, unsigned char *Src2, unsigned cha
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	cursrc2 = Src2;
-	curdst = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_BITAND, Src1, Src2, Dest, length, 0, 0, 0);
+	cursrc1 = &Src1[istart];
+	cursrc2 = &Src2[istart];
+	curdst = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -840,11 +1357,11 @@ int SDL_imageFilterBitOr(unsigned char *Src1, unsigned char *Src2, unsigned char
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	cursrc2 = Src2;
-	curdst = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_BITOR, Src1, Src2, Dest, length, 0, 0, 0);
+	cursrc1 = &Src1[istart];
+	cursrc2 = &Src2[istart];
+	curdst = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -975,10 +1492,10 @@ int SDL_imageFilterBitNegation(unsigned char *Src1, unsigned char *Dest, int len
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	curdst = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_BITNEGATION, Src1, NULL, Dest, length, 0, 0, 0);
+	cursrc1 = &Src1[istart];
+	curdst = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -1054,10 +1571,10 @@ int SDL_imageFilterAddByte(unsigned char *Src1, unsigned char *Dest, int length,
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	curdest = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_ADDBYTE, Src1, NULL, Dest, length, C, 0, 0);
+	cursrc1 = &Src1[istart];
+	curdest = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -1136,10 +1653,10 @@ int SDL_imageFilterAddUint(unsigned char *Src1, unsigned char *Dest, int length,
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	curdest = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_ADDUINT, Src1, NULL, Dest, length, (int) C, 0, 0);
+	cursrc1 = &Src1[istart];
+	curdest = &Dest[istart];
     }
 
     /* C routine to process bytes */
@@ -1234,10 +1751,10 @@ int SDL_imageFilterAddByteToHalf(unsigned char *Src1, unsigned char *Dest, int l
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	curdest = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_ADDBYTETOHALF, Src1, NULL, Dest, length, C, 0, 0);
+	cursrc1 = &Src1[istart];
+	curdest = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -1317,10 +1834,10 @@ int SDL_imageFilterSubByte(unsigned char *Src1, unsigned char *Dest, int length,
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	curdest = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_SUBBYTE, Src1, NULL, Dest, length, C, 0, 0);
+	cursrc1 = &Src1[istart];
+	curdest = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -1398,10 +1915,10 @@ int SDL_imageFilterSubUint(unsigned char *Src1, unsigned char *Dest, int length,
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	curdest = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_SUBUINT, Src1, NULL, Dest, length, (int) C, 0, 0);
+	cursrc1 = &Src1[istart];
+	curdest = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -1499,10 +2016,10 @@ int SDL_imageFilterShiftRight(unsigned char *Src1, unsigned char *Dest, int leng
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	curdest = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_SHIFTRIGHT, Src1, NULL, Dest, length, N, 0, 0);
+	cursrc1 = &Src1[istart];
+	curdest = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -1570,17 +2087,17 @@ int SDL_imageFilterShiftRightUint(unsigned char *Src1, unsigned char *Dest, int
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	curdest = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_SHIFTRIGHTUINT, Src1, NULL, Dest, length, N, 0, 0);
+	cursrc1 = &Src1[istart];
+	curdest = &Dest[istart];
     }
 
     /* C routine to process image */
     icursrc1=(unsigned int *)cursrc1;
     icurdest=(unsigned int *)curdest;
     for (i = istart; i < length; i += 4) {
-     if ((i+4)<length) {
+     if ((i+4)<=length) {
 	result = ((unsigned int)*icursrc1 >> N);
 	*icurdest = (unsigned int)result;
      }
@@ -1682,10 +2199,10 @@ int SDL_imageFilterMultByByte(unsigned char *Src1, unsigned char *Dest, int leng
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	curdest = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_MULTBYBYTE, Src1, NULL, Dest, length, C, 0, 0);
+	cursrc1 = &Src1[istart];
+	curdest = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -1783,10 +2300,10 @@ int SDL_imageFilterShiftRightAndMultByByte(unsigned char *Src1, unsigned char *D
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	curdest = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_SHIFTRIGHTANDMULTBYBYTE, Src1, NULL, Dest, length, N, C, 0);
+	cursrc1 = &Src1[istart];
+	curdest = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -1873,10 +2390,10 @@ int SDL_imageFilterShiftLeftByte(unsigned char *Src1, unsigned char *Dest, int l
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	curdest = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_SHIFTLEFTBYTE, Src1, NULL, Dest, length, N, 0, 0);
+	cursrc1 = &Src1[istart];
+	curdest = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -1945,17 +2462,17 @@ int SDL_imageFilterShiftLeftUint(unsigned char *Src1, unsigned char *Dest, int l
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	curdest = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_SHIFTLEFTUINT, Src1, NULL, Dest, length, N, 0, 0);
+	cursrc1 = &Src1[istart];
+	curdest = &Dest[istart];
     }
 
     /* C routine to process image */
     icursrc1=(unsigned int *)cursrc1;
     icurdest=(unsigned int *)curdest;
     for (i = istart; i < length; i += 4) {
-     if ((i+4)<length) {
+     if ((i+4)<=length) {
 	result = ((unsigned int)*icursrc1 << N);
 	*icurdest = (unsigned int)result;
      }
@@ -2052,10 +2569,10 @@ int SDL_imageFilterShiftLeft(unsigned char *Src1, unsigned char *Dest, int lengt
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	curdest = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_SHIFTLEFT, Src1, NULL, Dest, length, N, 0, 0);
+	cursrc1 = &Src1[istart];
+	curdest = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -2136,10 +2653,10 @@ int SDL_imageFilterBinarizeUsingThreshold(unsigned char *Src1, unsigned char *De
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	curdest = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_BINARIZE, Src1, NULL, Dest, length, T, 0, 0);
+	cursrc1 = &Src1[istart];
+	curdest = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -2230,10 +2747,10 @@ int SDL_imageFilterClipToRange(unsigned char *Src1, unsigned char *Dest, int len
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
-	istart = 0;
-	cursrc1 = Src1;
-	curdest = Dest;
+	/* Vector routine for the whole blocks, C routine for the rest */
+	istart = SDL_imageFilterVector(IFOP_CLIPTORANGE, Src1, NULL, Dest, length, Tmin, Tmax, 0);
+	cursrc1 = &Src1[istart];
+	curdest = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -2360,10 +2877,14 @@ int SDL_imageFilterNormalizeLinear(unsigned char *Src1, unsigned char *Dest, int
 	    return (0);
 	}
     } else {
-	/* Setup to process whole image */
+	/* Vector routine for the whole blocks, C routine for the rest */
 	istart = 0;
-	cursrc1 = Src1;
-	curdest = Dest;
+	if (Cmax != Cmin) {
+	    istart = SDL_imageFilterVector(IFOP_NORMALIZELINEAR, Src1, NULL, Dest, length,
+					   (Nmax - Nmin) / (Cmax - Cmin), Cmin, Nmin);
+	}
+	cursrc1 = &Src1[istart];
+	curdest = &Dest[istart];
     }
 
     /* C routine to process image */
@@ -2387,6 +2908,324 @@ int SDL_imageFilterNormalizeLinear(unsigned char *Src1, unsigned char *Dest, int
 
 /* ------------------------------------------------------------------------------------ */
 
+/* Convolution without MMX                                                              */
+/*                                                                                      */
+/* Gives the same bytes as the MMX code. That multiplies in 16 bit words, keeping the   */
+/* low half of each product, and sums with saturation in 4 lanes before adding those   */
+/* up: lane l takes columns l and l+4 of each kernel row, and the last 4 shorts of a    */
+/* 9x9 kernel row, which it weighs with the pixels in columns 1+l. The rows of a 3x3    */
+/* kernel are 4 shorts apart, those of 5x5 and 7x7 kernels 8, those of 9x9 kernels 12.  */
+/*                                                                                      */
+/* When no sum can leave the 16 bit range, the lanes and the order of the sums make no  */
+/* difference, so the pixels are summed straight, in strips of columns narrow enough    */
+/* for the rows under the kernel to stay in the cache. A kernel that is a column times  */
+/* a row is run as a horizontal and then a vertical pass.                               */
+
+#define CONVOLVE_STRIP	512	/* Columns summed at a time */
+
+#if IFVEC_AVX2 || IFVEC_SSE2
+#define CONVOLVE_SSE2
+#elif IFVEC_NEON
+#define CONVOLVE_NEON
+#endif
+
+typedef struct {
+    int size;			/* 3, 5, 7 or 9 */
+    int shift;			/* NRightShift, or 0 */
+    int weight[9][9];		/* What the pixel under each kernel position counts */
+    int separable;		/* Whether weight[r][c] is column[r] * row[c] */
+    int column[9];
+    int row[9];
+} tConvolveKernel;
+
+static int SDL_imageFilterGCD(int a, int b)
+{
+    int t;
+
+    a = abs(a);
+    b = abs(b);
+    while (b) {
+	t = a % b;
+	a = b;
+	b = t;
+    }
+    return (a);
+}
+
+/* Works out the weights of the kernel; returns 0 if its sums might saturate */
+static int SDL_imageFilterConvolveSetup(tConvolveKernel * k, signed short *Kernel, int size, int NRightShift)
+{
+    int stride, r, c, l, columns, pivot, g, total;
+
+    stride = (size == 3) ? 4 : ((size == 9) ? 12 : 8);
+    columns = (size == 9) ? 8 : size;
+    k->size = size;
+    k->shift = NRightShift;
+    memset(k->weight, 0, sizeof(k->weight));
+    total = 0;
+    for (r = 0; r < size; r++) {
+	for (c = 0; c < columns; c++) {
+	    k->weight[r][c] = Kernel[r * stride + c];
+	    total += abs(Kernel[r * stride + c]);
+	}
+	if (size == 9) {
+	    for (l = 0; l < 4; l++) {
+		k->weight[r][1 + l] += Kernel[r * stride + 8 + l];
+		total += abs(Kernel[r * stride + 8 + l]);
+	    }
+	}
+    }
+    if (total * (255 >> NRightShift) > 32767) {
+	return (0);
+    }
+
+    /*
+     * Take the first row with a weight as the row vector, divided by what
+     * its weights have in common, and see if every row is a multiple of it 
+     */
+    k->separable = 0;
+    for (r = 0; r < size; r++) {
+	for (pivot = 0; pivot < size; pivot++) {
+	    if (k->weight[r][pivot]) {
+		break;
+	    }
+	}
+	if (pivot < size) {
+	    break;
+	}
+    }
+    if (r == size) {
+	return (1);
+    }
+    g = 0;
+    for (c = 0; c < size; c++) {
+	g = SDL_imageFilterGCD(g, k->weight[r][c]);
+    }
+    for (c = 0; c < size; c++) {
+	k->row[c] = k->weight[r][c] / g;
+    }
+    for (r = 0; r < size; r++) {
+	k->column[r] = k->weight[r][pivot] / k->row[pivot];
+	for (c = 0; c < size; c++) {
+	    if (k->weight[r][c] != k->column[r] * k->row[c]) {
+		return (1);
+	    }
+	}
+    }
+    k->separable = 1;
+    return (1);
+}
+
+/* The sum under the kernel at Src, as the MMX code works it out */
+static int SDL_imageFilterConvolveLanes(unsigned char *Src, int columns, signed short *Kernel, int size,
+					int NRightShift)
+{
+    int stride, r, l, sum, lane[4];
+
+#define SATURATE16(x) (((x) > 32767) ? 32767 : (((x) < -32768) ? -32768 : (x)))
+#define PRODUCT16(p, k) ((signed short) (((p) >> NRightShift) * (k)))
+
+    stride = (size == 3) ? 4 : ((size == 9) ? 12 : 8);
+    lane[0] = lane[1] = lane[2] = lane[3] = 0;
+    for (r = 0; r < size; r++) {
+	for (l = 0; l < 4; l++) {
+	    if (size == 3) {
+		sum = (l < 3) ? PRODUCT16(Src[l], Kernel[l]) : 0;
+	    } else if ((size == 9) || (l + 4 < size)) {
+		sum = SATURATE16(PRODUCT16(Src[l], Kernel[l]) + PRODUCT16(Src[l + 4], Kernel[l + 4]));
+	    } else {
+		sum = PRODUCT16(Src[l], Kernel[l]);
+	    }
+	    lane[l] = SATURATE16(lane[l] + sum);
+	    if (size == 9) {
+		lane[l] = SATURATE16(lane[l] + PRODUCT16(Src[1 + l], Kernel[8 + l]));
+	    }
+	}
+	Src += columns;
+	Kernel += stride;
+    }
+    lane[0] = SATURATE16(lane[0] + lane[2]);
+    lane[1] = SATURATE16(lane[1] + lane[3]);
+    return (SATURATE16(lane[0] + lane[1]));
+
+#undef PRODUCT16
+#undef SATURATE16
+}
+
+/* Sums[x] += Weight * (Src[x] >> NRightShift) */
+static void SDL_imageFilterMultiplyAddBytes(signed short *Sums, unsigned char *Src, int n, int Weight,
+					    int NRightShift)
+{
+    int x = 0;
+
+#if defined(CONVOLVE_SSE2)
+    __m128i zero = _mm_setzero_si128();
+    __m128i weight = _mm_set1_epi16((short) Weight);
+    __m128i shift = _mm_cvtsi32_si128(NRightShift);
+    __m128i pixels;
+
+    for (; x + 8 <= n; x += 8) {
+	pixels = _mm_srl_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((__m128i *) (Src + x)), zero), shift);
+	_mm_storeu_si128((__m128i *) (Sums + x),
+			 _mm_add_epi16(_mm_loadu_si128((__m128i *) (Sums + x)), _mm_mullo_epi16(pixels, weight)));
+    }
+#elif defined(CONVOLVE_NEON)
+    int16x8_t weight = vdupq_n_s16((short) Weight);
+    int16x8_t shift = vdupq_n_s16((short) -NRightShift);
+    int16x8_t pixels;
+
+    for (; x + 8 <= n; x += 8) {
+	pixels = vreinterpretq_s16_u16(vshlq_u16(vmovl_u8(vld1_u8(Src + x)), shift));
+	vst1q_s16(Sums + x, vmlaq_s16(vld1q_s16(Sums + x), pixels, weight));
+    }
+#endif
+    for (; x < n; x++) {
+	Sums[x] += Weight * (Src[x] >> NRightShift);
+    }
+}
+
+/* Sums[x] += Weight * Src[x] */
+static void SDL_imageFilterMultiplyAddShorts(signed short *Sums, signed short *Src, int n, int Weight)
+{
+    int x = 0;
+
+#if defined(CONVOLVE_SSE2)
+    __m128i weight = _mm_set1_epi16((short) Weight);
+
+    for (; x + 8 <= n; x += 8) {
+	_mm_storeu_si128((__m128i *) (Sums + x),
+			 _mm_add_epi16(_mm_loadu_si128((__m128i *) (Sums + x)),
+				       _mm_mullo_epi16(_mm_loadu_si128((__m128i *) (Src + x)), weight)));
+    }
+#elif defined(CONVOLVE_NEON)
+    int16x8_t weight = vdupq_n_s16((short) Weight);
+
+    for (; x + 8 <= n; x += 8) {
+	vst1q_s16(Sums + x, vmlaq_s16(vld1q_s16(Sums + x), vld1q_s16(Src + x), weight));
+    }
+#endif
+    for (; x < n; x++) {
+	Sums[x] += Weight * Src[x];
+    }
+}
+
+/* Dest[x] = saturation0and255(Sums[x] / Divisor), or of Sums[x] with no Divisor */
+static void SDL_imageFilterConvolveStore(unsigned char *Dest, signed short *Sums, int n, int Divisor)
+{
+    int x, result;
+
+    for (x = 0; x < n; x++) {
+	result = Divisor ? Sums[x] / Divisor : Sums[x];
+	if (result < 0)
+	    result = 0;
+	if (result > 255)
+	    result = 255;
+	Dest[x] = (unsigned char) result;
+    }
+}
+
+static int SDL_imageFilterConvolveKernelC(unsigned char *Src, unsigned char *Dest, int rows, int columns,
+					  signed short *Kernel, int size, int Divisor, int NRightShift)
+{
+    tConvolveKernel k;
+    signed short *sums, *passes;
+    int half, x, y, x0, n, r, c, result;
+
+    half = size / 2;
+    sums = NULL;
+    if (SDL_imageFilterConvolveSetup(&k, Kernel, size, NRightShift)) {
+	sums = (signed short *) malloc(CONVOLVE_STRIP * (1 + size) * sizeof(signed short));
+    }
+
+    if (sums == NULL) {
+	/* Go through the lanes for every pixel */
+	for (y = half; y < rows - half; y++) {
+	    for (x = half; x < columns - half; x++) {
+		result = SDL_imageFilterConvolveLanes(Src + (y - half) * columns + x - half, columns,
+						      Kernel, size, NRightShift);
+		if (Divisor)
+		    result /= Divisor;
+		if (result < 0)
+		    result = 0;
+		if (result > 255)
+		    result = 255;
+		Dest[y * columns + x] = (unsigned char) result;
+	    }
+	}
+	return (0);
+    }
+
+    /* Separable kernels keep the horizontal pass of the rows under the kernel */
+    passes = sums + CONVOLVE_STRIP;
+    for (x0 = half; x0 < columns - half; x0 += CONVOLVE_STRIP) {
+	n = columns - half - x0;
+	if (n > CONVOLVE_STRIP)
+	    n = CONVOLVE_STRIP;
+	for (y = half; y < rows - half; y++) {
+	    memset(sums, 0, n * sizeof(signed short));
+	    if (k.separable) {
+		for (r = (y == half) ? 0 : size - 1; r < size; r++) {
+		    signed short *pass = passes + ((y - half + r) % size) * CONVOLVE_STRIP;
+
+		    memset(pass, 0, n * sizeof(signed short));
+		    for (c = 0; c < size; c++) {
+			if (k.row[c]) {
+			    SDL_imageFilterMultiplyAddBytes(pass, Src + (y - half + r) * columns + x0 - half + c,
+							    n, k.row[c], NRightShift);
+			}
+		    }
+		}
+		for (r = 0; r < size; r++) {
+		    if (k.column[r]) {
+			SDL_imageFilterMultiplyAddShorts(sums, passes + ((y - half + r) % size) * CONVOLVE_STRIP,
+							 n, k.column[r]);
+		    }
+		}
+	    } else {
+		for (r = 0; r < size; r++) {
+		    for (c = 0; c < size; c++) {
+			if (k.weight[r][c]) {
+			    SDL_imageFilterMultiplyAddBytes(sums, Src + (y - half + r) * columns + x0 - half + c,
+							    n, k.weight[r][c], NRightShift);
+			}
+		    }
+		}
+	    }
+	    SDL_imageFilterConvolveStore(Dest + y * columns + x0, sums, n, Divisor);
+	}
+    }
+
+    free(sums);
+    return (0);
+}
+
+/* SobelX without MMX: the MMX code does the columns 8 at a time, leaving those past */
+/* the last 8 alone, and reads the right neighbor of the last column from the next   */
+/* row; that one is left alone too.                                                  */
+static int SDL_imageFilterSobelXC(unsigned char *Src, unsigned char *Dest, int rows, int columns,
+				  int NRightShift)
+{
+    unsigned char *above, *row, *below, *dest;
+    int x, y, last, left, right, result;
+
+    last = (columns & ~7);
+    if (last > columns - 2)
+	last = columns - 2;
+    for (y = 1; y < rows - 1; y++) {
+	above = Src + (y - 1) * columns;
+	row = above + columns;
+	below = row + columns;
+	dest = Dest + y * columns;
+	for (x = 1; x <= last; x++) {
+	    left = (above[x - 1] >> NRightShift) + 2 * (row[x - 1] >> NRightShift) + (below[x - 1] >> NRightShift);
+	    right = (above[x + 1] >> NRightShift) + 2 * (row[x + 1] >> NRightShift) + (below[x + 1] >> NRightShift);
+	    result = abs(right - left);
+	    dest[x] = (unsigned char) ((result > 255) ? 255 : result);
+	}
+    }
+    return (0);
+}
+
 /*  SDL_imageFilterConvolveKernel3x3Divide: Dij = saturation0and255( ... ) */
 int SDL_imageFilterConvolveKernel3x3Divide(unsigned char *Src, unsigned char *Dest, int rows, int columns,
 					   signed short *Kernel, unsigned char Divisor)
@@ -2476,8 +3315,7 @@ int SDL_imageFilterConvolveKernel3x3Divide(unsigned char *Src, unsigned char *De
 #endif
 	return (0);
     } else {
-	/* No non-MMX implementation yet */
-	return (-1);
+	return (SDL_imageFilterConvolveKernelC(Src, Dest, rows, columns, Kernel, 3, Divisor, 0));
     }
 }
 
@@ -2626,8 +3464,7 @@ int SDL_imageFilterConvolveKernel5x5Divide(unsigned char *Src, unsigned char *De
 #endif
 	return (0);
     } else {
-	/* No non-MMX implementation yet */
-	return (-1);
+	return (SDL_imageFilterConvolveKernelC(Src, Dest, rows, columns, Kernel, 5, Divisor, 0));
     }
 }
 
@@ -2802,8 +3639,7 @@ int SDL_imageFilterConvolveKernel7x7Divide(unsigned char *Src, unsigned char *De
 #endif
 	return (0);
     } else {
-	/* No non-MMX implementation yet */
-	return (-1);
+	return (SDL_imageFilterConvolveKernelC(Src, Dest, rows, columns, Kernel, 7, Divisor, 0));
     }
 }
 
@@ -3069,8 +3905,7 @@ int SDL_imageFilterConvolveKernel9x9Divide(unsigned char *Src, unsigned char *De
 #endif
 	return (0);
     } else {
-	/* No non-MMX implementation yet */
-	return (-1);
+	return (SDL_imageFilterConvolveKernelC(Src, Dest, rows, columns, Kernel, 9, Divisor, 0));
     }
 }
 
@@ -3156,8 +3991,7 @@ int SDL_imageFilterConvolveKernel3x3ShiftRight(unsigned char *Src, unsigned char
 #endif
 	return (0);
     } else {
-	/* No non-MMX implementation yet */
-	return (-1);
+	return (SDL_imageFilterConvolveKernelC(Src, Dest, rows, columns, Kernel, 3, 0, NRightShift));
     }
 }
 
@@ -3305,8 +4139,7 @@ int SDL_imageFilterConvolveKernel5x5ShiftRight(unsigned char *Src, unsigned char
 #endif
 	return (0);
     } else {
-	/* No non-MMX implementation yet */
-	return (-1);
+	return (SDL_imageFilterConvolveKernelC(Src, Dest, rows, columns, Kernel, 5, 0, NRightShift));
     }
 }
 
@@ -3484,8 +4317,7 @@ int SDL_imageFilterConvolveKernel7x7ShiftRight(unsigned char *Src, unsigned char
 #endif
 	return (0);
     } else {
-	/* No non-MMX implementation yet */
-	return (-1);
+	return (SDL_imageFilterConvolveKernelC(Src, Dest, rows, columns, Kernel, 7, 0, NRightShift));
     }
 }
 
@@ -3767,8 +4599,7 @@ int SDL_imageFilterConvolveKernel9x9ShiftRight(unsigned char *Src, unsigned char
 #endif
 	return (0);
     } else {
-	/* No non-MMX implementation yet */
-	return (-1);
+	return (SDL_imageFilterConvolveKernelC(Src, Dest, rows, columns, Kernel, 9, 0, NRightShift));
     }
 }
 
@@ -3893,8 +4724,7 @@ int SDL_imageFilterSobelX(unsigned char *Src, unsigned char *Dest, int rows, int
 #endif
 	return (0);
     } else {
-	/* No non-MMX implementation yet */
-	return (-1);
+	return (SDL_imageFilterSobelXC(Src, Dest, rows, columns, 0));
     }
 }
 
@@ -4034,8 +4864,7 @@ int SDL_imageFilterSobelXShiftRight(unsigned char *Src, unsigned char *Dest, int
 #endif
 	return (0);
     } else {
-	/* No non-MMX implementation yet */
-	return (-1);
+	return (SDL_imageFilterSobelXC(Src, Dest, rows, columns, NRightShift));
     }
 }
 
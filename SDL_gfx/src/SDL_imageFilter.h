@@ -30,12 +30,19 @@ extern "C" {
 /* Comments:                                                                           */
 /*  1.) MMX functions work best if all data blocks are aligned on a 32 bytes boundary. */
 /*  2.) Data that is not within an 8 byte boundary is processed using the C routine.   */
-/*  3.) Convolution routines do not have C routines at this time.                      */
+/*  3.) Convolution routines give the same results with or without MMX. The rows of a  */
+/*      3x3 kernel are 4 shorts apart, those of 5x5 and 7x7 kernels 8 and those of 9x9 */
+/*      kernels 12, the shorts past the kernel size 0. The MMX code weighs the ninth   */
+/*      column of a 9x9 kernel with the second column of the image, and so does the C  */
+/*      routine. SobelX leaves the last column alone without MMX.                      */
+/*  4.) Without MMX, the byte-wise routines other than Div run on the SSE2, NEON or    */
+/*      AltiVec unit the library was compiled for, or on AVX2 where the CPU has it,    */
+/*      16 or 32 bytes at a time, giving the same results as the C routines.           */
 
 // Detect MMX capability in CPU
     DLLINTERFACE int SDL_imageFilterMMXdetect(void);
 
-// Force use of MMX off (or turn possible use back on)
+// Force use of MMX and the vector units off (or turn possible use back on)
     DLLINTERFACE void SDL_imageFilterMMXoff(void);
     DLLINTERFACE void SDL_imageFilterMMXon(void);
 
@@ -17,6 +17,150 @@
 
 #define MAX(a,b)    (((a) > (b)) ? (a) : (b))
 
+/* 
+
+ Vector kernels
+
+ The smooth zoomer, the shrinker and the mipmapper work on two 32bit
+ pixels at a time when the CPU has SSE2, through a small vector
+ abstraction:
+
+   zoomvec_t			8 16bit lanes, the 4 channels of 2 pixels
+   ZOOMVEC_AVAILABLE()		whether the CPU running us has the unit
+   ZOOMVEC_ZERO()		all lanes 0
+   ZOOMVEC_LOAD2(p, q)		the pixels at p and q, one channel a lane
+   ZOOMVEC_STORE2(p, v)		2 pixels to p, clamping the lanes to 0-255
+   ZOOMVEC_STORE16(p, v)	the 8 lanes to p as Uint16s
+   ZOOMVEC_WEIGHTS(a, b)	0-65535 weights, a for the first pixel, b the second
+   ZOOMVEC_LERP(a, b, w)	a + (((b - a) * w) >> 16), as the C code rounds it
+   ZOOMVEC_ADD(a, b)		add, wrapping around at 65536
+   ZOOMVEC_AVERAGE4(a, b, c, d)	(a + b + c + d + 2) >> 2
+
+ The kernels are tested to match the plain C loops exactly.
+ 
+*/
+
+#if SDL_ASSEMBLY_ROUTINES
+#  if defined(__GNUC__) && defined(__SSE2__)
+#    define ZOOMVEC_SSE2	1
+#  endif
+#endif
+
+#if ZOOMVEC_SSE2
+#include <emmintrin.h>
+
+typedef __m128i zoomvec_t;
+
+#define ZOOMVEC_AVAILABLE()	SDL_HasSSE2()
+#define ZOOMVEC_ZERO()		_mm_setzero_si128()
+#define ZOOMVEC_LOAD2(p, q)	_mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128(*(const int *)(p)), _mm_cvtsi32_si128(*(const int *)(q))), _mm_setzero_si128())
+#define ZOOMVEC_STORE2(p, v)	_mm_storel_epi64((__m128i *)(p), _mm_packus_epi16(v, v))
+#define ZOOMVEC_STORE16(p, v)	_mm_storeu_si128((__m128i *)(p), v)
+#define ZOOMVEC_WEIGHTS(a, b)	_mm_set_epi16((short)(b), (short)(b), (short)(b), (short)(b), (short)(a), (short)(a), (short)(a), (short)(a))
+#define ZOOMVEC_ADD(a, b)	_mm_add_epi16(a, b)
+#define ZOOMVEC_AVERAGE4(a, b, c, d)	_mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(_mm_add_epi16(a, b), _mm_add_epi16(c, d)), _mm_set1_epi16(2)), 2)
+#define ZOOMVEC_LERP(a, b, w)	ZoomVec_Lerp(a, b, w)
+
+static __inline__ zoomvec_t ZoomVec_Lerp(zoomvec_t a, zoomvec_t b, zoomvec_t w)
+{
+    __m128i d = _mm_sub_epi16(b, a);
+
+    /* Weights from 32768 up read as negative, which takes d off too much */
+    return _mm_add_epi16(_mm_add_epi16(a, _mm_mulhi_epi16(d, w)),
+			 _mm_and_si128(d, _mm_srai_epi16(w, 15)));
+}
+
+#endif
+
+#if ZOOMVEC_SSE2
+#define ZOOMVEC	1
+#endif
+
+/* 1 once the vector kernels are found to work here, 0 if not, -1 before */
+static int zoomVector = -1;
+
+static int _zoomVector(void)
+{
+    if (zoomVector < 0) {
+#if ZOOMVEC
+	zoomVector = ZOOMVEC_AVAILABLE() ? 1 : 0;
+#else
+	zoomVector = 0;
+#endif
+    }
+    return (zoomVector);
+}
+
+/* Publically available vector kernel control function */
+
+int rotozoomSetSIMD(int enable)
+{
+    if (enable >= 0) {
+#if ZOOMVEC
+	zoomVector = (enable && ZOOMVEC_AVAILABLE()) ? 1 : 0;
+#else
+	zoomVector = 0;
+#endif
+    }
+    return (_zoomVector());
+}
+
+
+#if ZOOMVEC
+
+/* 
+ 
+ 32bit integer-factor averaging Shrinker on the vector unit
+
+ Sums two boxes side by side at a time, in 16bit lanes, which hold the sum
+ of up to 257 pixels. Dividing by multiplying with the 32.32 reciprocal of
+ the box size gives the same quotients as dividing for sums up to 65535.
+ 
+*/
+
+static int _shrinkSurfaceRGBAVector(SDL_Surface * src, SDL_Surface * dst, int factorx, int factory)
+{
+    int x, y, dx, dy, i, bytes;
+    Uint64 reciprocal;
+    Uint16 sums[8];
+    zoomvec_t sum;
+    Uint8 *sp, *box, *next, *dp;
+
+    reciprocal = ((Uint64) 1 << 32) / (factorx * factory) + 1;
+
+    for (y = 0; y < dst->h; y++) {
+	sp = (Uint8 *) src->pixels + y * factory * src->pitch;
+	dp = (Uint8 *) dst->pixels + y * dst->pitch;
+	for (x = 0; x < dst->w; x += 2) {
+	    box = sp + x * factorx * 4;
+	    /* The last box of an odd width is summed twice */
+	    if (x + 1 < dst->w) {
+		next = box + factorx * 4;
+		bytes = 8;
+	    } else {
+		next = box;
+		bytes = 4;
+	    }
+	    sum = ZOOMVEC_ZERO();
+	    for (dy = 0; dy < factory; dy++) {
+		for (dx = 0; dx < factorx * 4; dx += 4) {
+		    sum = ZOOMVEC_ADD(sum, ZOOMVEC_LOAD2(box + dx, next + dx));
+		}
+		box += src->pitch;
+		next += src->pitch;
+	    }
+	    ZOOMVEC_STORE16(sums, sum);
+	    for (i = 0; i < bytes; i++) {
+		dp[i] = (Uint8) ((sums[i] * reciprocal) >> 32);
+	    }
+	    dp += bytes;
+	}
+    }
+
+    return (0);
+}
+
+#endif
 
 /* 
  
@@ -39,6 +183,12 @@ int shrinkSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int factorx, int fac
 
     /* Precalculate division factor */
     n_average = factorx*factory;
+
+#if ZOOMVEC
+    if (_zoomVector() && (n_average <= 257)) {
+	return (_shrinkSurfaceRGBAVector(src, dst, factorx, factory));
+    }
+#endif
    
     /*
      * Scan destination
@@ -168,72 +318,409 @@ int shrinkSurfaceY(SDL_Surface * src, SDL_Surface * dst, int factorx, int factor
 }
 
 /* 
- 
- 32bit Zoomer with optional anti-aliasing by bilinear interpolation.
 
- Zoomes 32bit RGBA/ABGR 'src' surface to 'dst' surface.
+ Worker threads and step tables
+
+ The rotozoomers split the destination surface into bands of rows, which
+ rotozoomSetThreads() worker threads and the calling thread render side by
+ side. Each row is worked out from its own y only, so the result is the
+ same however the rows are split up. The step tables of the zoomers are
+ kept for the last few sizes zoomed between.
+
+ One caller at a time has the workers; callers on other threads meanwhile
+ render on their own rather than wait. The lock is only held to claim the
+ workers and to look up or add step tables.
  
 */
 
-int zoomSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, int smooth)
+/* Publishes the lock made by whichever caller comes first */
+#if defined(__GNUC__)
+#define ROTOZOOM_CAS(p, old, new)	__sync_bool_compare_and_swap(p, old, new)
+#elif defined(WIN32)
+#define ROTOZOOM_CAS(p, old, new)	(InterlockedCompareExchangePointer((PVOID *) (p), new, old) == (old))
+#else
+#define ROTOZOOM_CAS(p, old, new)	((*(p) == (old)) ? (*(p) = (new), 1) : 0)
+#endif
+
+#define ROTOZOOM_MAX_THREADS	16
+#define ROTOZOOM_BANDS		4	/* Bands per thread, to even out the load */
+#define ROTOZOOM_MIN_PIXELS	16384	/* Smaller surfaces are left to one thread */
+#define ZOOM_TABLES		8
+
+typedef struct tRotozoomJob {
+    SDL_Surface *src;
+    SDL_Surface *dst;
+    int cx, cy, isin, icos;
+    int flipx, flipy, smooth;
+    int vector;
+    int *sax, *say;
+} tRotozoomJob;
+
+typedef void (*tRotozoomRows) (tRotozoomJob * job, int y0, int y1);
+
+typedef struct tZoomTables {
+    int kind;
+    int srcw, srch, dstw, dsth;
+    int *sax, *say;
+    Uint32 used;
+    int users;		/* Zooms running with them */
+    int cached;		/* Else freed once their zoom is done */
+} tZoomTables;
+
+/* Guards the pool and tables below */
+static SDL_mutex *rotozoomLock = NULL;
+
+static struct {
+    int threads;
+    SDL_Thread *thread[ROTOZOOM_MAX_THREADS];
+    SDL_sem *start;
+    SDL_sem *done;
+    SDL_mutex *lock;
+    int quit;
+    tRotozoomRows rows;
+    tRotozoomJob *job;
+    int height;
+    int bands;
+    int next;
+    int busy;		/* A caller has the workers */
+} rotozoomPool = { 1 };
+
+static tZoomTables zoomTables[ZOOM_TABLES];
+static Uint32 zoomTablesUsed = 0;
+
+static int _rotozoomLock(void)
 {
-    int x, y, sx, sy, *sax, *say, *csax, *csay, csx, csy, ex, ey, t1, t2, sstep;
-    tColorRGBA *c00, *c01, *c10, *c11;
-    tColorRGBA *sp, *csp, *dp;
-    int dgap;
+    SDL_mutex *lock;
 
-    /*
-     * Variable setup 
-     */
-    if (smooth) {
-	/*
-	 * For interpolation: assume source dimension is one pixel 
-	 */
-	/*
-	 * smaller to avoid overflow on right and bottom edge.     
-	 */
-	sx = (int) (65536.0 * (float) (src->w - 1) / (float) dst->w);
-	sy = (int) (65536.0 * (float) (src->h - 1) / (float) dst->h);
-    } else {
-	sx = (int) (65536.0 * (float) src->w / (float) dst->w);
-	sy = (int) (65536.0 * (float) src->h / (float) dst->h);
+    if (rotozoomLock == NULL) {
+	lock = SDL_CreateMutex();
+	if (lock == NULL) {
+	    return (-1);
+	}
+	if (!ROTOZOOM_CAS(&rotozoomLock, NULL, lock)) {
+	    SDL_DestroyMutex(lock);
+	}
+    }
+    return (SDL_mutexP(rotozoomLock));
+}
+
+static void _rotozoomUnlock(void)
+{
+    SDL_mutexV(rotozoomLock);
+}
+
+/* Render bands until there are none left */
+static void _rotozoomBands(void)
+{
+    int band, y0, y1;
+
+    for (;;) {
+	SDL_mutexP(rotozoomPool.lock);
+	band = rotozoomPool.next++;
+	SDL_mutexV(rotozoomPool.lock);
+	if (band >= rotozoomPool.bands) {
+	    break;
+	}
+	y0 = rotozoomPool.height * band / rotozoomPool.bands;
+	y1 = rotozoomPool.height * (band + 1) / rotozoomPool.bands;
+	rotozoomPool.rows(rotozoomPool.job, y0, y1);
     }
+}
+
+static int _rotozoomWorker(void *unused)
+{
+    for (;;) {
+	SDL_SemWait(rotozoomPool.start);
+	if (rotozoomPool.quit) {
+	    break;
+	}
+	_rotozoomBands();
+	SDL_SemPost(rotozoomPool.done);
+    }
+    return (0);
+}
+
+/* Render every row of job->dst, on all the threads if it's worth it */
+static void _rotozoomRun(tRotozoomRows rows, tRotozoomJob * job)
+{
+    int i, workers;
+
+    if ((job->dst->w * job->dst->h < ROTOZOOM_MIN_PIXELS) || (_rotozoomLock() < 0)) {
+	rows(job, 0, job->dst->h);
+	return;
+    }
+    workers = rotozoomPool.busy ? 0 : rotozoomPool.threads - 1;
+    if (workers > 0) {
+	rotozoomPool.busy = 1;
+    }
+    _rotozoomUnlock();
+    if (workers <= 0) {
+	rows(job, 0, job->dst->h);
+	return;
+    }
+
+    rotozoomPool.rows = rows;
+    rotozoomPool.job = job;
+    rotozoomPool.height = job->dst->h;
+    rotozoomPool.bands = rotozoomPool.threads * ROTOZOOM_BANDS;
+    if (rotozoomPool.bands > job->dst->h) {
+	rotozoomPool.bands = job->dst->h;
+    }
+    rotozoomPool.next = 0;
+    for (i = 0; i < workers; i++) {
+	SDL_SemPost(rotozoomPool.start);
+    }
+    _rotozoomBands();
+    for (i = 0; i < workers; i++) {
+	SDL_SemWait(rotozoomPool.done);
+    }
+
+    SDL_mutexP(rotozoomLock);
+    rotozoomPool.busy = 0;
+    _rotozoomUnlock();
+}
+
+static void _rotozoomStopThreads(void)
+{
+    int i;
+
+    rotozoomPool.quit = 1;
+    for (i = 0; i < rotozoomPool.threads - 1; i++) {
+	SDL_SemPost(rotozoomPool.start);
+    }
+    for (i = 0; i < rotozoomPool.threads - 1; i++) {
+	SDL_WaitThread(rotozoomPool.thread[i], NULL);
+	rotozoomPool.thread[i] = NULL;
+    }
+    rotozoomPool.threads = 1;
+    rotozoomPool.quit = 0;
+}
+
+/* Publically available thread control function */
+
+int rotozoomSetThreads(int threads)
+{
+    if (threads < 0) {
+	return (rotozoomPool.threads);
+    }
+    if (threads < 1) {
+	threads = 1;
+    }
+    if (threads > ROTOZOOM_MAX_THREADS) {
+	threads = ROTOZOOM_MAX_THREADS;
+    }
+    if (_rotozoomLock() < 0) {
+	return (-1);
+    }
+    /* Wait for the caller rendering with the workers */
+    while (rotozoomPool.busy) {
+	_rotozoomUnlock();
+	SDL_Delay(1);
+	if (_rotozoomLock() < 0) {
+	    return (-1);
+	}
+    }
+
+    _rotozoomStopThreads();
+    if (threads > 1) {
+	if (rotozoomPool.start == NULL) {
+	    rotozoomPool.start = SDL_CreateSemaphore(0);
+	    rotozoomPool.done = SDL_CreateSemaphore(0);
+	    rotozoomPool.lock = SDL_CreateMutex();
+	}
+	if (rotozoomPool.start && rotozoomPool.done && rotozoomPool.lock) {
+	    while (rotozoomPool.threads < threads) {
+		rotozoomPool.thread[rotozoomPool.threads - 1] =
+		    SDL_CreateThread(_rotozoomWorker, NULL);
+		if (rotozoomPool.thread[rotozoomPool.threads - 1] == NULL) {
+		    break;
+		}
+		rotozoomPool.threads++;
+	    }
+	}
+    }
+    threads = rotozoomPool.threads;
+
+    _rotozoomUnlock();
+    return (threads);
+}
+
+/* 
+
+ Step tables for zooming between two sizes, made once and then taken from
+ the cache. The RGBA tables hold 16.16 positions with dst->w+1 and dst->h+1
+ entries, the Y tables whole pixel steps with dst->w and dst->h entries.
+
+*/
+
+#define ZOOM_TABLES_RGBA	0
+#define ZOOM_TABLES_RGBA_SMOOTH	1
+#define ZOOM_TABLES_Y		2
+
+static tZoomTables *_zoomTables(int kind, SDL_Surface * src, SDL_Surface * dst)
+{
+    tZoomTables *tables, *oldest;
+    int i, x, y, sx, sy, csx, csy, *sax, *say;
+
+    if (_rotozoomLock() < 0) {
+	return (NULL);
+    }
+    for (i = 0; i < ZOOM_TABLES; i++) {
+	tables = &zoomTables[i];
+	if ((tables->sax != NULL) && (tables->kind == kind) &&
+	    (tables->srcw == src->w) && (tables->srch == src->h) &&
+	    (tables->dstw == dst->w) && (tables->dsth == dst->h)) {
+	    tables->used = ++zoomTablesUsed;
+	    tables->users++;
+	    _rotozoomUnlock();
+	    return (tables);
+	}
+    }
+    _rotozoomUnlock();
 
     /*
      * Allocate memory for row increments 
      */
     if ((sax = (int *) malloc((dst->w + 1) * sizeof(Uint32))) == NULL) {
-	return (-1);
+	return (NULL);
     }
     if ((say = (int *) malloc((dst->h + 1) * sizeof(Uint32))) == NULL) {
 	free(sax);
-	return (-1);
+	return (NULL);
     }
 
     /*
      * Precalculate row increments 
      */
-    sp = csp = (tColorRGBA *) src->pixels;
-    dp = (tColorRGBA *) dst->pixels;
+    if (kind == ZOOM_TABLES_Y) {
+	sx = (Uint32) (65536.0 * (float) src->w / (float) dst->w);
+	sy = (Uint32) (65536.0 * (float) src->h / (float) dst->h);
+	csx = 0;
+	for (x = 0; x < dst->w; x++) {
+	    csx += sx;
+	    sax[x] = ((Uint32) csx >> 16);
+	    csx &= 0xffff;
+	}
+	csy = 0;
+	for (y = 0; y < dst->h; y++) {
+	    csy += sy;
+	    say[y] = ((Uint32) csy >> 16);
+	    csy &= 0xffff;
+	}
+    } else {
+	if (kind == ZOOM_TABLES_RGBA_SMOOTH) {
+	    /*
+	     * For interpolation: assume source dimension is one pixel 
+	     */
+	    /*
+	     * smaller to avoid overflow on right and bottom edge.     
+	     */
+	    sx = (int) (65536.0 * (float) (src->w - 1) / (float) dst->w);
+	    sy = (int) (65536.0 * (float) (src->h - 1) / (float) dst->h);
+	} else {
+	    sx = (int) (65536.0 * (float) src->w / (float) dst->w);
+	    sy = (int) (65536.0 * (float) src->h / (float) dst->h);
+	}
+	csx = 0;
+	for (x = 0; x <= dst->w; x++) {
+	    sax[x] = csx;
+	    csx &= 0xffff;
+	    csx += sx;
+	}
+	csy = 0;
+	for (y = 0; y <= dst->h; y++) {
+	    say[y] = csy;
+	    csy &= 0xffff;
+	    csy += sy;
+	}
+    }
 
-    if (flipx) csp += (src->w-1);
-    if (flipy) csp  = (tColorRGBA*)( (Uint8*)csp + src->pitch*(src->h-1) );
+    /*
+     * Replace the tables used longest ago that no zoom is using, or keep
+     * these to this zoom if there are none
+     */
+    if (_rotozoomLock() < 0) {
+	free(sax);
+	free(say);
+	return (NULL);
+    }
+    oldest = NULL;
+    for (i = 0; i < ZOOM_TABLES; i++) {
+	tables = &zoomTables[i];
+	if ((tables->users == 0) && ((oldest == NULL) || (tables->used < oldest->used))) {
+	    oldest = tables;
+	}
+    }
+    if (oldest != NULL) {
+	tables = oldest;
+	free(tables->sax);
+	free(tables->say);
+	tables->cached = 1;
+    } else if ((tables = (tZoomTables *) malloc(sizeof(tZoomTables))) != NULL) {
+	tables->cached = 0;
+    } else {
+	_rotozoomUnlock();
+	free(sax);
+	free(say);
+	return (NULL);
+    }
+    tables->kind = kind;
+    tables->srcw = src->w;
+    tables->srch = src->h;
+    tables->dstw = dst->w;
+    tables->dsth = dst->h;
+    tables->sax = sax;
+    tables->say = say;
+    tables->used = ++zoomTablesUsed;
+    tables->users = 1;
+    _rotozoomUnlock();
+    return (tables);
+}
 
-    csx = 0;
-    csax = sax;
-    for (x = 0; x <= dst->w; x++) {
-	*csax = csx;
-	csax++;
-	csx &= 0xffff;
-	csx += sx;
+/* Give back the tables of a zoom that is done */
+static void _zoomTablesDone(tZoomTables * tables)
+{
+    SDL_mutexP(rotozoomLock);
+    if (tables->cached) {
+	tables->users--;
+    } else {
+	free(tables->sax);
+	free(tables->say);
+	free(tables);
     }
-    csy = 0;
-    csay = say;
-    for (y = 0; y <= dst->h; y++) {
-	*csay = csy;
-	csay++;
-	csy &= 0xffff;
-	csy += sy;
+    _rotozoomUnlock();
+}
+
+/* 
+ 
+ 32bit Zoomer with optional anti-aliasing by bilinear interpolation.
+
+ Zoomes 32bit RGBA/ABGR 'src' surface to 'dst' surface.
+ 
+*/
+
+static void _zoomRowsRGBA(tRotozoomJob * job, int y0, int y1)
+{
+    SDL_Surface *src = job->src;
+    SDL_Surface *dst = job->dst;
+    int x, y, *csax, *csay, ex, ey, t1, t2, sstep;
+    tColorRGBA *c00, *c01, *c10, *c11;
+    tColorRGBA *sp, *csp, *dp;
+    int dgap;
+
+    /*
+     * Pointer setup, skipping the source rows above y0 
+     */
+    csp = (tColorRGBA *) src->pixels;
+    dp = (tColorRGBA *) ((Uint8 *) dst->pixels + y0 * dst->pitch);
+
+    if (job->flipx) csp += (src->w-1);
+    if (job->flipy) csp  = (tColorRGBA*)( (Uint8*)csp + src->pitch*(src->h-1) );
+
+    for (y = 1; y <= y0; y++) {
+	sstep = (job->say[y] >> 16) * src->pitch;
+	if (job->flipy && !job->smooth) sstep = -sstep;
+	csp = (tColorRGBA *) ((Uint8 *) csp + sstep);
     }
 
     dgap = dst->pitch - dst->w * 4;
@@ -241,7 +728,7 @@ int zoomSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy,
     /*
      * Switch between interpolating and non-interpolating code 
      */
-    if (smooth) {
+    if (job->smooth) {
 
 	/*
 	 * Interpolating Zoom 
@@ -250,19 +737,47 @@ int zoomSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy,
 	/*
 	 * Scan destination 
 	 */
-	csay = say;
-	for (y = 0; y < dst->h; y++) {
+	csay = job->say + y0;
+	for (y = y0; y < y1; y++) {
+	    c00 = csp;
+	    csax = job->sax;
+	    x = 0;
+#if ZOOMVEC
+	    if (job->vector) {
+		/*
+		 * Interpolate two pixels at a time 
+		 */
+		tColorRGBA *ca, *cb;
+		zoomvec_t top, bottom, wx, wy;
+
+		wy = ZOOMVEC_WEIGHTS(*csay & 0xffff, *csay & 0xffff);
+		for (; x + 2 <= dst->w; x += 2) {
+		    ca = c00;
+		    ex = (*csax & 0xffff);
+		    csax++;
+		    c00 += (*csax >> 16);
+		    cb = c00;
+		    wx = ZOOMVEC_WEIGHTS(ex, *csax & 0xffff);
+		    csax++;
+		    c00 += (*csax >> 16);
+		    top = ZOOMVEC_LERP(ZOOMVEC_LOAD2(ca, cb), ZOOMVEC_LOAD2(ca + 1, cb + 1), wx);
+		    ca = (tColorRGBA *) ((Uint8 *) ca + src->pitch);
+		    cb = (tColorRGBA *) ((Uint8 *) cb + src->pitch);
+		    bottom = ZOOMVEC_LERP(ZOOMVEC_LOAD2(ca, cb), ZOOMVEC_LOAD2(ca + 1, cb + 1), wx);
+		    ZOOMVEC_STORE2(dp, ZOOMVEC_LERP(top, bottom, wy));
+		    dp += 2;
+		}
+	    }
+#endif
 	    /*
 	     * Setup color source pointers 
 	     */
-	    c00 = csp;
-	    c01 = csp;
+	    c01 = c00;
 	    c01++;
-	    c10 = (tColorRGBA *) ((Uint8 *) csp + src->pitch);
+	    c10 = (tColorRGBA *) ((Uint8 *) c00 + src->pitch);
 	    c11 = c10;
 	    c11++;
-	    csax = sax;
-	    for (x = 0; x < dst->w; x++) {
+	    for (; x < dst->w; x++) {
 
 		/*
 		 * Interpolate colors 
@@ -313,10 +828,10 @@ int zoomSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy,
 	 * Non-Interpolating Zoom 
 	 */
 
-	csay = say;
-	for (y = 0; y < dst->h; y++) {
+	csay = job->say + y0;
+	for (y = y0; y < y1; y++) {
 	    sp = csp;
-	    csax = sax;
+	    csax = job->sax;
 	    for (x = 0; x < dst->w; x++) {
 		/*
 		 * Draw 
@@ -327,7 +842,7 @@ int zoomSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy,
 		 */
 		csax++;
 		sstep = (*csax >> 16);
-		if (flipx) sstep = -sstep;
+		if (job->flipx) sstep = -sstep;
 		sp += sstep;
 		/*
 		 * Advance destination pointer 
@@ -339,7 +854,7 @@ int zoomSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy,
 	     */
 	    csay++;
 	    sstep = (*csay >> 16) * src->pitch;
-	    if (flipy) sstep = -sstep;
+	    if (job->flipy) sstep = -sstep;
 	    csp = (tColorRGBA *) ((Uint8 *) csp + sstep);
 
 	    /*
@@ -349,13 +864,29 @@ int zoomSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy,
 	}
 
     }
+}
 
-    /*
-     * Remove temp arrays 
-     */
-    free(sax);
-    free(say);
+int zoomSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, int smooth)
+{
+    tRotozoomJob job;
+    tZoomTables *tables;
 
+    tables = _zoomTables(smooth ? ZOOM_TABLES_RGBA_SMOOTH : ZOOM_TABLES_RGBA, src, dst);
+    if (tables == NULL) {
+	return (-1);
+    }
+
+    job.src = src;
+    job.dst = dst;
+    job.flipx = flipx;
+    job.flipy = flipy;
+    job.smooth = smooth;
+    job.vector = _zoomVector();
+    job.sax = tables->sax;
+    job.say = tables->say;
+    _rotozoomRun(_zoomRowsRGBA, &job);
+
+    _zoomTablesDone(tables);
     return (0);
 }
 
@@ -367,77 +898,30 @@ int zoomSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy,
  
 */
 
-int zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy)
+static void _zoomRowsY(tRotozoomJob * job, int y0, int y1)
 {
-    Uint32 x, y, sx, sy, *sax, *say, *csax, *csay, csx, csy;
+    SDL_Surface *src = job->src;
+    SDL_Surface *dst = job->dst;
+    int x, y, *csax, *csay;
     Uint8 *sp, *dp, *csp;
     int dgap;
 
     /*
-     * Variable setup 
+     * Pointer setup, skipping the source rows above y0 
      */
-    sx = (Uint32) (65536.0 * (float) src->w / (float) dst->w);
-    sy = (Uint32) (65536.0 * (float) src->h / (float) dst->h);
-
-    /*
-     * Allocate memory for row increments 
-     */
-    if ((sax = (Uint32 *) malloc(dst->w * sizeof(Uint32))) == NULL) {
-	return (-1);
-    }
-    if ((say = (Uint32 *) malloc(dst->h * sizeof(Uint32))) == NULL) {
-	if (sax != NULL) {
-	    free(sax);
-	}
-	return (-1);
+    csp = (Uint8 *) src->pixels;
+    for (y = 0; y < y0; y++) {
+	csp += (job->say[y] * src->pitch);
     }
-
-    /*
-     * Precalculate row increments 
-     */
-    csx = 0;
-    csax = sax;
-    for (x = 0; x < dst->w; x++) {
-	csx += sx;
-	*csax = (csx >> 16);
-	csx &= 0xffff;
-	csax++;
-    }
-    csy = 0;
-    csay = say;
-    for (y = 0; y < dst->h; y++) {
-	csy += sy;
-	*csay = (csy >> 16);
-	csy &= 0xffff;
-	csay++;
-    }
-
-    csx = 0;
-    csax = sax;
-    for (x = 0; x < dst->w; x++) {
-	csx += (*csax);
-	csax++;
-    }
-    csy = 0;
-    csay = say;
-    for (y = 0; y < dst->h; y++) {
-	csy += (*csay);
-	csay++;
-    }
-
-    /*
-     * Pointer setup 
-     */
-    sp = csp = (Uint8 *) src->pixels;
-    dp = (Uint8 *) dst->pixels;
+    dp = (Uint8 *) dst->pixels + y0 * dst->pitch;
     dgap = dst->pitch - dst->w;
 
     /*
      * Draw 
      */
-    csay = say;
-    for (y = 0; y < dst->h; y++) {
-	csax = sax;
+    csay = job->say + y0;
+    for (y = y0; y < y1; y++) {
+	csax = job->sax;
 	sp = csp;
 	for (x = 0; x < dst->w; x++) {
 	    /*
@@ -464,13 +948,25 @@ int zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy)
 	 */
 	dp += dgap;
     }
+}
 
-    /*
-     * Remove temp arrays 
-     */
-    free(sax);
-    free(say);
+int zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy)
+{
+    tRotozoomJob job;
+    tZoomTables *tables;
 
+    tables = _zoomTables(ZOOM_TABLES_Y, src, dst);
+    if (tables == NULL) {
+	return (-1);
+    }
+
+    job.src = src;
+    job.dst = dst;
+    job.sax = tables->sax;
+    job.say = tables->say;
+    _rotozoomRun(_zoomRowsY, &job);
+
+    _zoomTablesDone(tables);
     return (0);
 }
 
@@ -482,8 +978,11 @@ int zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy)
  
 */
 
-void transformSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int isin, int icos, int flipx, int flipy, int smooth)
+static void _transformRowsRGBA(tRotozoomJob * job, int y0, int y1)
 {
+    SDL_Surface *src = job->src;
+    SDL_Surface *dst = job->dst;
+    int cx = job->cx, cy = job->cy, isin = job->isin, icos = job->icos;
     int x, y, t1, t2, dx, dy, xd, yd, sdx, sdy, ax, ay, ex, ey, sw, sh;
     tColorRGBA c00, c01, c10, c11;
     tColorRGBA *pc, *sp;
@@ -498,14 +997,14 @@ void transformSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int cx, int cy,
     ay = (cy << 16) - (isin * cx);
     sw = src->w - 1;
     sh = src->h - 1;
-    pc = dst->pixels;
+    pc = (tColorRGBA *) ((Uint8 *) dst->pixels + y0 * dst->pitch);
     gap = dst->pitch - dst->w * 4;
 
     /*
      * Switch between interpolating and non-interpolating code 
      */
-    if (smooth) {
-	for (y = 0; y < dst->h; y++) {
+    if (job->smooth) {
+	for (y = y0; y < y1; y++) {
 	    dy = cy - y;
 	    sdx = (ax + (isin * dy)) + xd;
 	    sdy = (ay - (icos * dy)) + yd;
@@ -608,15 +1107,15 @@ void transformSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int cx, int cy,
 	    pc = (tColorRGBA *) ((Uint8 *) pc + gap);
 	}
     } else {
-	for (y = 0; y < dst->h; y++) {
+	for (y = y0; y < y1; y++) {
 	    dy = cy - y;
 	    sdx = (ax + (isin * dy)) + xd;
 	    sdy = (ay - (icos * dy)) + yd;
 	    for (x = 0; x < dst->w; x++) {
 		dx = (short) (sdx >> 16);
 		dy = (short) (sdy >> 16);
-		if (flipx) dx = (src->w-1)-dx;
-		if (flipy) dy = (src->h-1)-dy;
+		if (job->flipx) dx = (src->w-1)-dx;
+		if (job->flipy) dy = (src->h-1)-dy;
 		if ((dx >= 0) && (dy >= 0) && (dx < src->w) && (dy < src->h)) {
 		    sp = (tColorRGBA *) ((Uint8 *) src->pixels + src->pitch * dy);
 		    sp += dx;
@@ -631,6 +1130,22 @@ void transformSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int cx, int cy,
     }
 }
 
+void transformSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int isin, int icos, int flipx, int flipy, int smooth)
+{
+    tRotozoomJob job;
+
+    job.src = src;
+    job.dst = dst;
+    job.cx = cx;
+    job.cy = cy;
+    job.isin = isin;
+    job.icos = icos;
+    job.flipx = flipx;
+    job.flipy = flipy;
+    job.smooth = smooth;
+    _rotozoomRun(_transformRowsRGBA, &job);
+}
+
 /* 
  
  8bit Rotozoomer without smoothing
@@ -639,8 +1154,11 @@ void transformSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int cx, int cy,
  
 */
 
-void transformSurfaceY(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int isin, int icos)
+static void _transformRowsY(tRotozoomJob * job, int y0, int y1)
 {
+    SDL_Surface *src = job->src;
+    SDL_Surface *dst = job->dst;
+    int cx = job->cx, cy = job->cy, isin = job->isin, icos = job->icos;
     int x, y, dx, dy, xd, yd, sdx, sdy, ax, ay, sw, sh;
     tColorY *pc, *sp;
     int gap;
@@ -654,16 +1172,12 @@ void transformSurfaceY(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int
     ay = (cy << 16) - (isin * cx);
     sw = src->w - 1;
     sh = src->h - 1;
-    pc = dst->pixels;
+    pc = (tColorY *) dst->pixels + y0 * dst->pitch;
     gap = dst->pitch - dst->w;
-    /*
-     * Clear surface to colorkey 
-     */
-    memset(pc, (unsigned char) (src->format->colorkey & 0xff), dst->pitch * dst->h);
     /*
      * Iterate through destination surface 
      */
-    for (y = 0; y < dst->h; y++) {
+    for (y = y0; y < y1; y++) {
 	dy = cy - y;
 	sdx = (ax + (isin * dy)) + xd;
 	sdy = (ay - (icos * dy)) + yd;
@@ -683,6 +1197,23 @@ void transformSurfaceY(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int
     }
 }
 
+void transformSurfaceY(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int isin, int icos)
+{
+    tRotozoomJob job;
+
+    /*
+     * Clear surface to colorkey 
+     */
+    memset(dst->pixels, (unsigned char) (src->format->colorkey & 0xff), dst->pitch * dst->h);
+
+    job.src = src;
+    job.dst = dst;
+    job.cx = cx;
+    job.cy = cy;
+    job.isin = isin;
+    job.icos = icos;
+    _rotozoomRun(_transformRowsY, &job);
+}
 
 /* 
  
@@ -1377,3 +1908,158 @@ SDL_Surface *shrinkSurface(SDL_Surface * src, int factorx, int factory)
      */
     return (rz_dst);
 }
+
+/* 
+ 
+ 32bit mipmap level maker
+
+ Averages boxes of 'stepx' by 'stepy' pixels, either 1 or 2, of 32bit
+ RGBA/ABGR 'src' surface to 'dst' surface, rounding to nearest. A step of 1
+ takes the one pixel twice, so every box is averaged as 2x2.
+ 
+*/
+
+static void _mipmapSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int stepx, int stepy)
+{
+    int x, y, c;
+    Uint8 *sp0, *sp1, *dp;
+    int right = (stepx - 1) * 4;
+
+    for (y = 0; y < dst->h; y++) {
+	sp0 = (Uint8 *) src->pixels + y * stepy * src->pitch;
+	sp1 = sp0 + (stepy - 1) * src->pitch;
+	dp = (Uint8 *) dst->pixels + y * dst->pitch;
+	x = 0;
+#if ZOOMVEC
+	if (_zoomVector()) {
+	    /*
+	     * Two boxes at a time 
+	     */
+	    for (; x + 2 <= dst->w; x += 2) {
+		ZOOMVEC_STORE2(dp, ZOOMVEC_AVERAGE4(ZOOMVEC_LOAD2(sp0, sp0 + stepx * 4),
+						    ZOOMVEC_LOAD2(sp0 + right, sp0 + stepx * 4 + right),
+						    ZOOMVEC_LOAD2(sp1, sp1 + stepx * 4),
+						    ZOOMVEC_LOAD2(sp1 + right, sp1 + stepx * 4 + right)));
+		sp0 += stepx * 8;
+		sp1 += stepx * 8;
+		dp += 8;
+	    }
+	}
+#endif
+	for (; x < dst->w; x++) {
+	    for (c = 0; c < 4; c++) {
+		dp[c] = (sp0[c] + sp0[right + c] + sp1[c] + sp1[right + c] + 2) >> 2;
+	    }
+	    sp0 += stepx * 4;
+	    sp1 += stepx * 4;
+	    dp += 4;
+	}
+    }
+}
+
+/* 
+ 
+ mipmapSurface()
+
+ Halves the size of the source surface again and again, averaging 2x2
+ boxes, then interpolates the last level to the asked size.
+ 
+*/
+
+SDL_Surface *mipmapSurface(SDL_Surface * src, int width, int height)
+{
+    SDL_Surface *rz_src;
+    SDL_Surface *rz_dst;
+    SDL_Surface *level;
+    int stepx, stepy;
+
+    /*
+     * Sanity check 
+     */
+    if ((src == NULL) || (width < 1) || (height < 1))
+	return (NULL);
+
+    /*
+     * New source surface is 32bit with a defined RGBA ordering, unless
+     * it is one already 
+     */
+    if (src->format->BitsPerPixel == 32) {
+	rz_src = src;
+    } else {
+	rz_src =
+	    SDL_CreateRGBSurface(SDL_SWSURFACE, src->w, src->h, 32, 
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+                                0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
+#else
+                                0xff000000,  0x00ff0000, 0x0000ff00, 0x000000ff
+#endif
+	    );
+	if (rz_src == NULL) {
+	    return (NULL);
+	}
+	SDL_BlitSurface(src, NULL, rz_src, NULL);
+    }
+
+    SDL_LockSurface(rz_src);
+
+    /*
+     * Halve each side while that leaves it at least the asked size 
+     */
+    for (;;) {
+	stepx = (rz_src->w / 2 >= width) ? 2 : 1;
+	stepy = (rz_src->h / 2 >= height) ? 2 : 1;
+	if ((stepx == 1) && (stepy == 1)) {
+	    break;
+	}
+	level =
+	    SDL_CreateRGBSurface(SDL_SWSURFACE, rz_src->w / stepx, rz_src->h / stepy, 32,
+				 rz_src->format->Rmask, rz_src->format->Gmask,
+				 rz_src->format->Bmask, rz_src->format->Amask);
+	if (level == NULL) {
+	    break;
+	}
+	_mipmapSurfaceRGBA(rz_src, level, stepx, stepy);
+	SDL_UnlockSurface(rz_src);
+	if (rz_src != src) {
+	    SDL_FreeSurface(rz_src);
+	}
+	rz_src = level;
+	SDL_LockSurface(rz_src);
+    }
+
+    /*
+     * Interpolate the last level to size, which is less than halving it 
+     */
+    if ((rz_src != src) && (rz_src->w == width) && (rz_src->h == height)) {
+	rz_dst = rz_src;
+    } else {
+	rz_dst =
+	    SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, 32,
+				 rz_src->format->Rmask, rz_src->format->Gmask,
+				 rz_src->format->Bmask, rz_src->format->Amask);
+	if (rz_dst != NULL) {
+	    /* Interpolation needs two pixels each way */
+	    zoomSurfaceRGBA(rz_src, rz_dst, 0, 0, (rz_src->w > 1) && (rz_src->h > 1));
+	}
+    }
+    SDL_UnlockSurface(rz_src);
+
+    /*
+     * Cleanup temp surface 
+     */
+    if ((rz_src != src) && (rz_src != rz_dst)) {
+	SDL_FreeSurface(rz_src);
+    }
+
+    /*
+     * Turn on source-alpha support 
+     */
+    if (rz_dst != NULL) {
+	SDL_SetAlpha(rz_dst, SDL_SRCALPHA, 255);
+    }
+
+    /*
+     * Return destination surface 
+     */
+    return (rz_dst);
+}
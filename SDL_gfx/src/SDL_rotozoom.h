@@ -109,6 +109,20 @@ extern "C" {
     
     DLLINTERFACE SDL_Surface *shrinkSurface(SDL_Surface * src, int factorx, int factory);
 
+/* 
+    mipmapSurface()
+
+    Shrinks a 32bit or 8bit 'src' surface to a newly created 32bit 'dst'
+    surface 'width' by 'height' pixels, for thumbnails and sprites seen from
+    afar. The source is halved by averaging 2x2 boxes for as long as that
+    leaves it at least the asked size, then interpolated the rest of the way,
+    so every source pixel counts however far the surface is shrunk. If the
+    surface is not 32bit RGBA/ABGR it will be converted into a 32bit RGBA
+    format on the fly.
+*/
+
+    DLLINTERFACE SDL_Surface *mipmapSurface(SDL_Surface * src, int width, int height);
+
 /* 
 
     Other functions
@@ -117,6 +131,35 @@ extern "C" {
 
     DLLINTERFACE SDL_Surface* rotateSurface90Degrees(SDL_Surface* pSurf, int numClockwiseTurns);
 
+/* 
+
+    rotozoomSetThreads()
+
+    Sets the number of threads, the caller's included, that rotozoomSurface(),
+    rotozoomSurfaceXY() and zoomSurface() render with, up to 16. The default
+    is 1, which starts no threads; any other number gives the same pixels,
+    just sooner on more than one core. While one call has the threads, calls
+    from other threads render on their own thread instead of waiting.
+    Returns the number of threads now in use, which may be fewer if some
+    could not be started, or -1 on error. A negative 'threads' just returns
+    the number in use.
+*/
+
+    DLLINTERFACE int rotozoomSetThreads(int threads);
+
+/* 
+
+    rotozoomSetSIMD()
+
+    Turns the vector kernels of the smooth zoomSurface(), shrinkSurface() and
+    mipmapSurface() off with 0, or back on with 1, where the CPU has SSE2.
+    They give the same pixels as the plain C loops. Returns 1 if the vector
+    kernels are now in use, 0 if not. A negative 'enable' just returns
+    whether they are.
+*/
+
+    DLLINTERFACE int rotozoomSetSIMD(int enable);
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
@@ -0,0 +1,393 @@
+/*
+
+    TestConvolve
+
+    Test program and benchmark of the convolution and Sobel filters:
+    runs every kernel size with a corpus of kernels, from plain boxes to
+    ones whose sums saturate, over a corpus of images, and checks the
+    bytes against a pixel by pixel model of the MMX code. Then reports
+    the megapixels per second of each kernel size.
+
+    Usage: TestConvolve [milliseconds per measurement]
+
+    Copyright (C) A. Schiffler, July 2006, GPL
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#include "SDL/SDL_imageFilter.h"
+
+#define PAD	16	/* The MMX code reads a little past the image */
+
+enum {
+	KERNEL_BOX,
+	KERNEL_SMOOTHING,
+	KERNEL_DERIVATIVE,
+	KERNEL_SHARPEN,
+	KERNEL_SMALL,
+	KERNEL_LARGE,
+	KERNELS
+};
+
+static const char *kernel_names[KERNELS] = {
+	"box", "smoothing", "derivative", "sharpen", "small random", "large random"
+};
+
+enum {
+	IMAGE_NOISE,
+	IMAGE_GRADIENT,
+	IMAGE_CHECKER,
+	IMAGE_WHITE,
+	IMAGES
+};
+
+typedef struct {
+	int columns, rows;
+} tImageSize;
+
+static tImageSize image_sizes[] = {
+	{ 9, 9 }, { 16, 12 }, { 37, 23 }, { 128, 96 }, { 333, 201 }, { 0, 0 }
+};
+
+static unsigned int seed = 1;
+
+int Random(int n)
+{
+	seed = seed * 1103515245 + 12345;
+	return (int)((seed >> 16) % n);
+}
+
+/* Kernel rows are 4, 8 or 12 shorts apart, as the MMX code reads them */
+int KernelStride(int size)
+{
+	return (size == 3) ? 4 : ((size == 9) ? 12 : 8);
+}
+
+void MakeKernel(signed short *kernel, int size, int kind)
+{
+	static const int binomial[9][9] = {
+		{ 0 }, { 0 }, { 0 },
+		{ 1, 2, 1 }, { 0 },
+		{ 1, 4, 6, 4, 1 }, { 0 },
+		{ 1, 6, 15, 20, 15, 6, 1 }, { 0 }
+	};
+	int stride = KernelStride(size);
+	int r, c, k;
+
+	memset(kernel, 0, 9 * 12 * sizeof(signed short));
+	for (r = 0; r < size; r++) {
+		for (c = 0; c < size; c++) {
+			switch (kind) {
+			case KERNEL_BOX:
+				k = 1;
+				break;
+			case KERNEL_SMOOTHING:
+				k = (size == 9) ? (r + 1) * (c + 1) : binomial[size][r] * binomial[size][c];
+				break;
+			case KERNEL_DERIVATIVE:
+				k = (c - size / 2) * (size - abs(r - size / 2));
+				break;
+			case KERNEL_SHARPEN:
+				k = ((r == size / 2) && (c == size / 2)) ? size * size : -1;
+				break;
+			case KERNEL_SMALL:
+				k = Random(7) - 3;
+				break;
+			default:
+				k = Random(601) - 300;
+				break;
+			}
+			/* The ninth column goes after the first 8 */
+			kernel[r * stride + c] = (signed short)k;
+		}
+	}
+}
+
+void MakeImage(unsigned char *image, int columns, int rows, int kind)
+{
+	int x, y;
+
+	for (y = 0; y < rows; y++) {
+		for (x = 0; x < columns; x++) {
+			switch (kind) {
+			case IMAGE_NOISE:
+				image[y * columns + x] = (unsigned char)Random(256);
+				break;
+			case IMAGE_GRADIENT:
+				image[y * columns + x] = (unsigned char)((x * 255 / columns + y * 255 / rows) / 2);
+				break;
+			case IMAGE_CHECKER:
+				image[y * columns + x] = (((x / 3) ^ (y / 3)) & 1) ? 255 : 0;
+				break;
+			default:
+				image[y * columns + x] = 255;
+				break;
+			}
+		}
+	}
+}
+
+int Saturate(int x)
+{
+	return (x > 32767) ? 32767 : ((x < -32768) ? -32768 : x);
+}
+
+/* The sum the MMX code works out: 16 bit products, 4 saturating lanes */
+int ModelSum(unsigned char *src, int columns, signed short *kernel, int size, int shift)
+{
+	int stride = KernelStride(size);
+	int words = (size == 3) ? 4 : 8;
+	int lane[4] = { 0, 0, 0, 0 };
+	int product[8];
+	int r, l;
+
+	for (r = 0; r < size; r++) {
+		for (l = 0; l < words; l++) {
+			product[l] = (signed short)((src[r * columns + l] >> shift) * kernel[r * stride + l]);
+		}
+		for (l = 0; l < 4; l++) {
+			if (words == 8) {
+				lane[l] = Saturate(lane[l] + Saturate(product[l] + product[l + 4]));
+			} else {
+				lane[l] = Saturate(lane[l] + product[l]);
+			}
+		}
+		if (size == 9) {
+			/* The last 4 words go with the 4 pixels from the second on */
+			for (l = 0; l < 4; l++) {
+				lane[l] = Saturate(lane[l] +
+					(signed short)((src[r * columns + 1 + l] >> shift) * kernel[r * stride + 8 + l]));
+			}
+		}
+	}
+	return Saturate(Saturate(lane[0] + lane[2]) + Saturate(lane[1] + lane[3]));
+}
+
+void ModelConvolve(unsigned char *src, unsigned char *dest, int columns, int rows,
+		   signed short *kernel, int size, int divisor, int shift)
+{
+	int x, y, sum, half = size / 2;
+
+	for (y = half; y < rows - half; y++) {
+		for (x = half; x < columns - half; x++) {
+			sum = ModelSum(src + (y - half) * columns + x - half, columns, kernel, size, shift);
+			if (divisor) {
+				sum /= divisor;
+			}
+			dest[y * columns + x] = (sum < 0) ? 0 : ((sum > 255) ? 255 : sum);
+		}
+	}
+}
+
+/* The right neighbor of the last column is in the next row, so that is left out */
+int SobelLastColumn(int columns)
+{
+	int last = columns & ~7;
+
+	return (last > columns - 2) ? columns - 2 : last;
+}
+
+void ModelSobelX(unsigned char *src, unsigned char *dest, int columns, int rows, int shift)
+{
+	int x, y, left, right;
+
+	for (y = 1; y < rows - 1; y++) {
+		for (x = 1; x <= SobelLastColumn(columns); x++) {
+			left = (src[(y - 1) * columns + x - 1] >> shift) + 2 * (src[y * columns + x - 1] >> shift) +
+				(src[(y + 1) * columns + x - 1] >> shift);
+			right = (src[(y - 1) * columns + x + 1] >> shift) + 2 * (src[y * columns + x + 1] >> shift) +
+				(src[(y + 1) * columns + x + 1] >> shift);
+			dest[y * columns + x] = (abs(right - left) > 255) ? 255 : abs(right - left);
+		}
+	}
+}
+
+int Convolve(unsigned char *src, unsigned char *dest, int columns, int rows,
+	     signed short *kernel, int size, int divisor, int shift)
+{
+	if (divisor) {
+		switch (size) {
+		case 3:
+			return SDL_imageFilterConvolveKernel3x3Divide(src, dest, rows, columns, kernel, divisor);
+		case 5:
+			return SDL_imageFilterConvolveKernel5x5Divide(src, dest, rows, columns, kernel, divisor);
+		case 7:
+			return SDL_imageFilterConvolveKernel7x7Divide(src, dest, rows, columns, kernel, divisor);
+		default:
+			return SDL_imageFilterConvolveKernel9x9Divide(src, dest, rows, columns, kernel, divisor);
+		}
+	}
+	switch (size) {
+	case 3:
+		return SDL_imageFilterConvolveKernel3x3ShiftRight(src, dest, rows, columns, kernel, shift);
+	case 5:
+		return SDL_imageFilterConvolveKernel5x5ShiftRight(src, dest, rows, columns, kernel, shift);
+	case 7:
+		return SDL_imageFilterConvolveKernel7x7ShiftRight(src, dest, rows, columns, kernel, shift);
+	default:
+		return SDL_imageFilterConvolveKernel9x9ShiftRight(src, dest, rows, columns, kernel, shift);
+	}
+}
+
+/* Runs the corpus; returns the number of results that differ from the model */
+int CheckCorpus(void)
+{
+	static const struct {
+		int divisor, shift;
+	} modes[] = {
+		{ 1, 0 }, { 7, 0 }, { 16, 0 }, { 255, 0 },
+		{ 0, 0 }, { 0, 1 }, { 0, 3 }, { 0, 7 }, { 0, -1 }
+	};
+	static const int shifts[] = { 0, 1, 3, 7, -1 };
+	signed short kernel[9 * 12];
+	unsigned char *src, *dest, *expected;
+	tImageSize *image_size;
+	int image, size, kind, i, columns, rows, bytes, x, last;
+	int errors = 0;
+
+	for (image_size = image_sizes; image_size->columns; image_size++) {
+		columns = image_size->columns;
+		rows = image_size->rows;
+		bytes = columns * rows;
+		src = (unsigned char *)malloc(bytes + PAD);
+		dest = (unsigned char *)malloc(bytes + PAD);
+		expected = (unsigned char *)malloc(bytes + PAD);
+		memset(src, 0, bytes + PAD);
+		for (image = 0; image < IMAGES; image++) {
+			MakeImage(src, columns, rows, image);
+			for (size = 3; size <= 9; size += 2) {
+				for (kind = 0; kind < KERNELS; kind++) {
+					MakeKernel(kernel, size, kind);
+					for (i = 0; modes[i].divisor || modes[i].shift >= 0; i++) {
+						memset(dest, 0xa5, bytes);
+						memset(expected, 0xa5, bytes);
+						ModelConvolve(src, expected, columns, rows, kernel, size,
+							modes[i].divisor, modes[i].shift);
+						if (Convolve(src, dest, columns, rows, kernel, size,
+							modes[i].divisor, modes[i].shift) != 0) {
+							printf("%dx%d %s kernel on %dx%d failed\n",
+								size, size, kernel_names[kind], columns, rows);
+							errors++;
+						} else if (memcmp(dest, expected, bytes) != 0) {
+							printf("%dx%d %s kernel on %dx%d image %d, divisor %d shift %d, differs\n",
+								size, size, kernel_names[kind], columns, rows, image,
+								modes[i].divisor, modes[i].shift);
+							errors++;
+						}
+					}
+				}
+			}
+
+			if (columns < 8) {
+				continue;
+			}
+			for (i = 0; shifts[i] >= 0; i++) {
+				memset(dest, 0xa5, bytes);
+				memset(expected, 0xa5, bytes);
+				ModelSobelX(src, expected, columns, rows, shifts[i]);
+				if (shifts[i]) {
+					SDL_imageFilterSobelXShiftRight(src, dest, rows, columns, shifts[i]);
+				} else {
+					SDL_imageFilterSobelX(src, dest, rows, columns);
+				}
+				last = SobelLastColumn(columns);
+				for (x = columns; x < bytes - columns; x += columns) {
+					if (memcmp(dest + x + 1, expected + x + 1, last) != 0) {
+						printf("SobelX on %dx%d image %d, shift %d, differs\n",
+							columns, rows, image, shifts[i]);
+						errors++;
+						break;
+					}
+				}
+			}
+		}
+		free(src);
+		free(dest);
+		free(expected);
+	}
+	return errors;
+}
+
+double Measure(unsigned char *src, unsigned char *dest, int columns, int rows,
+	       signed short *kernel, int size, Uint32 ms)
+{
+	Uint32 start, elapsed;
+	double pixels = 0.0;
+
+	start = SDL_GetTicks();
+	do {
+		if (size) {
+			Convolve(src, dest, columns, rows, kernel, size, 16, 0);
+		} else {
+			SDL_imageFilterSobelX(src, dest, rows, columns);
+		}
+		pixels += (double)columns * rows;
+		elapsed = SDL_GetTicks() - start;
+	} while (elapsed < ms);
+	return pixels / (elapsed * 1000.0);
+}
+
+void Benchmark(Uint32 ms)
+{
+	static const int kinds[] = { KERNEL_BOX, KERNEL_SHARPEN, KERNEL_LARGE };
+	signed short kernel[9 * 12];
+	unsigned char *src, *dest;
+	int columns = 640, rows = 480;
+	int size, i;
+
+	src = (unsigned char *)malloc(columns * rows + PAD);
+	dest = (unsigned char *)malloc(columns * rows + PAD);
+	MakeImage(src, columns, rows, IMAGE_NOISE);
+
+	printf("\n%dx%d image, megapixels per second\n", columns, rows);
+	for (size = 3; size <= 9; size += 2) {
+		printf("%dx%d", size, size);
+		for (i = 0; i < 3; i++) {
+			MakeKernel(kernel, size, kinds[i]);
+			printf("  %s %6.1f", kernel_names[kinds[i]],
+				Measure(src, dest, columns, rows, kernel, size, ms));
+		}
+		printf("\n");
+	}
+	printf("SobelX %6.1f\n", Measure(src, dest, columns, rows, NULL, 0, ms));
+
+	free(src);
+	free(dest);
+}
+
+int main(int argc, char *argv[])
+{
+	Uint32 ms;
+	int errors;
+
+	ms = (argc > 1) ? atoi(argv[1]) : 250;
+
+	if (SDL_Init(SDL_INIT_TIMER) < 0) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		exit(1);
+	}
+	atexit(SDL_Quit);
+
+	errors = CheckCorpus();
+	if (SDL_imageFilterMMXdetect()) {
+		printf("With MMX:\n");
+		Benchmark(ms);
+		SDL_imageFilterMMXoff();
+		errors += CheckCorpus();
+		printf("Without MMX:\n");
+	}
+	Benchmark(ms);
+	SDL_imageFilterMMXon();
+
+	if (errors) {
+		printf("%d convolution tests failed\n", errors);
+	} else {
+		printf("All convolution tests passed.\n");
+	}
+	return (errors ? 1 : 0);
+}
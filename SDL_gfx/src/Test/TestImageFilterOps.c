@@ -0,0 +1,274 @@
+/*
+
+    TestImageFilterOps
+
+    Test program for the vector routines of the byte-wise image filters:
+    runs every filter on every byte, and every pair of bytes for those
+    taking two images, with every byte, shift and threshold argument it
+    takes, checks the vector routines give what the C routines give, and
+    reports the megabytes per second each does on a 640x480 image.
+
+    Usage: TestImageFilterOps [milliseconds to time each filter]
+
+    Copyright (C) A. Schiffler, July 2006, GPL
+
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#include "SDL/SDL_imageFilter.h"
+
+#define BENCH_SIZE	(640 * 480)
+
+/* The filters, all called the same way */
+typedef int (*tFilter)(unsigned char *Src1, unsigned char *Src2, unsigned char *Dest, int length, int a, int b);
+
+int Add(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterAdd(s1, s2, d, n); }
+int Mean(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterMean(s1, s2, d, n); }
+int Sub(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterSub(s1, s2, d, n); }
+int AbsDiff(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterAbsDiff(s1, s2, d, n); }
+int Mult(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterMult(s1, s2, d, n); }
+int MultNor(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterMultNor(s1, s2, d, n); }
+int MultDivby2(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterMultDivby2(s1, s2, d, n); }
+int MultDivby4(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterMultDivby4(s1, s2, d, n); }
+int BitAnd(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterBitAnd(s1, s2, d, n); }
+int BitOr(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterBitOr(s1, s2, d, n); }
+int BitNegation(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterBitNegation(s1, d, n); }
+int AddByte(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterAddByte(s1, d, n, (unsigned char) a); }
+int AddUint(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterAddUint(s1, d, n, (unsigned int) a); }
+int AddByteToHalf(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterAddByteToHalf(s1, d, n, (unsigned char) a); }
+int SubByte(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterSubByte(s1, d, n, (unsigned char) a); }
+int SubUint(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterSubUint(s1, d, n, (unsigned int) a); }
+int ShiftRight(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterShiftRight(s1, d, n, (unsigned char) a); }
+int ShiftRightUint(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterShiftRightUint(s1, d, n, (unsigned char) a); }
+int MultByByte(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterMultByByte(s1, d, n, (unsigned char) a); }
+int ShiftRightAndMultByByte(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterShiftRightAndMultByByte(s1, d, n, (unsigned char) a, (unsigned char) b); }
+int ShiftLeftByte(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterShiftLeftByte(s1, d, n, (unsigned char) a); }
+int ShiftLeftUint(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterShiftLeftUint(s1, d, n, (unsigned char) a); }
+int ShiftLeft(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterShiftLeft(s1, d, n, (unsigned char) a); }
+int BinarizeUsingThreshold(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterBinarizeUsingThreshold(s1, d, n, (unsigned char) a); }
+int ClipToRange(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{ return SDL_imageFilterClipToRange(s1, d, n, (unsigned char) a, (unsigned char) b); }
+
+/* NormalizeLinear takes 4 arguments: a picks a row of these */
+static const int normalize[][4] = {
+	{ 0, 255, 0, 255 }, { 0, 127, 0, 255 }, { 100, 101, 0, 255 }, { 10, 40, 0, 255 },
+	{ 0, 255, 255, 0 }, { 20, 10, 0, 255 }, { 0, 64, -50, 300 }, { 128, 129, -1000, 1000 },
+	{ -300, 300, 0, 255 }, { 300, 302, 0, 100 }, { 0, 1, 0, 30000 }, { 0, 1, 0, 128 },
+	{ 255, 0, 0, 255 }, { -1000, 1000, -1000, 1000 }, { 0, 1, -3000, 3000 }, { 5, 5, 0, 255 }
+};
+#define NUM_NORMALIZE	(int)(sizeof(normalize) / sizeof(normalize[0]))
+
+int NormalizeLinear(unsigned char *s1, unsigned char *s2, unsigned char *d, int n, int a, int b)
+{
+	return SDL_imageFilterNormalizeLinear(s1, d, n, normalize[a][0], normalize[a][1],
+		normalize[a][2], normalize[a][3]);
+}
+
+/* How each filter is tried: with each a from amin to amax and b from bmin to bmax */
+typedef struct {
+	const char *name;
+	tFilter filter;
+	int binary;
+	int amin, amax;
+	int bmin, bmax;
+	int words;		/* works on 32bit words, so wants them aligned */
+} tOp;
+
+static tOp ops[] = {
+	{ "Add",                     Add,                     1, 0, 0,   0, 0,   0 },
+	{ "Mean",                    Mean,                    1, 0, 0,   0, 0,   0 },
+	{ "Sub",                     Sub,                     1, 0, 0,   0, 0,   0 },
+	{ "AbsDiff",                 AbsDiff,                 1, 0, 0,   0, 0,   0 },
+	{ "Mult",                    Mult,                    1, 0, 0,   0, 0,   0 },
+	{ "MultNor",                 MultNor,                 1, 0, 0,   0, 0,   0 },
+	{ "MultDivby2",              MultDivby2,              1, 0, 0,   0, 0,   0 },
+	{ "MultDivby4",              MultDivby4,              1, 0, 0,   0, 0,   0 },
+	{ "BitAnd",                  BitAnd,                  1, 0, 0,   0, 0,   0 },
+	{ "BitOr",                   BitOr,                   1, 0, 0,   0, 0,   0 },
+	{ "BitNegation",             BitNegation,             0, 0, 0,   0, 0,   0 },
+	{ "AddByte",                 AddByte,                 0, 0, 255, 0, 0,   0 },
+	{ "AddUint",                 AddUint,                 0, 0, 255, 0, 0,   0 },
+	{ "AddByteToHalf",           AddByteToHalf,           0, 0, 255, 0, 0,   0 },
+	{ "SubByte",                 SubByte,                 0, 0, 255, 0, 0,   0 },
+	{ "SubUint",                 SubUint,                 0, 0, 255, 0, 0,   0 },
+	{ "ShiftRight",              ShiftRight,              0, 0, 9,   0, 0,   0 },
+	{ "ShiftRightUint",          ShiftRightUint,          0, 0, 31,  0, 0,   1 },
+	{ "MultByByte",              MultByByte,              0, 0, 255, 0, 0,   0 },
+	{ "ShiftRightAndMultByByte", ShiftRightAndMultByByte, 0, 0, 9,   0, 255, 0 },
+	{ "ShiftLeftByte",           ShiftLeftByte,           0, 0, 9,   0, 0,   0 },
+	{ "ShiftLeftUint",           ShiftLeftUint,           0, 0, 31,  0, 0,   1 },
+	{ "ShiftLeft",               ShiftLeft,               0, 0, 9,   0, 0,   0 },
+	{ "BinarizeUsingThreshold",  BinarizeUsingThreshold,  0, 0, 255, 0, 0,   0 },
+	{ "ClipToRange",             ClipToRange,             0, 0, 255, 0, 255, 0 },
+	{ "NormalizeLinear",         NormalizeLinear,         0, 0, NUM_NORMALIZE - 1, 0, 0, 0 },
+	{ NULL }
+};
+
+/* Uint filter arguments: a few all over the word as well as each byte in every byte */
+static unsigned int UintArgument(int a)
+{
+	static const unsigned int others[] = { 0x01020304, 0xff000000, 0x000000ff, 0x80402010, 0x7f00ff01 };
+
+	if (a < 5) {
+		return others[a];
+	}
+	return (unsigned int) a * 0x01010101u;
+}
+
+/* Runs the filter with and without the vector routines and compares what they wrote,
+   Dest starting out the same for both */
+int Check(tOp *op, unsigned char *Src1, unsigned char *Src2, int length, int a, int b)
+{
+	static unsigned char expected[65536 + 64], result[65536 + 64];
+	int retexpected, retresult, i;
+
+	if ((op->filter == AddUint) || (op->filter == SubUint)) {
+		a = (int) UintArgument(a);
+	}
+	memset(expected, 0x5a, length + 32);
+	memset(result, 0x5a, length + 32);
+
+	SDL_imageFilterMMXoff();
+	retexpected = op->filter(Src1, Src2, expected, length, a, b);
+	SDL_imageFilterMMXon();
+	retresult = op->filter(Src1, Src2, result, length, a, b);
+
+	if (retexpected != retresult) {
+		printf("%s(%d, %d) on %d bytes returned %d, not %d\n", op->name, a, b, length,
+			retresult, retexpected);
+		return 1;
+	}
+	for (i = 0; i < length + 32; i++) {
+		if (expected[i] != result[i]) {
+			printf("%s(%d, %d) on %d bytes: byte %d of %d and %d is %d, not %d\n",
+				op->name, a, b, length, i, Src1[i], Src2 ? Src2[i] : 0,
+				result[i], expected[i]);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	static unsigned char all1[65536 + 64], all2[65536 + 64];
+	unsigned char *src1, *src2, *dest;
+	tOp *op;
+	int ms, a, b, i, length, offset, rounds, errors = 0, tests = 0;
+	Uint32 start, elapsed;
+	int on;
+
+	ms = (argc > 1) ? atoi(argv[1]) : 200;
+
+	if (SDL_Init(SDL_INIT_TIMER) < 0) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		exit(1);
+	}
+	atexit(SDL_Quit);
+
+	/* Every pair of bytes, the first one changing fastest */
+	for (i = 0; i < 65536 + 64; i++) {
+		all1[i] = (unsigned char) i;
+		all2[i] = (unsigned char) (i >> 8);
+	}
+
+	for (op = ops; op->name; op++) {
+		for (a = op->amin; a <= op->amax; a++) {
+			for (b = op->bmin; b <= op->bmax; b++) {
+				length = op->binary ? 65536 : 256 * 4 + 7;
+				errors += Check(op, all1, op->binary ? all2 : NULL, length, a, b);
+				tests++;
+			}
+		}
+
+		/* Short images and long ones, at every alignment, with a few random arguments */
+		for (i = 0; i < 200; i++) {
+			length = (i < 100) ? i : rand() % 4096;
+			offset = op->words ? 0 : rand() % 32;
+			a = op->amin + rand() % (op->amax - op->amin + 1);
+			b = op->bmin + rand() % (op->bmax - op->bmin + 1);
+			src1 = all1 + (rand() % 240) * 256 + offset;
+			src2 = op->binary ? all2 + rand() % 64 : NULL;
+			errors += Check(op, src1, src2, length, a, b);
+			tests++;
+		}
+	}
+	if (errors) {
+		printf("%d of %d image filter tests failed\n", errors, tests);
+	} else {
+		printf("All %d image filter tests passed.\n", tests);
+	}
+
+	/* Throughput with and without the MMX or vector routines */
+	src1 = (unsigned char *) malloc(BENCH_SIZE);
+	src2 = (unsigned char *) malloc(BENCH_SIZE);
+	dest = (unsigned char *) malloc(BENCH_SIZE);
+	if ((src1 == NULL) || (src2 == NULL) || (dest == NULL)) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+	for (i = 0; i < BENCH_SIZE; i++) {
+		src1[i] = (unsigned char) rand();
+		src2[i] = (unsigned char) rand();
+	}
+
+	printf("%-24s %10s %10s\n", "MB/s on 640x480", "vector", "C");
+	for (op = ops; op->name; op++) {
+		a = (op->amax > 8) ? 3 : op->amax;
+		b = op->bmax / 2;
+		for (on = 1; on >= 0; on--) {
+			if (on) {
+				SDL_imageFilterMMXon();
+			} else {
+				SDL_imageFilterMMXoff();
+			}
+			rounds = 0;
+			start = SDL_GetTicks();
+			do {
+				op->filter(src1, src2, dest, BENCH_SIZE, a, b);
+				rounds++;
+			} while ((elapsed = SDL_GetTicks() - start) < (Uint32) ms);
+			if (on) {
+				printf("%-24s", op->name);
+			}
+			printf(" %10.0f", (double) BENCH_SIZE * rounds / 1000.0 / elapsed);
+		}
+		printf("\n");
+	}
+	SDL_imageFilterMMXon();
+
+	free(src1);
+	free(src2);
+	free(dest);
+
+	return (errors ? 1 : 0);
+}
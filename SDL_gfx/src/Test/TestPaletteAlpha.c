@@ -0,0 +1,326 @@
+/*
+
+    TestPaletteAlpha
+
+    Test program for alpha blended drawing on 8 bit surfaces: checks that
+    SDL_MapRGB finds the nearest palette entry for a few palettes, also
+    after SDL_SetColors changes them and from several threads at once
+    while the inverse colormap is being built, checks that boxRGBA and pixelRGBA
+    blend every pixel the way a search of the whole palette would, and
+    reports how many pixels per second each blends on a 640x480 surface
+    next to that search.
+
+    Usage: TestPaletteAlpha [milliseconds to time each primitive]
+
+    Copyright (C) A. Schiffler, July 2006, GPL
+
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#include "SDL/SDL_gfxPrimitives.h"
+
+#define WIDTH	640
+#define HEIGHT	480
+#define MAPPERS	4
+
+/* The nearest palette entry, searched the way SDL_MapRGB always did */
+Uint8 Nearest(SDL_Palette *pal, Uint8 r, Uint8 g, Uint8 b)
+{
+	unsigned int smallest = ~0, distance;
+	int i, rd, gd, bd;
+	Uint8 pixel = 0;
+
+	for (i = 0; i < pal->ncolors; i++) {
+		rd = pal->colors[i].r - r;
+		gd = pal->colors[i].g - g;
+		bd = pal->colors[i].b - b;
+		distance = rd * rd + gd * gd + bd * bd;
+		if (distance < smallest) {
+			pixel = i;
+			if (distance == 0) {
+				break;
+			}
+			smallest = distance;
+		}
+	}
+	return pixel;
+}
+
+/* Blend a rectangle the way _filledRectAlpha does, but with Nearest */
+void BlendRect(SDL_Surface *s, int x1, int y1, int x2, int y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL_Palette *pal = s->format->palette;
+	Uint8 sR, sG, sB, dR, dG, dB, *pixel;
+	Uint8 color;
+	int x, y;
+
+	color = Nearest(pal, r, g, b);
+	sR = pal->colors[color].r;
+	sG = pal->colors[color].g;
+	sB = pal->colors[color].b;
+	for (y = y1; y <= y2; y++) {
+		for (x = x1; x <= x2; x++) {
+			pixel = (Uint8 *) s->pixels + y * s->pitch + x;
+			dR = pal->colors[*pixel].r;
+			dG = pal->colors[*pixel].g;
+			dB = pal->colors[*pixel].b;
+			dR = dR + ((sR - dR) * a >> 8);
+			dG = dG + ((sG - dG) * a >> 8);
+			dB = dB + ((sB - dB) * a >> 8);
+			*pixel = Nearest(pal, dR, dG, dB);
+		}
+	}
+}
+
+/* Fill in one of the test palettes */
+void MakePalette(SDL_Color *colors, int kind)
+{
+	int i;
+
+	for (i = 0; i < 256; i++) {
+		switch (kind) {
+		case 0:		/* Random colors */
+			colors[i].r = rand();
+			colors[i].g = rand();
+			colors[i].b = rand();
+			break;
+		case 1:		/* A 6x6x6 color cube and a ramp of grays */
+			if (i < 216) {
+				colors[i].r = (i / 36) * 51;
+				colors[i].g = (i / 6 % 6) * 51;
+				colors[i].b = (i % 6) * 51;
+			} else {
+				colors[i].r = colors[i].g = colors[i].b = (i - 216) * 255 / 39;
+			}
+			break;
+		case 2:		/* Sixteen colors, each many times over */
+			colors[i] = colors[i % 16];
+			if (i < 16) {
+				colors[i].r = rand();
+				colors[i].g = rand();
+				colors[i].b = rand();
+			}
+			break;
+		default:	/* All black */
+			colors[i].r = colors[i].g = colors[i].b = 0;
+			break;
+		}
+		colors[i].unused = 0;
+	}
+}
+
+/* Compare SDL_MapRGB with Nearest on a grid of colors and random ones */
+int CheckMap(SDL_Surface *s, const char *name)
+{
+	int r, g, b, i, errors = 0;
+	Uint32 got;
+	Uint8 want;
+
+	for (r = 0; r < 256; r += 5) {
+		for (g = 0; g < 256; g += 3) {
+			for (b = 0; b < 256; b++) {
+				got = SDL_MapRGB(s->format, r, g, b);
+				want = Nearest(s->format->palette, r, g, b);
+				if ((got != want) && (errors++ < 10)) {
+					printf("%s palette: SDL_MapRGB(%d, %d, %d) is %d, not %d\n", name, r, g, b, got, want);
+				}
+			}
+		}
+	}
+	for (i = 0; i < 100000; i++) {
+		r = rand() & 255;
+		g = rand() & 255;
+		b = rand() & 255;
+		got = SDL_MapRGB(s->format, r, g, b);
+		want = Nearest(s->format->palette, r, g, b);
+		if ((got != want) && (errors++ < 10)) {
+			printf("%s palette: SDL_MapRGB(%d, %d, %d) is %d, not %d\n", name, r, g, b, got, want);
+		}
+	}
+	return errors;
+}
+
+/* Map random colors on another thread, returning the number wrong */
+SDL_Surface *mapped;
+
+int Mapper(void *data)
+{
+	Uint32 seed = (Uint32) (size_t) data;
+	Uint8 r, g, b;
+	int i, errors = 0;
+
+	for (i = 0; i < 200000; i++) {
+		seed = seed * 1103515245 + 12345;
+		r = seed >> 24;
+		g = seed >> 16;
+		b = seed >> 8;
+		if (SDL_MapRGB(mapped->format, r, g, b) != Nearest(mapped->format->palette, r, g, b)) {
+			errors++;
+		}
+	}
+	return errors;
+}
+
+/* Have several threads map colors with a palette whose cells are unlisted */
+int CheckMapThreads(SDL_Surface *s, const char *name)
+{
+	SDL_Thread *mappers[MAPPERS];
+	int i, status, errors = 0;
+
+	mapped = s;
+	for (i = 0; i < MAPPERS; i++) {
+		mappers[i] = SDL_CreateThread(Mapper, (void *) (size_t) (i + 1));
+	}
+	for (i = 0; i < MAPPERS; i++) {
+		if (mappers[i] == NULL) {
+			fprintf(stderr, "Couldn't start mapper %d\n", i);
+			continue;
+		}
+		SDL_WaitThread(mappers[i], &status);
+		errors += status;
+	}
+	if (errors) {
+		printf("%s palette: %d colors mapped wrong from %d threads\n", name, errors, MAPPERS);
+	}
+	return errors;
+}
+
+/* Compare the pixels of two surfaces */
+int Compare(SDL_Surface *a, SDL_Surface *b, const char *what)
+{
+	int y;
+
+	for (y = 0; y < a->h; y++) {
+		if (memcmp((Uint8 *) a->pixels + y * a->pitch, (Uint8 *) b->pixels + y * b->pitch, a->w)) {
+			printf("%s: row %d differs\n", what, y);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+void Randomize(SDL_Surface *s)
+{
+	int i;
+
+	for (i = 0; i < s->pitch * s->h; i++) {
+		((Uint8 *) s->pixels)[i] = rand();
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	static const char *names[] = { "random", "cube", "repeated", "black" };
+	SDL_Surface *s, *ref;
+	SDL_Color colors[256];
+	int ms, kind, i, x, y, w, h, rounds, errors = 0;
+	Uint8 r, g, b, a;
+	Uint32 start, elapsed;
+	int run;
+
+	ms = (argc > 1) ? atoi(argv[1]) : 500;
+
+	if (SDL_Init(SDL_INIT_TIMER) < 0) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		exit(1);
+	}
+	atexit(SDL_Quit);
+
+	s = SDL_CreateRGBSurface(SDL_SWSURFACE, WIDTH, HEIGHT, 8, 0, 0, 0, 0);
+	ref = SDL_CreateRGBSurface(SDL_SWSURFACE, WIDTH, HEIGHT, 8, 0, 0, 0, 0);
+	if ((s == NULL) || (ref == NULL)) {
+		fprintf(stderr, "Couldn't create surfaces: %s\n", SDL_GetError());
+		exit(1);
+	}
+
+	/* A new surface, then each palette in turn, set over the last one */
+	errors += CheckMap(s, "new");
+	for (kind = 0; kind < 4; kind++) {
+		MakePalette(colors, kind);
+		SDL_SetColors(s, colors, 0, 256);
+		SDL_SetColors(ref, colors, 0, 256);
+		errors += CheckMapThreads(s, names[kind]);
+		SDL_SetColors(s, colors, 0, 256);
+		errors += CheckMap(s, names[kind]);
+
+		/* Only part of it changing */
+		colors[7].r ^= 0x80;
+		colors[200].g ^= 0x40;
+		SDL_SetColors(s, &colors[7], 7, 1);
+		SDL_SetColors(s, &colors[200], 200, 1);
+		SDL_SetColors(ref, colors, 0, 256);
+		errors += CheckMap(s, names[kind]);
+
+		for (i = 0; i < 20; i++) {
+			Randomize(s);
+			memcpy(ref->pixels, s->pixels, s->pitch * s->h);
+			r = rand();
+			g = rand();
+			b = rand();
+			a = 1 + rand() % 254;
+			x = rand() % WIDTH;
+			y = rand() % HEIGHT;
+			w = rand() % 200;
+			h = rand() % 200;
+			boxRGBA(s, x, y, x + w, y + h, r, g, b, a);
+			BlendRect(ref, x, y, (x + w < WIDTH) ? x + w : WIDTH - 1, (y + h < HEIGHT) ? y + h : HEIGHT - 1, r, g, b, a);
+			errors += Compare(s, ref, "boxRGBA");
+			for (y = 0; y < 10; y++) {
+				for (x = 0; x < 100; x++) {
+					pixelRGBA(s, x, y, r, g, b, a);
+				}
+			}
+			BlendRect(ref, 0, 0, 99, 9, r, g, b, a);
+			errors += Compare(s, ref, "pixelRGBA");
+		}
+	}
+	if (errors) {
+		printf("%d palette tests failed\n", errors);
+	} else {
+		printf("All palette tests passed.\n");
+	}
+
+	/* Blended pixels per second, for the cube and the random palette */
+	printf("%-28s %10s %10s %10s\n", "Mpixels/s on 640x480", "boxRGBA", "pixelRGBA", "search");
+	for (kind = 1; kind >= 0; kind--) {
+		MakePalette(colors, kind);
+		SDL_SetColors(s, colors, 0, 256);
+		Randomize(s);
+		printf("%-28s", names[kind]);
+		for (run = 0; run < 3; run++) {
+			rounds = 0;
+			start = SDL_GetTicks();
+			do {
+				a = 32 + rounds % 192;
+				switch (run) {
+				case 0:
+					boxRGBA(s, 0, 0, WIDTH - 1, HEIGHT - 1, 255, 128, 0, a);
+					break;
+				case 1:
+					for (y = 0; y < HEIGHT; y++) {
+						for (x = 0; x < WIDTH; x++) {
+							pixelRGBA(s, x, y, 255, 128, 0, a);
+						}
+					}
+					break;
+				default:
+					BlendRect(s, 0, 0, WIDTH - 1, HEIGHT - 1, 255, 128, 0, a);
+					break;
+				}
+				rounds++;
+			} while ((elapsed = SDL_GetTicks() - start) < (Uint32) ms);
+			printf(" %10.2f", (double) WIDTH * HEIGHT * rounds / 1000.0 / elapsed);
+		}
+		printf("\n");
+	}
+
+	SDL_FreeSurface(s);
+	SDL_FreeSurface(ref);
+
+	return (errors ? 1 : 0);
+}
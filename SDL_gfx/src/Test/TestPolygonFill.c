@@ -0,0 +1,306 @@
+/*
+
+    TestPolygonFill
+
+    Test program for the scanline fill of filledPolygonColor and
+    texturedPolygon: draws random polygons, stars and long random paths,
+    opaque and blended, clipped and not, and checks the pixels are those
+    the fill used to give, where every edge was intersected with every
+    scanline and the crossings sorted with qsort. Then reports how many
+    stars and 1000 vertex paths per second each fill draws.
+
+    Usage: TestPolygonFill [milliseconds to time each shape]
+
+    Copyright (C) A. Schiffler, July 2006, GPL
+
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "SDL.h"
+
+#include "SDL/SDL_gfxPrimitives.h"
+
+#define WIDTH	640
+#define HEIGHT	480
+#define MAXVERTS 1000
+
+/* Not in the header, but the textured fill draws with it */
+int _texturedHLine(SDL_Surface * dst, Sint16 x1, Sint16 x2, Sint16 y, SDL_Surface * texture, int texture_dx, int texture_dy);
+
+int CompareInt(const void *a, const void *b)
+{
+	return (*(const int *) a) - (*(const int *) b);
+}
+
+/* The fill as it was: every edge against every scanline, then qsort */
+int OldPolygon(SDL_Surface *dst, const Sint16 *vx, const Sint16 *vy, int n, Uint32 color, SDL_Surface *texture, int tdx, int tdy)
+{
+	static int ints[MAXVERTS];
+	int i, y, xa, xb, minx, maxx, miny, maxy, x1, y1, x2, y2, ind1, ind2, count, result = 0;
+
+	minx = maxx = vx[0];
+	miny = maxy = vy[0];
+	for (i = 1; i < n; i++) {
+		if (vy[i] < miny) {
+			miny = vy[i];
+		} else if (vy[i] > maxy) {
+			maxy = vy[i];
+		}
+		if (vx[i] < minx) {
+			minx = vx[i];
+		} else if (vx[i] > maxx) {
+			maxx = vx[i];
+		}
+	}
+	if (texture && ((maxx < 0) || (minx > dst->w) || (maxy < 0) || (miny > dst->h))) {
+		return -1;
+	}
+	for (y = miny; y <= maxy; y++) {
+		count = 0;
+		for (i = 0; i < n; i++) {
+			ind1 = i ? i - 1 : n - 1;
+			ind2 = i;
+			y1 = vy[ind1];
+			y2 = vy[ind2];
+			if (y1 < y2) {
+				x1 = vx[ind1];
+				x2 = vx[ind2];
+			} else if (y1 > y2) {
+				y2 = vy[ind1];
+				y1 = vy[ind2];
+				x2 = vx[ind1];
+				x1 = vx[ind2];
+			} else {
+				continue;
+			}
+			if (((y >= y1) && (y < y2)) || ((y == maxy) && (y > y1) && (y <= y2))) {
+				ints[count++] = ((65536 * (y - y1)) / (y2 - y1)) * (x2 - x1) + (65536 * x1);
+			}
+		}
+		qsort(ints, count, sizeof(int), CompareInt);
+		for (i = 0; i < count; i += 2) {
+			xa = ints[i] + 1;
+			xa = (xa >> 16) + ((xa & 32768) >> 15);
+			xb = ints[i + 1] - 1;
+			xb = (xb >> 16) + ((xb & 32768) >> 15);
+			if (texture) {
+				result |= _texturedHLine(dst, xa, xb, y, texture, tdx, tdy);
+			} else {
+				result |= hlineColor(dst, xa, xb, y, color);
+			}
+		}
+	}
+	return result;
+}
+
+/* Shapes */
+int Star(Sint16 *vx, Sint16 *vy, int points, int cx, int cy, int r1, int r2, double turn)
+{
+	int i;
+	double a;
+
+	for (i = 0; i < 2 * points; i++) {
+		a = turn + i * M_PI / points;
+		vx[i] = (Sint16) (cx + ((i & 1) ? r2 : r1) * cos(a));
+		vy[i] = (Sint16) (cy + ((i & 1) ? r2 : r1) * sin(a));
+	}
+	return 2 * points;
+}
+
+int Path(Sint16 *vx, Sint16 *vy, int n, int xmin, int ymin, int w, int h)
+{
+	int i;
+
+	vx[0] = xmin + rand() % w;
+	vy[0] = ymin + rand() % h;
+	for (i = 1; i < n; i++) {
+		vx[i] = vx[i - 1] + rand() % 81 - 40;
+		vy[i] = vy[i - 1] + rand() % 81 - 40;
+		if ((vx[i] < xmin) || (vx[i] >= xmin + w)) {
+			vx[i] = xmin + rand() % w;
+		}
+		if ((vy[i] < ymin) || (vy[i] >= ymin + h)) {
+			vy[i] = ymin + rand() % h;
+		}
+	}
+	return n;
+}
+
+int Random(Sint16 *vx, Sint16 *vy, int n, int xmin, int ymin, int w, int h)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		vx[i] = xmin + rand() % w;
+		vy[i] = ymin + rand() % h;
+	}
+	/* Now and then, some horizontal edges and repeated vertices */
+	if (rand() % 3 == 0) {
+		for (i = 1; i < n; i += 3) {
+			vy[i] = vy[i - 1];
+		}
+		vx[n - 1] = vx[0];
+		vy[n - 1] = vy[0];
+	}
+	return n;
+}
+
+/* Compare the pixels of two surfaces */
+int Compare(SDL_Surface *a, SDL_Surface *b)
+{
+	int y;
+
+	for (y = 0; y < a->h; y++) {
+		if (memcmp((Uint8 *) a->pixels + y * a->pitch, (Uint8 *) b->pixels + y * b->pitch, a->w * a->format->BytesPerPixel)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	static Sint16 vx[MAXVERTS], vy[MAXVERTS];
+	static const int depths[] = { 8, 16, 24, 32 };
+	SDL_Surface *s[4], *ref[4], *texture;
+	SDL_Rect clip;
+	int ms, d, i, k, n, shape, rounds, errors = 0, tests = 0;
+	int got, want, use_cache, tdx, tdy;
+	int *cache = NULL, cached = 0;
+	Uint32 color, start, elapsed;
+	int run;
+
+	ms = (argc > 1) ? atoi(argv[1]) : 500;
+
+	if (SDL_Init(SDL_INIT_TIMER) < 0) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		exit(1);
+	}
+	atexit(SDL_Quit);
+
+	for (d = 0; d < 4; d++) {
+		s[d] = SDL_CreateRGBSurface(SDL_SWSURFACE, WIDTH, HEIGHT, depths[d], 0, 0, 0, 0);
+		ref[d] = SDL_CreateRGBSurface(SDL_SWSURFACE, WIDTH, HEIGHT, depths[d], 0, 0, 0, 0);
+		if ((s[d] == NULL) || (ref[d] == NULL)) {
+			fprintf(stderr, "Couldn't create surfaces: %s\n", SDL_GetError());
+			exit(1);
+		}
+	}
+	texture = SDL_CreateRGBSurface(SDL_SWSURFACE, 37, 23, 32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0);
+	if (texture == NULL) {
+		fprintf(stderr, "Couldn't create texture: %s\n", SDL_GetError());
+		exit(1);
+	}
+	for (i = 0; i < texture->pitch * texture->h; i++) {
+		((Uint8 *) texture->pixels)[i] = rand();
+	}
+
+	for (i = 0; i < 3000; i++) {
+		d = i % 4;
+		shape = (i / 4) % 4;
+		switch (shape) {
+		case 0:
+			n = Random(vx, vy, 3 + rand() % 40, -100, -100, WIDTH + 200, HEIGHT + 200);
+			break;
+		case 1:
+			n = Star(vx, vy, 3 + rand() % 20, rand() % WIDTH, rand() % HEIGHT, 20 + rand() % 300, rand() % 100, rand() / (double) RAND_MAX);
+			break;
+		case 2:
+			n = Path(vx, vy, MAXVERTS, -50, -50, WIDTH + 100, HEIGHT + 100);
+			break;
+		default:
+			n = Random(vx, vy, 3 + rand() % 5, rand() % WIDTH, rand() % HEIGHT, 1 + rand() % 8, 1 + rand() % 8);
+			break;
+		}
+
+		/* Half of them clipped to a random rectangle */
+		if (i % 8 < 4) {
+			clip.x = rand() % WIDTH;
+			clip.y = rand() % HEIGHT;
+			clip.w = rand() % (WIDTH - clip.x + 1);
+			clip.h = rand() % (HEIGHT - clip.y + 1);
+			SDL_SetClipRect(s[d], &clip);
+			SDL_SetClipRect(ref[d], &clip);
+		} else {
+			SDL_SetClipRect(s[d], NULL);
+			SDL_SetClipRect(ref[d], NULL);
+		}
+
+		color = ((Uint32) rand() << 8) | ((i & 1) ? 255 : 1 + rand() % 254);
+		use_cache = (i % 3 == 0);
+		tdx = rand() % 100 - 50;
+		tdy = rand() % 100 - 50;
+		for (k = 0; k < 2; k++) {
+			if (k == 0) {
+				got = use_cache ? filledPolygonColorMT(s[d], vx, vy, n, color, &cache, &cached) : filledPolygonColor(s[d], vx, vy, n, color);
+				want = OldPolygon(ref[d], vx, vy, n, color, NULL, 0, 0);
+			} else {
+				got = use_cache ? texturedPolygonMT(s[d], vx, vy, n, texture, tdx, tdy, &cache, &cached) : texturedPolygon(s[d], vx, vy, n, texture, tdx, tdy);
+				want = OldPolygon(ref[d], vx, vy, n, 0, texture, tdx, tdy);
+			}
+			tests++;
+			if ((got != want) || Compare(s[d], ref[d])) {
+				if (errors++ < 10) {
+					printf("%s, shape %d with %d vertices on %d bpp: returned %d, expected %d%s\n",
+					       k ? "texturedPolygon" : "filledPolygonColor", shape, n, depths[d], got, want,
+					       Compare(s[d], ref[d]) ? ", pixels differ" : "");
+				}
+				memcpy(s[d]->pixels, ref[d]->pixels, s[d]->pitch * s[d]->h);
+			}
+		}
+	}
+	free(cache);
+	if (errors) {
+		printf("%d of %d polygon tests failed\n", errors, tests);
+	} else {
+		printf("All %d polygon tests passed.\n", tests);
+	}
+
+	/* Polygons per second, on a 32 bpp surface */
+	SDL_SetClipRect(s[3], NULL);
+	printf("%-32s %10s %10s\n", "Polygons/s on 640x480", "new", "old");
+	for (shape = 0; shape < 4; shape++) {
+		if (shape & 1) {
+			srand(1);
+			n = Path(vx, vy, MAXVERTS, 0, 0, WIDTH, HEIGHT);
+		} else {
+			n = Star(vx, vy, 12, WIDTH / 2, HEIGHT / 2, 230, 90, 0.1);
+		}
+		printf("%-32s", (shape & 1) ? ((shape & 2) ? "textured 1000 vertex path" : "filled 1000 vertex path")
+		       : ((shape & 2) ? "textured 12 point star" : "filled 12 point star"));
+		for (run = 0; run < 2; run++) {
+			rounds = 0;
+			start = SDL_GetTicks();
+			do {
+				if (shape & 2) {
+					if (run == 0) {
+						texturedPolygon(s[3], vx, vy, n, texture, 0, 0);
+					} else {
+						OldPolygon(s[3], vx, vy, n, 0, texture, 0, 0);
+					}
+				} else {
+					if (run == 0) {
+						filledPolygonColor(s[3], vx, vy, n, 0xff8000ff);
+					} else {
+						OldPolygon(s[3], vx, vy, n, 0xff8000ff, NULL, 0, 0);
+					}
+				}
+				rounds++;
+			} while ((elapsed = SDL_GetTicks() - start) < (Uint32) ms);
+			printf(" %10.1f", rounds * 1000.0 / elapsed);
+		}
+		printf("\n");
+	}
+
+	for (d = 0; d < 4; d++) {
+		SDL_FreeSurface(s[d]);
+		SDL_FreeSurface(ref[d]);
+	}
+	SDL_FreeSurface(texture);
+
+	return (errors ? 1 : 0);
+}
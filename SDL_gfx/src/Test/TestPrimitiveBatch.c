@@ -0,0 +1,248 @@
+/*
+
+    TestPrimitiveBatch
+
+    Test program for batched primitives: records random pixels, lines,
+    rectangles and boxes, opaque and blended, clipped and not, and checks
+    that gfxPrimitivesBatchDraw gives the same pixels as drawing each of
+    them with its single call, in order and sorted by tile. Then reports
+    how many small primitives per second each way draws.
+
+    Usage: TestPrimitiveBatch [milliseconds to time each primitive]
+
+    Copyright (C) A. Schiffler, July 2006, GPL
+
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#include "SDL/SDL_gfxPrimitives.h"
+
+#define WIDTH	640
+#define HEIGHT	480
+#define COMMANDS 300
+#define TIMED	4000
+
+/* One random primitive, drawn with its single call or recorded into a batch */
+typedef struct {
+	int kind;
+	Sint16 x1, y1, x2, y2;
+	Uint32 color;
+} Primitive;
+
+void RandomPrimitive(Primitive *p, int kinds, int size, Uint32 color)
+{
+	p->kind = rand() % kinds;
+	p->x1 = rand() % (WIDTH + 200) - 100;
+	p->y1 = rand() % (HEIGHT + 200) - 100;
+	p->x2 = p->x1 + rand() % (2 * size + 1) - size;
+	p->y2 = p->y1 + rand() % (2 * size + 1) - size;
+	p->color = color;
+}
+
+int Draw(SDL_Surface *dst, Primitive *p)
+{
+	switch (p->kind) {
+	case 0:
+		return pixelColor(dst, p->x1, p->y1, p->color);
+	case 1:
+		return hlineColor(dst, p->x1, p->x2, p->y1, p->color);
+	case 2:
+		return vlineColor(dst, p->x1, p->y1, p->y2, p->color);
+	case 3:
+		return rectangleColor(dst, p->x1, p->y1, p->x2, p->y2, p->color);
+	case 4:
+		return boxColor(dst, p->x1, p->y1, p->x2, p->y2, p->color);
+	default:
+		return lineColor(dst, p->x1, p->y1, p->x2, p->y2, p->color);
+	}
+}
+
+int Record(gfxPrimitivesBatch *batch, Primitive *p)
+{
+	Uint8 r = p->color >> 24, g = p->color >> 16, b = p->color >> 8, a = p->color;
+
+	switch (p->kind) {
+	case 0:
+		return pixelColorBatch(batch, p->x1, p->y1, p->color);
+	case 1:
+		return hlineRGBABatch(batch, p->x1, p->x2, p->y1, r, g, b, a);
+	case 2:
+		return vlineColorBatch(batch, p->x1, p->y1, p->y2, p->color);
+	case 3:
+		return rectangleRGBABatch(batch, p->x1, p->y1, p->x2, p->y2, r, g, b, a);
+	case 4:
+		return boxColorBatch(batch, p->x1, p->y1, p->x2, p->y2, p->color);
+	default:
+		return lineColorBatch(batch, p->x1, p->y1, p->x2, p->y2, p->color);
+	}
+}
+
+/* Compare the pixels of two surfaces */
+int Compare(SDL_Surface *a, SDL_Surface *b)
+{
+	int y;
+
+	for (y = 0; y < a->h; y++) {
+		if (memcmp((Uint8 *) a->pixels + y * a->pitch, (Uint8 *) b->pixels + y * b->pitch, a->w * a->format->BytesPerPixel)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+void Randomize(SDL_Surface *s)
+{
+	int i;
+
+	for (i = 0; i < s->pitch * s->h; i++) {
+		((Uint8 *) s->pixels)[i] = rand();
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	static Primitive p[TIMED];
+	static const int depths[] = { 8, 16, 24, 32 };
+	static const char *names[] = { "pixels", "8 pixel hlines", "8 pixel vlines", "8x8 rectangles", "8x8 boxes", "8 pixel lines" };
+	SDL_Surface *s[4], *ref[4];
+	SDL_Rect clip;
+	SDL_Color colors[256];
+	gfxPrimitivesBatch batch;
+	int ms, d, i, j, n, kind, sort, rounds, errors = 0, tests = 0;
+	int timed[2] = { 3, 0 };
+	Uint32 color, start, elapsed;
+	int run;
+
+	ms = (argc > 1) ? atoi(argv[1]) : 500;
+
+	if (SDL_Init(SDL_INIT_TIMER) < 0) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		exit(1);
+	}
+	atexit(SDL_Quit);
+
+	for (i = 0; i < 256; i++) {
+		colors[i].r = rand();
+		colors[i].g = rand();
+		colors[i].b = rand();
+		colors[i].unused = 0;
+	}
+	for (d = 0; d < 4; d++) {
+		s[d] = SDL_CreateRGBSurface(SDL_SWSURFACE, WIDTH, HEIGHT, depths[d], 0, 0, 0, 0);
+		ref[d] = SDL_CreateRGBSurface(SDL_SWSURFACE, WIDTH, HEIGHT, depths[d], 0, 0, 0, 0);
+		if ((s[d] == NULL) || (ref[d] == NULL)) {
+			fprintf(stderr, "Couldn't create surfaces: %s\n", SDL_GetError());
+			exit(1);
+		}
+		if (depths[d] == 8) {
+			SDL_SetColors(s[d], colors, 0, 256);
+			SDL_SetColors(ref[d], colors, 0, 256);
+		}
+	}
+
+	gfxPrimitivesBatchInit(&batch);
+	for (i = 0; i < 800; i++) {
+		d = i % 4;
+		sort = (i / 4) % 2;
+
+		/* Half of them clipped to a random rectangle */
+		if (i % 16 < 8) {
+			clip.x = rand() % WIDTH;
+			clip.y = rand() % HEIGHT;
+			clip.w = rand() % (WIDTH - clip.x + 1);
+			clip.h = rand() % (HEIGHT - clip.y + 1);
+			SDL_SetClipRect(s[d], &clip);
+			SDL_SetClipRect(ref[d], &clip);
+		} else {
+			SDL_SetClipRect(s[d], NULL);
+			SDL_SetClipRect(ref[d], NULL);
+		}
+		Randomize(s[d]);
+		memcpy(ref[d]->pixels, s[d]->pixels, s[d]->pitch * s[d]->h);
+
+		/*
+		 * In order, anything goes. Sorted, the pixels only stay the same
+		 * where overlapping primitives are opaque and of one color.
+		 */
+		n = 1 + rand() % COMMANDS;
+		color = ((Uint32) rand() << 8) | 255;
+		for (j = 0; j < n; j++) {
+			if (!sort) {
+				color = ((Uint32) rand() << 8) | ((rand() & 1) ? 255 : rand() % 255);
+			}
+			RandomPrimitive(&p[j], 6, (j % 3 == 0) ? 300 : ((j % 3 == 1) ? 20 : 1), color);
+		}
+
+		gfxPrimitivesBatchClear(&batch);
+		for (j = 0; j < n; j++) {
+			Draw(ref[d], &p[j]);
+			if (Record(&batch, &p[j])) {
+				fprintf(stderr, "Couldn't record primitive %d\n", j);
+				exit(1);
+			}
+		}
+		tests++;
+		if (gfxPrimitivesBatchDraw(s[d], &batch, sort ? GFX_BATCH_SORT : 0) || Compare(s[d], ref[d])) {
+			if (errors++ < 10) {
+				printf("%s batch of %d primitives on %d bpp: pixels differ\n", sort ? "sorted" : "unsorted", n, depths[d]);
+			}
+		}
+	}
+	if (errors) {
+		printf("%d of %d batch tests failed\n", errors, tests);
+	} else {
+		printf("All %d batch tests passed.\n", tests);
+	}
+
+	/* Small primitives per second, on a 32 and an 8 bpp surface */
+	printf("%-28s %12s %12s %12s\n", "Kprimitives/s on 640x480", "single", "batch", "sorted");
+	for (i = 0; i < 2; i++) {
+		d = timed[i];
+		SDL_SetClipRect(s[d], NULL);
+		for (kind = 0; kind < 7; kind++) {
+			srand(1);
+			for (j = 0; j < TIMED; j++) {
+				p[j].kind = (kind < 6) ? kind : 4;
+				p[j].x1 = rand() % (WIDTH - 8);
+				p[j].y1 = rand() % (HEIGHT - 8);
+				p[j].x2 = p[j].x1 + 7;
+				p[j].y2 = p[j].y1 + 7;
+				p[j].color = (kind < 6) ? 0xff8000ff : 0xff800080;
+			}
+			printf("%2d bpp %-21s", depths[d], (kind < 6) ? names[kind] : "blended 8x8 boxes");
+			for (run = 0; run < 3; run++) {
+				rounds = 0;
+				start = SDL_GetTicks();
+				do {
+					if (run == 0) {
+						for (j = 0; j < TIMED; j++) {
+							Draw(s[d], &p[j]);
+						}
+					} else {
+						gfxPrimitivesBatchClear(&batch);
+						for (j = 0; j < TIMED; j++) {
+							Record(&batch, &p[j]);
+						}
+						gfxPrimitivesBatchDraw(s[d], &batch, (run == 2) ? GFX_BATCH_SORT : 0);
+					}
+					rounds++;
+				} while ((elapsed = SDL_GetTicks() - start) < (Uint32) ms);
+				printf(" %12.1f", (double) TIMED * rounds / elapsed);
+			}
+			printf("\n");
+		}
+	}
+	gfxPrimitivesBatchFree(&batch);
+
+	for (d = 0; d < 4; d++) {
+		SDL_FreeSurface(s[d]);
+		SDL_FreeSurface(ref[d]);
+	}
+
+	return (errors ? 1 : 0);
+}
@@ -0,0 +1,238 @@
+/*
+
+    TestRotozoomThreads
+
+    Test program for rotozooming on several threads: renders rotations
+    and zooms of 32bit and 8bit surfaces on 1 to N threads, checks every
+    thread count gives the same pixels as one thread, and reports the
+    time each takes and the speedup. Then has several threads call the
+    rotozoomers at once, which must give the same pixels too.
+
+    Usage: TestRotozoomThreads [max threads] [source size]
+
+    Copyright (C) A. Schiffler, July 2006, GPL
+
+*/
+
+#ifdef WIN32
+ #include <windows.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#include "SDL/SDL_rotozoom.h"
+
+#define ROUNDS	10
+#define CALLERS	4
+
+typedef struct {
+	const char *name;
+	int is32bit;
+	double angle;
+	double zoomx, zoomy;
+	int smooth;
+} tTransform;
+
+static tTransform transforms[] = {
+	{ "rotozoom 32bit smooth",    1, 30.0,  2.0,  2.0, SMOOTHING_ON },
+	{ "rotozoom 32bit",           1, 30.0,  2.0,  2.0, SMOOTHING_OFF },
+	{ "rotozoom 32bit flipped",   1, 135.0, -1.5, -1.0, SMOOTHING_OFF },
+	{ "rotozoom 8bit",            0, 60.0,  2.0,  2.0, SMOOTHING_OFF },
+	{ "zoom 32bit smooth",        1, 0.0,   3.0,  3.0, SMOOTHING_ON },
+	{ "zoom 32bit",               1, 0.0,   3.0,  2.5, SMOOTHING_OFF },
+	{ "zoom 32bit flipped",       1, 0.0,  -2.0, -2.0, SMOOTHING_OFF },
+	{ "zoom 8bit",                0, 0.0,   3.0,  3.0, SMOOTHING_OFF },
+	{ "shrink 32bit smooth",      1, 0.0,   0.4,  0.3, SMOOTHING_ON },
+	{ NULL }
+};
+
+static SDL_Surface *picture[2];
+static SDL_Surface *expected[sizeof(transforms) / sizeof(transforms[0])];
+
+/* A picture with detail everywhere, so any misplaced pixel shows */
+SDL_Surface *MakePicture(int size, int is32bit)
+{
+	SDL_Surface *picture;
+	Uint8 *row;
+	int x, y, i;
+
+	if (is32bit) {
+		picture = SDL_CreateRGBSurface(SDL_SWSURFACE, size, size * 3 / 4, 32,
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+			0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
+#else
+			0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff
+#endif
+			);
+	} else {
+		picture = SDL_CreateRGBSurface(SDL_SWSURFACE, size, size * 3 / 4, 8, 0, 0, 0, 0);
+	}
+	if (picture == NULL) {
+		return NULL;
+	}
+	if (!is32bit) {
+		for (i = 0; i < 256; i++) {
+			picture->format->palette->colors[i].r = i;
+			picture->format->palette->colors[i].g = 255 - i;
+			picture->format->palette->colors[i].b = (i * 7) & 0xff;
+		}
+	}
+	for (y = 0; y < picture->h; y++) {
+		row = (Uint8 *)picture->pixels + y * picture->pitch;
+		for (x = 0; x < picture->w * picture->format->BytesPerPixel; x++) {
+			row[x] = (Uint8)((x * 13) ^ (y * 7) ^ ((x * y) >> 5));
+		}
+	}
+	return picture;
+}
+
+SDL_Surface *Transform(SDL_Surface *picture, tTransform *transform)
+{
+	if (transform->angle != 0.0) {
+		return rotozoomSurfaceXY(picture, transform->angle,
+			transform->zoomx, transform->zoomy, transform->smooth);
+	}
+	return zoomSurface(picture, transform->zoomx, transform->zoomy, transform->smooth);
+}
+
+int SameSurface(SDL_Surface *a, SDL_Surface *b)
+{
+	int y, len;
+
+	if ((a->w != b->w) || (a->h != b->h) ||
+	    (a->format->BytesPerPixel != b->format->BytesPerPixel)) {
+		return 0;
+	}
+	len = a->w * a->format->BytesPerPixel;
+	for (y = 0; y < a->h; y++) {
+		if (memcmp((Uint8 *)a->pixels + y * a->pitch,
+			   (Uint8 *)b->pixels + y * b->pitch, len) != 0) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* Runs every transform, as one of several callers at once. Returns the number that differ. */
+int Caller(void *unused)
+{
+	SDL_Surface *result;
+	int i, errors = 0;
+
+	for (i = 0; transforms[i].name; i++) {
+		result = Transform(picture[transforms[i].is32bit], &transforms[i]);
+		if ((result == NULL) || !SameSurface(expected[i], result)) {
+			errors++;
+		}
+		SDL_FreeSurface(result);
+	}
+	return errors;
+}
+
+int main(int argc, char *argv[])
+{
+	SDL_Surface *result;
+	SDL_Thread *callers[CALLERS];
+	tTransform *transform;
+	int maxthreads, size, threads, round, i, status, differ, errors = 0;
+	Uint32 start, ms, ms1;
+
+	maxthreads = (argc > 1) ? atoi(argv[1]) : 8;
+	size = (argc > 2) ? atoi(argv[2]) : 640;
+
+	if (SDL_Init(SDL_INIT_TIMER) < 0) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		exit(1);
+	}
+	atexit(SDL_Quit);
+
+	picture[0] = MakePicture(size, 0);
+	picture[1] = MakePicture(size, 1);
+	if ((picture[0] == NULL) || (picture[1] == NULL)) {
+		fprintf(stderr, "Couldn't create pictures: %s\n", SDL_GetError());
+		exit(1);
+	}
+
+	printf("%d x %d source, %d rounds\n", picture[1]->w, picture[1]->h, ROUNDS);
+	for (transform = transforms; transform->name; transform++) {
+		rotozoomSetThreads(1);
+		i = transform - transforms;
+		expected[i] = Transform(picture[transform->is32bit], transform);
+		if (expected[i] == NULL) {
+			fprintf(stderr, "%s failed\n", transform->name);
+			exit(1);
+		}
+		printf("%-24s %4d x %4d:", transform->name, expected[i]->w, expected[i]->h);
+
+		ms1 = 1;
+		for (threads = 1; threads <= maxthreads; threads *= 2) {
+			if (rotozoomSetThreads(threads) != threads) {
+				fprintf(stderr, "Couldn't start %d threads\n", threads);
+				break;
+			}
+			start = SDL_GetTicks();
+			for (round = 0; round < ROUNDS; round++) {
+				result = Transform(picture[transform->is32bit], transform);
+				if (result == NULL) {
+					fprintf(stderr, "%s failed\n", transform->name);
+					exit(1);
+				}
+				if ((round == 0) && !SameSurface(expected[i], result)) {
+					printf("\n%s on %d threads differs from 1 thread\n",
+						transform->name, threads);
+					errors++;
+				}
+				SDL_FreeSurface(result);
+			}
+			ms = SDL_GetTicks() - start;
+			if (ms == 0) {
+				ms = 1;
+			}
+			if (threads == 1) {
+				ms1 = ms;
+			}
+			printf("  %d: %5.1f ms %4.2fx", threads,
+				(double)ms / ROUNDS, (double)ms1 / ms);
+			fflush(stdout);
+		}
+		printf("\n");
+	}
+
+	/* Callers on other threads don't wait for the one with the workers */
+	rotozoomSetThreads(maxthreads);
+	for (i = 0; i < CALLERS; i++) {
+		callers[i] = SDL_CreateThread(Caller, NULL);
+	}
+	differ = Caller(NULL);
+	for (i = 0; i < CALLERS; i++) {
+		if (callers[i] == NULL) {
+			fprintf(stderr, "Couldn't start caller %d\n", i);
+			continue;
+		}
+		SDL_WaitThread(callers[i], &status);
+		differ += status;
+	}
+	if (differ) {
+		printf("%d transforms differ with %d callers at once\n", differ, CALLERS + 1);
+	}
+	errors += differ;
+	rotozoomSetThreads(1);
+
+	for (i = 0; transforms[i].name; i++) {
+		SDL_FreeSurface(expected[i]);
+	}
+
+	SDL_FreeSurface(picture[0]);
+	SDL_FreeSurface(picture[1]);
+
+	if (errors) {
+		printf("%d rotozoom thread tests failed\n", errors);
+	} else {
+		printf("All rotozoom thread tests passed.\n");
+	}
+	return (errors ? 1 : 0);
+}
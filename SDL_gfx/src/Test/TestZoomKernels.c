@@ -0,0 +1,242 @@
+/*
+
+    TestZoomKernels
+
+    Test program and benchmark of the vector kernels of the smooth zoomer,
+    the shrinker and the mipmapper: zooms, shrinks and mipmaps 32bit
+    surfaces from 64x64 up to 3840x2160 with the vector kernels and with
+    the plain C loops, checks how far apart the two come out against the
+    bound each kernel has, and reports the megapixels per second of each,
+    counting the larger of source and destination.
+
+    Usage: TestZoomKernels [milliseconds per measurement]
+
+    Copyright (C) A. Schiffler, July 2006, GPL
+
+*/
+
+#ifdef WIN32
+ #include <windows.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#include "SDL/SDL_rotozoom.h"
+
+typedef struct {
+	int w, h;
+} tSize;
+
+static tSize sizes[] = {
+	{ 64, 64 },
+	{ 320, 240 },
+	{ 640, 480 },
+	{ 1280, 720 },
+	{ 1920, 1080 },
+	{ 3840, 2160 },
+	{ 0, 0 }
+};
+
+enum {
+	ZOOM_UP,
+	ZOOM_DOWN,
+	SHRINK_2,
+	SHRINK_3,
+	MIPMAP_QUARTER,
+	MIPMAP_THUMBNAIL
+};
+
+typedef struct {
+	const char *name;
+	int kind;
+	int maxarea;	/* Largest source, in pixels */
+	int bound;	/* Largest difference allowed from the plain C loops */
+} tKernel;
+
+static tKernel kernels[] = {
+	{ "bilinear zoom x2",      ZOOM_UP,          1920 * 1080, 0 },
+	{ "bilinear zoom x0.6",    ZOOM_DOWN,        3840 * 2160, 0 },
+	{ "box shrink 1/2",        SHRINK_2,         3840 * 2160, 0 },
+	{ "box shrink 1/3",        SHRINK_3,         3840 * 2160, 0 },
+	{ "mipmap 1/4",            MIPMAP_QUARTER,   3840 * 2160, 0 },
+	{ "mipmap thumbnail",      MIPMAP_THUMBNAIL, 3840 * 2160, 0 },
+	{ NULL }
+};
+
+/* A picture with detail everywhere, so any misplaced pixel shows */
+SDL_Surface *MakePicture(int w, int h)
+{
+	SDL_Surface *picture;
+	Uint8 *row;
+	int x, y;
+
+	picture = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, 32,
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+		0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
+#else
+		0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff
+#endif
+		);
+	if (picture == NULL) {
+		return NULL;
+	}
+	for (y = 0; y < picture->h; y++) {
+		row = (Uint8 *)picture->pixels + y * picture->pitch;
+		for (x = 0; x < picture->w * 4; x++) {
+			row[x] = (Uint8)((x * 13) ^ (y * 7) ^ ((x * y) >> 5));
+		}
+	}
+	return picture;
+}
+
+SDL_Surface *Run(SDL_Surface *picture, int kind)
+{
+	switch (kind) {
+	case ZOOM_UP:
+		return zoomSurface(picture, 2.0, 2.0, SMOOTHING_ON);
+	case ZOOM_DOWN:
+		return zoomSurface(picture, 0.6, 0.6, SMOOTHING_ON);
+	case SHRINK_2:
+		return shrinkSurface(picture, 2, 2);
+	case SHRINK_3:
+		return shrinkSurface(picture, 3, 3);
+	case MIPMAP_QUARTER:
+		return mipmapSurface(picture, picture->w / 4, picture->h / 4);
+	default:
+		return mipmapSurface(picture, (picture->w + 4) / 5, (picture->h + 6) / 7);
+	}
+}
+
+/* Returns the largest difference of any channel, or 256 if the sizes differ */
+int Difference(SDL_Surface *a, SDL_Surface *b)
+{
+	Uint8 *pa, *pb;
+	int x, y, d, diff = 0;
+
+	if ((a->w != b->w) || (a->h != b->h)) {
+		return 256;
+	}
+	for (y = 0; y < a->h; y++) {
+		pa = (Uint8 *)a->pixels + y * a->pitch;
+		pb = (Uint8 *)b->pixels + y * b->pitch;
+		for (x = 0; x < a->w * 4; x++) {
+			d = abs(pa[x] - pb[x]);
+			if (d > diff) {
+				diff = d;
+			}
+		}
+	}
+	return diff;
+}
+
+/* Megapixels a second, counting the larger of source and destination */
+double Measure(SDL_Surface *picture, int kind, Uint32 ms)
+{
+	SDL_Surface *result;
+	Uint32 start, elapsed;
+	double pixels = 0.0;
+
+	start = SDL_GetTicks();
+	do {
+		result = Run(picture, kind);
+		if (result == NULL) {
+			fprintf(stderr, "Out of memory\n");
+			exit(1);
+		}
+		if (picture->w * picture->h > result->w * result->h) {
+			pixels += picture->w * picture->h;
+		} else {
+			pixels += result->w * result->h;
+		}
+		SDL_FreeSurface(result);
+		elapsed = SDL_GetTicks() - start;
+	} while (elapsed < ms);
+	return pixels / (elapsed * 1000.0);
+}
+
+int main(int argc, char *argv[])
+{
+	SDL_Surface *picture, *vector, *plain, *reference;
+	tKernel *kernel;
+	tSize *size;
+	Uint32 ms;
+	int diff, errors = 0;
+
+	ms = (argc > 1) ? atoi(argv[1]) : 250;
+
+	if (SDL_Init(SDL_INIT_TIMER) < 0) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		exit(1);
+	}
+	atexit(SDL_Quit);
+
+	if (rotozoomSetSIMD(1) == 0) {
+		printf("No vector kernels on this CPU, comparing the plain C loops to themselves\n");
+	}
+
+	printf("%-32s %11s %11s %s\n", "", "vector", "plain C", "difference");
+	for (size = sizes; size->w; size++) {
+		picture = MakePicture(size->w, size->h);
+		if (picture == NULL) {
+			fprintf(stderr, "Couldn't create picture: %s\n", SDL_GetError());
+			exit(1);
+		}
+		for (kernel = kernels; kernel->name; kernel++) {
+			if (size->w * size->h > kernel->maxarea) {
+				continue;
+			}
+			rotozoomSetSIMD(1);
+			vector = Run(picture, kernel->kind);
+			rotozoomSetSIMD(0);
+			plain = Run(picture, kernel->kind);
+			if ((vector == NULL) || (plain == NULL)) {
+				fprintf(stderr, "Out of memory\n");
+				exit(1);
+			}
+			diff = Difference(vector, plain);
+			printf("%-20s %4d x %4d", kernel->name, size->w, size->h);
+			rotozoomSetSIMD(1);
+			printf(" %6.1f MP/s", Measure(picture, kernel->kind, ms));
+			rotozoomSetSIMD(0);
+			printf(" %6.1f MP/s", Measure(picture, kernel->kind, ms));
+			printf(" %d", diff);
+			if (diff > kernel->bound) {
+				printf(", more than %d", kernel->bound);
+				errors++;
+			}
+			printf("\n");
+			SDL_FreeSurface(vector);
+			SDL_FreeSurface(plain);
+		}
+
+		/* Mipmapping by 4 is shrinking by 4, rounded twice */
+		rotozoomSetSIMD(1);
+		vector = Run(picture, MIPMAP_QUARTER);
+		reference = shrinkSurface(picture, 4, 4);
+		if ((vector == NULL) || (reference == NULL)) {
+			fprintf(stderr, "Out of memory\n");
+			exit(1);
+		}
+		diff = Difference(vector, reference);
+		if (diff > 1) {
+			printf("mipmap 1/4 %d x %d is %d away from shrinking\n", size->w, size->h, diff);
+			errors++;
+		}
+		SDL_FreeSurface(vector);
+		SDL_FreeSurface(reference);
+
+		SDL_FreeSurface(picture);
+	}
+	rotozoomSetSIMD(1);
+
+	if (errors) {
+		printf("%d zoom kernel tests failed\n", errors);
+	} else {
+		printf("All zoom kernel tests passed.\n");
+	}
+	return (errors ? 1 : 0);
+}
@@ -87,6 +87,7 @@ typedef struct Mix_Chunk {
 	Uint8 *abuf;
 	Uint32 alen;
 	Uint8 volume;		/* Per-sample volume, 0-128 */
+	Uint8 priority;		/* For MIX_STEAL_PRIORITY, 0-255 */
 } Mix_Chunk;
 
 /* The different fading types supported */
@@ -96,6 +97,15 @@ typedef enum {
 	MIX_FADING_IN
 } Mix_Fading;
 
+/* What playing a chunk on channel -1 does when no channel is free */
+typedef enum {
+	MIX_STEAL_NONE,		/* Fail, the default */
+	MIX_STEAL_OLDEST,	/* Stop the channel that started first */
+	MIX_STEAL_QUIETEST,	/* Stop the channel at the lowest volume */
+	MIX_STEAL_PRIORITY	/* Stop the lowest priority chunk, if it isn't
+				   higher than the new one */
+} Mix_StealPolicy;
+
 typedef enum {
 	MUS_NONE,
 	MUS_CMD,
@@ -142,6 +152,56 @@ extern DECLSPEC Mix_Chunk * SDLCALL Mix_QuickLoad_WAV(Uint8 *mem);
 /* Load raw audio data of the mixer format from a memory buffer */
 extern DECLSPEC Mix_Chunk * SDLCALL Mix_QuickLoad_RAW(Uint8 *mem, Uint32 len);
 
+/* Load a wave file through the chunk cache, decoded to the mixer format.
+   Loading the same file again while the audio is open returns the same
+   chunk, and each load must be matched by a Mix_FreeChunk(). Shared chunks
+   share their volume too.
+   The RWops version finds the sound by the RWops pointer and its current
+   position, and only shares it if the bytes there are still the same, so
+   a new RWops at an old address doesn't get the old sound. It leaves the
+   RWops after the sound like Mix_LoadWAV_RW(), and never frees it.
+ */
+extern DECLSPEC Mix_Chunk * SDLCALL Mix_LoadWAV_Cached(const char *file);
+extern DECLSPEC Mix_Chunk * SDLCALL Mix_LoadWAV_RW_Cached(SDL_RWops *src);
+
+/* Set how many bytes the chunk cache may use to keep chunks nobody holds,
+   so loading them again doesn't decode them again. When it's over, the
+   least recently used chunks that aren't playing are freed. The default
+   is 0, which frees chunks as soon as nobody holds them.
+   If bytes is -1, the budget is not changed.
+   This function returns the previous budget.
+ */
+extern DECLSPEC int SDLCALL Mix_SetChunkCacheBudget(int bytes);
+
+/* If on is nonzero, cached chunks loaded after this keep the file as it is
+   (an Ogg or FLAC file is much smaller than the decoded sound), and only
+   decode it the first time the chunk is played. Until then the chunk's
+   abuf is NULL and its alen is 0. When the cache is over its budget,
+   these chunks go back to just the file, even while they're held.
+   In this mode a sound read from a RWops is the rest of the RWops.
+   This function returns the previous setting.
+ */
+extern DECLSPEC int SDLCALL Mix_SetChunkCacheCompressed(int on);
+
+/* Free every cached chunk that isn't held or playing, and the decoded
+   sound of held chunks that were kept compressed.
+ */
+extern DECLSPEC void SDLCALL Mix_FlushChunkCache(void);
+
+typedef struct Mix_ChunkCacheStats {
+	int hits;		/* Loads that found the chunk in the cache */
+	int misses;		/* Loads that had to decode the file */
+	int evictions;		/* Chunks freed or put back to the file */
+	int entries;		/* Chunks in the cache now */
+	int decoded_bytes;	/* Bytes of decoded sound in the cache */
+	int compressed_bytes;	/* Bytes of files kept compressed */
+} Mix_ChunkCacheStats;
+
+/* Get the chunk cache statistics. The counts are since the program
+   started, the sizes are now.
+ */
+extern DECLSPEC void SDLCALL Mix_GetChunkCacheStats(Mix_ChunkCacheStats *stats);
+
 /* Free an audio chunk previously loaded */
 extern DECLSPEC void SDLCALL Mix_FreeChunk(Mix_Chunk *chunk);
 extern DECLSPEC void SDLCALL Mix_FreeMusic(Mix_Music *music);
@@ -469,7 +529,7 @@ extern DECLSPEC int SDLCALL Mix_ReserveChannels(int num);
 extern DECLSPEC int SDLCALL Mix_GroupChannel(int which, int tag);
 /* Assign several consecutive channels to a group */
 extern DECLSPEC int SDLCALL Mix_GroupChannels(int from, int to, int tag);
-/* Finds the first available channel in a group of channels,
+/* Finds an available channel in a group of channels,
    returning -1 if none are available.
  */
 extern DECLSPEC int SDLCALL Mix_GroupAvailable(int tag);
@@ -482,8 +542,15 @@ extern DECLSPEC int SDLCALL Mix_GroupOldest(int tag);
 /* Finds the "most recent" (i.e. last) sample playing in a group of channels */
 extern DECLSPEC int SDLCALL Mix_GroupNewer(int tag);
 
+/* Choose what playing on channel -1 does when no channel is free.
+   Reserved channels are never stopped.
+ */
+extern DECLSPEC void SDLCALL Mix_SetStealPolicy(Mix_StealPolicy policy);
+extern DECLSPEC Mix_StealPolicy SDLCALL Mix_GetStealPolicy(void);
+
 /* Play an audio chunk on a specific channel.
-   If the specified channel is -1, play on the first free channel.
+   If the specified channel is -1, play on a free channel, the one that
+   has been free longest. If none is free, the steal policy decides.
    If 'loops' is greater than zero, loop the sound that many times.
    If 'loops' is -1, loop inifinitely (~65000 times).
    Returns which channel was used to play the sound.
@@ -506,6 +573,13 @@ extern DECLSPEC int SDLCALL Mix_FadeInChannelTimed(int channel, Mix_Chunk *chunk
 */
 extern DECLSPEC int SDLCALL Mix_Volume(int channel, int volume);
 extern DECLSPEC int SDLCALL Mix_VolumeChunk(Mix_Chunk *chunk, int volume);
+
+/* Set the priority in the range of 0-255 of a chunk, for
+   MIX_STEAL_PRIORITY. Chunks are loaded with priority 0.
+   Returns the original priority.
+   If the specified priority is -1, just return the current priority.
+*/
+extern DECLSPEC int SDLCALL Mix_PriorityChunk(Mix_Chunk *chunk, int priority);
 extern DECLSPEC int SDLCALL Mix_VolumeMusic(int volume);
 
 /* Halt playing of a particular channel */
@@ -556,6 +630,29 @@ extern DECLSPEC int SDLCALL Mix_SetMusicPosition(double position);
 extern DECLSPEC int SDLCALL Mix_Playing(int channel);
 extern DECLSPEC int SDLCALL Mix_PlayingMusic(void);
 
+/* Decode the music on a thread of its own, up to prefetch_ms milliseconds
+   ahead of playback, so a slow read or decode doesn't stall the audio
+   callback. 0, the default, decodes in the audio callback. This halts the
+   music, and can be called before or after Mix_OpenAudio().
+   WAV, MOD, Timidity MIDI, OGG, FLAC and libmad MP3 music are decoded
+   ahead, other music is still played from the audio callback.
+   This function returns 0, or -1 if the decode thread couldn't be started.
+*/
+extern DECLSPEC int SDLCALL Mix_SetMusicDecodeAhead(int prefetch_ms);
+
+/* How well decoding ahead keeps up, all in bytes of mixer audio */
+typedef struct Mix_MusicDecodeStats {
+	int size;		/* How much can be decoded ahead */
+	int filled;		/* How much is decoded ahead now */
+	int lowest_filled;	/* The least decoded ahead since the last call */
+	int underruns;		/* Times playback caught up with decoding */
+} Mix_MusicDecodeStats;
+
+/* Get the decode ahead statistics.
+   This returns 0, or -1 if the music isn't being decoded ahead.
+*/
+extern DECLSPEC int SDLCALL Mix_GetMusicDecodeStats(Mix_MusicDecodeStats *stats);
+
 /* Stop music and set external music playback command */
 extern DECLSPEC int SDLCALL Mix_SetMusicCMD(const char *command);
 
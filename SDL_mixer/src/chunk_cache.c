@@ -0,0 +1,497 @@
+/*
+    SDL_mixer:  An audio mixer library based on the SDL library
+    Copyright (C) 1997-2009 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public
+    License along with this library; if not, write to the Free
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/* This file implements the cache of chunks decoded to the mixer format.
+   Chunks are found by file name, or by RWops and position, and shared by
+   reference count. A RWops can be closed and another opened at the same
+   address, so a sound loaded from one is only shared if the bytes there
+   hash the same as when it was loaded. Chunks nobody holds are kept while they fit in the
+   budget, and the least recently used ones that aren't playing go first.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "SDL_rwops.h"
+
+#include "SDL_mixer.h"
+#include "chunk_cache.h"
+
+#define CACHE_BUCKETS	128		/* a power of two */
+
+typedef struct _Mix_CachedChunk {
+	Mix_Chunk chunk;		/* first, so a chunk is its entry */
+	Uint32 hash;
+	char *file;			/* NULL if loaded from a RWops */
+	SDL_RWops *rw;
+	int offset;			/* where in the RWops the sound starts */
+	int end;			/* and where it ends */
+	Uint32 sum;			/* hash of the bytes in between */
+	int freq;
+	Uint16 format;
+	int channels;
+	int refcount;
+	int decoded;			/* bytes of abuf counted in the budget */
+	Uint8 *source;			/* the undecoded sound, kept compressed */
+	int sourcelen;
+	int detached;			/* left behind when the audio closed */
+	struct _Mix_CachedChunk *next;	/* in its bucket */
+	struct _Mix_CachedChunk *newer;	/* in order of use */
+	struct _Mix_CachedChunk *older;
+} cached_chunk;
+
+static cached_chunk *buckets[CACHE_BUCKETS];
+static cached_chunk *newest = NULL;
+static cached_chunk *oldest = NULL;
+static int cache_bytes = 0;
+static int cache_budget = 0;
+static int cache_compressed = 0;
+static Mix_ChunkCacheStats cache_stats;
+
+/* FNV-1a */
+static Uint32 hash_bytes(Uint32 hash, const void *data, int len)
+{
+	const Uint8 *p = (const Uint8 *)data;
+
+	while ( len-- ) {
+		hash = (hash ^ *p++) * 16777619;
+	}
+	return(hash);
+}
+
+/* Hash the bytes of rw from start to end, leaving rw at end */
+static int hash_source(SDL_RWops *rw, int start, int end, Uint32 *sum)
+{
+	Uint8 buf[1024];
+	Uint32 hash = 2166136261u;
+	int len;
+
+	if ( SDL_RWseek(rw, start, SEEK_SET) < 0 ) {
+		return(-1);
+	}
+	while ( start < end ) {
+		len = end - start;
+		if ( len > (int)sizeof(buf) ) {
+			len = sizeof(buf);
+		}
+		if ( SDL_RWread(rw, buf, len, 1) != 1 ) {
+			return(-1);
+		}
+		hash = hash_bytes(hash, buf, len);
+		start += len;
+	}
+	*sum = hash;
+	return(0);
+}
+
+static Uint32 hash_key(const char *file, SDL_RWops *rw, int offset,
+                       int freq, Uint16 format, int channels)
+{
+	Uint32 hash = 2166136261u;
+
+	if ( file ) {
+		hash = hash_bytes(hash, file, strlen(file));
+	} else {
+		hash = hash_bytes(hash, &rw, sizeof(rw));
+		hash = hash_bytes(hash, &offset, sizeof(offset));
+	}
+	hash = hash_bytes(hash, &freq, sizeof(freq));
+	hash = hash_bytes(hash, &format, sizeof(format));
+	hash = hash_bytes(hash, &channels, sizeof(channels));
+	return(hash);
+}
+
+static cached_chunk *find_chunk(Uint32 hash, const char *file,
+                                SDL_RWops *rw, int offset,
+                                int freq, Uint16 format, int channels)
+{
+	cached_chunk *entry;
+
+	for ( entry = buckets[hash & (CACHE_BUCKETS-1)]; entry; entry = entry->next ) {
+		if ( entry->hash != hash ||
+		     entry->freq != freq || entry->format != format ||
+		     entry->channels != channels ) {
+			continue;
+		}
+		if ( file ? (entry->file && strcmp(entry->file, file) == 0)
+		          : (!entry->file && entry->rw == rw &&
+		             entry->offset == offset) ) {
+			return(entry);
+		}
+	}
+	return(NULL);
+}
+
+static void link_newest(cached_chunk *entry)
+{
+	entry->older = newest;
+	entry->newer = NULL;
+	if ( newest ) {
+		newest->newer = entry;
+	} else {
+		oldest = entry;
+	}
+	newest = entry;
+}
+
+static void unlink_use(cached_chunk *entry)
+{
+	if ( entry->newer ) {
+		entry->newer->older = entry->older;
+	} else {
+		newest = entry->older;
+	}
+	if ( entry->older ) {
+		entry->older->newer = entry->newer;
+	} else {
+		oldest = entry->newer;
+	}
+}
+
+/* Make the entry the most recently used */
+static void touch_entry(cached_chunk *entry)
+{
+	if ( entry != newest ) {
+		unlink_use(entry);
+		link_newest(entry);
+	}
+}
+
+static void add_entry(cached_chunk *entry)
+{
+	entry->next = buckets[entry->hash & (CACHE_BUCKETS-1)];
+	buckets[entry->hash & (CACHE_BUCKETS-1)] = entry;
+	link_newest(entry);
+	cache_bytes += entry->decoded + entry->sourcelen;
+}
+
+static void remove_entry(cached_chunk *entry)
+{
+	cached_chunk **prev;
+
+	unlink_use(entry);
+	for ( prev = &buckets[entry->hash & (CACHE_BUCKETS-1)]; *prev; prev = &(*prev)->next ) {
+		if ( *prev == entry ) {
+			*prev = entry->next;
+			break;
+		}
+	}
+	cache_bytes -= entry->decoded + entry->sourcelen;
+}
+
+static void free_entry(cached_chunk *entry)
+{
+	free(entry->chunk.abuf);
+	free(entry->source);
+	free(entry->file);
+	free(entry);
+}
+
+/* Decode the sound in rw into the entry's chunk */
+static int decode_chunk(cached_chunk *entry, SDL_RWops *rw)
+{
+	Mix_Chunk *chunk;
+
+	chunk = Mix_LoadWAV_RW(rw, 0);
+	if ( chunk == NULL ) {
+		return(-1);
+	}
+	entry->chunk.abuf = chunk->abuf;
+	entry->chunk.alen = chunk->alen;
+	entry->decoded = chunk->alen;
+	free(chunk);
+	return(0);
+}
+
+/* Read the rest of rw into the entry, to decode when it's played */
+static int read_source(cached_chunk *entry, SDL_RWops *rw)
+{
+	int start, end;
+
+	start = SDL_RWtell(rw);
+	end = SDL_RWseek(rw, 0, SEEK_END);
+	if ( start < 0 || end <= start || SDL_RWseek(rw, start, SEEK_SET) < 0 ) {
+		Mix_SetError("Couldn't find the length of the sound");
+		return(-1);
+	}
+	entry->source = (Uint8 *)malloc(end - start);
+	if ( entry->source == NULL ) {
+		Mix_SetError("Out of memory");
+		return(-1);
+	}
+	if ( SDL_RWread(rw, entry->source, end - start, 1) != 1 ) {
+		Mix_SetError("Couldn't read the sound");
+		free(entry->source);
+		entry->source = NULL;
+		return(-1);
+	}
+	entry->sourcelen = end - start;
+	return(0);
+}
+
+/* Bring the cache down to limit bytes, leaving out keep. Chunks nobody
+   holds are freed, and chunks that are held but were kept compressed go
+   back to just the compressed sound.
+ */
+static void evict(int limit, cached_chunk *keep)
+{
+	cached_chunk *entry, *newer;
+
+	for ( entry = oldest; entry && cache_bytes > limit; entry = newer ) {
+		newer = entry->newer;
+		if ( entry == keep ||
+		     (entry->refcount && (!entry->source || !entry->decoded)) ||
+		     _Mix_ChunkPlaying(&entry->chunk) ) {
+			continue;
+		}
+		if ( entry->refcount ) {
+			cache_bytes -= entry->decoded;
+			free(entry->chunk.abuf);
+			entry->chunk.abuf = NULL;
+			entry->chunk.alen = 0;
+			entry->decoded = 0;
+		} else {
+			remove_entry(entry);
+			free_entry(entry);
+		}
+		++cache_stats.evictions;
+	}
+}
+
+static Mix_Chunk *load_cached(const char *file, SDL_RWops *src)
+{
+	int freq, channels, offset = 0;
+	Uint16 format;
+	Uint32 hash;
+	cached_chunk *entry;
+	SDL_RWops *rw;
+	int status;
+
+	/* Make sure audio has been opened */
+	if ( ! Mix_QuerySpec(&freq, &format, &channels) ) {
+		Mix_SetError("Audio device hasn't been opened");
+		return(NULL);
+	}
+	if ( src ) {
+		offset = SDL_RWtell(src);
+	}
+
+	hash = hash_key(file, src, offset, freq, format, channels);
+	entry = find_chunk(hash, file, src, offset, freq, format, channels);
+	if ( entry && src ) {
+		Uint32 sum;
+
+		if ( hash_source(src, offset, entry->end, &sum) < 0 ||
+		     sum != entry->sum ) {
+			/* Another sound at the same RWops address */
+			entry->rw = NULL;
+			entry = NULL;
+			SDL_RWseek(src, offset, SEEK_SET);
+		}
+	}
+	if ( entry ) {
+		++cache_stats.hits;
+		++entry->refcount;
+		touch_entry(entry);
+		if ( src ) {
+			SDL_RWseek(src, entry->end, SEEK_SET);
+		}
+		return(&entry->chunk);
+	}
+	++cache_stats.misses;
+
+	entry = (cached_chunk *)calloc(1, sizeof(cached_chunk));
+	if ( entry == NULL ) {
+		Mix_SetError("Out of memory");
+		return(NULL);
+	}
+	if ( file ) {
+		entry->file = (char *)malloc(strlen(file)+1);
+		if ( entry->file == NULL ) {
+			Mix_SetError("Out of memory");
+			free(entry);
+			return(NULL);
+		}
+		strcpy(entry->file, file);
+		rw = SDL_RWFromFile(file, "rb");
+		if ( rw == NULL ) {
+			free_entry(entry);
+			return(NULL);
+		}
+	} else {
+		rw = src;
+	}
+
+	if ( cache_compressed ) {
+		status = read_source(entry, rw);
+	} else {
+		status = decode_chunk(entry, rw);
+	}
+	if ( file ) {
+		SDL_RWclose(rw);
+	} else if ( status == 0 ) {
+		entry->end = SDL_RWtell(src);
+		if ( entry->source ) {
+			entry->sum = hash_bytes(2166136261u, entry->source, entry->sourcelen);
+		} else {
+			status = hash_source(src, offset, entry->end, &entry->sum);
+			if ( status < 0 ) {
+				Mix_SetError("Couldn't read the sound");
+			}
+		}
+	}
+	if ( status < 0 ) {
+		free_entry(entry);
+		return(NULL);
+	}
+
+	entry->chunk.allocated = MIX_CHUNK_CACHED;
+	entry->chunk.volume = MIX_MAX_VOLUME;
+	entry->chunk.priority = 0;
+	entry->hash = hash;
+	entry->rw = src;
+	entry->offset = offset;
+	entry->freq = freq;
+	entry->format = format;
+	entry->channels = channels;
+	entry->refcount = 1;
+	add_entry(entry);
+	evict(cache_budget, entry);
+	return(&entry->chunk);
+}
+
+Mix_Chunk *Mix_LoadWAV_Cached(const char *file)
+{
+	if ( file == NULL ) {
+		Mix_SetError("Mix_LoadWAV_Cached with NULL file");
+		return(NULL);
+	}
+	return(load_cached(file, NULL));
+}
+
+Mix_Chunk *Mix_LoadWAV_RW_Cached(SDL_RWops *src)
+{
+	if ( src == NULL ) {
+		Mix_SetError("Mix_LoadWAV_RW_Cached with NULL src");
+		return(NULL);
+	}
+	return(load_cached(NULL, src));
+}
+
+int _Mix_UseCachedChunk(Mix_Chunk *chunk)
+{
+	cached_chunk *entry = (cached_chunk *)chunk;
+	SDL_RWops *rw;
+	int status;
+
+	if ( ! entry->detached ) {
+		touch_entry(entry);
+	}
+	if ( chunk->abuf ) {
+		return(0);
+	}
+
+	/* Kept compressed, decode it now */
+	rw = SDL_RWFromConstMem(entry->source, entry->sourcelen);
+	if ( rw == NULL ) {
+		return(-1);
+	}
+	status = decode_chunk(entry, rw);
+	SDL_RWclose(rw);
+	if ( status < 0 ) {
+		return(-1);
+	}
+	if ( ! entry->detached ) {
+		cache_bytes += entry->decoded;
+		evict(cache_budget, entry);
+	}
+	return(0);
+}
+
+void _Mix_ReleaseCachedChunk(Mix_Chunk *chunk)
+{
+	cached_chunk *entry = (cached_chunk *)chunk;
+
+	if ( entry->refcount <= 0 || --entry->refcount > 0 ) {
+		return;
+	}
+	if ( entry->detached ) {
+		_Mix_HaltChunk(chunk);
+		free_entry(entry);
+	} else {
+		evict(cache_budget, NULL);
+	}
+}
+
+void _Mix_CloseChunkCache(void)
+{
+	cached_chunk *entry, *newer;
+
+	for ( entry = oldest; entry; entry = newer ) {
+		newer = entry->newer;
+		remove_entry(entry);
+		if ( entry->refcount ) {
+			entry->detached = 1;
+		} else {
+			free_entry(entry);
+		}
+	}
+}
+
+int Mix_SetChunkCacheBudget(int bytes)
+{
+	int prev_budget = cache_budget;
+
+	if ( bytes >= 0 ) {
+		cache_budget = bytes;
+		evict(cache_budget, NULL);
+	}
+	return(prev_budget);
+}
+
+int Mix_SetChunkCacheCompressed(int on)
+{
+	int prev_compressed = cache_compressed;
+
+	cache_compressed = on;
+	return(prev_compressed);
+}
+
+void Mix_FlushChunkCache(void)
+{
+	evict(0, NULL);
+}
+
+void Mix_GetChunkCacheStats(Mix_ChunkCacheStats *stats)
+{
+	cached_chunk *entry;
+
+	*stats = cache_stats;
+	stats->entries = 0;
+	stats->decoded_bytes = 0;
+	stats->compressed_bytes = 0;
+	for ( entry = newest; entry; entry = entry->older ) {
+		++stats->entries;
+		stats->decoded_bytes += entry->decoded;
+		stats->compressed_bytes += entry->sourcelen;
+	}
+}
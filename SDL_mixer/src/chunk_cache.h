@@ -0,0 +1,55 @@
+/*
+    SDL_mixer:  An audio mixer library based on the SDL library
+    Copyright (C) 1997-2009 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public
+    License along with this library; if not, write to the Free
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/* This file implements the cache behind Mix_LoadWAV_Cached(). Cached
+   chunks are shared between everyone who loads them, and are only freed
+   by the cache.
+ */
+
+#ifndef _CHUNK_CACHE_H_
+#define _CHUNK_CACHE_H_
+
+#include "SDL_mixer.h"
+
+/* The allocated field of a chunk owned by the cache */
+#define MIX_CHUNK_CACHED	2
+
+/* Make a cached chunk ready to play, decoding it if it was kept
+   compressed. This function returns 0, or -1 if it couldn't be decoded.
+ */
+extern int _Mix_UseCachedChunk(Mix_Chunk *chunk);
+
+/* Drop a reference to a cached chunk, from Mix_FreeChunk() */
+extern void _Mix_ReleaseCachedChunk(Mix_Chunk *chunk);
+
+/* Free every chunk nobody holds, and let go of the rest, which are freed
+   when they're released. Called when the audio device is closed.
+ */
+extern void _Mix_CloseChunkCache(void);
+
+/* In mixer.c: whether any channel is playing the chunk, and stop every
+   channel that is
+ */
+extern int _Mix_ChunkPlaying(Mix_Chunk *chunk);
+extern void _Mix_HaltChunk(Mix_Chunk *chunk);
+
+#endif /* _CHUNK_CACHE_H_ */
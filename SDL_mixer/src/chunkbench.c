@@ -0,0 +1,359 @@
+/*
+    CHUNKBENCH:  A test and benchmark of the SDL mixer chunk cache.
+    Copyright (C) 1997-2009 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public
+    License along with this library; if not, write to the Free
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/*
+ * Times loading the same sounds over and over, with Mix_LoadWAV_RW() and
+ *  through the chunk cache, and checks that cached chunks are the same as
+ *  loaded ones, are shared, are evicted least recently used first but not
+ *  while playing, that chunks kept compressed decode when played, and
+ *  that a RWops opened where a closed one was doesn't get its sound.
+ *  The sounds are WAVs made in memory that need converting to the mixer
+ *  format; files given on the command line (Ogg, FLAC, ...) are timed too.
+ *  Set SDL_AUDIODRIVER=dummy to run without sound hardware.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "SDL_mixer.h"
+
+#define LOADS		50
+#define WAV_SECONDS	2
+#define TEMP_FILE	"chunkbench.wav"
+
+static void put16(Uint8 *p, Uint16 v)
+{
+	p[0] = v & 0xFF;
+	p[1] = (v >> 8) & 0xFF;
+}
+
+static void put32(Uint8 *p, Uint32 v)
+{
+	p[0] = v & 0xFF;
+	p[1] = (v >> 8) & 0xFF;
+	p[2] = (v >> 16) & 0xFF;
+	p[3] = (v >> 24) & 0xFF;
+}
+
+/* A 16-bit mono WAV of noise */
+static Uint8 *make_wav(int rate, int *len)
+{
+	int samples = rate * WAV_SECONDS;
+	Uint8 *wav = (Uint8 *)malloc(44 + samples * 2);
+	int i;
+
+	*len = 44 + samples * 2;
+	memcpy(wav, "RIFF", 4);
+	put32(wav + 4, *len - 8);
+	memcpy(wav + 8, "WAVEfmt ", 8);
+	put32(wav + 16, 16);
+	put16(wav + 20, 1);			/* PCM */
+	put16(wav + 22, 1);			/* mono */
+	put32(wav + 24, rate);
+	put32(wav + 28, rate * 2);
+	put16(wav + 32, 2);
+	put16(wav + 34, 16);
+	memcpy(wav + 36, "data", 4);
+	put32(wav + 40, samples * 2);
+	for (i = 0; i < samples; i++) {
+		put16(wav + 44 + i * 2, (Uint16)(rand() % 16384));
+	}
+	return wav;
+}
+
+static int same_chunk(const char *what, Mix_Chunk *a, Mix_Chunk *b)
+{
+	if ( a->alen != b->alen || memcmp(a->abuf, b->abuf, a->alen) != 0 ) {
+		printf("%s: the cached chunk differs from the loaded one\n", what);
+		return 1;
+	}
+	return 0;
+}
+
+/* Load the sound LOADS times each way, and check the results match */
+static int bench(const char *name, const char *file, SDL_RWops *rw)
+{
+	Mix_ChunkCacheStats before, after;
+	Mix_Chunk *loaded, *cached;
+	Uint32 start, load_ms, cache_ms;
+	int i, errors = 0;
+
+	Mix_GetChunkCacheStats(&before);
+	start = SDL_GetTicks();
+	for (i = 0; i < LOADS; i++) {
+		if ( file ) {
+			loaded = Mix_LoadWAV(file);
+		} else {
+			SDL_RWseek(rw, 0, SEEK_SET);
+			loaded = Mix_LoadWAV_RW(rw, 0);
+		}
+		if ( loaded == NULL ) {
+			printf("%s: skipped, couldn't load it: %s\n", name, Mix_GetError());
+			return 0;
+		}
+		if ( i < LOADS - 1 ) {
+			Mix_FreeChunk(loaded);
+		}
+	}
+	load_ms = SDL_GetTicks() - start;
+
+	start = SDL_GetTicks();
+	for (i = 0; i < LOADS; i++) {
+		if ( file ) {
+			cached = Mix_LoadWAV_Cached(file);
+		} else {
+			SDL_RWseek(rw, 0, SEEK_SET);
+			cached = Mix_LoadWAV_RW_Cached(rw);
+		}
+		if ( cached == NULL ) {
+			printf("%s: couldn't load it cached: %s\n", name, Mix_GetError());
+			Mix_FreeChunk(loaded);
+			return 1;
+		}
+		Mix_FreeChunk(cached);
+	}
+	cache_ms = SDL_GetTicks() - start;
+	Mix_GetChunkCacheStats(&after);
+
+	printf("%s: %d loads take %u ms, cached %u ms (%d hits, %d misses)\n",
+	       name, LOADS, load_ms, cache_ms,
+	       after.hits - before.hits, after.misses - before.misses);
+	if ( after.misses - before.misses != 1 ) {
+		printf("  Expected one miss\n");
+		++errors;
+	}
+
+	if ( file ) {
+		cached = Mix_LoadWAV_Cached(file);
+	} else {
+		SDL_RWseek(rw, 0, SEEK_SET);
+		cached = Mix_LoadWAV_RW_Cached(rw);
+	}
+	errors += same_chunk(name, cached, loaded);
+	Mix_FreeChunk(cached);
+	Mix_FreeChunk(loaded);
+	Mix_FlushChunkCache();
+	return errors;
+}
+
+/* Sharing, eviction and compressed chunks */
+static int test_cache(const Uint8 *wav, int len, const Uint8 *wav2, int len2)
+{
+	Mix_ChunkCacheStats stats;
+	SDL_RWops *rw, *rw2;
+	Mix_Chunk *loaded, *a, *b;
+	int errors = 0;
+
+	rw = SDL_RWFromConstMem(wav, len);
+	rw2 = SDL_RWFromConstMem(wav2, len2);
+	loaded = Mix_LoadWAV_RW(rw, 0);
+
+	/* Loads of the same sound share it, and skip past it */
+	SDL_RWseek(rw, 0, SEEK_SET);
+	a = Mix_LoadWAV_RW_Cached(rw);
+	SDL_RWseek(rw, 0, SEEK_SET);
+	b = Mix_LoadWAV_RW_Cached(rw);
+	if ( a != b ) {
+		printf("Two loads of a sound made two chunks\n");
+		++errors;
+	}
+	if ( SDL_RWtell(rw) != len ) {
+		printf("A cached load left the RWops at %d, not %d\n", SDL_RWtell(rw), len);
+		++errors;
+	}
+	Mix_FreeChunk(a);
+	Mix_GetChunkCacheStats(&stats);
+	if ( stats.entries != 1 ) {
+		printf("A held chunk isn't cached\n");
+		++errors;
+	}
+
+	/* With no budget, the last release frees it */
+	Mix_SetChunkCacheBudget(0);
+	Mix_FreeChunk(b);
+	Mix_GetChunkCacheStats(&stats);
+	if ( stats.entries != 0 ) {
+		printf("A chunk nobody holds was kept without a budget\n");
+		++errors;
+	}
+
+	/* Room for one: loading the second evicts the first */
+	Mix_SetChunkCacheBudget(loaded->alen + loaded->alen / 2);
+	SDL_RWseek(rw, 0, SEEK_SET);
+	Mix_FreeChunk(Mix_LoadWAV_RW_Cached(rw));
+	Mix_FreeChunk(Mix_LoadWAV_RW_Cached(rw2));
+	Mix_GetChunkCacheStats(&stats);
+	if ( stats.entries != 1 || stats.evictions == 0 ) {
+		printf("The budget didn't evict a chunk (%d cached, %d evictions)\n",
+		       stats.entries, stats.evictions);
+		++errors;
+	}
+	Mix_FlushChunkCache();
+
+	/* A playing chunk isn't evicted */
+	SDL_RWseek(rw, 0, SEEK_SET);
+	a = Mix_LoadWAV_RW_Cached(rw);
+	Mix_PlayChannel(0, a, -1);
+	Mix_FreeChunk(a);
+	Mix_SetChunkCacheBudget(0);
+	Mix_GetChunkCacheStats(&stats);
+	if ( stats.entries != 1 || !Mix_Playing(0) ) {
+		printf("A playing chunk was evicted\n");
+		++errors;
+	}
+	Mix_HaltChannel(0);
+	Mix_FlushChunkCache();
+	Mix_GetChunkCacheStats(&stats);
+	if ( stats.entries != 0 ) {
+		printf("A halted chunk wasn't flushed\n");
+		++errors;
+	}
+
+	/* Kept compressed, it's decoded when played */
+	Mix_SetChunkCacheCompressed(1);
+	SDL_RWseek(rw, 0, SEEK_SET);
+	a = Mix_LoadWAV_RW_Cached(rw);
+	Mix_GetChunkCacheStats(&stats);
+	if ( a == NULL || a->abuf != NULL || stats.compressed_bytes != len ) {
+		printf("A chunk kept compressed was decoded when loaded\n");
+		++errors;
+	} else if ( Mix_PlayChannel(0, a, 0) < 0 || a->abuf == NULL ) {
+		printf("A chunk kept compressed didn't decode when played: %s\n", Mix_GetError());
+		++errors;
+	} else {
+		errors += same_chunk("Compressed", a, loaded);
+		/* Over the budget, it goes back to compressed once it stops */
+		Mix_HaltChannel(0);
+		Mix_FlushChunkCache();
+		if ( a->abuf != NULL ) {
+			printf("A held compressed chunk wasn't put back to the file\n");
+			++errors;
+		}
+	}
+	Mix_FreeChunk(a);
+	Mix_SetChunkCacheCompressed(0);
+	Mix_FlushChunkCache();
+
+	/* A RWops closed and another opened, likely at the same address */
+	Mix_SetChunkCacheBudget(16 * 1024 * 1024);
+	SDL_RWclose(rw);
+	rw = SDL_RWFromConstMem(wav, len);
+	a = Mix_LoadWAV_RW_Cached(rw);
+	SDL_RWclose(rw);
+	rw = SDL_RWFromConstMem(wav2, len2);
+	b = Mix_LoadWAV_RW_Cached(rw);
+	SDL_RWseek(rw2, 0, SEEK_SET);
+	Mix_FreeChunk(loaded);
+	loaded = Mix_LoadWAV_RW(rw2, 0);
+	if ( a == NULL || b == NULL || loaded == NULL ) {
+		printf("Couldn't load the sounds of a reopened RWops: %s\n", Mix_GetError());
+		++errors;
+	} else if ( a == b ) {
+		printf("A reopened RWops got the sound of the closed one\n");
+		++errors;
+	} else {
+		errors += same_chunk("Reopened", b, loaded);
+	}
+	Mix_FreeChunk(a);
+	Mix_FreeChunk(b);
+	Mix_FlushChunkCache();
+
+	Mix_FreeChunk(loaded);
+	SDL_RWclose(rw);
+	SDL_RWclose(rw2);
+	return errors;
+}
+
+int main(int argc, char *argv[])
+{
+	Mix_ChunkCacheStats stats;
+	int audio_rate;
+	Uint16 audio_format;
+	int audio_channels;
+	Uint8 *wav, *wav2;
+	int i, len, len2, errors = 0;
+	Mix_Chunk *held;
+	SDL_RWops *rw;
+	FILE *fp;
+
+	if ( SDL_Init(SDL_INIT_AUDIO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n",SDL_GetError());
+		return(1);
+	}
+	if ( Mix_OpenAudio(44100, AUDIO_S16SYS, 2, 1024) < 0 ) {
+		fprintf(stderr, "Couldn't open audio: %s\n", SDL_GetError());
+		SDL_Quit();
+		return(1);
+	}
+	Mix_QuerySpec(&audio_rate, &audio_format, &audio_channels);
+
+	/* Half the mixer rate and mono, so every load converts */
+	srand(1);
+	wav = make_wav(audio_rate / 2, &len);
+	wav2 = make_wav(audio_rate / 2, &len2);
+	Mix_SetChunkCacheBudget(16 * 1024 * 1024);
+
+	rw = SDL_RWFromConstMem(wav, len);
+	errors += bench("WAV from memory", NULL, rw);
+	SDL_RWclose(rw);
+
+	fp = fopen(TEMP_FILE, "wb");
+	if ( fp && fwrite(wav, len, 1, fp) == 1 && fclose(fp) == 0 ) {
+		errors += bench("WAV file", TEMP_FILE, NULL);
+		remove(TEMP_FILE);
+	} else {
+		printf("WAV file: skipped, couldn't write %s\n", TEMP_FILE);
+		if ( fp ) {
+			fclose(fp);
+		}
+	}
+
+	for (i = 1; i < argc; i++) {
+		errors += bench(argv[i], argv[i], NULL);
+	}
+
+	errors += test_cache(wav, len, wav2, len2);
+
+	Mix_GetChunkCacheStats(&stats);
+	printf("Cache: %d hits, %d misses, %d evictions, %d chunks, %d bytes decoded, %d compressed\n",
+	       stats.hits, stats.misses, stats.evictions, stats.entries,
+	       stats.decoded_bytes, stats.compressed_bytes);
+
+	if ( errors ) {
+		printf("%d chunk cache tests failed\n", errors);
+	} else {
+		printf("All chunk cache tests passed.\n");
+	}
+
+	/* A chunk held when the audio closes is freed when it's released */
+	rw = SDL_RWFromConstMem(wav, len);
+	held = Mix_LoadWAV_RW_Cached(rw);
+	Mix_CloseAudio();
+	Mix_FreeChunk(held);
+	SDL_RWclose(rw);
+	free(wav);
+	free(wav2);
+	SDL_Quit();
+	return (errors ? 1 : 0);
+}
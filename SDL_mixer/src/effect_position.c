@@ -35,6 +35,14 @@
 #define __MIX_INTERNAL_EFFECT__
 #include "effects_internal.h"
 
+/* The fused position mix is vectorized where the float math is done in
+   single precision, so the vector and scalar loops round the same way */
+#if defined(__GNUC__) && defined(__SSE2__) && \
+    defined(__FLT_EVAL_METHOD__) && (__FLT_EVAL_METHOD__ == 0)
+#define POSITION_MIX_SSE2 1
+#include <emmintrin.h>
+#endif
+
 /* profile code:
     #include <sys/time.h>
     #include <unistd.h>
@@ -1021,8 +1029,14 @@ static void _Eff_position_s16msb(int chan, void *stream, int len, void *udata)
                                     args->left_f) * args->distance_f);
         Sint16 swapr = (Sint16) ((((float) (Sint16) SDL_SwapBE16(*(ptr+1))) *
                                     args->right_f) * args->distance_f);
-        *(ptr++) = (Sint16) SDL_SwapBE16(swapl);
-        *(ptr++) = (Sint16) SDL_SwapBE16(swapr);
+	if (args->room_angle == 180) {
+        	*(ptr++) = (Sint16) SDL_SwapBE16(swapr);
+        	*(ptr++) = (Sint16) SDL_SwapBE16(swapl);
+	}
+	else {
+        	*(ptr++) = (Sint16) SDL_SwapBE16(swapl);
+        	*(ptr++) = (Sint16) SDL_SwapBE16(swapr);
+	}
     }
 }
 static void _Eff_position_s16msb_c4(int chan, void *stream, int len, void *udata)
@@ -1127,6 +1141,174 @@ static void _Eff_position_s16msb_c6(int chan, void *stream, int len, void *udata
     }
 }
 
+
+/*
+ * The stereo 16-bit effects fused with SDL_MixAudio(), so a positioned
+ *  channel is mixed in one pass without a copy. With SSE2 four frames are
+ *  done at a time, as SDL_MixAudio() itself does, or mixing separately
+ *  would be faster. The samples must come out exactly as the effect
+ *  followed by SDL_MixAudio()'s C or SSE2 loops would make them.
+ */
+
+static __inline__ Sint16 _Eff_mix_s16(Sint16 sample, Sint16 mixed, int volume)
+{
+    int result = ((sample * volume) / SDL_MIX_MAXVOLUME) + mixed;
+    if (result > 32767)
+        result = 32767;
+    else if (result < -32768)
+        result = -32768;
+    return((Sint16) result);
+}
+
+#if POSITION_MIX_SSE2
+#define _EFF_SWAP_SSE2(v) _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8))
+
+/* Position and mix whole vectors of frames, returning the bytes done;
+ *  the scalar loop does the rest. byteswap is set when the samples aren't
+ *  in the CPU's byte order.
+ */
+static __inline__ int _Eff_position_mix_s16_sse2(const Sint16 *in, Sint16 *out,
+                      int len, float left_f, float right_f, float distance_f,
+                      int volume, const int swap, const int byteswap)
+{
+    const __m128 gain = _mm_set_ps(right_f, left_f, right_f, left_f);
+    const __m128 distance = _mm_set1_ps(distance_f);
+    const __m128i vol = _mm_set1_epi16((short) volume);
+    const __m128i round = _mm_set1_epi32(SDL_MIX_MAXVOLUME - 1);
+    int i;
+
+    for (i = 0; i + 16 <= len; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i *) (in + (i / 2)));
+        __m128i d = _mm_loadu_si128((const __m128i *) (out + (i / 2)));
+        __m128i a, b, lo, hi;
+
+        if (byteswap) {
+            s = _EFF_SWAP_SSE2(s);
+            d = _EFF_SWAP_SSE2(d);
+        }
+
+        /* the effect: each sample times its side and the distance */
+        a = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+        b = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+        a = _mm_cvttps_epi32(_mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(a), gain), distance));
+        b = _mm_cvttps_epi32(_mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(b), gain), distance));
+        s = _mm_packs_epi32(a, b);
+
+        /* the mix: times volume / 128, rounded toward zero, then added */
+        lo = _mm_mullo_epi16(s, vol);
+        hi = _mm_mulhi_epi16(s, vol);
+        a = _mm_unpacklo_epi16(lo, hi);
+        b = _mm_unpackhi_epi16(lo, hi);
+        a = _mm_add_epi32(a, _mm_and_si128(_mm_srai_epi32(a, 31), round));
+        b = _mm_add_epi32(b, _mm_and_si128(_mm_srai_epi32(b, 31), round));
+        s = _mm_packs_epi32(_mm_srai_epi32(a, 7), _mm_srai_epi32(b, 7));
+        if (swap)
+            s = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xB1), 0xB1);
+        d = _mm_adds_epi16(d, s);
+
+        if (byteswap)
+            d = _EFF_SWAP_SSE2(d);
+        _mm_storeu_si128((__m128i *) (out + (i / 2)), d);
+    }
+    return(i);
+}
+#endif
+
+/* swap is always a constant, so each caller gets a loop without branches */
+static __inline__ void _Eff_position_mix_s16lsb_frames(const Sint16 *in, Sint16 *out,
+                      int len, float left_f, float right_f, float distance_f,
+                      int volume, const int swap)
+{
+    int i = 0;
+
+#if POSITION_MIX_SSE2
+    i = _Eff_position_mix_s16_sse2(in, out, len, left_f, right_f, distance_f,
+                    volume, swap, (SDL_BYTEORDER == SDL_BIG_ENDIAN));
+    in += i / 2;
+    out += i / 2;
+#endif
+    for (; i < len; i += sizeof (Sint16) * 2) {
+        Sint16 swapl = (Sint16) ((((float) (Sint16) SDL_SwapLE16(*(in+0))) *
+                                    left_f) * distance_f);
+        Sint16 swapr = (Sint16) ((((float) (Sint16) SDL_SwapLE16(*(in+1))) *
+                                    right_f) * distance_f);
+        *(out+swap) = (Sint16) SDL_SwapLE16(_Eff_mix_s16(swapl,
+                                   (Sint16) SDL_SwapLE16(*(out+swap)), volume));
+        *(out+1-swap) = (Sint16) SDL_SwapLE16(_Eff_mix_s16(swapr,
+                                   (Sint16) SDL_SwapLE16(*(out+1-swap)), volume));
+        in += 2;
+        out += 2;
+    }
+}
+
+static void _Eff_position_mix_s16lsb(volatile position_args *args, Uint8 *dst,
+                                     const Uint8 *src, int len, int volume)
+{
+    if (args->room_angle == 180)
+        _Eff_position_mix_s16lsb_frames((const Sint16 *) src, (Sint16 *) dst, len,
+                    args->left_f, args->right_f, args->distance_f, volume, 1);
+    else
+        _Eff_position_mix_s16lsb_frames((const Sint16 *) src, (Sint16 *) dst, len,
+                    args->left_f, args->right_f, args->distance_f, volume, 0);
+}
+
+static __inline__ void _Eff_position_mix_s16msb_frames(const Sint16 *in, Sint16 *out,
+                      int len, float left_f, float right_f, float distance_f,
+                      int volume, const int swap)
+{
+    int i = 0;
+
+#if POSITION_MIX_SSE2
+    i = _Eff_position_mix_s16_sse2(in, out, len, left_f, right_f, distance_f,
+                    volume, swap, (SDL_BYTEORDER == SDL_LIL_ENDIAN));
+    in += i / 2;
+    out += i / 2;
+#endif
+    for (; i < len; i += sizeof (Sint16) * 2) {
+        Sint16 swapl = (Sint16) ((((float) (Sint16) SDL_SwapBE16(*(in+0))) *
+                                    left_f) * distance_f);
+        Sint16 swapr = (Sint16) ((((float) (Sint16) SDL_SwapBE16(*(in+1))) *
+                                    right_f) * distance_f);
+        *(out+swap) = (Sint16) SDL_SwapBE16(_Eff_mix_s16(swapl,
+                                   (Sint16) SDL_SwapBE16(*(out+swap)), volume));
+        *(out+1-swap) = (Sint16) SDL_SwapBE16(_Eff_mix_s16(swapr,
+                                   (Sint16) SDL_SwapBE16(*(out+1-swap)), volume));
+        in += 2;
+        out += 2;
+    }
+}
+
+static void _Eff_position_mix_s16msb(volatile position_args *args, Uint8 *dst,
+                                     const Uint8 *src, int len, int volume)
+{
+    if (args->room_angle == 180)
+        _Eff_position_mix_s16msb_frames((const Sint16 *) src, (Sint16 *) dst, len,
+                    args->left_f, args->right_f, args->distance_f, volume, 1);
+    else
+        _Eff_position_mix_s16msb_frames((const Sint16 *) src, (Sint16 *) dst, len,
+                    args->left_f, args->right_f, args->distance_f, volume, 0);
+}
+
+int _Eff_PositionMix(Mix_EffectFunc_t f, void *udata, Uint8 *dst,
+                     const Uint8 *src, int len, int volume)
+{
+    /* the effects themselves would run past a partial frame, and the
+       samples are read in place, so they must be aligned */
+    if ((len % (sizeof (Sint16) * 2) != 0) ||
+        (((size_t) src | (size_t) dst) & (sizeof (Sint16) - 1)))
+        return(0);
+
+    if (f == _Eff_position_s16lsb)
+        _Eff_position_mix_s16lsb((volatile position_args *) udata, dst, src, len, volume);
+    else if (f == _Eff_position_s16msb)
+        _Eff_position_mix_s16msb((volatile position_args *) udata, dst, src, len, volume);
+    else
+        return(0);
+
+    return(1);
+}
+
+
 static void init_position_args(position_args *args)
 {
     memset(args, '\0', sizeof (position_args));
@@ -45,6 +45,14 @@ void _Mix_InitEffects(void);
 void _Mix_DeinitEffects(void);
 void _Eff_PositionDeinit(void);
 
+/* If f is the positional effect for 16-bit stereo, apply it to len bytes
+   of src and mix the result into dst at volume, the same as running the
+   effect on a copy and calling SDL_MixAudio() with it (to within one per
+   channel mixed on the Wii). Returns 0 and does nothing for any other
+   effect. */
+int _Eff_PositionMix(Mix_EffectFunc_t f, void *udata, Uint8 *dst,
+                     const Uint8 *src, int len, int volume);
+
 /* Set up for C function definitions, even when using C++ */
 #ifdef __cplusplus
 }
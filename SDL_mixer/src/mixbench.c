@@ -0,0 +1,231 @@
+/*
+    MIXBENCH:  A benchmark for the SDL mixer library.
+    Copyright (C) 1997-2009 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public
+    License along with this library; if not, write to the Free
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/*
+ * Mixes 8 to 64 positioned channels and reports how much CPU the mixer
+ *  uses, once the normal way and once with an extra do-nothing effect on
+ *  every channel, which keeps the mixer from fusing the positioning with
+ *  the mix. The first buffers of both runs must be identical, or within
+ *  one per channel when SDL was built with the paired single
+ *  SDL_MixAudio() (SDL_PAIRED_MIXER), which truncates differently, and
+ *  fusing must not cost more CPU in total.
+ *  Set SDL_AUDIODRIVER=dummy to run without sound hardware.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "SDL.h"
+#include "SDL_mixer.h"
+
+#define CHUNKSIZE	1024
+#define CAPTURED	8			/* buffers compared between the runs */
+#define SOUNDS		5
+#define BENCH_MS	2000
+
+static Uint8 *sounds[SOUNDS];
+static int sound_lens[SOUNDS];
+static Mix_Chunk *chunks[SOUNDS];
+static Uint8 *captured;
+static int captured_len;
+static volatile int captured_count;
+
+
+static void noEffect(int chan, void *stream, int len, void *udata)
+{
+}
+
+static void capturePostMix(void *udata, Uint8 *stream, int len)
+{
+	if (captured_count < CAPTURED) {
+		if (captured_count == 0) {
+			captured_len = len;
+		}
+		memcpy(captured + captured_count * captured_len, stream, len);
+		++captured_count;
+	}
+}
+
+/* Start the channels with the same random settings every time */
+static void start_channels(int channels, int fused)
+{
+	int i;
+
+	srand(channels);
+	SDL_LockAudio();
+	Mix_AllocateChannels(channels);
+	for (i = 0; i < channels; i++) {
+		Mix_PlayChannel(i, chunks[i % SOUNDS], -1);
+		Mix_Volume(i, rand() % (MIX_MAX_VOLUME + 1));
+		switch (i % 3) {
+			case 0:
+				Mix_SetPanning(i, rand() % 256, rand() % 256);
+				break;
+			case 1:
+				Mix_SetDistance(i, rand() % 256);
+				break;
+			case 2:
+				/* half of these swap left and right */
+				Mix_SetPosition(i, rand() % 360, rand() % 256);
+				break;
+		}
+		if (!fused) {
+			Mix_RegisterEffect(i, noEffect, NULL, NULL);
+		}
+	}
+	captured_count = 0;
+	SDL_UnlockAudio();
+}
+
+/* Returns the CPU load of mixing the channels, in percent */
+static double run_channels(int channels, int fused, Uint8 *output)
+{
+	clock_t start;
+	Uint32 ticks;
+
+	captured = output;
+	start_channels(channels, fused);
+	while (captured_count < CAPTURED) {
+		SDL_Delay(1);
+	}
+
+	start = clock();
+	ticks = SDL_GetTicks();
+	SDL_Delay(BENCH_MS);
+	ticks = SDL_GetTicks() - ticks;
+	start = clock() - start;
+
+	Mix_HaltChannel(-1);
+	return (100.0 * start / CLOCKS_PER_SEC) / (ticks / 1000.0);
+}
+
+/* Whether the two runs mixed the same samples */
+static int same_output(const Uint8 *fused, const Uint8 *legacy, Uint16 format, int channels)
+{
+#if defined(GEKKO) && SDL_ASSEMBLY_ROUTINES && SDL_PAIRED_MIXER
+	int i, a, b;
+
+	for (i = 0; i < CAPTURED * captured_len; i += 2) {
+		if (format == AUDIO_S16MSB) {
+			a = (Sint16)((fused[i] << 8) | fused[i+1]);
+			b = (Sint16)((legacy[i] << 8) | legacy[i+1]);
+		} else {
+			a = (Sint16)((fused[i+1] << 8) | fused[i]);
+			b = (Sint16)((legacy[i+1] << 8) | legacy[i]);
+		}
+		if (abs(a - b) > channels) {
+			return 0;
+		}
+	}
+	return 1;
+#else
+	return (memcmp(fused, legacy, CAPTURED * captured_len) == 0);
+#endif
+}
+
+static int bench_format(Uint16 format)
+{
+	Uint8 *fused_output, *legacy_output;
+	double fused_total = 0.0, legacy_total = 0.0;
+	int i, channels, errors = 0;
+
+	if (Mix_OpenAudio(44100, format, 2, CHUNKSIZE) < 0) {
+		fprintf(stderr, "Couldn't open audio: %s\n", SDL_GetError());
+		return(1);
+	}
+	Mix_SetPostMix(capturePostMix, NULL);
+	for (i = 0; i < SOUNDS; i++) {
+		chunks[i] = Mix_QuickLoad_RAW(sounds[i], sound_lens[i]);
+	}
+
+	fused_output = (Uint8 *) malloc(CAPTURED * CHUNKSIZE * 4);
+	legacy_output = (Uint8 *) malloc(CAPTURED * CHUNKSIZE * 4);
+
+	printf("%s:\n", (format == AUDIO_S16MSB) ? "S16MSB" : "S16LSB");
+	for (channels = 8; channels <= 64; channels *= 2) {
+		double fused_cpu = run_channels(channels, 1, fused_output);
+		double legacy_cpu = run_channels(channels, 0, legacy_output);
+		int same = same_output(fused_output, legacy_output, format, channels);
+
+		printf("%2d channels: %5.1f%% CPU fused, %5.1f%% separate effect%s\n",
+		       channels, fused_cpu, legacy_cpu, same ? "" : ", OUTPUT DIFFERS");
+		if (!same) {
+			++errors;
+		}
+		fused_total += fused_cpu;
+		legacy_total += legacy_cpu;
+	}
+	/* single runs are noisy, so only the sum over all of them counts */
+	if (fused_total > legacy_total) {
+		printf("Fused mixing is slower than the effect and mix\n");
+		++errors;
+	}
+
+	for (i = 0; i < SOUNDS; i++) {
+		Mix_FreeChunk(chunks[i]);
+	}
+	free(fused_output);
+	free(legacy_output);
+	Mix_SetPostMix(NULL, NULL);
+	Mix_CloseAudio();
+	return(errors);
+}
+
+int main(int argc, char *argv[])
+{
+	int i, j, errors = 0;
+
+	if ( SDL_Init(SDL_INIT_AUDIO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n",SDL_GetError());
+		return(255);
+	}
+
+	/* noise of different lengths, a whole number of frames but not of
+	   buffers, so the loops wrap mid-buffer */
+	srand(1);
+	for (i = 0; i < SOUNDS; i++) {
+		sound_lens[i] = (CHUNKSIZE * (i + 1) + 97 * i) * 4;
+		sounds[i] = (Uint8 *) malloc(sound_lens[i]);
+		for (j = 0; j < sound_lens[i]; j++) {
+			sounds[i][j] = rand() & 0xFF;
+		}
+	}
+
+	errors += bench_format(AUDIO_S16LSB);
+	errors += bench_format(AUDIO_S16MSB);
+
+	for (i = 0; i < SOUNDS; i++) {
+		free(sounds[i]);
+	}
+	SDL_Quit();
+
+	if (errors) {
+		printf("%d fused mixing tests failed\n", errors);
+	} else {
+		printf("Fused mixing matches the effect and mix, and is faster\n");
+	}
+	return(errors ? 1 : 0);
+}
+
+/* end of mixbench.c ... */
@@ -35,6 +35,7 @@
 #include "load_voc.h"
 #include "load_ogg.h"
 #include "load_flac.h"
+#include "chunk_cache.h"
 
 #define __MIX_INTERNAL_EFFECT__
 #include "effects_internal.h"
@@ -58,6 +59,15 @@ typedef struct _Mix_effectinfo
 	struct _Mix_effectinfo *next;
 } effect_info;
 
+/* Channels are linked by index into two lists: the playing channels, in
+   the order they were started, and the unreserved channels that are free.
+   Reserved channels that aren't playing are in neither.
+ */
+typedef struct {
+	int head;
+	int tail;
+} channel_list;
+
 static struct _Mix_Channel {
 	Mix_Chunk *chunk;
 	int playing;
@@ -73,12 +83,42 @@ static struct _Mix_Channel {
 	Uint32 fade_length;
 	Uint32 ticks_fade;
 	effect_info *effects;
+	channel_list *list;
+	int prev;
+	int next;
 } *mix_channel = NULL;
 
+static channel_list active_channels = { -1, -1 };
+static channel_list free_channels = { -1, -1 };
+
+/* The playing channels, copied out of the list every callback */
+static int *mixing_order = NULL;
+
 static effect_info *posteffects = NULL;
 
+/* Channels with effects are processed in here before they are mixed.
+   The mixer always asks for one device buffer, so a single buffer of that
+   size serves every channel and is only reallocated when the audio device
+   is reopened.
+ */
+static Uint8 *effect_buf = NULL;
+static int effect_buflen = 0;
+
+/* Define DEBUG_MIX_ALLOCATIONS to assert the mixing callback never goes
+   to the heap */
+#ifdef DEBUG_MIX_ALLOCATIONS
+#include <assert.h>
+static int mix_allocations = 0;
+#define MIX_COUNT_ALLOCATION()		(++mix_allocations)
+#define MIX_ASSERT_NO_ALLOCATIONS()	assert(mix_allocations == 0)
+#else
+#define MIX_COUNT_ALLOCATION()
+#define MIX_ASSERT_NO_ALLOCATIONS()
+#endif
+
 static int num_channels;
 static int reserved_channels = 0;
+static Mix_StealPolicy steal_policy = MIX_STEAL_NONE;
 
 
 /* Support for hooking into the mixer callback system */
@@ -109,6 +149,71 @@ const SDL_version *Mix_Linked_Version(void)
 
 static int _Mix_remove_all_effects(int channel, effect_info **e);
 
+/*
+ * The channel lists.
+ *  MAKE SURE SDL_LockAudio() is called before these (or you're in the
+ *   audio callback).
+ */
+static void channel_unlink(int which)
+{
+	struct _Mix_Channel *channel = &mix_channel[which];
+	channel_list *list = channel->list;
+
+	if ( list == NULL ) {
+		return;
+	}
+	if ( channel->prev >= 0 ) {
+		mix_channel[channel->prev].next = channel->next;
+	} else {
+		list->head = channel->next;
+	}
+	if ( channel->next >= 0 ) {
+		mix_channel[channel->next].prev = channel->prev;
+	} else {
+		list->tail = channel->prev;
+	}
+	channel->list = NULL;
+}
+
+static void channel_append(int which, channel_list *list)
+{
+	struct _Mix_Channel *channel = &mix_channel[which];
+
+	channel_unlink(which);
+	channel->list = list;
+	channel->prev = list->tail;
+	channel->next = -1;
+	if ( list->tail >= 0 ) {
+		mix_channel[list->tail].next = which;
+	} else {
+		list->head = which;
+	}
+	list->tail = which;
+}
+
+/* Put a channel that isn't playing where it belongs */
+static void channel_idle(int which)
+{
+	if ( which >= reserved_channels ) {
+		channel_append(which, &free_channels);
+	} else {
+		channel_unlink(which);
+	}
+}
+
+/* Call when a channel's playing count goes from 0 to more, or back */
+static void channel_started(int which)
+{
+	channel_append(which, &active_channels);
+}
+
+static void channel_stopped(int which)
+{
+	if ( mix_channel[which].list == &active_channels ) {
+		channel_idle(which);
+	}
+}
+
 /*
  * rcg06122001 Cleanup effect callbacks.
  *  MAKE SURE SDL_LockAudio() is called before this (or you're in the
@@ -137,9 +242,14 @@ static void *Mix_DoEffects(int chan, void *snd, int len)
 	if (e != NULL) {    /* are there any registered effects? */
 		/* if this is the postmix, we can just overwrite the original. */
 		if (!posteffect) {
-			buf = malloc(len);
-			if (buf == NULL) {
-				return(snd);
+			if (len <= effect_buflen) {
+				buf = effect_buf;
+			} else {
+				MIX_COUNT_ALLOCATION();
+				buf = malloc(len);
+				if (buf == NULL) {
+					return(snd);
+				}
 			}
 		    memcpy(buf, snd, len);
 		}
@@ -151,16 +261,41 @@ static void *Mix_DoEffects(int chan, void *snd, int len)
 		}
 	}
 
-	/* be sure to free() the return value if != snd ... */
+	/* be sure to pass the return value to Mix_DoneEffects() ... */
 	return(buf);
 }
 
+/* Release a buffer returned by Mix_DoEffects() */
+static void Mix_DoneEffects(void *buf, void *snd)
+{
+	if (buf != snd && buf != effect_buf) {
+		free(buf);
+	}
+}
+
+/* Run a channel's effects on snd and mix the result into stream. A channel
+   whose only effect is the built in panning/distance/position effect is
+   positioned and mixed in one pass instead. */
+static void Mix_MixChannel(int chan, Uint8 *stream, Uint8 *snd, int len, int volume)
+{
+	effect_info *e = mix_channel[chan].effects;
+	void *mix_input;
+
+	if (e != NULL && e->next == NULL &&
+	    _Eff_PositionMix(e->callback, e->udata, stream, snd, len, volume)) {
+		return;
+	}
+
+	mix_input = Mix_DoEffects(chan, snd, len);
+	SDL_MixAudio(stream, mix_input, len, volume);
+	Mix_DoneEffects(mix_input, snd);
+}
+
 
 /* Mixing function */
 static void mix_channels(void *udata, Uint8 *stream, int len)
 {
-	Uint8 *mix_input;
-	int i, mixable, volume = SDL_MIX_MAXVOLUME;
+	int i, j, n, mixable, volume = SDL_MIX_MAXVOLUME;
 	Uint32 sdl_ticks;
 
 #if SDL_VERSION_ATLEAST(1, 3, 0)
@@ -173,15 +308,25 @@ static void mix_channels(void *udata, Uint8 *stream, int len)
 		mix_music(music_data, stream, len);
 	}
 
-	/* Mix any playing channels... */
+	/* Mix any playing channels... Channels can stop, or be started by the
+	   done callback, along the way, so go through a copy of the list. */
+	n = 0;
+	for ( i=active_channels.head; i>=0; i=mix_channel[i].next ) {
+		mixing_order[n++] = i;
+	}
 	sdl_ticks = SDL_GetTicks();
-	for ( i=0; i<num_channels; ++i ) {
+	for ( j=0; j<n; ++j ) {
+		i = mixing_order[j];
+		if ( mix_channel[i].list != &active_channels ) {
+			continue;
+		}
 		if( ! mix_channel[i].paused ) {
 			if ( mix_channel[i].expire > 0 && mix_channel[i].expire < sdl_ticks ) {
 				/* Expiration delay for that channel is reached */
 				mix_channel[i].playing = 0;
 				mix_channel[i].fading = MIX_NO_FADING;
 				mix_channel[i].expire = 0;
+				channel_stopped(i);
 				_Mix_channel_done_playing(i);
 			} else if ( mix_channel[i].fading != MIX_NO_FADING ) {
 				Uint32 ticks = sdl_ticks - mix_channel[i].ticks_fade;
@@ -190,6 +335,7 @@ static void mix_channels(void *udata, Uint8 *stream, int len)
 					if( mix_channel[i].fading == MIX_FADING_OUT ) {
 						mix_channel[i].playing = 0;
 						mix_channel[i].expire = 0;
+						channel_stopped(i);
 						_Mix_channel_done_playing(i);
 					}
 					mix_channel[i].fading = MIX_NO_FADING;
@@ -213,10 +359,7 @@ static void mix_channels(void *udata, Uint8 *stream, int len)
 						mixable = remaining;
 					}
 
-					mix_input = Mix_DoEffects(i, mix_channel[i].samples, mixable);
-					SDL_MixAudio(stream+index,mix_input,mixable,volume);
-					if (mix_input != mix_channel[i].samples)
-						free(mix_input);
+					Mix_MixChannel(i, stream+index, mix_channel[i].samples, mixable, volume);
 
 					mix_channel[i].samples += mixable;
 					mix_channel[i].playing -= mixable;
@@ -224,6 +367,7 @@ static void mix_channels(void *udata, Uint8 *stream, int len)
 
 					/* rcg06072001 Alert app if channel is done playing. */
 					if (!mix_channel[i].playing && !mix_channel[i].looping) {
+						channel_stopped(i);
 						_Mix_channel_done_playing(i);
 					}
 				}
@@ -237,15 +381,18 @@ static void mix_channels(void *udata, Uint8 *stream, int len)
 						remaining = alen;
 					}
 
-					mix_input = Mix_DoEffects(i, mix_channel[i].chunk->abuf, remaining);
-					SDL_MixAudio(stream+index, mix_input, remaining, volume);
-					if (mix_input != mix_channel[i].chunk->abuf)
-						free(mix_input);
+					Mix_MixChannel(i, stream+index, mix_channel[i].chunk->abuf, remaining, volume);
 
 					--mix_channel[i].looping;
 					mix_channel[i].samples = mix_channel[i].chunk->abuf + remaining;
 					mix_channel[i].playing = mix_channel[i].chunk->alen - remaining;
 					index += remaining;
+
+					/* The last loop of a chunk shorter than the buffer can end here */
+					if (!mix_channel[i].playing && !mix_channel[i].looping) {
+						channel_stopped(i);
+						_Mix_channel_done_playing(i);
+					}
 				}
 				if ( ! mix_channel[i].playing && mix_channel[i].looping ) {
 					--mix_channel[i].looping;
@@ -262,6 +409,8 @@ static void mix_channels(void *udata, Uint8 *stream, int len)
 	if ( mix_postmix ) {
 		mix_postmix(mix_postmix_data, stream, len);
 	}
+
+	MIX_ASSERT_NO_ALLOCATIONS();
 }
 
 #if 0
@@ -314,10 +463,40 @@ int Mix_OpenAudio(int frequency, Uint16 format, int nchannels, int chunksize)
 		return(-1);
 	}
 
+	/* Scratch space for channel effects, one device buffer long */
+	effect_buf = (Uint8 *) malloc(mixer.size);
+	if ( effect_buf == NULL ) {
+		close_music();
+		SDL_CloseAudio();
+		SDL_SetError("Out of memory");
+		return(-1);
+	}
+	effect_buflen = mixer.size;
+
 	num_channels = MIX_CHANNELS;
 	mix_channel = (struct _Mix_Channel *) malloc(num_channels * sizeof(struct _Mix_Channel));
+	mixing_order = (int *) malloc(num_channels * sizeof(int));
+	if ( mix_channel == NULL || mixing_order == NULL ) {
+		free(mix_channel);
+		mix_channel = NULL;
+		free(mixing_order);
+		mixing_order = NULL;
+		num_channels = 0;
+		free(effect_buf);
+		effect_buf = NULL;
+		effect_buflen = 0;
+		close_music();
+		SDL_CloseAudio();
+		SDL_SetError("Out of memory");
+		return(-1);
+	}
+	if ( reserved_channels > num_channels ) {
+		reserved_channels = num_channels;
+	}
 
 	/* Clear out the audio channels */
+	active_channels.head = active_channels.tail = -1;
+	free_channels.head = free_channels.tail = -1;
 	for ( i=0; i<num_channels; ++i ) {
 		mix_channel[i].chunk = NULL;
 		mix_channel[i].playing = 0;
@@ -329,6 +508,8 @@ int Mix_OpenAudio(int frequency, Uint16 format, int nchannels, int chunksize)
 		mix_channel[i].expire = 0;
 		mix_channel[i].effects = NULL;
 		mix_channel[i].paused = 0;
+		mix_channel[i].list = NULL;
+		channel_idle(i);
 	}
 	Mix_VolumeMusic(SDL_MIX_MAXVOLUME);
 
@@ -345,6 +526,9 @@ int Mix_OpenAudio(int frequency, Uint16 format, int nchannels, int chunksize)
  */
 int Mix_AllocateChannels(int numchans)
 {
+	struct _Mix_Channel *new_channels;
+	int *new_order;
+
 	if ( numchans<0 || numchans==num_channels )
 		return(num_channels);
 
@@ -357,7 +541,30 @@ int Mix_AllocateChannels(int numchans)
 		}
 	}
 	SDL_LockAudio();
-	mix_channel = (struct _Mix_Channel *) realloc(mix_channel, numchans * sizeof(struct _Mix_Channel));
+	if ( numchans < num_channels ) {
+		int i;
+		for(i=numchans; i < num_channels; i++) {
+			channel_unlink(i);
+		}
+		if ( reserved_channels > numchans ) {
+			reserved_channels = numchans;
+		}
+	}
+	/* A block that can't be resized is kept, and is big enough when
+	   shrinking */
+	new_channels = (struct _Mix_Channel *) realloc(mix_channel, numchans * sizeof(struct _Mix_Channel));
+	if ( new_channels || numchans == 0 ) {
+		mix_channel = new_channels;
+	}
+	new_order = (int *) realloc(mixing_order, numchans * sizeof(int));
+	if ( new_order || numchans == 0 ) {
+		mixing_order = new_order;
+	}
+	if ( numchans > num_channels && (!new_channels || !new_order) ) {
+		SDL_UnlockAudio();
+		SDL_SetError("Out of memory");
+		return(num_channels);
+	}
 	if ( numchans > num_channels ) {
 		/* Initialize the new channels */
 		int i;
@@ -372,6 +579,8 @@ int Mix_AllocateChannels(int numchans)
 			mix_channel[i].expire = 0;
 			mix_channel[i].effects = NULL;
 			mix_channel[i].paused = 0;
+			mix_channel[i].list = NULL;
+			channel_idle(i);
 		}
 	}
 	num_channels = numchans;
@@ -511,6 +720,7 @@ Mix_Chunk *Mix_LoadWAV_RW(SDL_RWops *src, int freesrc)
 	chunk->abuf = wavecvt.buf;
 	chunk->alen = wavecvt.len_cvt;
 	chunk->volume = MIX_MAX_VOLUME;
+	chunk->priority = 0;
 	return(chunk);
 }
 
@@ -545,6 +755,7 @@ Mix_Chunk *Mix_QuickLoad_WAV(Uint8 *mem)
 		mem += chunk->alen;
 	} while ( memcmp(magic, "data", 4) != 0 );
 	chunk->volume = MIX_MAX_VOLUME;
+	chunk->priority = 0;
 
 	return(chunk);
 }
@@ -572,27 +783,60 @@ Mix_Chunk *Mix_QuickLoad_RAW(Uint8 *mem, Uint32 len)
 	chunk->alen = len;
 	chunk->abuf = mem;
 	chunk->volume = MIX_MAX_VOLUME;
+	chunk->priority = 0;
 
 	return(chunk);
 }
 
-/* Free an audio chunk previously loaded */
-void Mix_FreeChunk(Mix_Chunk *chunk)
+/* Whether any channel is playing the chunk */
+int _Mix_ChunkPlaying(Mix_Chunk *chunk)
+{
+	int i, playing = 0;
+
+	SDL_LockAudio();
+	if ( mix_channel ) {
+		for ( i=0; i<num_channels; ++i ) {
+			if ( chunk == mix_channel[i].chunk &&
+			     (mix_channel[i].playing > 0 ||
+			      mix_channel[i].looping > 0) ) {
+				playing = 1;
+				break;
+			}
+		}
+	}
+	SDL_UnlockAudio();
+	return(playing);
+}
+
+/* Stop every channel playing the chunk */
+void _Mix_HaltChunk(Mix_Chunk *chunk)
 {
 	int i;
 
+	SDL_LockAudio();
+	if ( mix_channel ) {
+		for ( i=0; i<num_channels; ++i ) {
+			if ( chunk == mix_channel[i].chunk ) {
+				mix_channel[i].playing = 0;
+				channel_stopped(i);
+			}
+		}
+	}
+	SDL_UnlockAudio();
+}
+
+/* Free an audio chunk previously loaded */
+void Mix_FreeChunk(Mix_Chunk *chunk)
+{
 	/* Caution -- if the chunk is playing, the mixer will crash */
 	if ( chunk ) {
-		/* Guarantee that this chunk isn't playing */
-		SDL_LockAudio();
-		if ( mix_channel ) {
-			for ( i=0; i<num_channels; ++i ) {
-				if ( chunk == mix_channel[i].chunk ) {
-					mix_channel[i].playing = 0;
-				}
-			}
+		/* Cached chunks are shared, the cache frees them */
+		if ( chunk->allocated == MIX_CHUNK_CACHED ) {
+			_Mix_ReleaseCachedChunk(chunk);
+			return;
 		}
-		SDL_UnlockAudio();
+		/* Guarantee that this chunk isn't playing */
+		_Mix_HaltChunk(chunk);
 		/* Actually free the chunk */
 		if ( chunk->allocated ) {
 			free(chunk->abuf);
@@ -650,12 +894,85 @@ void Mix_ChannelFinished(void (*channel_finished)(int channel))
  */
 int Mix_ReserveChannels(int num)
 {
+	int i;
+
 	if (num > num_channels)
 		num = num_channels;
+	SDL_LockAudio();
 	reserved_channels = num;
+	for ( i=0; mix_channel && i<num_channels; ++i ) {
+		if ( mix_channel[i].list != &active_channels ) {
+			channel_unlink(i);
+		}
+	}
+	for ( i=0; mix_channel && i<num_channels; ++i ) {
+		if ( mix_channel[i].list != &active_channels ) {
+			channel_idle(i);
+		}
+	}
+	SDL_UnlockAudio();
 	return num;
 }
 
+void Mix_SetStealPolicy(Mix_StealPolicy policy)
+{
+	SDL_LockAudio();
+	steal_policy = policy;
+	SDL_UnlockAudio();
+}
+
+Mix_StealPolicy Mix_GetStealPolicy(void)
+{
+	return(steal_policy);
+}
+
+/* Find a channel to play a chunk on when it's played on channel -1: the
+   channel that has been free longest, or one the steal policy stops.
+   MAKE SURE SDL_LockAudio() is called before this.
+ */
+static int Mix_FindChannel(Mix_Chunk *chunk)
+{
+	int i, which = free_channels.head;
+	int volume, lowest = 0;
+
+	if ( which >= 0 ) {
+		return(which);
+	}
+
+	/* The playing channels are oldest first */
+	for ( i=active_channels.head; i>=0 && steal_policy!=MIX_STEAL_NONE; i=mix_channel[i].next ) {
+		if ( i < reserved_channels ) {
+			continue;
+		}
+		switch (steal_policy) {
+		    case MIX_STEAL_OLDEST:
+			return(i);
+		    case MIX_STEAL_QUIETEST:
+			volume = (mix_channel[i].fading == MIX_FADING_IN) ?
+				mix_channel[i].fade_volume : mix_channel[i].volume;
+			volume *= mix_channel[i].chunk->volume;
+			if ( which < 0 || volume < lowest ) {
+				which = i;
+				lowest = volume;
+			}
+			break;
+		    case MIX_STEAL_PRIORITY:
+			if ( mix_channel[i].chunk->priority <= chunk->priority &&
+			     (which < 0 || mix_channel[i].chunk->priority < lowest) ) {
+				which = i;
+				lowest = mix_channel[i].chunk->priority;
+			}
+			break;
+		    default:
+			break;
+		}
+	}
+	if ( which < 0 ) {
+		Mix_SetError("No free channels available");
+	}
+	return(which);
+}
+
 static int checkchunkintegral(Mix_Chunk *chunk)
 {
 	int frame_width = 1;
@@ -674,13 +991,15 @@ static int checkchunkintegral(Mix_Chunk *chunk)
 */
 int Mix_PlayChannelTimed(int which, Mix_Chunk *chunk, int loops, int ticks)
 {
-	int i;
-
 	/* Don't play null pointers :-) */
 	if ( chunk == NULL ) {
 		Mix_SetError("Tried to play a NULL chunk");
 		return(-1);
 	}
+	if ( chunk->allocated == MIX_CHUNK_CACHED &&
+	     _Mix_UseCachedChunk(chunk) < 0 ) {
+		return(-1);
+	}
 	if ( !checkchunkintegral(chunk)) {
 		Mix_SetError("Tried to play a chunk with a bad frame");
 		return(-1);
@@ -689,18 +1008,9 @@ int Mix_PlayChannelTimed(int which, Mix_Chunk *chunk, int loops, int ticks)
 	/* Lock the mixer while modifying the playing channels */
 	SDL_LockAudio();
 	{
-		/* If which is -1, play on the first free channel */
+		/* If which is -1, play on a free channel */
 		if ( which == -1 ) {
-			for ( i=reserved_channels; i<num_channels; ++i ) {
-				if ( mix_channel[i].playing <= 0 )
-					break;
-			}
-			if ( i == num_channels ) {
-				Mix_SetError("No free channels available");
-				which = -1;
-			} else {
-				which = i;
-			}
+			which = Mix_FindChannel(chunk);
 		}
 
 		/* Queue up the audio data for this channel */
@@ -716,6 +1026,7 @@ int Mix_PlayChannelTimed(int which, Mix_Chunk *chunk, int loops, int ticks)
 			mix_channel[which].fading = MIX_NO_FADING;
 			mix_channel[which].start_time = sdl_ticks;
 			mix_channel[which].expire = (ticks>0) ? (sdl_ticks + ticks) : 0;
+			channel_started(which);
 		}
 	}
 	SDL_UnlockAudio();
@@ -746,12 +1057,14 @@ int Mix_ExpireChannel(int which, int ticks)
 /* Fade in a sound on a channel, over ms milliseconds */
 int Mix_FadeInChannelTimed(int which, Mix_Chunk *chunk, int loops, int ms, int ticks)
 {
-	int i;
-
 	/* Don't play null pointers :-) */
 	if ( chunk == NULL ) {
 		return(-1);
 	}
+	if ( chunk->allocated == MIX_CHUNK_CACHED &&
+	     _Mix_UseCachedChunk(chunk) < 0 ) {
+		return(-1);
+	}
 	if ( !checkchunkintegral(chunk)) {
 		Mix_SetError("Tried to play a chunk with a bad frame");
 		return(-1);
@@ -760,17 +1073,9 @@ int Mix_FadeInChannelTimed(int which, Mix_Chunk *chunk, int loops, int ms, int t
 	/* Lock the mixer while modifying the playing channels */
 	SDL_LockAudio();
 	{
-		/* If which is -1, play on the first free channel */
+		/* If which is -1, play on a free channel */
 		if ( which == -1 ) {
-			for ( i=reserved_channels; i<num_channels; ++i ) {
-				if ( mix_channel[i].playing <= 0 )
-					break;
-			}
-			if ( i == num_channels ) {
-				which = -1;
-			} else {
-				which = i;
-			}
+			which = Mix_FindChannel(chunk);
 		}
 
 		/* Queue up the audio data for this channel */
@@ -789,6 +1094,7 @@ int Mix_FadeInChannelTimed(int which, Mix_Chunk *chunk, int loops, int ms, int t
 			mix_channel[which].fade_length = (Uint32)ms;
 			mix_channel[which].start_time = mix_channel[which].ticks_fade = sdl_ticks;
 			mix_channel[which].expire = (ticks > 0) ? (sdl_ticks+ticks) : 0;
+			channel_started(which);
 		}
 	}
 	SDL_UnlockAudio();
@@ -835,6 +1141,21 @@ int Mix_VolumeChunk(Mix_Chunk *chunk, int volume)
 	return(prev_volume);
 }
 
+/* Set the stealing priority of a particular chunk */
+int Mix_PriorityChunk(Mix_Chunk *chunk, int priority)
+{
+	int prev_priority;
+
+	prev_priority = chunk->priority;
+	if ( priority >= 0 ) {
+		if ( priority > 255 ) {
+			priority = 255;
+		}
+		chunk->priority = priority;
+	}
+	return(prev_priority);
+}
+
 /* Halt playing of a particular channel */
 int Mix_HaltChannel(int which)
 {
@@ -849,6 +1170,7 @@ int Mix_HaltChannel(int which)
 		if (mix_channel[which].playing) {
 			_Mix_channel_done_playing(which);
 		mix_channel[which].playing = 0;
+		channel_stopped(which);
 		}
 		mix_channel[which].expire = 0;
 		if(mix_channel[which].fading != MIX_NO_FADING) /* Restore volume */
@@ -974,10 +1296,16 @@ void Mix_CloseAudio(void)
 			Mix_UnregisterAllEffects(MIX_CHANNEL_POST);
 			close_music();
 			Mix_HaltChannel(-1);
+			_Mix_CloseChunkCache();
 			_Mix_DeinitEffects();
 			SDL_CloseAudio();
 			free(mix_channel);
 			mix_channel = NULL;
+			free(mixing_order);
+			mixing_order = NULL;
+			free(effect_buf);
+			effect_buf = NULL;
+			effect_buflen = 0;
 		}
 		--audio_opened;
 	}
@@ -1071,13 +1399,26 @@ int Mix_GroupChannels(int from, int to, int tag)
 /* Finds the first available channel in a group of channels */
 int Mix_GroupAvailable(int tag)
 {
-	int i;
-	for( i=0; i < num_channels; i ++ ) {
+	int i, chan = -1;
+
+	SDL_LockAudio();
+	for( i=0; i < reserved_channels; i ++ ) {
 		if ( ((tag == -1) || (tag == mix_channel[i].tag)) &&
-		                    (mix_channel[i].playing <= 0) )
-			return i;
+		                    (mix_channel[i].playing <= 0) ) {
+			chan = i;
+			break;
+		}
+	}
+	if ( chan < 0 ) {
+		for( i=free_channels.head; i >= 0; i=mix_channel[i].next ) {
+			if ( (tag == -1) || (tag == mix_channel[i].tag) ) {
+				chan = i;
+				break;
+			}
+		}
 	}
-	return(-1);
+	SDL_UnlockAudio();
+	return(chan);
 }
 
 int Mix_GroupCount(int tag)
@@ -1095,15 +1436,17 @@ int Mix_GroupCount(int tag)
 int Mix_GroupOldest(int tag)
 {
 	int chan = -1;
-	Uint32 mintime = SDL_GetTicks();
 	int i;
-	for( i=0; i < num_channels; i ++ ) {
-		if ( (mix_channel[i].tag==tag || tag==-1) && mix_channel[i].playing > 0
-			 && mix_channel[i].start_time <= mintime ) {
-			mintime = mix_channel[i].start_time;
+
+	/* The playing channels are in the order they started */
+	SDL_LockAudio();
+	for( i=active_channels.head; i >= 0; i=mix_channel[i].next ) {
+		if ( (mix_channel[i].tag==tag || tag==-1) && mix_channel[i].playing > 0 ) {
 			chan = i;
+			break;
 		}
 	}
+	SDL_UnlockAudio();
 	return(chan);
 }
 
@@ -1111,15 +1454,16 @@ int Mix_GroupOldest(int tag)
 int Mix_GroupNewer(int tag)
 {
 	int chan = -1;
-	Uint32 maxtime = 0;
 	int i;
-	for( i=0; i < num_channels; i ++ ) {
-		if ( (mix_channel[i].tag==tag || tag==-1) && mix_channel[i].playing > 0
-			 && mix_channel[i].start_time >= maxtime ) {
-			maxtime = mix_channel[i].start_time;
+
+	SDL_LockAudio();
+	for( i=active_channels.tail; i >= 0; i=mix_channel[i].prev ) {
+		if ( (mix_channel[i].tag==tag || tag==-1) && mix_channel[i].playing > 0 ) {
 			chan = i;
+			break;
 		}
 	}
+	SDL_UnlockAudio();
 	return(chan);
 }
 
@@ -29,8 +29,11 @@
 #include "SDL_endian.h"
 #include "SDL_audio.h"
 #include "SDL_timer.h"
+#include "SDL_thread.h"
+#include "SDL_mutex.h"
 
 #include "SDL_mixer.h"
+#include "music_ring.h"
 
 #define SDL_SURROUND
 
@@ -162,13 +165,38 @@ static Uint16 current_output_format;
 /* Used to calculate fading steps */
 static int ms_per_step;
 
+/* Decoding ahead: the decode thread keeps music_ring filled from
+   music_decoding, and the audio callback only mixes what's in the ring.
+   The decoders are then guarded by music_decode_lock as well as the audio
+   lock, and the audio callback never touches them.
+*/
+static int music_prefetch_ms = 0;
+static int music_opened = 0;
+static SDL_AudioSpec music_spec;
+static MusicRing music_ring;
+static Uint8 *music_decode_buf = NULL;	/* One buffer, for where the ring wraps */
+static SDL_Thread *music_decode_thread = NULL;
+static SDL_mutex *music_decode_lock = NULL;
+static SDL_sem *music_decode_wake = NULL;
+static int volatile music_decode_quit = 0;
+static Mix_Music * volatile music_decoding = NULL;
+static int music_primed = 0;		/* Playback from the ring started */
+static int music_ring_volume = MIX_MAX_VOLUME;
+static int music_lowest_filled = 0;
+static int music_underruns = 0;
+
 /* Local low-level functions prototypes */
 static void music_internal_initialize_volume(void);
 static void music_internal_volume(int volume);
+static void music_internal_set_volume(Mix_Music *music, int volume);
 static int  music_internal_play(Mix_Music *music, double position);
-static int  music_internal_position(double position);
+static int  music_internal_start(Mix_Music *music);
+static int  music_internal_position(Mix_Music *music, double position);
 static int  music_internal_playing();
+static int  music_internal_active(Mix_Music *music);
+static int  music_internal_decode(Mix_Music *music, Uint8 *stream, int len);
 static void music_internal_halt(void);
+static int  music_internal_stop(Mix_Music *music);
 
 
 /* Support for hooking when the music has finished */
@@ -182,6 +210,292 @@ void Mix_HookMusicFinished(void (*music_finished)(void))
 }
 
 
+/* Lock out both the audio callback and the decode thread */
+static void music_lock(void)
+{
+	if ( music_decode_lock ) {
+		SDL_mutexP(music_decode_lock);
+	}
+	SDL_LockAudio();
+}
+static void music_unlock(void)
+{
+	SDL_UnlockAudio();
+	if ( music_decode_lock ) {
+		SDL_mutexV(music_decode_lock);
+	}
+}
+
+/* Check whether the music is decoded by the decode thread */
+static int music_decodes_ahead(Mix_Music *music)
+{
+	if ( !music_decode_thread ) {
+		return(0);
+	}
+	switch (music->type) {
+#ifdef WAV_MUSIC
+	    case MUS_WAV:
+#endif
+#if defined(MOD_MUSIC) || defined(LIBMIKMOD_MUSIC)
+	    case MUS_MOD:
+#endif
+#ifdef OGG_MUSIC
+	    case MUS_OGG:
+#endif
+#ifdef FLAC_MUSIC
+	    case MUS_FLAC:
+#endif
+#ifdef MP3_MAD_MUSIC
+	    case MUS_MP3_MAD:
+#endif
+		return(1);
+#if defined(MID_MUSIC) && defined(USE_TIMIDITY_MIDI)
+	    case MUS_MID:
+#ifdef USE_NATIVE_MIDI
+		if ( native_midi_ok ) {
+			return(0);
+		}
+#endif
+		return(1);
+#endif
+	    default:
+		return(0);
+	}
+}
+
+/* Stop the decoder the decode thread was using.
+   Called with both locks held, or from the decode thread.
+*/
+static void music_decode_release(void)
+{
+	if ( music_decoding ) {
+		music_internal_stop(music_decoding);
+		music_decoding = NULL;
+	}
+}
+
+/* Have the decode thread fill the ring from the music's current position.
+   Called with both locks held.
+*/
+static void music_decode_begin(Mix_Music *music)
+{
+	MusicRing_Reset(&music_ring);
+	music_primed = 0;
+	music_lowest_filled = music_ring.size;
+	music_internal_set_volume(music, MIX_MAX_VOLUME);
+	music_decoding = music;
+	SDL_SemPost(music_decode_wake);
+}
+
+/* Make len bytes decoded at buf readable, copying them in if they were
+   decoded into music_decode_buf */
+static void music_decode_commit(Uint8 *buf, int len)
+{
+	Uint8 *dst;
+	int n;
+
+	if ( buf != music_decode_buf ) {
+		MusicRing_Commit(&music_ring, len);
+		return;
+	}
+	while ( len > 0 ) {
+		dst = MusicRing_WritePtr(&music_ring, &n);
+		if ( n > len ) {
+			n = len;
+		}
+		memcpy(dst, buf, n);
+		MusicRing_Commit(&music_ring, n);
+		buf += n;
+		len -= n;
+	}
+}
+
+/* Decode one audio buffer into the ring, looping the music if needed.
+   Returns the number of bytes decoded.
+   Called from the decode thread with the decode lock held.
+*/
+static int music_decode_some(void)
+{
+	Mix_Music *music = music_decoding;
+	Uint8 *buf;
+	int len, room, left;
+
+	/* The decoders get whole audio buffers, as in the audio callback.
+	   Timidity writes a whole buffer at a time, whatever it is asked for.
+	*/
+	len = music_spec.size;
+	if ( MusicRing_Space(&music_ring) < len ) {
+		return(0);
+	}
+	buf = MusicRing_WritePtr(&music_ring, &room);
+	if ( room < len ) {
+		buf = music_decode_buf;
+	}
+
+	/* The decoders mix into the buffer */
+	memset(buf, music_spec.silence, len);
+	left = music_internal_decode(music, buf, len);
+	if ( !music_internal_active(music) ) {
+		if ( music_loops && --music_loops ) {
+			music_internal_start(music);
+			music_internal_position(music, 0.0);
+			music_internal_set_volume(music, MIX_MAX_VOLUME);
+			if ( left > 0 ) {
+				music_internal_decode(music, buf + (len - left), left);
+			}
+		} else {
+			music_decode_commit(buf, len);
+			MusicRing_End(&music_ring);
+			return(len);
+		}
+	}
+	music_decode_commit(buf, len);
+	return(len);
+}
+
+static int SDLCALL music_decode(void *unused)
+{
+	while ( !music_decode_quit ) {
+		int decoded = 0;
+
+		SDL_mutexP(music_decode_lock);
+		if ( music_decoding ) {
+			if ( music_decoding != music_playing ) {
+				/* The audio callback finished with it */
+				music_decode_release();
+			} else if ( !MusicRing_Ended(&music_ring) ) {
+				decoded = music_decode_some();
+			}
+		}
+		SDL_mutexV(music_decode_lock);
+
+		/* Sleep until the audio callback makes room, or new music plays */
+		if ( !decoded ) {
+			SDL_SemWait(music_decode_wake);
+		}
+	}
+	return(0);
+}
+
+/* Start the decode thread, with a ring big enough for the prefetch time */
+static int music_decode_start(void)
+{
+	int frame = music_spec.size / music_spec.samples;
+	int len = (int)(((double)music_prefetch_ms * music_spec.freq) / 1000.0) * frame;
+
+	/* Keep at least one buffer decoded while the next is being played */
+	if ( len < 2 * (int)music_spec.size ) {
+		len = 2 * music_spec.size;
+	}
+	if ( MusicRing_Init(&music_ring, len, frame) < 0 ) {
+		return(-1);
+	}
+	music_decode_buf = (Uint8 *)malloc(music_spec.size);
+	music_decode_lock = SDL_CreateMutex();
+	music_decode_wake = SDL_CreateSemaphore(0);
+	if ( !music_decode_buf || !music_decode_lock || !music_decode_wake ) {
+		goto error;
+	}
+	music_decode_quit = 0;
+	music_decoding = NULL;
+	music_underruns = 0;
+	music_lowest_filled = 0;
+	music_decode_thread = SDL_CreateThread(music_decode, NULL);
+	if ( !music_decode_thread ) {
+		goto error;
+	}
+	return(0);
+
+error:
+	if ( music_decode_wake ) {
+		SDL_DestroySemaphore(music_decode_wake);
+		music_decode_wake = NULL;
+	}
+	if ( music_decode_lock ) {
+		SDL_DestroyMutex(music_decode_lock);
+		music_decode_lock = NULL;
+	}
+	if ( music_decode_buf ) {
+		free(music_decode_buf);
+		music_decode_buf = NULL;
+	}
+	MusicRing_Free(&music_ring);
+	return(-1);
+}
+
+/* Stop the decode thread. The music must have been halted. */
+static void music_decode_stop(void)
+{
+	if ( !music_decode_thread ) {
+		return;
+	}
+	music_decode_quit = 1;
+	SDL_SemPost(music_decode_wake);
+	SDL_WaitThread(music_decode_thread, NULL);
+	music_decode_release();
+
+	SDL_LockAudio();
+	music_decode_thread = NULL;
+	SDL_UnlockAudio();
+	SDL_DestroySemaphore(music_decode_wake);
+	music_decode_wake = NULL;
+	SDL_DestroyMutex(music_decode_lock);
+	music_decode_lock = NULL;
+	free(music_decode_buf);
+	music_decode_buf = NULL;
+	MusicRing_Free(&music_ring);
+}
+
+/* Mix decoded music from the ring, from the audio callback */
+static void music_mix_ahead(Uint8 *stream, int len)
+{
+	int ended, filled;
+
+	ended = MusicRing_Ended(&music_ring);
+	filled = MusicRing_Filled(&music_ring);
+
+	/* Start as soon as one buffer is decoded, the decode thread keeps
+	   working towards a full ring while it plays */
+	if ( !music_primed ) {
+		if ( !ended && filled < len ) {
+			return;
+		}
+		music_primed = 1;
+	}
+	if ( filled < music_lowest_filled ) {
+		music_lowest_filled = filled;
+	}
+
+	while ( len > 0 ) {
+		Uint8 *src;
+		int n;
+
+		src = MusicRing_ReadPtr(&music_ring, &n);
+		if ( n <= 0 ) {
+			break;
+		}
+		if ( n > len ) {
+			n = len;
+		}
+		SDL_MixAudio(stream, src, n, music_ring_volume);
+		MusicRing_Consume(&music_ring, n);
+		stream += n;
+		len -= n;
+	}
+	SDL_SemPost(music_decode_wake);
+
+	if ( len > 0 ) {
+		if ( ended ) {
+			music_internal_halt();
+			if ( music_finished_hook ) {
+				music_finished_hook();
+			}
+		} else {
+			++music_underruns;
+		}
+	}
+}
+
 /* If music isn't playing, halt it if no looping is required, restart it */
 /* otherwhise. NOP if the music is playing */
 static int music_halt_or_loop (void)
@@ -215,6 +529,8 @@ static int music_halt_or_loop (void)
 /* Mixing function */
 void music_mixer(void *udata, Uint8 *stream, int len)
 {
+	int left;
+
 	if ( music_playing && music_active ) {
 		/* Handle fading */
 		if ( music_playing->fading != MIX_NO_FADING ) {
@@ -241,138 +557,147 @@ void music_mixer(void *udata, Uint8 *stream, int len)
 			}
 		}
 		
+		if ( music_decodes_ahead(music_playing) ) {
+			music_mix_ahead(stream, len);
+			return;
+		}
+
 		if (music_halt_or_loop() == 0)
 			return;
-		
-		
-		switch (music_playing->type) {
+
+		left = music_internal_decode(music_playing, stream, len);
+		if ( left > 0 && music_halt_or_loop() ) {
+			/* The music looped, play its start after the end */
+			music_internal_decode(music_playing, stream + (len - left), left);
+		}
+	}
+}
+
+/* Decode music into the stream. Returns the number of bytes left unfilled
+   if the music ended partway through, for the music types that say.
+*/
+static int music_internal_decode(Mix_Music *music, Uint8 *stream, int len)
+{
+	switch (music->type) {
 #ifdef CMD_MUSIC
-			case MUS_CMD:
-				/* The playing is done externally */
-				break;
+		case MUS_CMD:
+			/* The playing is done externally */
+			break;
 #endif
 #ifdef WAV_MUSIC
-			case MUS_WAV:
-				WAVStream_PlaySome(stream, len);
-				break;
+		case MUS_WAV:
+			WAVStream_PlaySome(stream, len);
+			break;
 #endif
 #if defined(MOD_MUSIC) || defined(LIBMIKMOD_MUSIC)
-			case MUS_MOD:
-				if (current_output_channels > 2) {
-					int small_len = 2 * len / current_output_channels;
-					int i;
-					Uint8 *src, *dst;
-
-					VC_WriteBytes((SBYTE *)stream, small_len);
-					/* and extend to len by copying channels */
-					src = stream + small_len;
-					dst = stream + len;
-
-					switch (current_output_format & 0xFF) {
-						case 8:
-							for ( i=small_len/2; i; --i ) {
-								src -= 2;
-								dst -= current_output_channels;
-								dst[0] = src[0];
-								dst[1] = src[1];
-								dst[2] = src[0];
-								dst[3] = src[1];
-								if (current_output_channels == 6) {
-									dst[4] = src[0];
-									dst[5] = src[1];
-								}
-							}
-							break;
-						case 16:
-							for ( i=small_len/4; i; --i ) {
-								src -= 4;
-								dst -= 2 * current_output_channels;
-								dst[0] = src[0];
-								dst[1] = src[1];
-								dst[2] = src[2];
-								dst[3] = src[3];
+		case MUS_MOD:
+			if (current_output_channels > 2) {
+				int small_len = 2 * len / current_output_channels;
+				int i;
+				Uint8 *src, *dst;
+
+				VC_WriteBytes((SBYTE *)stream, small_len);
+				/* and extend to len by copying channels */
+				src = stream + small_len;
+				dst = stream + len;
+
+				switch (current_output_format & 0xFF) {
+					case 8:
+						for ( i=small_len/2; i; --i ) {
+							src -= 2;
+							dst -= current_output_channels;
+							dst[0] = src[0];
+							dst[1] = src[1];
+							dst[2] = src[0];
+							dst[3] = src[1];
+							if (current_output_channels == 6) {
 								dst[4] = src[0];
 								dst[5] = src[1];
-								dst[6] = src[2];
-								dst[7] = src[3];
-								if (current_output_channels == 6) {
-									dst[8] = src[0];
-									dst[9] = src[1];
-									dst[10] = src[2];
-									dst[11] = src[3];
-								}
 							}
-							break;
-					}
+						}
+						break;
+					case 16:
+						for ( i=small_len/4; i; --i ) {
+							src -= 4;
+							dst -= 2 * current_output_channels;
+							dst[0] = src[0];
+							dst[1] = src[1];
+							dst[2] = src[2];
+							dst[3] = src[3];
+							dst[4] = src[0];
+							dst[5] = src[1];
+							dst[6] = src[2];
+							dst[7] = src[3];
+							if (current_output_channels == 6) {
+								dst[8] = src[0];
+								dst[9] = src[1];
+								dst[10] = src[2];
+								dst[11] = src[3];
+							}
+						}
+						break;
+				}
 
 
 
+			}
+			else VC_WriteBytes((SBYTE *)stream, len);
+			if ( music_swap8 ) {
+				Uint8 *dst;
+				int i;
+
+				dst = stream;
+				for ( i=len; i; --i ) {
+					*dst++ ^= 0x80;
 				}
-				else VC_WriteBytes((SBYTE *)stream, len);
-				if ( music_swap8 ) {
-					Uint8 *dst;
-					int i;
-
-					dst = stream;
-					for ( i=len; i; --i ) {
-						*dst++ ^= 0x80;
-					}
-				} else
-				if ( music_swap16 ) {
-					Uint8 *dst, tmp;
-					int i;
-
-					dst = stream;
-					for ( i=(len/2); i; --i ) {
-						tmp = dst[0];
-						dst[0] = dst[1];
-						dst[1] = tmp;
-						dst += 2;
-					}
+			} else
+			if ( music_swap16 ) {
+				Uint8 *dst, tmp;
+				int i;
+
+				dst = stream;
+				for ( i=(len/2); i; --i ) {
+					tmp = dst[0];
+					dst[0] = dst[1];
+					dst[1] = tmp;
+					dst += 2;
 				}
-				break;
+			}
+			break;
 #endif
 #ifdef MID_MUSIC
 #ifdef USE_TIMIDITY_MIDI
-			case MUS_MID:
-				if ( timidity_ok ) {
-					int samples = len / samplesize;
-  					Timidity_PlaySome(stream, samples);
-				}
-				break;
+		case MUS_MID:
+			if ( timidity_ok ) {
+				int samples = len / samplesize;
+				Timidity_PlaySome(stream, samples);
+			}
+			break;
 #endif
 #endif
 #ifdef OGG_MUSIC
-			case MUS_OGG:
-				
-				len = OGG_playAudio(music_playing->data.ogg, stream, len);
-				if (len > 0 && music_halt_or_loop())
-					OGG_playAudio(music_playing->data.ogg, stream, len);
-			
-				break;
+		case MUS_OGG:
+			return OGG_playAudio(music->data.ogg, stream, len);
 #endif
 #ifdef FLAC_MUSIC
-			case MUS_FLAC:
-				len = FLAC_playAudio(music_playing->data.flac, stream, len);
-				if (len > 0 && music_halt_or_loop())
-					FLAC_playAudio(music_playing->data.flac, stream, len);
-				break;
+		case MUS_FLAC:
+			return FLAC_playAudio(music->data.flac, stream, len);
 #endif
 #ifdef MP3_MUSIC
-			case MUS_MP3:
-				smpeg.SMPEG_playAudio(music_playing->data.mp3, stream, len);
-				break;
+		case MUS_MP3:
+			smpeg.SMPEG_playAudio(music->data.mp3, stream, len);
+			break;
 #endif
 #ifdef MP3_MAD_MUSIC
-			case MUS_MP3_MAD:
-				mad_getSamples(music_playing->data.mp3_mad, stream, len);
-				break;
+		case MUS_MP3_MAD:
+			mad_getSamples(music->data.mp3_mad, stream, len);
+			break;
 #endif
-			default:
-				/* Unknown music type?? */
-				break;
-		}
+		default:
+			/* Unknown music type?? */
+			break;
 	}
+	return(0);
 }
 
 /* Initialize the music players with a certain desired audio format */
@@ -501,6 +826,12 @@ int open_music(SDL_AudioSpec *mixer)
 	/* Calculate the number of ms for each callback */
 	ms_per_step = (int) (((float)mixer->samples * 1000.0) / mixer->freq);
 
+	/* Without the decode thread the music is decoded in the callback */
+	music_spec = *mixer;
+	music_opened = 1;
+	if ( music_prefetch_ms > 0 ) {
+		music_decode_start();
+	}
 	return(0);
 }
 
@@ -701,19 +1032,22 @@ void Mix_FreeMusic(Mix_Music *music)
 {
 	if ( music ) {
 		/* Stop the music if it's currently playing */
-		SDL_LockAudio();
+		music_lock();
 		if ( music == music_playing ) {
 			/* Wait for any fade out to finish */
 			while ( music->fading == MIX_FADING_OUT ) {
-				SDL_UnlockAudio();
+				music_unlock();
 				SDL_Delay(100);
-				SDL_LockAudio();
+				music_lock();
 			}
 			if ( music == music_playing ) {
 				music_internal_halt();
 			}
 		}
-		SDL_UnlockAudio();
+		if ( music == music_decoding ) {
+			music_decode_release();
+		}
+		music_unlock();
 		switch (music->type) {
 #ifdef CMD_MUSIC
 			case MUS_CMD:
@@ -802,6 +1136,7 @@ static int music_internal_play(Mix_Music *music, double position)
 	if ( music_playing ) {
 		music_internal_halt();
 	}
+	music_decode_release();
 	music_playing = music;
 
 	/* Set the initial volume */
@@ -810,6 +1145,37 @@ static int music_internal_play(Mix_Music *music, double position)
 	}
 
 	/* Set up for playback */
+	retval = music_internal_start(music);
+
+	/* Player_SetVolume() does nothing before Player_Start() */
+	if ( retval == 0 && music->type == MUS_MOD ) {
+		music_internal_initialize_volume();
+	}
+
+	/* Set the playback position, note any errors if an offset is used */
+	if ( retval == 0 ) {
+		if ( position > 0.0 ) {
+			if ( music_internal_position(music, position) < 0 ) {
+				Mix_SetError("Position not implemented for music type");
+				retval = -1;
+			}
+		} else {
+			music_internal_position(music, 0.0);
+		}
+	}
+
+	/* If the setup failed, we're not playing any music anymore */
+	if ( retval < 0 ) {
+		music_playing = NULL;
+	} else if ( music_decodes_ahead(music) ) {
+		music_decode_begin(music);
+	}
+	return(retval);
+}
+
+/* Start the music's decoder from the beginning */
+static int music_internal_start(Mix_Music *music)
+{
 	switch (music->type) {
 #ifdef CMD_MUSIC
 	    case MUS_CMD:
@@ -824,8 +1190,6 @@ static int music_internal_play(Mix_Music *music, double position)
 #if defined(MOD_MUSIC) || defined(LIBMIKMOD_MUSIC)
 	    case MUS_MOD:
 		Player_Start(music->data.module);
-		/* Player_SetVolume() does nothing before Player_Start() */
-		music_internal_initialize_volume();
 		break;
 #endif
 #ifdef MID_MUSIC
@@ -856,7 +1220,7 @@ static int music_internal_play(Mix_Music *music, double position)
 	    case MUS_MP3:
 		smpeg.SMPEG_enableaudio(music->data.mp3,1);
 		smpeg.SMPEG_enablevideo(music->data.mp3,0);
-		smpeg.SMPEG_play(music_playing->data.mp3);
+		smpeg.SMPEG_play(music->data.mp3);
 		break;
 #endif
 #ifdef MP3_MAD_MUSIC
@@ -866,28 +1230,12 @@ static int music_internal_play(Mix_Music *music, double position)
 #endif
 	    default:
 		Mix_SetError("Can't play unknown music type");
-		retval = -1;
-		break;
-	}
-
-	/* Set the playback position, note any errors if an offset is used */
-	if ( retval == 0 ) {
-		if ( position > 0.0 ) {
-			if ( music_internal_position(position) < 0 ) {
-				Mix_SetError("Position not implemented for music type");
-				retval = -1;
-			}
-		} else {
-			music_internal_position(0.0);
-		}
+		return(-1);
 	}
 
-	/* If the setup failed, we're not playing any music anymore */
-	if ( retval < 0 ) {
-		music_playing = NULL;
-	}
-	return(retval);
+	return(0);
 }
+
 int Mix_FadeInMusicPos(Mix_Music *music, int loops, int ms, double position)
 {
 	int retval;
@@ -908,17 +1256,17 @@ int Mix_FadeInMusicPos(Mix_Music *music, int loops, int ms, double position)
 	music->fade_steps = ms/ms_per_step;
 
 	/* Play the puppy */
-	SDL_LockAudio();
+	music_lock();
 	/* If the current music is fading out, wait for the fade to complete */
 	while ( music_playing && (music_playing->fading == MIX_FADING_OUT) ) {
-		SDL_UnlockAudio();
+		music_unlock();
 		SDL_Delay(100);
-		SDL_LockAudio();
+		music_lock();
 	}
 	music_active = 1;
 	music_loops = loops;
 	retval = music_internal_play(music, position);
-	SDL_UnlockAudio();
+	music_unlock();
 
 	return(retval);
 }
@@ -932,11 +1280,11 @@ int Mix_PlayMusic(Mix_Music *music, int loops)
 }
 
 /* Set the playing music position */
-int music_internal_position(double position)
+static int music_internal_position(Mix_Music *music, double position)
 {
 	int retval = 0;
 
-	switch (music_playing->type) {
+	switch (music->type) {
 #if defined(MOD_MUSIC) || defined(LIBMIKMOD_MUSIC)
 	    case MUS_MOD:
 		Player_SetPosition((UWORD)position);
@@ -944,27 +1292,27 @@ int music_internal_position(double position)
 #endif
 #ifdef OGG_MUSIC
 	    case MUS_OGG:
-		OGG_jump_to_time(music_playing->data.ogg, position);
+		OGG_jump_to_time(music->data.ogg, position);
 		break;
 #endif
 #ifdef FLAC_MUSIC
 	    case MUS_FLAC:
-		FLAC_jump_to_time(music_playing->data.flac, position);
+		FLAC_jump_to_time(music->data.flac, position);
 		break;
 #endif
 #ifdef MP3_MUSIC
 	    case MUS_MP3:
 		if ( position > 0.0 ) {
-			smpeg.SMPEG_skip(music_playing->data.mp3, (float)position);
+			smpeg.SMPEG_skip(music->data.mp3, (float)position);
 		} else {
-			smpeg.SMPEG_rewind(music_playing->data.mp3);
-			smpeg.SMPEG_play(music_playing->data.mp3);
+			smpeg.SMPEG_rewind(music->data.mp3);
+			smpeg.SMPEG_play(music->data.mp3);
 		}
 		break;
 #endif
 #ifdef MP3_MAD_MUSIC
 	    case MUS_MP3_MAD:
-		mad_seek(music_playing->data.mp3_mad, position);
+		mad_seek(music->data.mp3_mad, position);
 		break;
 #endif
 	    default:
@@ -978,17 +1326,20 @@ int Mix_SetMusicPosition(double position)
 {
 	int retval;
 
-	SDL_LockAudio();
+	music_lock();
 	if ( music_playing ) {
-		retval = music_internal_position(position);
+		retval = music_internal_position(music_playing, position);
 		if ( retval < 0 ) {
 			Mix_SetError("Position not implemented for music type");
+		} else if ( music_decodes_ahead(music_playing) ) {
+			/* Throw away what was decoded before the seek */
+			music_decode_begin(music_playing);
 		}
 	} else {
 		Mix_SetError("Music isn't playing");
 		retval = -1;
 	}
-	SDL_UnlockAudio();
+	music_unlock();
 
 	return(retval);
 }
@@ -1006,7 +1357,17 @@ static void music_internal_initialize_volume(void)
 /* Set the music volume */
 static void music_internal_volume(int volume)
 {
-	switch (music_playing->type) {
+	/* Music decoded ahead is decoded at full volume, and turned down as
+	   it's mixed */
+	if ( music_decodes_ahead(music_playing) ) {
+		music_ring_volume = volume;
+	} else {
+		music_internal_set_volume(music_playing, volume);
+	}
+}
+static void music_internal_set_volume(Mix_Music *music, int volume)
+{
+	switch (music->type) {
 #ifdef CMD_MUSIC
 	    case MUS_CMD:
 		MusicCMD_SetVolume(volume);
@@ -1038,22 +1399,22 @@ static void music_internal_volume(int volume)
 #endif
 #ifdef OGG_MUSIC
 	    case MUS_OGG:
-		OGG_setvolume(music_playing->data.ogg, volume);
+		OGG_setvolume(music->data.ogg, volume);
 		break;
 #endif
 #ifdef FLAC_MUSIC
 	    case MUS_FLAC:
-		FLAC_setvolume(music_playing->data.flac, volume);
+		FLAC_setvolume(music->data.flac, volume);
 		break;
 #endif
 #ifdef MP3_MUSIC
 	    case MUS_MP3:
-		smpeg.SMPEG_setvolume(music_playing->data.mp3,(int)(((float)volume/(float)MIX_MAX_VOLUME)*100.0));
+		smpeg.SMPEG_setvolume(music->data.mp3,(int)(((float)volume/(float)MIX_MAX_VOLUME)*100.0));
 		break;
 #endif
 #ifdef MP3_MAD_MUSIC
 	    case MUS_MP3_MAD:
-		mad_setVolume(music_playing->data.mp3_mad, volume);
+		mad_setVolume(music->data.mp3_mad, volume);
 		break;
 #endif
 	    default:
@@ -1084,10 +1445,24 @@ int Mix_VolumeMusic(int volume)
 /* Halt playing of music */
 static void music_internal_halt(void)
 {
-	switch (music_playing->type) {
+	if ( music_decodes_ahead(music_playing) ) {
+		/* The decode thread stops the decoder when it sees the music
+		   is gone */
+		MusicRing_Drain(&music_ring);
+	} else if ( !music_internal_stop(music_playing) ) {
+		return;
+	}
+	music_playing->fading = MIX_NO_FADING;
+	music_playing = NULL;
+}
+
+/* Stop the music's decoder. Returns 0 for an unknown music type. */
+static int music_internal_stop(Mix_Music *music)
+{
+	switch (music->type) {
 #ifdef CMD_MUSIC
 	    case MUS_CMD:
-		MusicCMD_Stop(music_playing->data.cmd);
+		MusicCMD_Stop(music->data.cmd);
 		break;
 #endif
 #ifdef WAV_MUSIC
@@ -1116,30 +1491,29 @@ static void music_internal_halt(void)
 #endif
 #ifdef OGG_MUSIC
 	    case MUS_OGG:
-		OGG_stop(music_playing->data.ogg);
+		OGG_stop(music->data.ogg);
 		break;
 #endif
 #ifdef FLAC_MUSIC
 	    case MUS_FLAC:
-		FLAC_stop(music_playing->data.flac);
+		FLAC_stop(music->data.flac);
 		break;
 #endif
 #ifdef MP3_MUSIC
 	    case MUS_MP3:
-		smpeg.SMPEG_stop(music_playing->data.mp3);
+		smpeg.SMPEG_stop(music->data.mp3);
 		break;
 #endif
 #ifdef MP3_MAD_MUSIC
 	    case MUS_MP3_MAD:
-		mad_stop(music_playing->data.mp3_mad);
+		mad_stop(music->data.mp3_mad);
 		break;
 #endif
 	    default:
 		/* Unknown music type?? */
-		return;
+		return(0);
 	}
-	music_playing->fading = MIX_NO_FADING;
-	music_playing = NULL;
+	return(1);
 }
 int Mix_HaltMusic(void)
 {
@@ -1224,12 +1598,20 @@ int Mix_PausedMusic(void)
 
 /* Check the status of the music */
 static int music_internal_playing()
+{
+	/* Music decoded ahead plays until the ring runs dry */
+	if ( music_decodes_ahead(music_playing) ) {
+		return(1);
+	}
+	return(music_internal_active(music_playing));
+}
+static int music_internal_active(Mix_Music *music)
 {
 	int playing = 1;
-	switch (music_playing->type) {
+	switch (music->type) {
 #ifdef CMD_MUSIC
 	    case MUS_CMD:
-		if (!MusicCMD_Active(music_playing->data.cmd)) {
+		if (!MusicCMD_Active(music->data.cmd)) {
 			playing = 0;
 		}
 		break;
@@ -1266,27 +1648,27 @@ static int music_internal_playing()
 #endif
 #ifdef OGG_MUSIC
 	    case MUS_OGG:
-		if ( ! OGG_playing(music_playing->data.ogg) ) {
+		if ( ! OGG_playing(music->data.ogg) ) {
 			playing = 0;
 		}
 		break;
 #endif
 #ifdef FLAC_MUSIC
 	    case MUS_FLAC:
-		if ( ! FLAC_playing(music_playing->data.flac) ) {
+		if ( ! FLAC_playing(music->data.flac) ) {
 			playing = 0;
 		}
 		break;
 #endif
 #ifdef MP3_MUSIC
 	    case MUS_MP3:
-		if ( smpeg.SMPEG_status(music_playing->data.mp3) != SMPEG_PLAYING )
+		if ( smpeg.SMPEG_status(music->data.mp3) != SMPEG_PLAYING )
 			playing = 0;
 		break;
 #endif
 #ifdef MP3_MAD_MUSIC
 	    case MUS_MP3_MAD:
-		if (!mad_isPlaying(music_playing->data.mp3_mad)) {
+		if (!mad_isPlaying(music->data.mp3_mad)) {
 			playing = 0;
 		}
 		break;
@@ -1328,6 +1710,34 @@ int Mix_SetMusicCMD(const char *command)
 	return(0);
 }
 
+/* Set how far ahead of playback the music is decoded */
+int Mix_SetMusicDecodeAhead(int prefetch_ms)
+{
+	Mix_HaltMusic();
+	music_decode_stop();
+	music_prefetch_ms = prefetch_ms;
+	if ( music_opened && music_prefetch_ms > 0 ) {
+		return(music_decode_start());
+	}
+	return(0);
+}
+
+int Mix_GetMusicDecodeStats(Mix_MusicDecodeStats *stats)
+{
+	if ( !music_decode_thread ) {
+		Mix_SetError("Music isn't being decoded ahead");
+		return(-1);
+	}
+	SDL_LockAudio();
+	stats->size = music_ring.size - music_ring.frame;
+	stats->filled = MusicRing_Filled(&music_ring);
+	stats->lowest_filled = music_lowest_filled;
+	stats->underruns = music_underruns;
+	music_lowest_filled = stats->filled;
+	SDL_UnlockAudio();
+	return(0);
+}
+
 #ifdef LIBMIKMOD_MUSIC
 static int _pl_synchro_value;
 void Player_SetSynchroValue(int i)
@@ -1391,6 +1801,8 @@ int Mix_GetSynchroValue(void)
 void close_music(void)
 {
 	Mix_HaltMusic();
+	music_decode_stop();
+	music_opened = 0;
 #ifdef CMD_MUSIC
 	Mix_SetMusicCMD(NULL);
 #endif
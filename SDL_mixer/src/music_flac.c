@@ -225,19 +225,21 @@ static FLAC__StreamDecoderWriteStatus flac_write_music_cb(
 			}
 		}
 		else {
-			// we need to write to the overflow
-			if (!data->flac_data.overflow) {
-				data->flac_data.overflow_len =
-											4 * (frame->header.blocksize - i);
-				data->flac_data.overflow_read = 0;
-
+			// we need to write to the overflow, which is kept between
+			// blocks and only grows
+			if (data->flac_data.overflow_read + 4 >
+											data->flac_data.overflow_len) {
 				// make it big enough for the rest of the block
-				data->flac_data.overflow =
-								(char *)malloc (data->flac_data.overflow_len);
+				int overflow_len = data->flac_data.overflow_read +
+											4 * (frame->header.blocksize - i);
+				char *overflow = (char *)realloc (data->flac_data.overflow,
+															overflow_len);
 
-				if (!data->flac_data.overflow) {
+				if (!overflow) {
 					return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
 				}
+				data->flac_data.overflow = overflow;
+				data->flac_data.overflow_len = overflow_len;
 			}
 
 			FLAC__int16 i16;
@@ -392,52 +394,47 @@ int FLAC_playing(FLAC_music *music) {
 
 /* Read some FLAC stream data and convert it for output */
 static void FLAC_getsome(FLAC_music *music) {
-	int section;
 	SDL_AudioCVT *cvt;
 
 	/* GET AUDIO wAVE DATA */
 	// set the max number of characters to read
 	music->flac_data.max_to_read = 8192;
 
-	// clear out the data buffer if it exists
-	if (music->flac_data.data) {
-		free (music->flac_data.data);
+	// the data buffer is kept for the life of the stream
+	if (!music->flac_data.data) {
+		music->flac_data.data = (char *)malloc (music->flac_data.max_to_read);
+		if (!music->flac_data.data) {
+			SDL_SetError ("Out of memory");
+			music->playing = 0;
+			return;
+		}
 	}
-
 	music->flac_data.data_len = music->flac_data.max_to_read;
 	music->flac_data.data_read = 0;
-	music->flac_data.data = (char *)malloc (music->flac_data.data_len);
 
 	// we have data to read
 	while(music->flac_data.max_to_read > 0) {
 		// first check if there is data in the overflow from before
-		if (music->flac_data.overflow) {
-			size_t overflow_len = music->flac_data.overflow_read;
+		if (music->flac_data.overflow_read > 0) {
+			int overflow_len = music->flac_data.overflow_read;
 
 			if (overflow_len > music->flac_data.max_to_read) {
-				size_t overflow_extra_len = overflow_len -
+				int overflow_extra_len = overflow_len -
 												music->flac_data.max_to_read;
 
-				char* new_overflow = (char *)malloc (overflow_extra_len);
 				memcpy (music->flac_data.data+music->flac_data.data_read,
 					music->flac_data.overflow, music->flac_data.max_to_read);
 				music->flac_data.data_read += music->flac_data.max_to_read;
-				memcpy (new_overflow,
+				memmove (music->flac_data.overflow,
 					music->flac_data.overflow + music->flac_data.max_to_read,
 					overflow_extra_len);
-				free (music->flac_data.overflow);
-				music->flac_data.overflow = new_overflow;
-				music->flac_data.overflow_len = overflow_extra_len;
-				music->flac_data.overflow_read = 0;
+				music->flac_data.overflow_read = overflow_extra_len;
 				music->flac_data.max_to_read = 0;
 			}
 			else {
 				memcpy (music->flac_data.data+music->flac_data.data_read,
 					music->flac_data.overflow, overflow_len);
 				music->flac_data.data_read += overflow_len;
-				free (music->flac_data.overflow);
-				music->flac_data.overflow = NULL;
-				music->flac_data.overflow_len = 0;
 				music->flac_data.overflow_read = 0;
 				music->flac_data.max_to_read -= overflow_len;
 			}
@@ -462,26 +459,26 @@ static void FLAC_getsome(FLAC_music *music) {
 		return;
 	}
 	cvt = &music->cvt;
-	if (section != music->section) {
-
+	// a FLAC stream has one format throughout, so this is only done once
+	if (music->section < 0) {
 		SDL_BuildAudioCVT (cvt, AUDIO_S16, (Uint8)music->flac_data.channels,
 						(int)music->flac_data.sample_rate, mixer.format,
 		                mixer.channels, mixer.freq);
-		if (cvt->buf) {
-			free (cvt->buf);
+		if (cvt->needed) {
+			cvt->buf = (Uint8 *)malloc (music->flac_data.data_len *
+															cvt->len_mult);
 		}
-		cvt->buf = (Uint8 *)malloc (music->flac_data.data_len * cvt->len_mult);
-		music->section = section;
+		music->section = 0;
+	}
+	if (!cvt->needed) {
+		// play the decoded data as it is
+		music->len_available = music->flac_data.data_read;
+		music->snd_available = (Uint8 *)music->flac_data.data;
 	}
-	if (cvt->buf) {
+	else if (cvt->buf) {
 		memcpy (cvt->buf, music->flac_data.data, music->flac_data.data_read);
-		if (cvt->needed) {
-			cvt->len = music->flac_data.data_read;
-			SDL_ConvertAudio (cvt);
-		}
-		else {
-			cvt->len_cvt = music->flac_data.data_read;
-		}
+		cvt->len = music->flac_data.data_read;
+		SDL_ConvertAudio (cvt);
 		music->len_available = music->cvt.len_cvt;
 		music->snd_available = music->cvt.buf;
 	}
@@ -555,17 +552,11 @@ void FLAC_jump_to_time(FLAC_music *music, double time) {
 		if (music->flac_decoder) {
 			double seek_sample = music->flac_data.sample_rate * time;
 
-			// clear data if it has data
-			if (music->flac_data.data) {
-				free (music->flac_data.data);
-				music->flac_data.data = NULL;
-			}
-
-			// clear overflow if it has data
-			if (music->flac_data.overflow) {
-				free (music->flac_data.overflow);
-				music->flac_data.overflow = NULL;
-			}
+			// throw away anything decoded before the seek, keeping the
+			// buffers
+			music->flac_data.data_read = 0;
+			music->flac_data.overflow_read = 0;
+			music->len_available = 0;
 
 			if (!flac.FLAC__stream_decoder_seek_absolute (music->flac_decoder,
 												(FLAC__uint64)seek_sample)) {
@@ -133,51 +133,82 @@ int OGG_playing(OGG_music *music)
 	return(music->playing);
 }
 
-/* Read some Ogg stream data and convert it for output */
-static void OGG_getsome(OGG_music *music)
+/* The most Ogg stream data decoded at once */
+#define OGG_READ_SIZE	4096
+
+/* Decode up to len bytes of Ogg stream data, setting up the conversion
+   whenever the stream's format changes. Returns the number of bytes.
+ */
+static int OGG_read(OGG_music *music, char *buf, int len)
 {
 	int section;
-	int len;
-	char data[4096];
-	SDL_AudioCVT *cvt;
 
 #ifdef OGG_USE_TREMOR
-	len = vorbis.ov_read(&music->vf, data, sizeof(data), &section);
+	len = vorbis.ov_read(&music->vf, buf, len, &section);
 #else
-	len = vorbis.ov_read(&music->vf, data, sizeof(data), 0, 2, 1, &section);
+	len = vorbis.ov_read(&music->vf, buf, len, 0, 2, 1, &section);
 #endif
 	if ( len <= 0 ) {
 		if ( len == 0 ) {
 			music->playing = 0;
 		}
-		return;
+		return(0);
 	}
-	cvt = &music->cvt;
 	if ( section != music->section ) {
 		vorbis_info *vi;
 
 		vi = vorbis.ov_info(&music->vf, -1);
-		SDL_BuildAudioCVT(cvt, AUDIO_S16MSB, vi->channels, vi->rate,
+		SDL_BuildAudioCVT(&music->cvt, AUDIO_S16MSB, vi->channels, vi->rate,
 		                       mixer.format,mixer.channels,mixer.freq);
-		if ( cvt->buf ) {
-			free(cvt->buf);
-		}
-		cvt->buf = (Uint8 *)malloc(sizeof(data)*cvt->len_mult);
 		music->section = section;
 	}
-	if ( cvt->buf ) {
-		memcpy(cvt->buf, data, len);
-		if ( cvt->needed ) {
-			cvt->len = len;
-			SDL_ConvertAudio(cvt);
-		} else {
-			cvt->len_cvt = len;
+	return(len);
+}
+
+/* Make sure the conversion buffer can convert len bytes in place */
+static int OGG_reserve(OGG_music *music, int len)
+{
+	len *= music->cvt.len_mult > 1 ? music->cvt.len_mult : 1;
+	if ( len > music->buflen ) {
+		Uint8 *buf = (Uint8 *)realloc(music->cvt.buf, len);
+		if ( buf == NULL ) {
+			SDL_SetError("Out of memory");
+			music->playing = 0;
+			return(0);
 		}
-		music->len_available = music->cvt.len_cvt;
-		music->snd_available = music->cvt.buf;
+		music->cvt.buf = buf;
+		music->buflen = len;
+	}
+	return(1);
+}
+
+/* Convert len bytes of Ogg stream data in the conversion buffer for output */
+static void OGG_convert(OGG_music *music, int len)
+{
+	SDL_AudioCVT *cvt = &music->cvt;
+
+	if ( cvt->needed ) {
+		cvt->len = len;
+		SDL_ConvertAudio(cvt);
 	} else {
-		SDL_SetError("Out of memory");
-		music->playing = 0;
+		cvt->len_cvt = len;
+	}
+	music->len_available = cvt->len_cvt;
+	music->snd_available = cvt->buf;
+}
+
+/* Read some Ogg stream data and convert it for output */
+static void OGG_getsome(OGG_music *music)
+{
+	int len;
+
+	if ( !OGG_reserve(music, OGG_READ_SIZE) ) {
+		return;
+	}
+	len = OGG_read(music, (char *)music->cvt.buf, OGG_READ_SIZE);
+	/* A new section can need more room to convert */
+	if ( len > 0 && OGG_reserve(music, len) ) {
+		OGG_convert(music, len);
 	}
 }
 
@@ -188,7 +219,29 @@ int OGG_playAudio(OGG_music *music, Uint8 *snd, int len)
 
 	while ( (len > 0) && music->playing ) {
 		if ( ! music->len_available ) {
-			OGG_getsome(music);
+			/* Decode straight into the silent output if it can be
+			   played as it is */
+			if ( !music->cvt.needed && music->section >= 0 &&
+			     music->volume == MIX_MAX_VOLUME &&
+			     len >= mixer.channels * 2 ) {
+				int got = OGG_read(music, (char *)snd, len);
+				if ( got > 0 && !music->cvt.needed ) {
+					len -= got;
+					snd += got;
+					continue;
+				}
+				/* The format changed, so convert it after all,
+				   leaving silence where it was decoded */
+				if ( got > 0 ) {
+					if ( OGG_reserve(music, got) ) {
+						memcpy(music->cvt.buf, snd, got);
+						OGG_convert(music, got);
+					}
+					memset(snd, mixer.silence, got);
+				}
+			} else {
+				OGG_getsome(music);
+			}
 		}
 		mixable = len;
 		if ( mixable > music->len_available ) {
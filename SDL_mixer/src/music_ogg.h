@@ -38,6 +38,7 @@ typedef struct {
 	OggVorbis_File vf;
 	int section;
 	SDL_AudioCVT cvt;
+	int buflen;		/* The size of cvt.buf, which only ever grows */
 	int len_available;
 	Uint8 *snd_available;
 } OGG_music;
@@ -0,0 +1,154 @@
+/*
+    SDL_mixer:  An audio mixer library based on the SDL library
+    Copyright (C) 1997-2009 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public
+    License along with this library; if not, write to the Free
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/* This file implements the ring that decoded music is passed through from
+   the decode thread to the audio callback */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "SDL_mixer.h"
+#include "music_ring.h"
+
+/* The data has to be in memory before the head says it is there, and read
+   out before the tail gives it back.
+ */
+#ifdef __GNUC__
+#define MUSIC_RING_BARRIER()	__sync_synchronize()
+#else
+#define MUSIC_RING_BARRIER()
+#endif
+
+int MusicRing_Init(MusicRing *ring, int len, int frame)
+{
+	/* One frame always stays empty, so a full ring isn't mistaken for
+	   an empty one */
+	ring->frame = frame;
+	ring->size = ((len + frame - 1) / frame + 1) * frame;
+	ring->buf = (Uint8 *)malloc(ring->size);
+	if ( ring->buf == NULL ) {
+		Mix_SetError("Out of memory");
+		return(-1);
+	}
+	MusicRing_Reset(ring);
+	return(0);
+}
+
+void MusicRing_Free(MusicRing *ring)
+{
+	if ( ring->buf ) {
+		free(ring->buf);
+		ring->buf = NULL;
+	}
+	ring->size = 0;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->ended = 0;
+}
+
+void MusicRing_Reset(MusicRing *ring)
+{
+	ring->head = 0;
+	ring->tail = 0;
+	ring->ended = 0;
+	MUSIC_RING_BARRIER();
+}
+
+int MusicRing_Filled(MusicRing *ring)
+{
+	int filled = ring->head - ring->tail;
+	if ( filled < 0 ) {
+		filled += ring->size;
+	}
+	return(filled);
+}
+
+int MusicRing_Space(MusicRing *ring)
+{
+	return(ring->size - ring->frame - MusicRing_Filled(ring));
+}
+
+Uint8 *MusicRing_WritePtr(MusicRing *ring, int *len)
+{
+	int head = ring->head;
+	int space = MusicRing_Space(ring);
+
+	if ( space > ring->size - head ) {
+		space = ring->size - head;
+	}
+	*len = space;
+	return(ring->buf + head);
+}
+
+void MusicRing_Commit(MusicRing *ring, int len)
+{
+	int head = ring->head + len;
+
+	if ( head >= ring->size ) {
+		head -= ring->size;
+	}
+	MUSIC_RING_BARRIER();
+	ring->head = head;
+}
+
+void MusicRing_End(MusicRing *ring)
+{
+	MUSIC_RING_BARRIER();
+	ring->ended = 1;
+}
+
+int MusicRing_Ended(MusicRing *ring)
+{
+	int ended = ring->ended;
+	MUSIC_RING_BARRIER();
+	return(ended);
+}
+
+Uint8 *MusicRing_ReadPtr(MusicRing *ring, int *len)
+{
+	int tail = ring->tail;
+	int filled = MusicRing_Filled(ring);
+
+	if ( filled > ring->size - tail ) {
+		filled = ring->size - tail;
+	}
+	MUSIC_RING_BARRIER();
+	*len = filled;
+	return(ring->buf + tail);
+}
+
+void MusicRing_Consume(MusicRing *ring, int len)
+{
+	int tail = ring->tail + len;
+
+	if ( tail >= ring->size ) {
+		tail -= ring->size;
+	}
+	MUSIC_RING_BARRIER();
+	ring->tail = tail;
+}
+
+void MusicRing_Drain(MusicRing *ring)
+{
+	MUSIC_RING_BARRIER();
+	ring->tail = ring->head;
+}
@@ -0,0 +1,81 @@
+/*
+    SDL_mixer:  An audio mixer library based on the SDL library
+    Copyright (C) 1997-2009 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public
+    License along with this library; if not, write to the Free
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/* This file implements the ring that decoded music is passed through from
+   the decode thread to the audio callback. There is one writer and one
+   reader, and neither ever waits for the other.
+ */
+
+#include "SDL_types.h"
+
+typedef struct {
+	Uint8 *buf;
+	int size;
+	int frame;		/* reads and writes are whole frames */
+	volatile int head;	/* moved by the writer only */
+	volatile int tail;	/* moved by the reader only */
+	volatile int ended;	/* the writer has nothing more to add */
+} MusicRing;
+
+/* Allocate a ring holding at least len bytes of frame byte frames.
+   This function returns 0, or -1 if there was an error.
+ */
+extern int MusicRing_Init(MusicRing *ring, int len, int frame);
+
+/* Free the ring's buffer */
+extern void MusicRing_Free(MusicRing *ring);
+
+/* Empty the ring. Neither the writer nor the reader may be using it. */
+extern void MusicRing_Reset(MusicRing *ring);
+
+/* The number of bytes waiting to be read */
+extern int MusicRing_Filled(MusicRing *ring);
+
+/* The number of bytes that can be written */
+extern int MusicRing_Space(MusicRing *ring);
+
+/* Writer: return where the next write goes and how many bytes can be
+   written there in one piece
+ */
+extern Uint8 *MusicRing_WritePtr(MusicRing *ring, int *len);
+
+/* Writer: make len bytes written at MusicRing_WritePtr() readable */
+extern void MusicRing_Commit(MusicRing *ring, int len);
+
+/* Writer: note that nothing more will be committed */
+extern void MusicRing_End(MusicRing *ring);
+
+/* Reader: whether the writer is done. Check this before reading, so that
+   everything committed before the end is seen.
+ */
+extern int MusicRing_Ended(MusicRing *ring);
+
+/* Reader: return where the next read comes from and how many bytes can be
+   read there in one piece
+ */
+extern Uint8 *MusicRing_ReadPtr(MusicRing *ring, int *len);
+
+/* Reader: release len bytes read at MusicRing_ReadPtr() */
+extern void MusicRing_Consume(MusicRing *ring, int len);
+
+/* Reader: throw away everything written so far */
+extern void MusicRing_Drain(MusicRing *ring);
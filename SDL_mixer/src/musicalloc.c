@@ -0,0 +1,772 @@
+/*
+    MUSICALLOC:  A test of heap use while playing music with SDL_mixer.
+    Copyright (C) 1997-2009 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public
+    License along with this library; if not, write to the Free
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/*
+ * Plays music and counts every malloc, realloc and free made once playback
+ *  has warmed up, which must be none. A WAV that needs no conversion, a
+ *  WAV that does, a MOD and a MIDI file are made in memory, an Ogg Vorbis
+ *  file that needs converting is built in, and any music files given on
+ *  the command line (MP3, ...) are played too. Each is
+ *  played decoded in the audio callback at full and half volume, and
+ *  decoded ahead. MIDI needs Timidity's timidity.cfg and instrument
+ *  patches, and is skipped without them. Counting replaces malloc, so it
+ *  needs glibc. Set SDL_AUDIODRIVER=dummy to run without sound hardware.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "SDL_mixer.h"
+
+#define WARMUP_CALLBACKS	8
+#define COUNTED_CALLBACKS	24
+#define WAV_SECONDS		2
+
+static volatile int counting;
+static volatile int allocations;
+static volatile int callbacks;
+
+#ifdef __GLIBC__
+#define COUNTING_ALLOCATIONS
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+void *malloc(size_t size)
+{
+	if ( counting ) {
+		__sync_fetch_and_add(&allocations, 1);
+	}
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+	if ( counting ) {
+		__sync_fetch_and_add(&allocations, 1);
+	}
+	return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	if ( counting ) {
+		__sync_fetch_and_add(&allocations, 1);
+	}
+	return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+	if ( counting && ptr ) {
+		__sync_fetch_and_add(&allocations, 1);
+	}
+	__libc_free(ptr);
+}
+#endif
+
+/* Count the heap calls over some callbacks, once the music has warmed up */
+static void countingPostMix(void *udata, Uint8 *stream, int len)
+{
+	++callbacks;
+	if ( callbacks == WARMUP_CALLBACKS ) {
+		counting = 1;
+	} else if ( callbacks == WARMUP_CALLBACKS + COUNTED_CALLBACKS ) {
+		counting = 0;
+	}
+}
+
+static void put16(Uint8 *p, Uint16 v)
+{
+	p[0] = v & 0xFF;
+	p[1] = (v >> 8) & 0xFF;
+}
+
+static void put32(Uint8 *p, Uint32 v)
+{
+	p[0] = v & 0xFF;
+	p[1] = (v >> 8) & 0xFF;
+	p[2] = (v >> 16) & 0xFF;
+	p[3] = (v >> 24) & 0xFF;
+}
+
+/* A 16-bit stereo WAV of noise */
+static Uint8 *make_wav(int rate, int *len)
+{
+	int samples = rate * WAV_SECONDS * 2;
+	Uint8 *wav = (Uint8 *)malloc(44 + samples * 2);
+	int i;
+
+	*len = 44 + samples * 2;
+	memcpy(wav, "RIFF", 4);
+	put32(wav + 4, *len - 8);
+	memcpy(wav + 8, "WAVEfmt ", 8);
+	put32(wav + 16, 16);
+	put16(wav + 20, 1);			/* PCM */
+	put16(wav + 22, 2);			/* stereo */
+	put32(wav + 24, rate);
+	put32(wav + 28, rate * 4);
+	put16(wav + 32, 4);
+	put16(wav + 34, 16);
+	memcpy(wav + 36, "data", 4);
+	put32(wav + 40, samples * 2);
+	for (i = 0; i < samples; i++) {
+		put16(wav + 44 + i * 2, (Uint16)(rand() % 16384));
+	}
+	return wav;
+}
+
+/* A one pattern, four channel ProTracker module playing a looped saw wave */
+static Uint8 *make_mod(int *len)
+{
+	static const int periods[4] = { 428, 339, 285, 214 };
+	const int sample_len = 128;
+	Uint8 *mod, *cell;
+	int row, chan, i;
+
+	*len = 1084 + 64 * 4 * 4 + sample_len;
+	mod = (Uint8 *)malloc(*len);
+	memset(mod, 0, *len);
+	memcpy(mod, "musicalloc", 10);
+
+	/* Sample 1, looped from start to end. Lengths are in big-endian words. */
+	mod[20 + 22] = (sample_len / 2) >> 8;
+	mod[20 + 23] = (sample_len / 2) & 0xFF;
+	mod[20 + 25] = 64;			/* volume */
+	mod[20 + 28] = (sample_len / 2) >> 8;
+	mod[20 + 29] = (sample_len / 2) & 0xFF;
+
+	mod[950] = 1;				/* song length */
+	mod[951] = 127;
+	memcpy(mod + 1080, "M.K.", 4);
+
+	for (row = 0; row < 64; row += 4) {
+		for (chan = 0; chan < 4; chan++) {
+			int period = periods[(row / 4 + chan) % 4];
+			cell = mod + 1084 + (row * 4 + chan) * 4;
+			cell[0] = period >> 8;
+			cell[1] = period & 0xFF;
+			cell[2] = 1 << 4;		/* sample 1 */
+		}
+	}
+
+	for (i = 0; i < sample_len; i++) {
+		mod[1084 + 64 * 4 * 4 + i] = (Uint8)(i * 2 - 128);
+	}
+	return mod;
+}
+
+/* A format 0 MIDI file playing eight eighth notes on a piano, 2 seconds long */
+static Uint8 *make_mid(int *len)
+{
+	static const Uint8 header[] = {
+		'M', 'T', 'h', 'd', 0, 0, 0, 6,
+		0, 0,				/* format 0 */
+		0, 1,				/* one track */
+		0, 96				/* ticks a quarter note, at 120 bpm */
+	};
+	static const Uint8 notes[8] = { 60, 64, 67, 72, 67, 64, 60, 48 };
+	Uint8 *mid, *track, *p;
+	int i, track_len;
+
+	mid = (Uint8 *)malloc(sizeof(header) + 8 + 3 + 8 * 8 + 4);
+	memcpy(mid, header, sizeof(header));
+	track = mid + sizeof(header) + 8;
+
+	p = track;
+	*p++ = 0; *p++ = 0xC0; *p++ = 0;	/* piano */
+	for (i = 0; i < 8; i++) {
+		*p++ = 0; *p++ = 0x90; *p++ = notes[i]; *p++ = 100;
+		*p++ = 48; *p++ = 0x80; *p++ = notes[i]; *p++ = 0;
+	}
+	*p++ = 0; *p++ = 0xFF; *p++ = 0x2F; *p++ = 0;	/* end of track */
+
+	/* Chunk lengths are big-endian */
+	track_len = p - track;
+	memcpy(track - 8, "MTrk", 4);
+	track[-4] = (track_len >> 24) & 0xFF;
+	track[-3] = (track_len >> 16) & 0xFF;
+	track[-2] = (track_len >> 8) & 0xFF;
+	track[-1] = track_len & 0xFF;
+	*len = p - mid;
+	return mid;
+}
+
+#ifdef OGG_MUSIC
+/* A 1.5 second, 440 Hz tone in 22050 Hz mono Ogg Vorbis */
+static const Uint8 ogg_tone[] = {
+	0x4f, 0x67, 0x67, 0x53, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0xd4, 0x71, 0xf0, 0x47, 0x00, 0x00, 0x00, 0x00, 0x53, 0xe1,
+	0xb8, 0x5c, 0x01, 0x1e, 0x01, 0x76, 0x6f, 0x72, 0x62, 0x69, 0x73, 0x00,
+	0x00, 0x00, 0x00, 0x01, 0x22, 0x56, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0xc0, 0x5d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xaa, 0x01, 0x4f, 0x67,
+	0x67, 0x53, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0xd4, 0x71, 0xf0, 0x47, 0x01, 0x00, 0x00, 0x00, 0xc0, 0xc9, 0x9b, 0xe3,
+	0x0e, 0x5a, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0x9a, 0x03, 0x76, 0x6f, 0x72, 0x62, 0x69, 0x73, 0x34, 0x00,
+	0x00, 0x00, 0x58, 0x69, 0x70, 0x68, 0x2e, 0x4f, 0x72, 0x67, 0x20, 0x6c,
+	0x69, 0x62, 0x56, 0x6f, 0x72, 0x62, 0x69, 0x73, 0x20, 0x49, 0x20, 0x32,
+	0x30, 0x32, 0x30, 0x30, 0x37, 0x30, 0x34, 0x20, 0x28, 0x52, 0x65, 0x64,
+	0x75, 0x63, 0x69, 0x6e, 0x67, 0x20, 0x45, 0x6e, 0x76, 0x69, 0x72, 0x6f,
+	0x6e, 0x6d, 0x65, 0x6e, 0x74, 0x29, 0x01, 0x00, 0x00, 0x00, 0x12, 0x00,
+	0x00, 0x00, 0x45, 0x4e, 0x43, 0x4f, 0x44, 0x45, 0x52, 0x3d, 0x6c, 0x69,
+	0x62, 0x73, 0x6e, 0x64, 0x66, 0x69, 0x6c, 0x65, 0x01, 0x05, 0x76, 0x6f,
+	0x72, 0x62, 0x69, 0x73, 0x22, 0x42, 0x43, 0x56, 0x01, 0x00, 0x08, 0x00,
+	0x00, 0x80, 0x20, 0x0a, 0x19, 0xc6, 0x80, 0xd0, 0x90, 0x55, 0x00, 0x00,
+	0x10, 0x00, 0x00, 0x42, 0x88, 0x46, 0xc6, 0x50, 0xa7, 0x94, 0x04, 0x97,
+	0x82, 0x85, 0x10, 0x47, 0xc4, 0x50, 0x87, 0x90, 0xf3, 0x50, 0x6a, 0xe9,
+	0x20, 0x78, 0x4a, 0x61, 0xc9, 0x98, 0xf4, 0x14, 0x6b, 0x10, 0x42, 0x08,
+	0xdf, 0x7b, 0xcf, 0xbd, 0xf7, 0xde, 0x7b, 0x20, 0x34, 0x64, 0x15, 0x00,
+	0x00, 0x04, 0x00, 0x40, 0x18, 0x05, 0x0e, 0x62, 0xe0, 0x31, 0x09, 0x42,
+	0x08, 0xa1, 0x18, 0xc5, 0x09, 0x51, 0x9c, 0x29, 0x08, 0x42, 0x08, 0x61,
+	0x39, 0x09, 0x96, 0x72, 0x1e, 0x3a, 0x09, 0x42, 0xf7, 0x20, 0x84, 0x10,
+	0x2e, 0xe7, 0xde, 0x72, 0xee, 0xbd, 0xf7, 0x1e, 0x08, 0x0d, 0x59, 0x05,
+	0x00, 0x00, 0x02, 0x00, 0x30, 0x08, 0x21, 0x84, 0x10, 0x42, 0x08, 0x21,
+	0x84, 0x10, 0x42, 0x0a, 0x29, 0xa5, 0x14, 0x52, 0x8a, 0x29, 0xa6, 0x98,
+	0x62, 0xca, 0x31, 0xc7, 0x1c, 0x73, 0xcc, 0x31, 0xc8, 0x20, 0x83, 0x0c,
+	0x3a, 0xe8, 0xa4, 0x93, 0x4e, 0x32, 0xa9, 0xa4, 0x93, 0x8e, 0x32, 0xc9,
+	0xa8, 0xa3, 0xd4, 0x5a, 0x4a, 0x2d, 0xc5, 0x14, 0x53, 0x6c, 0xb9, 0xc5,
+	0x58, 0x6b, 0xad, 0x35, 0xe7, 0xdc, 0x6b, 0x50, 0xca, 0x18, 0x63, 0x8c,
+	0x31, 0xc6, 0x18, 0x63, 0x8c, 0x31, 0xc6, 0x18, 0x63, 0x8c, 0x31, 0xc6,
+	0x08, 0x42, 0x43, 0x56, 0x01, 0x00, 0x20, 0x00, 0x00, 0x84, 0x41, 0x06,
+	0x19, 0x64, 0x10, 0x42, 0x08, 0x21, 0x85, 0x14, 0x52, 0x8a, 0x29, 0xa6,
+	0x1c, 0x73, 0xcc, 0x31, 0xc7, 0x80, 0xd0, 0x90, 0x55, 0x00, 0x00, 0x20,
+	0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x47, 0x91, 0x14, 0xc9, 0x91, 0x1c,
+	0xc9, 0x91, 0x24, 0x49, 0xb2, 0x24, 0x4b, 0xd2, 0x24, 0xcf, 0xf2, 0x2c,
+	0xcf, 0xf2, 0x2c, 0x4f, 0x13, 0x35, 0x51, 0x53, 0x45, 0x55, 0x75, 0x55,
+	0xdb, 0xb5, 0x7d, 0xdb, 0x97, 0x7d, 0xdb, 0x77, 0x75, 0xd9, 0xb7, 0x7d,
+	0xd9, 0x76, 0x75, 0x59, 0x97, 0x65, 0x59, 0x77, 0x6d, 0x5b, 0x97, 0x75,
+	0x57, 0xd7, 0x75, 0x5d, 0xd7, 0x75, 0x5d, 0xd7, 0x75, 0x5d, 0xd7, 0x75,
+	0x5d, 0xd7, 0x75, 0x5d, 0xd7, 0x75, 0x20, 0x34, 0x64, 0x15, 0x00, 0x20,
+	0x01, 0x00, 0xa0, 0x23, 0x39, 0x8e, 0x23, 0x39, 0x8e, 0x23, 0x39, 0x92,
+	0x23, 0x29, 0x92, 0x02, 0x84, 0x86, 0xac, 0x02, 0x00, 0x64, 0x00, 0x00,
+	0x04, 0x00, 0xe0, 0x28, 0x8e, 0xe2, 0x38, 0x92, 0x23, 0x39, 0x96, 0x63,
+	0x49, 0x96, 0xa4, 0x49, 0x9a, 0xe5, 0x59, 0x9e, 0xe5, 0x69, 0x9e, 0x26,
+	0x6a, 0xa2, 0x07, 0x84, 0x86, 0xac, 0x02, 0x00, 0x00, 0x01, 0x00, 0x04,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0xa0, 0x28, 0x8a, 0xe2, 0x28, 0x8e, 0x23,
+	0x49, 0x96, 0xa5, 0x69, 0x9a, 0xe7, 0xa9, 0x9e, 0x28, 0x8a, 0xa6, 0xaa,
+	0xaa, 0xa2, 0x69, 0xaa, 0xaa, 0xaa, 0x9a, 0xa6, 0x69, 0x9a, 0xa6, 0x69,
+	0x9a, 0xa6, 0x69, 0x9a, 0xa6, 0x69, 0x9a, 0xa6, 0x69, 0x9a, 0xa6, 0x69,
+	0x9a, 0xa6, 0x69, 0x9a, 0xa6, 0x69, 0x9a, 0xa6, 0x69, 0x9a, 0xa6, 0x69,
+	0x9a, 0xa6, 0x69, 0x9a, 0x40, 0x68, 0xc8, 0x2a, 0x00, 0x40, 0x02, 0x00,
+	0x40, 0xc7, 0x71, 0x1c, 0xc7, 0x51, 0x1c, 0xc7, 0x71, 0x1c, 0xc9, 0x91,
+	0x24, 0x09, 0x08, 0x0d, 0x59, 0x05, 0x00, 0xc8, 0x00, 0x00, 0x08, 0x00,
+	0xc0, 0x50, 0x14, 0x47, 0x91, 0x1c, 0xcb, 0xb1, 0x24, 0xcd, 0xd2, 0x2c,
+	0xcf, 0xf2, 0x34, 0xd1, 0x33, 0x3d, 0x57, 0x94, 0x4d, 0xdd, 0xd4, 0x55,
+	0x1b, 0x08, 0x0d, 0x59, 0x05, 0x00, 0x00, 0x02, 0x00, 0x08, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0xc0, 0xf1, 0x1c, 0xcf, 0xf1, 0x1c, 0x4f, 0xf2, 0x24,
+	0xcf, 0xf2, 0x1c, 0xcf, 0xf1, 0x24, 0x4f, 0xd2, 0x34, 0x4d, 0xd3, 0x34,
+	0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34,
+	0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34,
+	0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34,
+	0x4d, 0xd3, 0x80, 0xd0, 0x90, 0x55, 0x00, 0x00, 0x02, 0x00, 0x00, 0x20,
+	0x88, 0x42, 0x86, 0x31, 0x20, 0x34, 0x64, 0x15, 0x00, 0x00, 0x04, 0x00,
+	0x80, 0x10, 0xa2, 0x91, 0x31, 0xd4, 0x29, 0x25, 0xc1, 0xa5, 0x60, 0x21,
+	0xc4, 0x11, 0x31, 0xd4, 0x21, 0xe4, 0x3c, 0x94, 0x5a, 0x3a, 0x08, 0x9e,
+	0x52, 0x58, 0x32, 0x26, 0x3d, 0xc5, 0x1a, 0x84, 0x10, 0xc2, 0xf7, 0xde,
+	0x73, 0xef, 0xbd, 0xf7, 0x1e, 0x08, 0x0d, 0x59, 0x05, 0x00, 0x00, 0x01,
+	0x00, 0x10, 0x46, 0x81, 0x83, 0x18, 0x78, 0x4c, 0x82, 0x10, 0x42, 0x28,
+	0x46, 0x71, 0x42, 0x14, 0x67, 0x0a, 0x82, 0x10, 0x42, 0x58, 0x4e, 0x82,
+	0xa5, 0x9c, 0x87, 0x4e, 0x82, 0xd0, 0x3d, 0x08, 0x21, 0x84, 0xcb, 0xb9,
+	0xb7, 0x9c, 0x7b, 0xef, 0xbd, 0x07, 0x42, 0x43, 0x56, 0x01, 0x00, 0x80,
+	0x00, 0x00, 0x0c, 0x42, 0x08, 0x21, 0x84, 0x10, 0x42, 0x08, 0x21, 0x84,
+	0x90, 0x42, 0x4a, 0x29, 0x85, 0x94, 0x62, 0x8a, 0x29, 0xa6, 0x98, 0x72,
+	0xcc, 0x31, 0xc7, 0x1c, 0x73, 0x0c, 0x32, 0xc8, 0x20, 0x83, 0x0e, 0x3a,
+	0xe9, 0xa4, 0x93, 0x4c, 0x2a, 0xe9, 0xa4, 0xa3, 0x4c, 0x32, 0xea, 0x28,
+	0xb5, 0x96, 0x52, 0x4b, 0x31, 0xc5, 0x14, 0x5b, 0x6e, 0x31, 0xd6, 0x5a,
+	0x6b, 0xcd, 0x39, 0xf7, 0x1a, 0x94, 0x32, 0xc6, 0x18, 0x63, 0x8c, 0x31,
+	0xc6, 0x18, 0x63, 0x8c, 0x31, 0xc6, 0x18, 0x63, 0x8c, 0x31, 0x82, 0xd0,
+	0x90, 0x55, 0x00, 0x00, 0x08, 0x00, 0x00, 0x61, 0x90, 0x41, 0x06, 0x19,
+	0x84, 0x10, 0x42, 0x48, 0x21, 0x85, 0x94, 0x62, 0x8a, 0x29, 0xc7, 0x1c,
+	0x73, 0xcc, 0x31, 0x20, 0x34, 0x64, 0x15, 0x00, 0x00, 0x08, 0x00, 0x20,
+	0x00, 0x00, 0x00, 0xc0, 0x51, 0x24, 0x45, 0x72, 0x24, 0x47, 0x72, 0x24,
+	0x49, 0x92, 0x2c, 0xc9, 0x92, 0x34, 0xc9, 0xb3, 0x3c, 0xcb, 0xb3, 0x3c,
+	0xcb, 0xd3, 0x44, 0x4d, 0xd4, 0x54, 0x51, 0x55, 0x5d, 0xd5, 0x76, 0x6d,
+	0xdf, 0xf6, 0x65, 0xdf, 0xf6, 0x5d, 0x5d, 0xf6, 0x6d, 0x5f, 0xb6, 0x5d,
+	0x5d, 0xd6, 0x65, 0x59, 0xd6, 0x5d, 0xdb, 0xd6, 0x65, 0xdd, 0xd5, 0x75,
+	0x5d, 0xd7, 0x75, 0x5d, 0xd7, 0x75, 0x5d, 0xd7, 0x75, 0x5d, 0xd7, 0x75,
+	0x5d, 0xd7, 0x75, 0x1d, 0x08, 0x0d, 0x59, 0x05, 0x00, 0x48, 0x00, 0x00,
+	0xe8, 0x48, 0x8e, 0xe3, 0x48, 0x8e, 0xe3, 0x48, 0x8e, 0xe4, 0x48, 0x8a,
+	0xa4, 0x00, 0xa1, 0x21, 0xab, 0x00, 0x00, 0x19, 0x00, 0x00, 0x01, 0x00,
+	0x38, 0x8a, 0xa3, 0x38, 0x8e, 0xe4, 0x48, 0x8e, 0xe5, 0x58, 0x92, 0x25,
+	0x69, 0x92, 0x66, 0x79, 0x96, 0x67, 0x79, 0x9a, 0xa7, 0x89, 0x9a, 0xe8,
+	0x01, 0xa1, 0x21, 0xab, 0x00, 0x00, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x28, 0x8a, 0xa2, 0x38, 0x8a, 0xe3, 0x48, 0x92, 0x65,
+	0x69, 0x9a, 0xe6, 0x79, 0xaa, 0x27, 0x8a, 0xa2, 0xa9, 0xaa, 0xaa, 0x68,
+	0x9a, 0xaa, 0xaa, 0xaa, 0xa6, 0x69, 0x9a, 0xa6, 0x69, 0x9a, 0xa6, 0x69,
+	0x9a, 0xa6, 0x69, 0x9a, 0xa6, 0x69, 0x9a, 0xa6, 0x69, 0x9a, 0xa6, 0x69,
+	0x9a, 0xa6, 0x69, 0x9a, 0xa6, 0x69, 0x9a, 0xa6, 0x69, 0x9a, 0xa6, 0x69,
+	0x9a, 0x26, 0x10, 0x1a, 0xb2, 0x0a, 0x00, 0x90, 0x00, 0x00, 0xd0, 0x71,
+	0x1c, 0xc7, 0x71, 0x14, 0xc7, 0x71, 0x1c, 0x47, 0x72, 0x24, 0x49, 0x02,
+	0x42, 0x43, 0x56, 0x01, 0x00, 0x32, 0x00, 0x00, 0x02, 0x00, 0x30, 0x14,
+	0xc5, 0x51, 0x24, 0xc7, 0x72, 0x2c, 0x49, 0xb3, 0x34, 0xcb, 0xb3, 0x3c,
+	0x4d, 0xf4, 0x4c, 0xcf, 0x15, 0x65, 0x53, 0x37, 0x75, 0xd5, 0x06, 0x42,
+	0x43, 0x56, 0x01, 0x00, 0x80, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x70, 0x3c, 0xc7, 0x73, 0x3c, 0xc7, 0x93, 0x3c, 0xc9, 0xb3, 0x3c,
+	0xc7, 0x73, 0x3c, 0xc9, 0x93, 0x34, 0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34,
+	0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34,
+	0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34,
+	0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34, 0x4d, 0xd3, 0x34,
+	0x20, 0x34, 0x64, 0x25, 0x00, 0x00, 0x04, 0x00, 0x80, 0x20, 0xc7, 0xb4,
+	0x83, 0x24, 0x09, 0x84, 0xa0, 0x82, 0xe4, 0x19, 0xc4, 0x1c, 0xc4, 0xa4,
+	0x19, 0x85, 0xa0, 0x82, 0xe4, 0x3a, 0x06, 0x25, 0xc5, 0xe4, 0x21, 0xa7,
+	0xa0, 0x62, 0xe4, 0x39, 0xc9, 0x98, 0x41, 0xe4, 0x82, 0xd2, 0x45, 0xa6,
+	0x22, 0x08, 0x0d, 0x59, 0x11, 0x00, 0x44, 0x01, 0x00, 0x00, 0xc6, 0x20,
+	0xc6, 0x10, 0x73, 0xc8, 0x39, 0x27, 0xa5, 0x93, 0x14, 0x39, 0xe7, 0xa4,
+	0x74, 0x52, 0x1a, 0x08, 0xa1, 0xa5, 0x8e, 0x52, 0x67, 0xa9, 0xb4, 0x5a,
+	0x62, 0xcc, 0x28, 0x95, 0xda, 0x52, 0xad, 0x0d, 0x84, 0x8e, 0x52, 0x48,
+	0x2d, 0xa3, 0x54, 0x62, 0x2d, 0xad, 0x76, 0xd4, 0x4a, 0xad, 0x25, 0xb6,
+	0x02, 0x00, 0x00, 0x02, 0x1c, 0x00, 0x00, 0x02, 0x2c, 0x84, 0x42, 0x43,
+	0x56, 0x04, 0x00, 0x51, 0x00, 0x00, 0x84, 0x31, 0x48, 0x29, 0xa4, 0x14,
+	0x62, 0x8c, 0x39, 0xc8, 0x1c, 0x44, 0x8c, 0x31, 0xe8, 0x18, 0x64, 0x86,
+	0x31, 0x06, 0x21, 0x73, 0x4e, 0x41, 0xc7, 0x1c, 0x85, 0x54, 0x2a, 0x07,
+	0x1d, 0x75, 0x50, 0x52, 0xc3, 0x18, 0x73, 0x8e, 0x41, 0xa8, 0xa0, 0x83,
+	0x54, 0x3a, 0x47, 0x95, 0x83, 0x50, 0x52, 0x47, 0x9d, 0x00, 0x00, 0x80,
+	0x00, 0x07, 0x00, 0x80, 0x00, 0x0b, 0xa1, 0xd0, 0x90, 0x15, 0x01, 0x40,
+	0x9c, 0x00, 0x80, 0x41, 0x92, 0x34, 0xcd, 0xd2, 0x34, 0xcf, 0xb3, 0x34,
+	0xcf, 0xf3, 0x3c, 0x51, 0x54, 0x55, 0x4f, 0x14, 0x55, 0xd5, 0x12, 0x3d,
+	0xd3, 0xf4, 0x4c, 0x53, 0x55, 0x3d, 0xd3, 0x54, 0x55, 0x53, 0x35, 0x65,
+	0x57, 0x54, 0x4d, 0x59, 0xb6, 0x3c, 0xd1, 0x34, 0x3d, 0xd3, 0x54, 0x55,
+	0xcf, 0x34, 0x55, 0x55, 0x34, 0x55, 0xd9, 0x35, 0x4d, 0xd5, 0x75, 0x3d,
+	0x55, 0xb5, 0x65, 0xd3, 0x55, 0x75, 0x59, 0x74, 0x55, 0xdd, 0x76, 0x6d,
+	0xd9, 0xb7, 0x5d, 0x59, 0x16, 0x6e, 0x4f, 0x55, 0x65, 0x5b, 0x54, 0x5d,
+	0x5b, 0x37, 0x55, 0x57, 0xd6, 0x55, 0x59, 0xb6, 0x7d, 0x57, 0xb6, 0x6d,
+	0x5f, 0x12, 0x45, 0x55, 0x15, 0x55, 0xd5, 0x75, 0x3d, 0x55, 0x75, 0x5d,
+	0xd5, 0x75, 0x75, 0xdb, 0x74, 0x5d, 0x5d, 0xf7, 0x54, 0x55, 0x76, 0x4d,
+	0xd7, 0x95, 0x65, 0xd3, 0x75, 0x6d, 0xd9, 0x75, 0x65, 0x5b, 0x57, 0x65,
+	0x59, 0xf8, 0x35, 0x55, 0x95, 0x65, 0xd3, 0x75, 0x6d, 0xd9, 0x74, 0x5d,
+	0xd9, 0x76, 0x65, 0x57, 0xb7, 0x55, 0x59, 0xd6, 0x6d, 0xd1, 0x75, 0x7d,
+	0x5d, 0x95, 0x65, 0xe1, 0x37, 0x65, 0xd9, 0xf7, 0x65, 0x5b, 0xd7, 0x7d,
+	0x59, 0xb7, 0x95, 0x61, 0x74, 0x5d, 0xdb, 0x57, 0x65, 0x59, 0xf7, 0x4d,
+	0x59, 0x16, 0x7e, 0xd9, 0x96, 0x85, 0xdd, 0xd5, 0x75, 0x5f, 0x98, 0x44,
+	0x51, 0x55, 0x3d, 0x55, 0x95, 0x5d, 0x51, 0x55, 0x5d, 0xd7, 0x74, 0x5d,
+	0x5b, 0x57, 0x5d, 0xd7, 0xb6, 0x35, 0xd5, 0x94, 0x5d, 0xd3, 0x75, 0x6d,
+	0xd9, 0x54, 0x5d, 0x59, 0x56, 0x65, 0x59, 0xf7, 0x5d, 0x57, 0xd6, 0x75,
+	0x4d, 0x55, 0x65, 0xd9, 0x94, 0x65, 0xdb, 0x36, 0x5d, 0x57, 0x96, 0x55,
+	0x59, 0xf6, 0x75, 0x57, 0x96, 0x75, 0x5b, 0x74, 0x5d, 0x5d, 0x37, 0x65,
+	0x59, 0xf8, 0x55, 0x57, 0xd6, 0x75, 0x57, 0xb7, 0x8d, 0x63, 0xb6, 0x6d,
+	0x5f, 0x18, 0x5d, 0x57, 0xf7, 0x4d, 0x59, 0xd6, 0x7d, 0x55, 0x96, 0x75,
+	0x5f, 0xd6, 0x75, 0x61, 0x98, 0x75, 0xdb, 0xd7, 0x35, 0x55, 0xd5, 0x7d,
+	0x53, 0x76, 0x7d, 0xe1, 0x74, 0x65, 0x5d, 0xd8, 0x7d, 0xdf, 0x18, 0x66,
+	0x5d, 0x17, 0x8e, 0xcf, 0x75, 0x7d, 0x5f, 0x95, 0x6d, 0xe1, 0x58, 0x65,
+	0xd9, 0xf8, 0x75, 0xe1, 0x17, 0x96, 0x5b, 0xd7, 0x85, 0xdf, 0x73, 0x5d,
+	0x5f, 0x57, 0x6d, 0xd9, 0x18, 0x56, 0xd9, 0x36, 0x86, 0xdd, 0xf7, 0x8d,
+	0x61, 0xf6, 0x7d, 0xe3, 0x58, 0x75, 0xdb, 0x18, 0x66, 0x5b, 0x37, 0xba,
+	0xba, 0x4e, 0x18, 0x7e, 0x61, 0x38, 0x6e, 0xdf, 0x38, 0xaa, 0xb6, 0x2d,
+	0x74, 0x75, 0x5b, 0x58, 0x5e, 0xdd, 0x36, 0xea, 0xc6, 0x4f, 0xb8, 0x8d,
+	0xdf, 0xa8, 0xa9, 0xaa, 0xaf, 0x9b, 0xae, 0x6b, 0xfc, 0xa6, 0x2c, 0xfb,
+	0xba, 0xac, 0xdb, 0xc2, 0x70, 0xfb, 0xbe, 0x72, 0x7c, 0xae, 0xeb, 0xfb,
+	0xaa, 0x2c, 0x1b, 0xbf, 0x2a, 0xdb, 0xc2, 0x6f, 0xeb, 0xba, 0x72, 0xec,
+	0xbe, 0x4f, 0xf9, 0x5c, 0xd7, 0x17, 0x56, 0x59, 0x16, 0x86, 0xd5, 0x96,
+	0x85, 0x61, 0xd6, 0x75, 0x61, 0xd9, 0x85, 0x61, 0xa9, 0xda, 0xba, 0x32,
+	0xbc, 0xba, 0x6f, 0x1c, 0xaf, 0xad, 0x2b, 0xc3, 0xed, 0x0b, 0x8d, 0xdf,
+	0x57, 0x86, 0xaa, 0x6d, 0x1b, 0xcb, 0xab, 0xdb, 0xc2, 0x30, 0xfb, 0xb6,
+	0xf0, 0xdb, 0xc2, 0x6f, 0x1c, 0xbb, 0xb1, 0x33, 0x06, 0x00, 0x00, 0x0c,
+	0x38, 0x00, 0x00, 0x04, 0x98, 0x50, 0x06, 0x0a, 0x0d, 0x59, 0x11, 0x00,
+	0xc4, 0x09, 0x00, 0x58, 0x24, 0xc9, 0xf3, 0x2c, 0xcb, 0x12, 0x45, 0xcb,
+	0xb2, 0x44, 0x51, 0x34, 0x45, 0x55, 0x15, 0x45, 0x51, 0x55, 0x2d, 0x4d,
+	0x33, 0x4d, 0x4d, 0xf3, 0x4c, 0x53, 0xd3, 0x3c, 0xd3, 0x34, 0x4d, 0x53,
+	0x75, 0x45, 0xd3, 0x54, 0x5d, 0x4b, 0xd3, 0x4c, 0x53, 0xf3, 0x34, 0xd3,
+	0xd4, 0x3c, 0xcd, 0x34, 0x4d, 0xd5, 0x74, 0x55, 0xd3, 0x34, 0x65, 0x53,
+	0x34, 0x4d, 0xd7, 0x35, 0x55, 0xd3, 0x76, 0x45, 0x55, 0x95, 0x65, 0xd5,
+	0x95, 0x65, 0x59, 0x75, 0x5d, 0x5d, 0x16, 0x4d, 0xd3, 0x95, 0x45, 0xd5,
+	0x74, 0x65, 0xd3, 0x54, 0x5d, 0x59, 0x75, 0x5d, 0x57, 0x56, 0x5d, 0x57,
+	0x96, 0x25, 0x4d, 0x33, 0x4d, 0xcd, 0xf3, 0x4c, 0x53, 0xf3, 0x3c, 0xd3,
+	0x34, 0x55, 0xd3, 0x95, 0x4d, 0x53, 0x75, 0x5d, 0xcb, 0xf3, 0x54, 0x53,
+	0xf3, 0x44, 0xd3, 0xf5, 0x44, 0x51, 0x55, 0x55, 0x53, 0x55, 0x5d, 0x53,
+	0x55, 0x65, 0x57, 0xf3, 0x3c, 0x53, 0xf5, 0x44, 0x4f, 0x35, 0x3d, 0x51,
+	0x54, 0x55, 0xd3, 0x35, 0x65, 0xd5, 0x54, 0x55, 0x59, 0x36, 0x55, 0xd3,
+	0x96, 0x4d, 0x53, 0x95, 0x65, 0xd3, 0x55, 0x6d, 0xd9, 0x55, 0x65, 0x57,
+	0x96, 0x5d, 0xd9, 0xb6, 0x4d, 0x55, 0x95, 0x65, 0x53, 0x35, 0x5d, 0xd9,
+	0x74, 0x5d, 0xd7, 0x76, 0x5d, 0xd7, 0x76, 0x5d, 0xd9, 0x15, 0x76, 0x49,
+	0xd3, 0x4c, 0x53, 0xf3, 0x3c, 0xd3, 0xd4, 0x3c, 0x4f, 0x35, 0x4d, 0x53,
+	0x75, 0x5d, 0x53, 0x55, 0x5d, 0xd9, 0xf2, 0x3c, 0xd5, 0xf4, 0x44, 0x51,
+	0x55, 0x35, 0x4f, 0x34, 0x55, 0x55, 0x55, 0x5d, 0xd7, 0x34, 0x55, 0x57,
+	0xb6, 0x3c, 0xcf, 0x54, 0x3d, 0x51, 0x54, 0x55, 0x4d, 0xd4, 0x54, 0xd3,
+	0x74, 0x5d, 0x59, 0x56, 0x55, 0x53, 0x56, 0x45, 0xd5, 0xb4, 0x65, 0x55,
+	0x55, 0x75, 0xd9, 0x34, 0x55, 0x59, 0x76, 0x65, 0xd9, 0xb6, 0x5d, 0xd5,
+	0x75, 0x65, 0x53, 0x55, 0x5d, 0xd9, 0x54, 0x5d, 0x59, 0x36, 0x55, 0x53,
+	0x76, 0x5d, 0x57, 0xb6, 0xb9, 0xb2, 0x2a, 0xab, 0x9e, 0x69, 0xca, 0xb2,
+	0xa9, 0xaa, 0xb6, 0x6c, 0xaa, 0xaa, 0xec, 0xca, 0xb6, 0x6d, 0xeb, 0xae,
+	0xeb, 0xea, 0xb6, 0xa8, 0x9a, 0xb2, 0x6b, 0x9a, 0xaa, 0x6c, 0xab, 0xaa,
+	0xaa, 0xbb, 0xb2, 0x6b, 0xeb, 0xbe, 0x2c, 0xcb, 0xb6, 0x2c, 0xaa, 0xaa,
+	0xeb, 0x9a, 0xae, 0x2a, 0xcb, 0xa6, 0xaa, 0xca, 0xb6, 0x2c, 0xcb, 0xba,
+	0x2e, 0xcb, 0xb6, 0xb0, 0xab, 0xae, 0x6b, 0xdb, 0xa6, 0xea, 0xca, 0xba,
+	0x2b, 0xcb, 0x74, 0x59, 0xb5, 0x5d, 0xdf, 0xf6, 0x6d, 0xba, 0xea, 0xba,
+	0xb6, 0xaf, 0xca, 0xae, 0xaf, 0xbb, 0xb2, 0x6c, 0xeb, 0xae, 0xed, 0xea,
+	0xb2, 0x6e, 0xdb, 0xbe, 0xef, 0x99, 0xa6, 0x2c, 0x9b, 0xaa, 0x29, 0xdb,
+	0xa6, 0xaa, 0xca, 0xb2, 0x2c, 0xbb, 0xb6, 0x6d, 0xcb, 0xb2, 0x2f, 0x8c,
+	0xa6, 0xe9, 0xda, 0xa6, 0xab, 0xda, 0xb2, 0xa9, 0xba, 0xb2, 0xed, 0xba,
+	0xae, 0xae, 0xcb, 0xb2, 0x6c, 0xdb, 0xa2, 0x69, 0xca, 0xb2, 0xa9, 0xba,
+	0xae, 0x6d, 0xaa, 0xa6, 0x2c, 0xcb, 0xb2, 0x6c, 0xfb, 0xb2, 0x2c, 0xdb,
+	0xb6, 0xea, 0xca, 0xba, 0xec, 0xda, 0xb2, 0xed, 0xbb, 0xae, 0x2c, 0xdb,
+	0xb2, 0x6d, 0x0b, 0xbb, 0xec, 0x0a, 0xb3, 0xaf, 0xba, 0xb2, 0xad, 0xbb,
+	0xb2, 0x6d, 0x0b, 0xab, 0xab, 0xda, 0xb6, 0xec, 0xdb, 0x3e, 0x5b, 0x57,
+	0x75, 0x55, 0x00, 0x00, 0xc0, 0x80, 0x03, 0x00, 0x40, 0x80, 0x09, 0x65,
+	0xa0, 0xd0, 0x90, 0x95, 0x00, 0x40, 0x14, 0x00, 0x00, 0x60, 0x0c, 0x63,
+	0x8c, 0x41, 0x68, 0x94, 0x72, 0xce, 0x39, 0x08, 0x8d, 0x52, 0xce, 0x39,
+	0x07, 0x21, 0x73, 0x0e, 0x42, 0x08, 0xa9, 0x64, 0xce, 0x41, 0x08, 0xa1,
+	0xa4, 0xcc, 0x39, 0x08, 0xa5, 0xa4, 0x94, 0x39, 0x07, 0xa1, 0x94, 0x94,
+	0x42, 0x08, 0xa5, 0xa4, 0xd4, 0x5a, 0x08, 0xa1, 0x94, 0x94, 0x5a, 0x2b,
+	0x00, 0x00, 0xa0, 0xc0, 0x01, 0x00, 0x20, 0xc0, 0x06, 0x4d, 0x89, 0xc5,
+	0x01, 0x0a, 0x0d, 0x59, 0x09, 0x00, 0xa4, 0x02, 0x00, 0x18, 0x1c, 0x47,
+	0xd3, 0x4c, 0xd3, 0x75, 0x65, 0xd9, 0x18, 0x16, 0xcb, 0x12, 0x45, 0x55,
+	0x95, 0x65, 0xdb, 0x36, 0x86, 0xc5, 0xb2, 0x44, 0x51, 0x55, 0x65, 0xd9,
+	0xb6, 0x85, 0x63, 0x13, 0x45, 0x55, 0x95, 0x65, 0xdb, 0xd6, 0x75, 0x34,
+	0x51, 0x54, 0x55, 0x59, 0xb6, 0x6d, 0xdd, 0x57, 0x8e, 0x53, 0x55, 0x65,
+	0xd9, 0xb6, 0x7d, 0x5d, 0x38, 0x32, 0x55, 0x55, 0x96, 0x6d, 0x5b, 0xd7,
+	0x7d, 0x23, 0x55, 0x96, 0x6d, 0x5b, 0xd7, 0x85, 0xa1, 0x92, 0x2a, 0xcb,
+	0xb6, 0x6d, 0xeb, 0xbe, 0x51, 0x49, 0xb6, 0x6d, 0x5d, 0x37, 0x86, 0xe3,
+	0xa8, 0x24, 0xdb, 0xb6, 0xee, 0xfb, 0xbe, 0x71, 0x2c, 0xf1, 0x85, 0xa1,
+	0xb0, 0x2c, 0x95, 0xf0, 0x95, 0x5f, 0x38, 0x2a, 0x81, 0x00, 0x00, 0xf0,
+	0x04, 0x07, 0x00, 0xa0, 0x02, 0x1b, 0x56, 0x47, 0x38, 0x29, 0x1a, 0x0b,
+	0x2c, 0x34, 0x64, 0x25, 0x00, 0x90, 0x01, 0x00, 0x00, 0x18, 0xa4, 0x94,
+	0x51, 0x4a, 0x29, 0xa3, 0x94, 0x52, 0x4a, 0x29, 0xc6, 0x94, 0x52, 0x8c,
+	0x09, 0x00, 0x00, 0x18, 0x70, 0x00, 0x00, 0x08, 0x30, 0xa1, 0x0c, 0x14,
+	0x1a, 0xb2, 0x22, 0x00, 0x88, 0x02, 0x00, 0x00, 0x9c, 0x73, 0xce, 0x39,
+	0xe7, 0x9c, 0x73, 0xce, 0x39, 0xe7, 0x9c, 0x73, 0xce, 0x39, 0xe7, 0x9c,
+	0x73, 0xce, 0x39, 0xe7, 0x18, 0x63, 0x8c, 0x31, 0xc6, 0x18, 0x63, 0x8c,
+	0x31, 0xc6, 0x18, 0x63, 0x8c, 0x31, 0xc6, 0x18, 0x63, 0x8c, 0x31, 0xc6,
+	0x18, 0x63, 0x8c, 0x31, 0xc6, 0x18, 0x63, 0x8c, 0x31, 0xc6, 0x04, 0x00,
+	0xec, 0x44, 0x38, 0x00, 0xec, 0x44, 0x58, 0x08, 0x85, 0x86, 0xac, 0x04,
+	0x00, 0xc2, 0x01, 0x00, 0x00, 0x84, 0x14, 0x82, 0x92, 0x52, 0x29, 0xa5,
+	0x94, 0x12, 0x39, 0xe7, 0xa4, 0x94, 0x52, 0x4a, 0x29, 0xa5, 0x94, 0xc8,
+	0x41, 0x08, 0xa5, 0x94, 0x52, 0x4a, 0x29, 0xa5, 0x44, 0xd2, 0x49, 0x29,
+	0xa5, 0x94, 0x52, 0x4a, 0x29, 0xa5, 0x71, 0x50, 0x4a, 0x29, 0xa5, 0x94,
+	0x52, 0x4a, 0x29, 0xa1, 0x94, 0x52, 0x4a, 0x29, 0xa5, 0x94, 0x52, 0x4a,
+	0x09, 0xa5, 0x94, 0x52, 0x4a, 0x29, 0xa5, 0x94, 0x52, 0x4a, 0x29, 0xa5,
+	0x94, 0x52, 0x4a, 0x29, 0xa5, 0x94, 0x52, 0x4a, 0x29, 0xa5, 0x94, 0x52,
+	0x4a, 0x29, 0xa5, 0x94, 0x52, 0x4a, 0x29, 0xa5, 0x94, 0x52, 0x4a, 0x29,
+	0xa5, 0x94, 0x52, 0x4a, 0x29, 0xa5, 0x94, 0x52, 0x4a, 0x29, 0xa5, 0x94,
+	0x52, 0x4a, 0x29, 0xa5, 0x94, 0x52, 0x4a, 0x29, 0xa5, 0x94, 0x52, 0x4a,
+	0x29, 0xa5, 0x94, 0x52, 0x4a, 0x29, 0xa5, 0x94, 0x52, 0x4a, 0x29, 0xa5,
+	0x94, 0x52, 0x4a, 0x29, 0xa5, 0x94, 0x52, 0x4a, 0x29, 0xa5, 0x94, 0x52,
+	0x4a, 0x01, 0x00, 0x26, 0x0f, 0x0e, 0x00, 0x50, 0x09, 0x36, 0xce, 0xb0,
+	0x92, 0x74, 0x56, 0x38, 0x1a, 0x5c, 0x68, 0xc8, 0x4a, 0x00, 0x20, 0x37,
+	0x00, 0x00, 0x50, 0x8a, 0x39, 0xc6, 0x24, 0x94, 0x90, 0x4a, 0x48, 0x25,
+	0x84, 0x10, 0x4a, 0xe5, 0x18, 0x84, 0xce, 0x49, 0x09, 0x29, 0xb5, 0x56,
+	0x42, 0x0a, 0xad, 0x84, 0x0a, 0x3a, 0x68, 0x9d, 0xa3, 0x90, 0x52, 0x4b,
+	0xad, 0x95, 0x94, 0x4a, 0x49, 0x99, 0x84, 0x10, 0x42, 0x28, 0xa1, 0x84,
+	0x52, 0x5a, 0x29, 0x25, 0xb5, 0x52, 0x32, 0x08, 0xa1, 0x84, 0x50, 0x4a,
+	0x08, 0x21, 0xa5, 0x52, 0x4a, 0x09, 0xa1, 0x65, 0x50, 0x42, 0x0a, 0x25,
+	0x94, 0x94, 0x52, 0x49, 0x2d, 0xb4, 0x54, 0x4a, 0xc9, 0x20, 0x84, 0x50,
+	0x5a, 0x09, 0xa9, 0x95, 0xd4, 0x5a, 0x0a, 0x25, 0x95, 0x94, 0x41, 0x29,
+	0xa9, 0x84, 0x92, 0x52, 0x2a, 0xad, 0xb5, 0x94, 0x4a, 0x4a, 0xad, 0x83,
+	0xd2, 0x52, 0x29, 0xad, 0xb5, 0xd6, 0x4a, 0x4a, 0x21, 0x95, 0x96, 0x52,
+	0x07, 0xa5, 0xa4, 0x96, 0x52, 0x29, 0xa5, 0xb5, 0x16, 0x4a, 0x6b, 0xad,
+	0xb5, 0x4e, 0x52, 0x29, 0x2d, 0xa4, 0xd6, 0x52, 0x6b, 0xad, 0x95, 0x56,
+	0x4a, 0x29, 0x9d, 0xa5, 0x94, 0x4a, 0x49, 0xad, 0xb5, 0x96, 0x5a, 0x6b,
+	0x29, 0xa5, 0x56, 0x42, 0x29, 0xad, 0xb4, 0xd2, 0x5a, 0x29, 0x25, 0xb5,
+	0xd6, 0x52, 0x6b, 0x2d, 0x95, 0xd4, 0x5a, 0x4b, 0xad, 0xa5, 0xd6, 0x52,
+	0x6b, 0xad, 0xa5, 0xd6, 0x4a, 0x29, 0x25, 0xa5, 0x96, 0x5a, 0x6b, 0xad,
+	0xb5, 0x96, 0x5a, 0x2a, 0x29, 0xb5, 0x94, 0x42, 0x29, 0xa5, 0x95, 0x92,
+	0x42, 0x6a, 0xa9, 0xa5, 0xd6, 0x4a, 0x2a, 0x2d, 0x84, 0xd0, 0x52, 0x49,
+	0xa5, 0x95, 0x56, 0x5a, 0x6b, 0x29, 0xa5, 0x94, 0x4a, 0x28, 0x25, 0x95,
+	0x94, 0x5a, 0x2a, 0xa9, 0xb5, 0x96, 0x52, 0x68, 0xa5, 0x85, 0xd2, 0x4a,
+	0x49, 0x25, 0xa5, 0x96, 0x4a, 0x2a, 0x29, 0xa5, 0xd4, 0x52, 0x2a, 0xa1,
+	0x94, 0x12, 0x52, 0x2a, 0xa1, 0x95, 0xd4, 0x52, 0x6b, 0xa9, 0xa5, 0x96,
+	0x4a, 0x2a, 0x2d, 0xb5, 0xd4, 0x52, 0x2b, 0xa9, 0x94, 0x96, 0x4a, 0x4a,
+	0xa9, 0x14, 0x00, 0x00, 0x74, 0xe0, 0x00, 0x00, 0x10, 0x60, 0x44, 0xa5,
+	0x85, 0xd8, 0x69, 0xc6, 0x95, 0x47, 0xe0, 0x88, 0x42, 0x86, 0x09, 0x28,
+	0x00, 0x00, 0x10, 0x04, 0x00, 0x18, 0x88, 0x90, 0x99, 0x40, 0xa0, 0x00,
+	0x0a, 0x0c, 0x64, 0x00, 0xc0, 0x01, 0x42, 0x82, 0x14, 0x00, 0x50, 0x58,
+	0x60, 0x28, 0x5d, 0xe8, 0x82, 0x10, 0x22, 0x48, 0x17, 0x41, 0x16, 0x0f,
+	0x5c, 0x38, 0x71, 0xe3, 0x89, 0x1b, 0x4e, 0xe8, 0xd0, 0x06, 0x00, 0x18,
+	0x88, 0x90, 0x99, 0x00, 0xa1, 0x18, 0x22, 0x24, 0x64, 0x03, 0xc0, 0x04,
+	0x45, 0x85, 0x74, 0x00, 0xb0, 0xb8, 0xc0, 0x28, 0x5d, 0xe8, 0x82, 0x10,
+	0x22, 0x48, 0x17, 0x41, 0x16, 0x0f, 0x5c, 0x38, 0x71, 0xe3, 0x89, 0x1b,
+	0x4e, 0xe8, 0xd0, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00,
+	0x1f, 0x00, 0x00, 0x07, 0x06, 0x10, 0x11, 0xd1, 0x5c, 0x86, 0xc6, 0x06,
+	0x47, 0x87, 0xc7, 0x07, 0x48, 0x88, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x4f, 0x67, 0x67, 0x53, 0x00,
+	0x04, 0x33, 0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xd4, 0x71, 0xf0,
+	0x47, 0x02, 0x00, 0x00, 0x00, 0x55, 0x39, 0x04, 0x86, 0x42, 0x19, 0x17,
+	0x18, 0x17, 0x15, 0x17, 0x18, 0x17, 0x18, 0x17, 0x17, 0x15, 0x17, 0x17,
+	0x17, 0x17, 0x18, 0x18, 0x16, 0x16, 0x17, 0x17, 0x18, 0x18, 0x18, 0x17,
+	0x16, 0x17, 0x18, 0x18, 0x17, 0x17, 0x17, 0x16, 0x16, 0x18, 0x18, 0x17,
+	0x18, 0x18, 0x17, 0x16, 0x16, 0x18, 0x17, 0x18, 0x17, 0x18, 0x16, 0x16,
+	0x17, 0x17, 0x18, 0x18, 0x17, 0x17, 0x17, 0x17, 0x18, 0x18, 0x17, 0x17,
+	0x17, 0x17, 0x18, 0x22, 0x4e, 0x63, 0xe6, 0xa8, 0x2a, 0x00, 0xfd, 0x76,
+	0x85, 0x23, 0x00, 0x6d, 0x1f, 0x16, 0x00, 0x00, 0x00, 0x58, 0xbb, 0xbd,
+	0x59, 0xbb, 0xb6, 0xdf, 0x0a, 0x62, 0x69, 0xc9, 0x5e, 0x56, 0x00, 0xc9,
+	0x17, 0xa1, 0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x92, 0x00, 0x80, 0x74,
+	0x47, 0x1f, 0x22, 0x06, 0x62, 0x69, 0xc9, 0x5e, 0xa9, 0x00, 0x92, 0x2f,
+	0x42, 0x35, 0x02, 0x00, 0x00, 0x00, 0x00, 0xa3, 0x26, 0x00, 0xa8, 0x5d,
+	0x40, 0xbd, 0x10, 0x00, 0x62, 0x69, 0xc9, 0x5e, 0xa9, 0x00, 0x92, 0xaf,
+	0x41, 0x35, 0x02, 0x00, 0x00, 0x00, 0x00, 0x52, 0x02, 0x00, 0xa6, 0xb0,
+	0xce, 0x38, 0x00, 0x62, 0x69, 0xc9, 0xde, 0xe8, 0x00, 0x92, 0xd7, 0xa0,
+	0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x2d, 0x00, 0x60, 0x1c, 0x26, 0x01,
+	0x62, 0x69, 0xc9, 0x5e, 0xa9, 0x00, 0x92, 0xaf, 0x41, 0x35, 0x02, 0x00,
+	0x00, 0x00, 0x00, 0x2d, 0x05, 0x00, 0x28, 0x7f, 0xb8, 0x39, 0x06, 0x62,
+	0x69, 0xc9, 0x5e, 0x56, 0x00, 0xc9, 0x17, 0xa0, 0x1a, 0x01, 0x00, 0x00,
+	0x00, 0x80, 0x52, 0x0b, 0x00, 0x6a, 0x4f, 0xdd, 0xa4, 0x08, 0x00, 0x62,
+	0x69, 0xc9, 0x5e, 0x56, 0x00, 0xc9, 0x1f, 0xa0, 0x1a, 0x01, 0x00, 0x00,
+	0x00, 0x80, 0x52, 0x17, 0x00, 0xa4, 0x4d, 0x9e, 0x8e, 0x03, 0x62, 0x69,
+	0xc9, 0x5e, 0xa9, 0x00, 0x92, 0x2f, 0x42, 0x35, 0x02, 0x00, 0x00, 0x00,
+	0x00, 0x2d, 0x2d, 0x00, 0x50, 0x56, 0xf5, 0x3f, 0x71, 0x00, 0x62, 0x69,
+	0xc9, 0x5e, 0xeb, 0x00, 0x92, 0x17, 0xa1, 0x1a, 0x01, 0x00, 0x00, 0x00,
+	0x80, 0x4d, 0x07, 0x00, 0xed, 0x03, 0x26, 0x8f, 0x00, 0x62, 0x69, 0xc9,
+	0x5e, 0xeb, 0x00, 0x92, 0x8f, 0x41, 0x35, 0x02, 0x00, 0x00, 0x00, 0x00,
+	0x52, 0x00, 0x00, 0x37, 0xb9, 0x68, 0x0c, 0x00, 0x62, 0x69, 0xc9, 0xde,
+	0x9a, 0x00, 0x24, 0x4f, 0x80, 0x6a, 0x04, 0x00, 0x00, 0x00, 0x00, 0x46,
+	0x03, 0x00, 0xfd, 0x3e, 0x00, 0x62, 0x69, 0xc9, 0x5e, 0xeb, 0x00, 0x92,
+	0x8f, 0x41, 0x35, 0x02, 0x00, 0x00, 0x00, 0x00, 0x52, 0x02, 0x00, 0x6e,
+	0x66, 0x71, 0x1c, 0x00, 0x62, 0x69, 0xc9, 0xde, 0xe8, 0x00, 0x92, 0xd7,
+	0xa0, 0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0xad, 0x00, 0x00, 0xed, 0xb9,
+	0x76, 0x1f, 0x05, 0x62, 0x69, 0xc9, 0x5e, 0x56, 0x00, 0xc9, 0x1f, 0xa0,
+	0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x56, 0x09, 0x00, 0xca, 0xbc, 0x7f,
+	0x8c, 0x01, 0x62, 0x69, 0xc9, 0x5e, 0x56, 0x00, 0xc9, 0x1f, 0xa0, 0x1a,
+	0x01, 0x00, 0x00, 0x00, 0x80, 0x52, 0x07, 0x00, 0xa4, 0x8d, 0x3d, 0x25,
+	0x06, 0x62, 0x69, 0xc9, 0x5e, 0x56, 0x00, 0xc9, 0x17, 0xa0, 0x1a, 0x01,
+	0x00, 0x00, 0x00, 0x80, 0x52, 0x13, 0x00, 0xd4, 0x9e, 0xb1, 0xc9, 0x51,
+	0x00, 0x62, 0x69, 0xc9, 0x5e, 0xa9, 0x00, 0x92, 0xaf, 0x41, 0x35, 0x02,
+	0x00, 0x00, 0x00, 0x00, 0x2d, 0x25, 0x00, 0x50, 0xfe, 0xe0, 0x06, 0xc5,
+	0x01, 0x62, 0x69, 0xc9, 0xde, 0xe8, 0x00, 0x92, 0xd7, 0xa0, 0x1a, 0x01,
+	0x00, 0x00, 0x00, 0x80, 0x2d, 0x00, 0x60, 0x1c, 0x24, 0x06, 0x00, 0x62,
+	0x69, 0xc9, 0x5e, 0xeb, 0x00, 0x92, 0x8f, 0x41, 0x35, 0x02, 0x00, 0x00,
+	0x00, 0x00, 0x52, 0x00, 0x00, 0x2b, 0x6b, 0x31, 0x00, 0x62, 0x69, 0xc9,
+	0x5e, 0xa9, 0x00, 0x92, 0x0f, 0x42, 0x35, 0x02, 0x00, 0x00, 0x00, 0x00,
+	0xa3, 0x16, 0x00, 0xd4, 0xce, 0x5f, 0x3f, 0x00, 0x62, 0x69, 0xc9, 0x5e,
+	0x56, 0x00, 0xc9, 0x1f, 0xa1, 0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x92,
+	0x01, 0x40, 0xba, 0x0b, 0xef, 0xc5, 0x01, 0x62, 0x69, 0xc9, 0x5e, 0x56,
+	0x00, 0xc9, 0x1f, 0xa0, 0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x96, 0x16,
+	0x00, 0x28, 0x77, 0xf0, 0xfc, 0x51, 0x00, 0x62, 0x69, 0xc9, 0x5e, 0x56,
+	0x00, 0xc9, 0x17, 0xa0, 0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x56, 0x09,
+	0x00, 0xca, 0x0b, 0x39, 0x89, 0x08, 0x00, 0x62, 0x69, 0xc9, 0x5e, 0xa9,
+	0x00, 0x92, 0xaf, 0x41, 0x35, 0x02, 0x00, 0x00, 0x00, 0x00, 0x25, 0x05,
+	0x00, 0x48, 0x2f, 0x7a, 0xe9, 0x18, 0x00, 0x62, 0x69, 0xc9, 0x5e, 0xeb,
+	0x00, 0x92, 0x17, 0xa1, 0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x51, 0x13,
+	0x00, 0xd4, 0x26, 0x34, 0x1e, 0x02, 0x62, 0x69, 0xc9, 0x5e, 0x56, 0x00,
+	0xc9, 0x17, 0xa1, 0x1a, 0x01, 0x00, 0x00, 0x00, 0x00, 0x29, 0x01, 0x00,
+	0x09, 0x27, 0x8a, 0x03, 0x62, 0x69, 0xc9, 0x5e, 0xeb, 0x00, 0x92, 0x17,
+	0xa1, 0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0xad, 0x00, 0x00, 0xed, 0x81,
+	0x74, 0x17, 0x02, 0x62, 0x69, 0xc9, 0x5e, 0xa9, 0x00, 0x92, 0xaf, 0x41,
+	0x35, 0x02, 0x00, 0x00, 0x00, 0x00, 0x2d, 0x05, 0x00, 0x28, 0xcf, 0xf4,
+	0x2c, 0x31, 0x00, 0x62, 0x69, 0xc9, 0x5e, 0x56, 0x00, 0xc9, 0x17, 0xa0,
+	0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x52, 0x07, 0x00, 0xd4, 0x4e, 0xf7,
+	0x90, 0x11, 0x00, 0x62, 0x69, 0xc9, 0x5e, 0x56, 0x00, 0xc9, 0x1f, 0xa0,
+	0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x52, 0x17, 0x00, 0xa4, 0x1b, 0x5f,
+	0x15, 0x07, 0x62, 0x69, 0xc9, 0x5e, 0x56, 0x00, 0xc9, 0x17, 0xa1, 0x1a,
+	0x01, 0x00, 0x00, 0x00, 0x80, 0x96, 0x01, 0x40, 0x39, 0xff, 0xe7, 0x89,
+	0x03, 0x62, 0x69, 0xc9, 0x5e, 0xeb, 0x00, 0x92, 0x17, 0xa1, 0x1a, 0x01,
+	0x00, 0x00, 0x00, 0x80, 0x4d, 0x07, 0x00, 0xed, 0x55, 0x1e, 0x19, 0x00,
+	0x62, 0x69, 0xc9, 0x5e, 0xeb, 0x00, 0x92, 0x8f, 0x41, 0x35, 0x02, 0x00,
+	0x00, 0x00, 0x00, 0x52, 0x00, 0x00, 0x0b, 0x69, 0xc7, 0x00, 0x62, 0x69,
+	0xc9, 0xde, 0xe8, 0x00, 0x92, 0xd7, 0xa0, 0x1a, 0x01, 0x00, 0x00, 0x00,
+	0x80, 0xd1, 0x00, 0x40, 0x3f, 0x48, 0x04, 0x00, 0x62, 0x69, 0xc9, 0x5e,
+	0xa9, 0x00, 0x92, 0xaf, 0x41, 0x35, 0x02, 0x00, 0x00, 0x00, 0x00, 0x52,
+	0x02, 0x00, 0xe9, 0x0f, 0xee, 0x68, 0x1c, 0x00, 0x62, 0x69, 0xc9, 0x5e,
+	0x56, 0x00, 0xc9, 0x17, 0xa0, 0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x56,
+	0x01, 0x00, 0xda, 0x6f, 0xdb, 0xe5, 0x28, 0x00, 0x62, 0x69, 0xc9, 0x9e,
+	0x47, 0x00, 0xc9, 0x1f, 0xa0, 0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x56,
+	0x09, 0x00, 0xca, 0x68, 0x5e, 0x8b, 0x01, 0x62, 0x69, 0xc9, 0x5e, 0xa9,
+	0x00, 0x92, 0x2f, 0x42, 0x35, 0x02, 0x00, 0x00, 0x00, 0x00, 0xa5, 0x0e,
+	0x00, 0x48, 0xf3, 0xf9, 0x42, 0x31, 0x00, 0x62, 0x69, 0xc9, 0x5e, 0xeb,
+	0x00, 0x92, 0x17, 0xa1, 0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x51, 0x13,
+	0x00, 0xd4, 0x8e, 0x1d, 0xba, 0x28, 0x00, 0x62, 0x69, 0xc9, 0x5e, 0xeb,
+	0x00, 0x92, 0x8f, 0x41, 0x35, 0x02, 0x00, 0x00, 0x00, 0x00, 0x52, 0x02,
+	0x00, 0xe5, 0x43, 0x4e, 0x8f, 0x03, 0x62, 0x69, 0xc9, 0xde, 0x9a, 0x00,
+	0x24, 0x4f, 0x84, 0x6a, 0x04, 0x00, 0x00, 0x00, 0x00, 0xb6, 0x00, 0x80,
+	0xf1, 0xb8, 0x08, 0x00, 0x62, 0x69, 0xc9, 0x5e, 0xeb, 0x00, 0x92, 0x8f,
+	0x41, 0x35, 0x02, 0x00, 0x00, 0x00, 0x00, 0x52, 0x00, 0x00, 0x17, 0xef,
+	0x31, 0x06, 0x62, 0x69, 0xc9, 0xde, 0xe8, 0x00, 0x92, 0xd7, 0xa0, 0x1a,
+	0x01, 0x00, 0x00, 0x00, 0x80, 0x51, 0x0b, 0x00, 0x6a, 0x13, 0x55, 0x6d,
+	0x04, 0x00, 0x62, 0x69, 0xc9, 0x9e, 0x47, 0x00, 0xc9, 0x1f, 0xa0, 0x1a,
+	0x01, 0x00, 0x00, 0x00, 0x80, 0x92, 0x01, 0x40, 0xda, 0xe5, 0xf7, 0x71,
+	0x00, 0x62, 0x69, 0xc9, 0x5e, 0x56, 0x00, 0xc9, 0x1f, 0xa0, 0x1a, 0x01,
+	0x00, 0x00, 0x00, 0x80, 0x96, 0x16, 0x00, 0x28, 0x87, 0xfb, 0x6e, 0x1c,
+	0x00, 0x62, 0x69, 0xc9, 0x9e, 0x47, 0x00, 0xc9, 0x17, 0xa0, 0x1a, 0x01,
+	0x00, 0x00, 0x00, 0x80, 0x96, 0x0e, 0x00, 0xca, 0x0b, 0xee, 0x1a, 0x01,
+	0x62, 0x69, 0xc9, 0x5e, 0xa9, 0x00, 0x92, 0xaf, 0x41, 0x35, 0x02, 0x00,
+	0x00, 0x00, 0x00, 0x25, 0x05, 0x00, 0x48, 0xdf, 0x77, 0x12, 0x31, 0x00,
+	0x62, 0x69, 0xc9, 0xde, 0xe8, 0x00, 0x92, 0xd7, 0xa0, 0x1a, 0x01, 0x00,
+	0x00, 0x00, 0x80, 0xd1, 0x00, 0x40, 0x3f, 0x4c, 0x16, 0x02, 0x62, 0x69,
+	0xc9, 0x5e, 0xeb, 0x00, 0x92, 0x8f, 0x41, 0x35, 0x02, 0x00, 0x00, 0x00,
+	0x00, 0x52, 0x02, 0x00, 0x86, 0xbe, 0x8c, 0x03, 0x62, 0x69, 0xc9, 0x5e,
+	0xeb, 0x00, 0x92, 0x0f, 0x42, 0x35, 0x02, 0x00, 0x00, 0x00, 0x00, 0x5b,
+	0x01, 0x00, 0xda, 0x73, 0x69, 0x1d, 0x02, 0x62, 0x69, 0xc9, 0x5e, 0x56,
+	0x00, 0xc9, 0x17, 0xa1, 0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x96, 0x00,
+	0x80, 0x72, 0x83, 0x6e, 0x22, 0x06, 0x62, 0x69, 0xc9, 0x5e, 0x56, 0x00,
+	0xc9, 0x1f, 0xa0, 0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x52, 0x07, 0x00,
+	0xa4, 0x1b, 0x38, 0x9d, 0x08, 0x00, 0x62, 0x69, 0xc9, 0x5e, 0x56, 0x00,
+	0xc9, 0x1f, 0xa0, 0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x52, 0x17, 0x00,
+	0xa4, 0xa7, 0x3f, 0x98, 0x28, 0x00, 0x62, 0x69, 0xc9, 0x5e, 0x56, 0x00,
+	0xc9, 0x17, 0xa1, 0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x96, 0x01, 0x40,
+	0x79, 0x26, 0x67, 0x89, 0x03, 0x62, 0x69, 0xc9, 0x5e, 0xeb, 0x00, 0x92,
+	0x0f, 0x42, 0x35, 0x02, 0x00, 0x00, 0x00, 0x00, 0x9b, 0x0e, 0x00, 0xda,
+	0x73, 0x76, 0x09, 0x00, 0x62, 0x69, 0xc9, 0x5e, 0x56, 0x00, 0xc9, 0x17,
+	0xa1, 0x1a, 0x01, 0x00, 0x00, 0x00, 0x00, 0x29, 0x00, 0x80, 0x7c, 0x56,
+	0x4d, 0x0c, 0x00, 0x62, 0x69, 0xc9, 0x5e, 0xeb, 0x00, 0x92, 0x17, 0xa1,
+	0x1a, 0x01, 0x00, 0x00, 0x00, 0x80, 0x51, 0x0b, 0x00, 0x6a, 0x23, 0x9b,
+	0x2b, 0x00, 0x62, 0x69, 0xc9, 0x5e, 0xa9, 0x00, 0x92, 0xaf, 0x41, 0x35,
+	0x02, 0x00, 0x00, 0x00, 0x00, 0x25, 0x25, 0x00, 0x90, 0x3e, 0xe4, 0xc5,
+	0xe3, 0x00, 0x62, 0x69, 0xc9, 0x5e, 0x56, 0x00, 0xc9, 0x17, 0xa0, 0x1a,
+	0x01, 0x00, 0x00, 0x00, 0x80, 0x96, 0x16, 0x00, 0x68, 0xdf, 0xe3, 0xc9,
+	0x44, 0x01, 0x62, 0x69, 0xc9, 0x5e, 0x56, 0x00, 0xc9, 0x1f, 0xa0, 0x1a,
+	0x01, 0x00, 0x00, 0x00, 0x80, 0x56, 0x09, 0x00, 0xca, 0xe5, 0xbd, 0x1b,
+	0x03, 0x62, 0x69, 0xc9, 0x5e, 0x56, 0x00, 0xc9, 0x17, 0xa1, 0x1a, 0x01,
+	0x00, 0x00, 0x00, 0x80, 0x92, 0x00, 0x80, 0x74, 0x79, 0xdf, 0x11, 0x03,
+	0x62, 0x69, 0xc9, 0xde, 0xe8, 0x00, 0x92, 0xd7, 0xa0, 0x1a, 0x01, 0x00,
+	0x00, 0x00, 0x80, 0x51, 0x13, 0x00, 0xd4, 0x86, 0x2b, 0x37, 0x04, 0x62,
+	0x69, 0xc9, 0x5e, 0xa9, 0x00, 0x92, 0xaf, 0x41, 0x35, 0x02, 0x00, 0x00,
+	0x00, 0x00, 0x52, 0x02, 0x00, 0x76, 0xa9, 0xce, 0x38, 0x00, 0x5a, 0x67,
+	0x6e, 0x4f, 0x05, 0x00, 0xf1, 0x36, 0x38, 0x02, 0xd0, 0x7f, 0xfb, 0x02,
+	0x00, 0x00, 0x00, 0x54, 0xd3, 0xc4, 0xd3, 0x67, 0x0d, 0x00, 0x36, 0x5b,
+	0xe6, 0xde, 0x97, 0x0b, 0xe5, 0x94, 0x8f, 0x22, 0x74, 0x84, 0x25, 0xde,
+	0xad, 0x5f, 0x2a, 0x0b, 0x20, 0x0c, 0x00, 0x68, 0xf7, 0x5b, 0x6b, 0xce,
+	0x5f, 0xd7, 0x87, 0xb6, 0x05, 0xf6, 0x20, 0x01
+};
+#endif
+
+/* Play the music and return the number of heap calls after warming up */
+static int count_allocations(Mix_Music *music, int volume)
+{
+	Uint32 start;
+
+	SDL_LockAudio();
+	callbacks = 0;
+	allocations = 0;
+	counting = 0;
+	SDL_UnlockAudio();
+
+	Mix_VolumeMusic(volume);
+	Mix_PlayMusic(music, -1);
+	start = SDL_GetTicks();
+	while ( callbacks < WARMUP_CALLBACKS + COUNTED_CALLBACKS &&
+	        SDL_GetTicks() - start < 10000 ) {
+		SDL_Delay(20);
+	}
+	Mix_HaltMusic();
+	return allocations;
+}
+
+/* Ogg music closes its RWops itself, even when it fails to load */
+static int test_music(const char *name, const Uint8 *data, int len,
+                      const char *file, int closes_rw)
+{
+	static const struct {
+		const char *mode;
+		int prefetch_ms;
+		int volume;
+	} runs[] = {
+		{ "decoded in the callback", 0, MIX_MAX_VOLUME },
+		{ "decoded in the callback at half volume", 0, MIX_MAX_VOLUME / 2 },
+		{ "decoded ahead", 250, MIX_MAX_VOLUME }
+	};
+	int i, errors = 0;
+
+	for (i = 0; i < SDL_arraysize(runs); i++) {
+		SDL_RWops *rw = NULL;
+		Mix_Music *music;
+		int n;
+
+		Mix_SetMusicDecodeAhead(runs[i].prefetch_ms);
+		if ( file ) {
+			music = Mix_LoadMUS(file);
+		} else {
+			rw = SDL_RWFromConstMem(data, len);
+			music = Mix_LoadMUS_RW(rw);
+		}
+		if ( music == NULL ) {
+			printf("%s: skipped, couldn't load it: %s\n", name, Mix_GetError());
+			if ( rw && !closes_rw ) {
+				SDL_FreeRW(rw);
+			}
+			return 0;
+		}
+		n = count_allocations(music, runs[i].volume);
+		printf("%s, %s: %d heap calls\n", name, runs[i].mode, n);
+		if ( n ) {
+			++errors;
+		}
+		Mix_FreeMusic(music);
+		/* WAV, MOD and MIDI music leave the RWops to the caller */
+		if ( rw && !closes_rw ) {
+			SDL_FreeRW(rw);
+		}
+	}
+	return errors;
+}
+
+int main(int argc, char *argv[])
+{
+	int audio_rate;
+	Uint16 audio_format;
+	int audio_channels;
+	Uint8 *data;
+	int i, len, errors = 0;
+
+	if ( SDL_Init(SDL_INIT_AUDIO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n",SDL_GetError());
+		return(1);
+	}
+	if ( Mix_OpenAudio(44100, AUDIO_S16SYS, 2, 1024) < 0 ) {
+		fprintf(stderr, "Couldn't open audio: %s\n", SDL_GetError());
+		SDL_Quit();
+		return(1);
+	}
+	Mix_QuerySpec(&audio_rate, &audio_format, &audio_channels);
+	Mix_SetPostMix(countingPostMix, NULL);
+#ifndef COUNTING_ALLOCATIONS
+	printf("Heap calls can't be counted on this platform, only playing\n");
+#endif
+
+	data = make_wav(audio_rate, &len);
+	errors += test_music("WAV", data, len, NULL, 0);
+	free(data);
+
+	data = make_wav(audio_rate / 2, &len);
+	errors += test_music("Converted WAV", data, len, NULL, 0);
+	free(data);
+
+	data = make_mod(&len);
+	errors += test_music("MOD", data, len, NULL, 0);
+	free(data);
+
+	data = make_mid(&len);
+	errors += test_music("MIDI", data, len, NULL, 0);
+	free(data);
+
+#ifdef OGG_MUSIC
+	errors += test_music("Ogg", ogg_tone, sizeof(ogg_tone), NULL, 1);
+#else
+	printf("Ogg: skipped, SDL_mixer was built without OGG_MUSIC\n");
+#endif
+
+	for (i = 1; i < argc; i++) {
+		errors += test_music(argv[i], NULL, 0, argv[i], 0);
+	}
+
+	if ( errors ) {
+		printf("%d music allocation tests failed\n", errors);
+	} else {
+		printf("All music allocation tests passed.\n");
+	}
+
+	Mix_SetPostMix(NULL, NULL);
+	Mix_CloseAudio();
+	SDL_Quit();
+	return (errors ? 1 : 0);
+}
@@ -0,0 +1,285 @@
+/*
+    MUSICSTALL:  A test of decoding music ahead for the SDL mixer library.
+    Copyright (C) 1997-2009 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public
+    License along with this library; if not, write to the Free
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/*
+ * Plays a WAV stream whose reads stall every so often, like a slow disc,
+ *  once decoded in the audio callback and once decoded ahead. Decoding
+ *  ahead must play every sample without an underrun, and keep the audio
+ *  callbacks evenly spaced. Set SDL_AUDIODRIVER=dummy to run without
+ *  sound hardware.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "SDL_mixer.h"
+
+#define SECONDS		2
+#define STALL_EVERY	8			/* reads between stalls */
+#define STALL_MS	100
+#define PREFETCH_MS	500
+#define LATE_MS		100			/* most a decoded ahead start may lag */
+
+static Uint8 *wav;
+static int wav_len;
+static Sint16 *samples;
+static int sample_count;
+
+static Sint16 *captured;
+static volatile int captured_count;
+static Uint32 last_callback;
+static Uint32 longest_gap;
+static volatile int finished;
+
+/* An in-memory file whose reads stall every STALL_EVERY calls */
+static int reads;
+
+static int SDLCALL stall_seek(SDL_RWops *rw, int offset, int whence)
+{
+	SDL_RWops *mem = (SDL_RWops *)rw->hidden.unknown.data1;
+	return SDL_RWseek(mem, offset, whence);
+}
+
+static int SDLCALL stall_read(SDL_RWops *rw, void *ptr, int size, int maxnum)
+{
+	SDL_RWops *mem = (SDL_RWops *)rw->hidden.unknown.data1;
+	if ( ++reads % STALL_EVERY == 0 ) {
+		SDL_Delay(STALL_MS);
+	}
+	return SDL_RWread(mem, ptr, size, maxnum);
+}
+
+static int SDLCALL stall_write(SDL_RWops *rw, const void *ptr, int size, int num)
+{
+	SDL_SetError("Can't write to a stalling file");
+	return -1;
+}
+
+static int SDLCALL stall_close(SDL_RWops *rw)
+{
+	SDL_RWclose((SDL_RWops *)rw->hidden.unknown.data1);
+	SDL_FreeRW(rw);
+	return 0;
+}
+
+static SDL_RWops *stall_open(void)
+{
+	SDL_RWops *rw = SDL_AllocRW();
+
+	rw->seek = stall_seek;
+	rw->read = stall_read;
+	rw->write = stall_write;
+	rw->close = stall_close;
+	rw->hidden.unknown.data1 = SDL_RWFromMem(wav, wav_len);
+	reads = 0;
+	return rw;
+}
+
+static void put32(Uint8 *p, Uint32 v)
+{
+	p[0] = v & 0xFF;
+	p[1] = (v >> 8) & 0xFF;
+	p[2] = (v >> 16) & 0xFF;
+	p[3] = (v >> 24) & 0xFF;
+}
+
+/* A 16-bit stereo WAV of noise, at the mixer's rate so it isn't converted */
+static void make_wav(int rate)
+{
+	Uint8 *p;
+	int i;
+
+	sample_count = rate * SECONDS * 2;
+	samples = (Sint16 *)malloc(sample_count * 2);
+	wav_len = 44 + sample_count * 2;
+	wav = (Uint8 *)malloc(wav_len);
+
+	p = wav;
+	memcpy(p, "RIFF", 4);
+	put32(p + 4, wav_len - 8);
+	memcpy(p + 8, "WAVEfmt ", 8);
+	put32(p + 16, 16);
+	p[20] = 1; p[21] = 0;			/* PCM */
+	p[22] = 2; p[23] = 0;			/* stereo */
+	put32(p + 24, rate);
+	put32(p + 28, rate * 4);
+	p[32] = 4; p[33] = 0;
+	p[34] = 16; p[35] = 0;
+	memcpy(p + 36, "data", 4);
+	put32(p + 40, sample_count * 2);
+
+	p += 44;
+	srand(1);
+	for (i = 0; i < sample_count; i++) {
+		/* Never silent, so the start is easy to find */
+		samples[i] = (Sint16)((rand() % 32000) + 1);
+		p[0] = samples[i] & 0xFF;
+		p[1] = (samples[i] >> 8) & 0xFF;
+		p += 2;
+	}
+}
+
+static void capturePostMix(void *udata, Uint8 *stream, int len)
+{
+	Uint32 now = SDL_GetTicks();
+
+	if ( last_callback && now - last_callback > longest_gap ) {
+		longest_gap = now - last_callback;
+	}
+	last_callback = now;
+
+	len /= 2;
+	if ( captured_count + len > sample_count * 2 ) {
+		len = sample_count * 2 - captured_count;
+	}
+	memcpy(captured + captured_count, stream, len * 2);
+	captured_count += len;
+}
+
+static void musicFinished(void)
+{
+	finished = 1;
+}
+
+/* Play the stalling WAV to the end. Returns the number of errors. */
+static int play(int prefetch_ms)
+{
+	Mix_MusicDecodeStats stats;
+	SDL_RWops *rw;
+	Mix_Music *music;
+	Uint32 start;
+	int i, late_ms, errors = 0;
+
+	if ( Mix_SetMusicDecodeAhead(prefetch_ms) < 0 ) {
+		fprintf(stderr, "Couldn't decode ahead: %s\n", Mix_GetError());
+		return 1;
+	}
+	rw = stall_open();
+	music = Mix_LoadMUS_RW(rw);
+	if ( music == NULL ) {
+		fprintf(stderr, "Couldn't load the WAV: %s\n", Mix_GetError());
+		SDL_RWclose(rw);
+		return 1;
+	}
+
+	SDL_LockAudio();
+	captured_count = 0;
+	last_callback = 0;
+	longest_gap = 0;
+	finished = 0;
+	SDL_UnlockAudio();
+
+	Mix_PlayMusic(music, 1);
+	start = SDL_GetTicks();
+	while ( Mix_PlayingMusic() && SDL_GetTicks() - start < SECONDS * 4000 ) {
+		SDL_Delay(50);
+	}
+
+	printf("%s: longest gap between callbacks %u ms",
+	       prefetch_ms ? "Decoding ahead" : "Decoding in the callback",
+	       longest_gap);
+	if ( prefetch_ms ) {
+		Mix_GetMusicDecodeStats(&stats);
+		printf(", %d underruns", stats.underruns);
+		if ( stats.underruns ) {
+			++errors;
+		}
+	}
+	printf("\n");
+
+	if ( !finished ) {
+		printf("  The music didn't finish\n");
+		++errors;
+	}
+	if ( prefetch_ms ) {
+		/* Playback waits for the first buffer to be decoded */
+		for (i = 0; i < captured_count && captured[i] == 0; i++) {
+			;
+		}
+		/* and not for the whole prefetch time */
+		late_ms = i * 1000 / (sample_count / SECONDS);
+		if ( late_ms > LATE_MS ) {
+			printf("  The music started %d ms late\n", late_ms);
+			++errors;
+		}
+		if ( captured_count - i < sample_count ||
+		     memcmp(captured + i, samples, sample_count * 2) != 0 ) {
+			printf("  The music played differs from the WAV\n");
+			++errors;
+		}
+	}
+
+	Mix_HaltMusic();
+	Mix_FreeMusic(music);
+	SDL_RWclose(rw);
+	return errors;
+}
+
+int main(int argc, char *argv[])
+{
+	int audio_rate;
+	Uint16 audio_format;
+	int audio_channels;
+	int errors = 0;
+
+	if ( SDL_Init(SDL_INIT_AUDIO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n",SDL_GetError());
+		return(1);
+	}
+	if ( Mix_OpenAudio(44100, AUDIO_S16SYS, 2, 1024) < 0 ) {
+		fprintf(stderr, "Couldn't open audio: %s\n", SDL_GetError());
+		SDL_Quit();
+		return(1);
+	}
+	Mix_QuerySpec(&audio_rate, &audio_format, &audio_channels);
+	if ( audio_format != AUDIO_S16SYS || audio_channels != 2 ) {
+		fprintf(stderr, "Needs 16-bit stereo audio\n");
+		Mix_CloseAudio();
+		SDL_Quit();
+		return(1);
+	}
+
+	make_wav(audio_rate);
+	/* Room for the silence before the first buffer is decoded */
+	captured = (Sint16 *)malloc(sample_count * 2 * 2);
+	Mix_SetPostMix(capturePostMix, NULL);
+	Mix_HookMusicFinished(musicFinished);
+
+	errors += play(0);
+	errors += play(PREFETCH_MS);
+
+	if ( errors ) {
+		printf("%d music decoding tests failed\n", errors);
+	} else {
+		printf("All music decoding tests passed.\n");
+	}
+
+	Mix_SetPostMix(NULL, NULL);
+	Mix_CloseAudio();
+	free(captured);
+	free(samples);
+	free(wav);
+	SDL_Quit();
+	return (errors ? 1 : 0);
+}
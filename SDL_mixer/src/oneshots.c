@@ -0,0 +1,291 @@
+/*
+    ONESHOTS:  A test and benchmark of channel allocation in SDL_mixer.
+    Copyright (C) 1997-2009 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public
+    License along with this library; if not, write to the Free
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/*
+ * Checks which channel playing on channel -1 picks, and what each voice
+ *  stealing policy stops when no channel is free, and that channels come
+ *  back when their sounds end, looping or not. Then plays thousands of
+ *  short one-shots a second on 256 channels, reporting how long playing
+ *  one takes and the CPU used, and compares mixing a few channels out of
+ *  8 and out of 1024 allocated. Set SDL_AUDIODRIVER=dummy to run without
+ *  sound hardware.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "SDL.h"
+#include "SDL_mixer.h"
+
+#define SHOT_MS		20			/* length of a one-shot */
+#define SHOTS_PER_MS	4
+#define BENCH_MS	2000
+#define PLAY_CALLS	100000
+
+static Uint8 *sound;
+static int sound_len;
+static int finished;
+
+static void channel_finished(int channel)
+{
+	++finished;
+}
+
+static int expect(const char *what, int got, int want)
+{
+	if ( got != want ) {
+		printf("%s: got %d, expected %d\n", what, got, want);
+		return 1;
+	}
+	return 0;
+}
+
+/* Play a chunk with each of the given priorities on channels 2 to 7 */
+static void fill_channels(Mix_Chunk *chunks, const int *priorities)
+{
+	int i;
+
+	Mix_HaltChannel(-1);
+	for (i = 0; i < 6; i++) {
+		Mix_PriorityChunk(&chunks[i], priorities[i]);
+		Mix_PlayChannel(-1, &chunks[i], -1);
+	}
+}
+
+static int test_policies(void)
+{
+	static const int priorities[6] = { 5, 3, 7, 3, 9, 8 };
+	Mix_Chunk chunks[6], probe, *shot;
+	int i, failed, errors = 0;
+
+	shot = Mix_QuickLoad_RAW(sound, sound_len);
+	for (i = 0; i < 6; i++) {
+		chunks[i] = *shot;
+	}
+
+	/* 8 channels, the first 2 reserved */
+	Mix_AllocateChannels(8);
+	Mix_ReserveChannels(2);
+	Mix_SetStealPolicy(MIX_STEAL_NONE);
+	for (i = 2; i < 8; i++) {
+		errors += expect("Free channel", Mix_PlayChannel(-1, shot, -1), i);
+	}
+	errors += expect("No free channel", Mix_PlayChannel(-1, shot, -1), -1);
+	errors += expect("Oldest", Mix_GroupOldest(-1), 2);
+	errors += expect("Newest", Mix_GroupNewer(-1), 7);
+	errors += expect("Available", Mix_GroupAvailable(-1), 0);
+
+	/* Channels come back in the order they stopped */
+	Mix_HaltChannel(5);
+	Mix_HaltChannel(3);
+	errors += expect("Longest free", Mix_PlayChannel(-1, shot, -1), 5);
+	errors += expect("Next free", Mix_PlayChannel(-1, shot, -1), 3);
+	errors += expect("Restarted is newest", Mix_GroupNewer(-1), 3);
+
+	Mix_SetStealPolicy(MIX_STEAL_OLDEST);
+	errors += expect("Steal oldest", Mix_PlayChannel(-1, shot, -1), 2);
+	errors += expect("Next oldest", Mix_GroupOldest(-1), 4);
+
+	Mix_SetStealPolicy(MIX_STEAL_QUIETEST);
+	Mix_Volume(-1, MIX_MAX_VOLUME);
+	Mix_Volume(6, 10);
+	errors += expect("Steal quietest", Mix_PlayChannel(-1, shot, -1), 6);
+
+	/* The lowest priority goes, the oldest of equals first */
+	Mix_SetStealPolicy(MIX_STEAL_PRIORITY);
+	fill_channels(chunks, priorities);
+	Mix_PriorityChunk(shot, 4);
+	errors += expect("Steal lowest priority", Mix_PlayChannel(-1, shot, -1), 3);
+	errors += expect("Then the next lowest", Mix_PlayChannel(-1, shot, -1), 5);
+	probe = *shot;
+	Mix_PriorityChunk(&probe, 2);
+	errors += expect("Nothing lower to steal", Mix_PlayChannel(-1, &probe, -1), -1);
+	Mix_PriorityChunk(shot, 0);
+
+	/* One-shots free their channels when they end */
+	Mix_SetStealPolicy(MIX_STEAL_NONE);
+	Mix_HaltChannel(-1);
+	for (i = 2; i < 8; i++) {
+		Mix_PlayChannel(-1, shot, 0);
+	}
+	SDL_Delay(SHOT_MS * 10);
+	errors += expect("Ended one-shots", Mix_Playing(-1), 0);
+	errors += expect("Free after ending", Mix_PlayChannel(-1, shot, 0) >= 2, 1);
+	Mix_HaltChannel(-1);
+
+	/* So do looping chunks shorter than the audio buffer */
+	Mix_ReserveChannels(0);
+	Mix_AllocateChannels(4);
+	probe = *shot;
+	probe.alen = 100 * 4;			/* 100 16-bit stereo frames */
+	failed = 0;
+	finished = 0;
+	Mix_ChannelFinished(channel_finished);
+	for (i = 0; i < 50; i++) {
+		if ( Mix_PlayChannel(-1, &probe, 1) < 0 ) {
+			++failed;
+		}
+		if ( i % 4 == 3 ) {
+			SDL_Delay(SHOT_MS * 5);
+		}
+	}
+	SDL_Delay(SHOT_MS * 5);
+	Mix_ChannelFinished(NULL);
+	errors += expect("Short loops without a free channel", failed, 0);
+	errors += expect("Ended short loops", Mix_Playing(-1), 0);
+	errors += expect("Short loops finished", finished, 50);
+
+	Mix_HaltChannel(-1);
+	Mix_ReserveChannels(0);
+	Mix_FreeChunk(shot);
+	return errors;
+}
+
+/* Returns the CPU load of the process while it sleeps, in percent */
+static double cpu_while_sleeping(void)
+{
+	clock_t start;
+	Uint32 ticks;
+
+	start = clock();
+	ticks = SDL_GetTicks();
+	SDL_Delay(BENCH_MS);
+	ticks = SDL_GetTicks() - ticks;
+	start = clock() - start;
+	return (100.0 * start / CLOCKS_PER_SEC) / (ticks / 1000.0);
+}
+
+static void bench_idle_channels(Mix_Chunk *loop)
+{
+	int allocated;
+
+	for (allocated = 8; allocated <= 1024; allocated *= 128) {
+		int i;
+
+		Mix_AllocateChannels(allocated);
+		for (i = 0; i < 4; i++) {
+			Mix_PlayChannel(-1, loop, -1);
+		}
+		printf("4 channels playing out of %4d: %5.1f%% CPU\n",
+		       allocated, cpu_while_sleeping());
+		Mix_HaltChannel(-1);
+	}
+}
+
+static void bench_oneshots(Mix_Chunk *shot)
+{
+	Uint32 start, now, ms;
+	clock_t cpu;
+	int i, played = 0, failed = 0;
+	Mix_StealPolicy policy;
+
+	Mix_AllocateChannels(256);
+	for (policy = MIX_STEAL_OLDEST; policy <= MIX_STEAL_PRIORITY; policy++) {
+		static const char *names[] = { "none", "oldest", "quietest", "priority" };
+
+		Mix_SetStealPolicy(policy);
+
+		/* Every channel busy, so every play steals one */
+		for (i = 0; i < 256; i++) {
+			Mix_PlayChannel(i, shot, -1);
+		}
+		start = SDL_GetTicks();
+		for (i = 0; i < PLAY_CALLS; i++) {
+			Mix_PlayChannel(-1, shot, 0);
+		}
+		ms = SDL_GetTicks() - start;
+		printf("Stealing the %s channel of 256: %.2f us a play\n",
+		       names[policy], (1000.0 * ms) / PLAY_CALLS);
+		Mix_HaltChannel(-1);
+	}
+
+	/* One-shots at a steady rate, stealing only when they pile up */
+	Mix_SetStealPolicy(MIX_STEAL_OLDEST);
+	cpu = clock();
+	start = SDL_GetTicks();
+	while ( (now = SDL_GetTicks()) - start < BENCH_MS ) {
+		while ( played + failed < (int)(now - start) * SHOTS_PER_MS ) {
+			if ( Mix_PlayChannel(-1, shot, 0) < 0 ) {
+				++failed;
+			} else {
+				++played;
+			}
+		}
+		SDL_Delay(1);
+	}
+	cpu = clock() - cpu;
+	printf("%d one-shots a second on 256 channels: %d played, %d failed, %5.1f%% CPU\n",
+	       SHOTS_PER_MS * 1000, played, failed,
+	       (100.0 * cpu / CLOCKS_PER_SEC) / (BENCH_MS / 1000.0));
+	Mix_HaltChannel(-1);
+	Mix_SetStealPolicy(MIX_STEAL_NONE);
+}
+
+int main(int argc, char *argv[])
+{
+	int audio_rate;
+	Uint16 audio_format;
+	int audio_channels;
+	Mix_Chunk *shot, *loop;
+	int i, errors = 0;
+
+	if ( SDL_Init(SDL_INIT_AUDIO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n",SDL_GetError());
+		return(1);
+	}
+	if ( Mix_OpenAudio(44100, AUDIO_S16SYS, 2, 1024) < 0 ) {
+		fprintf(stderr, "Couldn't open audio: %s\n", SDL_GetError());
+		SDL_Quit();
+		return(1);
+	}
+	Mix_QuerySpec(&audio_rate, &audio_format, &audio_channels);
+
+	/* A short burst of noise in the mixer format */
+	sound_len = (audio_rate * SHOT_MS / 1000) * audio_channels *
+	            ((audio_format & 0xFF) / 8);
+	sound = (Uint8 *)malloc(sound_len);
+	srand(1);
+	for (i = 0; i < sound_len; i++) {
+		sound[i] = rand() & 0x1F;
+	}
+
+	errors += test_policies();
+	if ( errors ) {
+		printf("%d channel allocation tests failed\n", errors);
+	} else {
+		printf("All channel allocation tests passed.\n");
+	}
+
+	shot = Mix_QuickLoad_RAW(sound, sound_len);
+	loop = Mix_QuickLoad_RAW(sound, sound_len);
+	bench_idle_channels(loop);
+	bench_oneshots(shot);
+	Mix_FreeChunk(shot);
+	Mix_FreeChunk(loop);
+
+	Mix_CloseAudio();
+	free(sound);
+	SDL_Quit();
+	return (errors ? 1 : 0);
+}
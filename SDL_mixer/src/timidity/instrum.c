@@ -686,8 +686,9 @@ static InstrumentLayer *load_instrument(char *name, int font_type, int percussio
         {
 	  goto fail;
 	}
-      sp->data = safe_malloc(sp->data_length + 1);
-      lp->size += sp->data_length + 1;
+      /* One more 16-bit sample is added past the end below */
+      sp->data = safe_malloc(sp->data_length + 2);
+      lp->size += sp->data_length + 2;
 
       if (1 != fread(sp->data, sp->data_length, 1, fp))
 	goto fail;
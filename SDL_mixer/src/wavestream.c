@@ -173,6 +173,20 @@ void WAVStream_Start(WAVStream *wave)
 	music = wave;
 }
 
+/* Make sure the stream's buffer holds at least len bytes */
+static int WAVStream_Reserve(WAVStream *wave, int len)
+{
+	if ( len > wave->buflen ) {
+		Uint8 *buf = (Uint8 *)realloc(wave->cvt.buf, len);
+		if ( buf == NULL ) {
+			return(0);
+		}
+		wave->cvt.buf = buf;
+		wave->buflen = len;
+	}
+	return(1);
+}
+
 /* Play some of a stream previously started with WAVStream_Start() */
 void WAVStream_PlaySome(Uint8 *stream, int len)
 {
@@ -183,17 +197,8 @@ void WAVStream_PlaySome(Uint8 *stream, int len)
 			int original_len;
 
 			original_len=(int)((double)len/music->cvt.len_ratio);
-			if ( music->cvt.len != original_len ) {
-				int worksize;
-				if ( music->cvt.buf != NULL ) {
-					free(music->cvt.buf);
-				}
-				worksize = original_len*music->cvt.len_mult;
-				music->cvt.buf=(Uint8 *)malloc(worksize);
-				if ( music->cvt.buf == NULL ) {
-					return;
-				}
-				music->cvt.len = original_len;
+			if ( !WAVStream_Reserve(music, original_len*music->cvt.len_mult) ) {
+				return;
 			}
 			if ( (music->stop - pos) < original_len ) {
 				original_len = (music->stop - pos);
@@ -210,19 +215,22 @@ void WAVStream_PlaySome(Uint8 *stream, int len)
 			}
 			music->cvt.len = original_len;
 			SDL_ConvertAudio(&music->cvt);
+			/* Resampling may make a frame more than len */
+			if ( music->cvt.len_cvt > len ) {
+				music->cvt.len_cvt = len;
+			}
 			SDL_MixAudio(stream, music->cvt.buf, music->cvt.len_cvt, wavestream_volume);
 		} else {
-			Uint8 *data;
 			if ( (music->stop - pos) < len ) {
 				len = (music->stop - pos);
 			}
-			data = SDL_stack_alloc(Uint8, len);
-			if (data)
-			{		
-				SDL_RWread(music->rw, data, len, 1);
-				SDL_MixAudio(stream, data, len, wavestream_volume);
-				SDL_stack_free(data);
-			}	
+			if ( wavestream_volume == MIX_MAX_VOLUME ) {
+				/* The stream is silent, so read straight into it */
+				SDL_RWread(music->rw, stream, len, 1);
+			} else if ( WAVStream_Reserve(music, len) ) {
+				SDL_RWread(music->rw, music->cvt.buf, len, 1);
+				SDL_MixAudio(stream, music->cvt.buf, len, wavestream_volume);
+			}
 		}
 	}
 }
@@ -32,6 +32,7 @@ typedef struct {
 	long  start;
 	long  stop;
 	SDL_AudioCVT cvt;
+	int buflen;		/* The size of cvt.buf, which only ever grows */
 } WAVStream;
 
 /* Initialize the WAVStream player, with the given mixer settings
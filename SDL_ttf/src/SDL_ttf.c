@@ -48,6 +48,27 @@
 #include "SDL_endian.h"
 #include "SDL_ttf.h"
 
+/* Glyphs are composited a vector at a time where the CPU has a unit for it,
+   and a pixel at a time otherwise */
+#if SDL_ASSEMBLY_ROUTINES
+#  if defined(__GNUC__) && defined(__SSE2__)
+#    define TTF_SIMD_SSE2	1
+#  elif SDL_ALTIVEC_BLITTERS
+#    define TTF_SIMD_ALTIVEC	1
+#  endif
+#endif
+
+#if TTF_SIMD_SSE2
+#include <emmintrin.h>
+#elif TTF_SIMD_ALTIVEC
+#if __MWERKS__
+#pragma altivec_model on
+#endif
+#ifdef HAVE_ALTIVEC_H
+#include <altivec.h>
+#endif
+#endif
+
 /* FIXME: Right now we assume the gray-scale renderer Freetype is using
    supports 256 shades of gray, but we should instead key off of num_grays
    in the result FT_Bitmap after the FT_Render_Glyph() call. */
@@ -61,6 +82,33 @@
 #define CACHED_BITMAP	0x01
 #define CACHED_PIXMAP	0x02
 
+/* The default memory limit for glyphs outside Latin-1 */
+#define GLYPH_CACHE_LIMIT	(256*1024)
+
+/* The glyph atlases, one for each way of drawing text */
+#define ATLAS_SOLID	0
+#define ATLAS_SHADED	1
+#define ATLAS_BLENDED	2
+#define NUM_ATLASES	3
+
+/* The smallest atlas page, and the default number of pages per atlas */
+#define ATLAS_PAGE_SIZE	256
+#define ATLAS_PAGES	4
+
+/* The text colors blended pages are kept in at once */
+#define ATLAS_COLORS	4
+
+/* What the string cache keeps for a string, and the string's encoding */
+#define STRING_SIZE	0
+#define STRING_SOLID	1
+#define STRING_SHADED	2
+#define STRING_BLENDED	3
+
+#define STRING_LATIN1	0
+#define STRING_UTF8	1
+#define STRING_UNICODE	2
+#define STRING_SWAPPED	3	/* Byte swapped UNICODE */
+
 /* Cached glyph information */
 typedef struct cached_glyph {
 	int stored;
@@ -74,8 +122,73 @@ typedef struct cached_glyph {
 	int yoffset;
 	int advance;
 	Uint16 cached;
+	struct {
+		Uint16 page;	/* 1-based, 0 if not in the atlas */
+		Uint16 x;
+		Uint16 y;
+	} atlas[NUM_ATLASES];
 } c_glyph;
 
+/* Glyphs outside Latin-1, hashed by character and style */
+typedef struct glyph_entry {
+	c_glyph glyph;
+	Uint32 key;
+	int size;
+	struct glyph_entry *prev;	/* Most recently used first */
+	struct glyph_entry *next;
+} glyph_entry;
+
+/* A row of glyphs packed in an atlas page */
+typedef struct atlas_shelf {
+	int y;
+	int h;
+	int x;		/* Where the next glyph goes */
+} atlas_shelf;
+
+typedef struct atlas_page {
+	SDL_Surface *surface[ATLAS_COLORS];	/* Only blended pages use more than one */
+	atlas_shelf *shelves;
+	int num_shelves;
+	int bottom;	/* Top of the space below the shelves */
+} atlas_page;
+
+/* Glyphs packed on shelves in surfaces, to draw text with blits */
+typedef struct glyph_atlas {
+	atlas_page *pages;
+	int num_pages;
+	int colored;	/* The pages are set up for these colors */
+	SDL_Color fg;
+	SDL_Color bg;
+
+	/* Blended glyphs keep their coverage in the alpha of every copy of a
+	   page, so a copy in a new color is made from any other, and the copy
+	   used longest ago is recolored when there's no room for another */
+	int num_colors;
+	int color;	/* The copy being drawn from */
+	SDL_Color colors[ATLAS_COLORS];
+	Uint32 used[ATLAS_COLORS];
+	Uint32 clock;
+} glyph_atlas;
+
+/* A rendered string, or the size of one, in the string cache */
+typedef struct string_entry {
+	Uint32 hash;
+	int kind;
+	int encoding;
+	int style;
+	SDL_Color fg;
+	SDL_Color bg;
+	void *text;
+	int len;		/* In bytes */
+	int w;
+	int h;
+	SDL_Surface *surface;	/* The cache holds a reference */
+	int size;
+	struct string_entry *chain;	/* Next in the hash bucket */
+	struct string_entry *prev;	/* Most recently used first */
+	struct string_entry *next;
+} string_entry;
+
 /* The structure used to hold internal font information */
 struct _TTF_Font {
 	/* Freetype2 maintains all sorts of useful info itself */
@@ -101,7 +214,34 @@ struct _TTF_Font {
 	/* Cache for style-transformed glyphs */
 	c_glyph *current;
 	c_glyph cache[256];
-	c_glyph scratch;
+
+	/* Open addressed hash table for the other glyphs, with a memory
+	   limit past which the least recently used glyphs are freed */
+	glyph_entry **table;
+	int table_size;
+	int table_count;
+	glyph_entry *lru_head;
+	glyph_entry *lru_tail;
+	int cache_bytes;
+	int cache_limit;
+	Uint32 cache_hits;
+	Uint32 cache_misses;
+
+	/* Atlases for drawing text straight onto surfaces */
+	glyph_atlas atlas[NUM_ATLASES];
+	int atlas_size;
+	int atlas_limit;
+
+	/* Optional cache of rendered strings and string sizes */
+	string_entry **strings;
+	int strings_size;
+	int strings_count;
+	string_entry *strings_head;
+	string_entry *strings_tail;
+	int strings_bytes;
+	int strings_limit;
+	Uint32 strings_hits;
+	Uint32 strings_misses;
 
 	/* We are responsible for closing the font stream */
 	SDL_RWops *src;
@@ -116,6 +256,7 @@ struct _TTF_Font {
 static FT_Library library;
 static int TTF_initialized = 0;
 static int TTF_byteswapped = 0;
+static int TTF_simd = 0;
 
 /* UNICODE string utilities */
 static __inline__ int UNICODE_strlen(const Uint16 *text)
@@ -205,6 +346,14 @@ int TTF_Init( void )
 			TTF_SetFTError("Couldn't init FreeType engine", error);
 			status = -1;
 		}
+#if TTF_SIMD_SSE2
+		TTF_simd = SDL_HasSSE2();
+#elif TTF_SIMD_ALTIVEC
+		TTF_simd = SDL_HasAltiVec();
+#endif
+		if ( SDL_getenv(TTF_NOSIMD) != NULL ) {
+			TTF_simd = 0;
+		}
 	}
 	if ( status == 0 ) {
 		++TTF_initialized;
@@ -257,6 +406,8 @@ TTF_Font* TTF_OpenFontIndexRW( SDL_RWops *src, int freesrc, int ptsize, long ind
 	}
 	memset(font, 0, sizeof(*font));
 
+	font->cache_limit = GLYPH_CACHE_LIMIT;
+	font->atlas_limit = ATLAS_PAGES;
 	font->src = src;
 	font->freesrc = freesrc;
 
@@ -387,6 +538,7 @@ static void Flush_Glyph( c_glyph* glyph )
 		glyph->pixmap.buffer = 0;
 	}
 	glyph->cached = 0;
+	memset( glyph->atlas, 0, sizeof( glyph->atlas ) );
 }
 	
 static void Flush_Cache( TTF_Font* font )
@@ -400,10 +552,160 @@ static void Flush_Cache( TTF_Font* font )
 		}
 
 	}
-	if( font->scratch.cached ) {
-		Flush_Glyph( &font->scratch );
+}
+
+static __inline__ int Hash_Slot( const TTF_Font* font, Uint32 key )
+{
+	Uint32 hash = key * 2654435761U;
+	return (int)((hash ^ (hash >> 15)) & (font->table_size - 1));
+}
+
+static void Unlink_Entry( TTF_Font* font, glyph_entry* entry )
+{
+	if ( entry->prev ) {
+		entry->prev->next = entry->next;
+	} else {
+		font->lru_head = entry->next;
+	}
+	if ( entry->next ) {
+		entry->next->prev = entry->prev;
+	} else {
+		font->lru_tail = entry->prev;
+	}
+}
+
+static void Link_Entry( TTF_Font* font, glyph_entry* entry )
+{
+	entry->prev = NULL;
+	entry->next = font->lru_head;
+	if ( font->lru_head ) {
+		font->lru_head->prev = entry;
+	} else {
+		font->lru_tail = entry;
+	}
+	font->lru_head = entry;
+}
+
+/* Take a glyph out of the hash table and free it */
+static void Remove_Entry( TTF_Font* font, glyph_entry* entry )
+{
+	int mask = font->table_size - 1;
+	int i, j, home;
+
+	i = Hash_Slot( font, entry->key );
+	while ( font->table[i] != entry ) {
+		i = (i + 1) & mask;
+	}
+
+	/* Shift back the entries that probed past this slot */
+	font->table[i] = NULL;
+	for ( j = (i + 1) & mask; font->table[j]; j = (j + 1) & mask ) {
+		home = Hash_Slot( font, font->table[j]->key );
+		if ( (j > i) ? (home <= i || home > j) : (home <= i && home > j) ) {
+			font->table[i] = font->table[j];
+			font->table[j] = NULL;
+			i = j;
+		}
+	}
+	--font->table_count;
+
+	Unlink_Entry( font, entry );
+	font->cache_bytes -= entry->size;
+	Flush_Glyph( &entry->glyph );
+	free( entry );
+}
+
+/* Free the least recently used glyphs until the cache fits its limit */
+static void Trim_Glyphs( TTF_Font* font, glyph_entry* keep )
+{
+	while ( font->cache_bytes > font->cache_limit &&
+	        font->lru_tail && font->lru_tail != keep ) {
+		Remove_Entry( font, font->lru_tail );
+	}
+}
+
+static void Free_Glyphs( TTF_Font* font )
+{
+	while ( font->lru_tail ) {
+		Remove_Entry( font, font->lru_tail );
+	}
+	if ( font->table ) {
+		free( font->table );
+		font->table = NULL;
+	}
+	font->table_size = 0;
+}
+
+static int Grow_Table( TTF_Font* font )
+{
+	glyph_entry **old_table = font->table;
+	int old_size = font->table_size;
+	int i, j;
+
+	font->table_size = old_size ? old_size * 2 : 64;
+	font->table = (glyph_entry **)calloc(font->table_size, sizeof(*font->table));
+	if ( !font->table ) {
+		font->table = old_table;
+		font->table_size = old_size;
+		return -1;
+	}
+	for ( i = 0; i < old_size; ++i ) {
+		if ( old_table[i] ) {
+			j = Hash_Slot( font, old_table[i]->key );
+			while ( font->table[j] ) {
+				j = (j + 1) & (font->table_size - 1);
+			}
+			font->table[j] = old_table[i];
+		}
+	}
+	if ( old_table ) {
+		free( old_table );
+	}
+	return 0;
+}
+
+/* Find or add the hashed glyph for a character in the current style */
+static glyph_entry* Find_Entry( TTF_Font* font, Uint16 ch )
+{
+	Uint32 key = ch | ((Uint32)font->style << 16);
+	glyph_entry* entry;
+	int i;
+
+	if ( font->table_size ) {
+		for ( i = Hash_Slot( font, key ); font->table[i];
+		      i = (i + 1) & (font->table_size - 1) ) {
+			entry = font->table[i];
+			if ( entry->key == key ) {
+				Unlink_Entry( font, entry );
+				Link_Entry( font, entry );
+				return entry;
+			}
+		}
+	}
+
+	/* Keep the table at most three quarters full */
+	if ( (font->table_count + 1) * 4 > font->table_size * 3 ) {
+		if ( Grow_Table( font ) < 0 ) {
+			return NULL;
+		}
+	}
+	entry = (glyph_entry *)malloc(sizeof(*entry));
+	if ( !entry ) {
+		return NULL;
 	}
+	memset(entry, 0, sizeof(*entry));
+	entry->key = key;
+	entry->size = sizeof(*entry);
 
+	i = Hash_Slot( font, key );
+	while ( font->table[i] ) {
+		i = (i + 1) & (font->table_size - 1);
+	}
+	font->table[i] = entry;
+	++font->table_count;
+	Link_Entry( font, entry );
+	font->cache_bytes += entry->size;
+	return entry;
 }
 
 static FT_Error Load_Glyph( TTF_Font* font, Uint16 ch, c_glyph* cached, int want )
@@ -702,208 +1004,742 @@ static FT_Error Load_Glyph( TTF_Font* font, Uint16 ch, c_glyph* cached, int want
 static FT_Error Find_Glyph( TTF_Font* font, Uint16 ch, int want )
 {
 	int retval = 0;
+	glyph_entry* entry = NULL;
 
 	if( ch < 256 ) {
 		font->current = &font->cache[ch];
 	} else {
-		if ( font->scratch.cached != ch ) {
-			Flush_Glyph( &font->scratch );
+		entry = Find_Entry( font, ch );
+		if ( !entry ) {
+			return FT_Err_Out_Of_Memory;
 		}
-		font->current = &font->scratch;
+		font->current = &entry->glyph;
 	}
 	if ( (font->current->stored & want) != want ) {
+		++font->cache_misses;
 		retval = Load_Glyph( font, ch, font->current, want );
+		if ( entry ) {
+			int size = sizeof(*entry);
+
+			if ( entry->glyph.bitmap.buffer ) {
+				size += entry->glyph.bitmap.pitch * entry->glyph.bitmap.rows;
+			}
+			if ( entry->glyph.pixmap.buffer ) {
+				size += entry->glyph.pixmap.pitch * entry->glyph.pixmap.rows;
+			}
+			font->cache_bytes += size - entry->size;
+			entry->size = size;
+		}
+	} else {
+		++font->cache_hits;
+	}
+	if ( entry ) {
+		Trim_Glyphs( font, entry );
 	}
 	return retval;
 }
 
-void TTF_CloseFont( TTF_Font* font )
+static void Free_Page( atlas_page* page )
 {
-	if ( font ) {
-		Flush_Cache( font );
-		if ( font->face ) {
-			FT_Done_Face( font->face );
-		}
-		if ( font->args.stream ) {
-			free( font->args.stream );
-		}
-		if ( font->freesrc ) {
-			SDL_RWclose( font->src );
+	int i;
+
+	for ( i = 0; i < ATLAS_COLORS; ++i ) {
+		if ( page->surface[i] ) {
+			SDL_FreeSurface( page->surface[i] );
+			page->surface[i] = NULL;
 		}
-		free( font );
 	}
+	free( page->shelves );
+	page->shelves = NULL;
 }
 
-static Uint16 *LATIN1_to_UNICODE(Uint16 *unicode, const char *text, int len)
+static void Free_Atlases( TTF_Font* font )
 {
-	int i;
+	glyph_atlas* atlas;
+	int i, j;
 
-	for ( i=0; i < len; ++i ) {
-		unicode[i] = ((const unsigned char *)text)[i];
+	for ( i = 0; i < NUM_ATLASES; ++i ) {
+		atlas = &font->atlas[i];
+		for ( j = 0; j < atlas->num_pages; ++j ) {
+			Free_Page( &atlas->pages[j] );
+		}
+		if ( atlas->pages ) {
+			free( atlas->pages );
+			atlas->pages = NULL;
+		}
+		atlas->num_pages = 0;
+		atlas->colored = 0;
+		atlas->num_colors = 0;
+		atlas->color = 0;
 	}
-	unicode[i] = 0;
-
-	return unicode;
 }
 
-static Uint16 *UTF8_to_UNICODE(Uint16 *unicode, const char *utf8, int len)
+/* Empty an atlas that is full, keeping its pages */
+static void Reset_Atlas( TTF_Font* font, int which )
 {
+	glyph_atlas* atlas = &font->atlas[which];
+	glyph_entry* entry;
 	int i, j;
-	Uint16 ch;
 
-	for ( i=0, j=0; i < len; ++i, ++j ) {
-		ch = ((const unsigned char *)utf8)[i];
-		if ( ch >= 0xF0 ) {
-			ch  =  (Uint16)(utf8[i]&0x07) << 18;
-			ch |=  (Uint16)(utf8[++i]&0x3F) << 12;
-			ch |=  (Uint16)(utf8[++i]&0x3F) << 6;
-			ch |=  (Uint16)(utf8[++i]&0x3F);
-		} else
-		if ( ch >= 0xE0 ) {
-			ch  =  (Uint16)(utf8[i]&0x0F) << 12;
-			ch |=  (Uint16)(utf8[++i]&0x3F) << 6;
-			ch |=  (Uint16)(utf8[++i]&0x3F);
-		} else
-		if ( ch >= 0xC0 ) {
-			ch  =  (Uint16)(utf8[i]&0x1F) << 6;
-			ch |=  (Uint16)(utf8[++i]&0x3F);
+	for ( i = 0; i < 256; ++i ) {
+		font->cache[i].atlas[which].page = 0;
+	}
+	for ( entry = font->lru_head; entry; entry = entry->next ) {
+		entry->glyph.atlas[which].page = 0;
+	}
+	for ( i = 0; i < atlas->num_pages; ++i ) {
+		for ( j = 0; j < ATLAS_COLORS; ++j ) {
+			if ( atlas->pages[i].surface[j] ) {
+				SDL_FillRect( atlas->pages[i].surface[j], NULL, 0 );
+			}
 		}
-		unicode[j] = ch;
+		atlas->pages[i].num_shelves = 0;
+		atlas->pages[i].bottom = 0;
 	}
-	unicode[j] = 0;
-
-	return unicode;
 }
 
-int TTF_FontHeight(const TTF_Font *font)
+static void Color_Page( TTF_Font* font, int which, SDL_Surface* surface )
 {
-	return(font->height);
-}
+	glyph_atlas* atlas = &font->atlas[which];
+	SDL_Color colors[NUM_GRAYS];
+	int rdiff, gdiff, bdiff;
+	int index;
 
-int TTF_FontAscent(const TTF_Font *font)
-{
-	return(font->ascent);
+	switch ( which ) {
+	    case ATLAS_SOLID:
+		colors[0].r = 255 - atlas->fg.r;
+		colors[0].g = 255 - atlas->fg.g;
+		colors[0].b = 255 - atlas->fg.b;
+		colors[1] = atlas->fg;
+		SDL_SetColors( surface, colors, 0, 2 );
+		break;
+	    case ATLAS_SHADED:
+		rdiff = atlas->fg.r - atlas->bg.r;
+		gdiff = atlas->fg.g - atlas->bg.g;
+		bdiff = atlas->fg.b - atlas->bg.b;
+		for( index = 0; index < NUM_GRAYS; ++index ) {
+			colors[index].r = atlas->bg.r + (index*rdiff) / (NUM_GRAYS-1);
+			colors[index].g = atlas->bg.g + (index*gdiff) / (NUM_GRAYS-1);
+			colors[index].b = atlas->bg.b + (index*bdiff) / (NUM_GRAYS-1);
+		}
+		SDL_SetColors( surface, colors, 0, NUM_GRAYS );
+		break;
+	}
 }
 
-int TTF_FontDescent(const TTF_Font *font)
+/* Copy the glyph alpha of a blended page, in another color */
+static void Recolor_Page( SDL_Surface* dst, SDL_Surface* src, SDL_Color fg )
 {
-	return(font->descent);
-}
+	Uint32 pixel = (fg.r<<16)|(fg.g<<8)|fg.b;
+	Uint32* d;
+	Uint32* s;
+	int row, col;
 
-int TTF_FontLineSkip(const TTF_Font *font)
-{
-	return(font->lineskip);
+	for ( row = 0; row < src->h; ++row ) {
+		s = (Uint32*)((Uint8*)src->pixels + row * src->pitch);
+		d = (Uint32*)((Uint8*)dst->pixels + row * dst->pitch);
+		for ( col = 0; col < src->w; ++col ) {
+			d[col] = (s[col] & 0xFF000000) | pixel;
+		}
+	}
 }
 
-long TTF_FontFaces(const TTF_Font *font)
+static SDL_Surface* Create_Page( int which, int size )
 {
-	return(font->face->num_faces);
-}
+	SDL_Surface* surface;
 
-int TTF_FontFaceIsFixedWidth(const TTF_Font *font)
-{
-	return(FT_IS_FIXED_WIDTH(font->face));
+	if ( which == ATLAS_BLENDED ) {
+		surface = SDL_CreateRGBSurface( SDL_SWSURFACE, size, size, 32,
+		                   0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 );
+	} else {
+		surface = SDL_CreateRGBSurface( SDL_SWSURFACE, size, size,
+		                   8, 0, 0, 0, 0 );
+	}
+	if ( !surface ) {
+		return NULL;
+	}
+	SDL_FillRect( surface, NULL, 0 );
+	if ( which != ATLAS_BLENDED ) {
+		/* The 0 pixels are what isn't glyph */
+		SDL_SetColorKey( surface, SDL_SRCCOLORKEY, 0 );
+	}
+	return surface;
 }
 
-char *TTF_FontFaceFamilyName(const TTF_Font *font)
+/* Draw blended text from the copy of the pages in its color, making one
+   from the copy drawn from last if there isn't one yet */
+static int Color_Blended( TTF_Font* font, SDL_Color fg )
 {
-	return(font->face->family_name);
+	glyph_atlas* atlas = &font->atlas[ATLAS_BLENDED];
+	atlas_page* page;
+	int slot, i;
+
+	for ( slot = 0; slot < atlas->num_colors; ++slot ) {
+		if ( atlas->colors[slot].r == fg.r &&
+		     atlas->colors[slot].g == fg.g &&
+		     atlas->colors[slot].b == fg.b ) {
+			break;
+		}
+	}
+	if ( slot == atlas->num_colors ) {
+		if ( atlas->num_colors < ATLAS_COLORS ) {
+			for ( i = 0; i < atlas->num_pages; ++i ) {
+				page = &atlas->pages[i];
+				page->surface[slot] = Create_Page( ATLAS_BLENDED, font->atlas_size );
+				if ( !page->surface[slot] ) {
+					while ( i-- > 0 ) {
+						SDL_FreeSurface( atlas->pages[i].surface[slot] );
+						atlas->pages[i].surface[slot] = NULL;
+					}
+					return -1;
+				}
+			}
+			++atlas->num_colors;
+		} else {
+			slot = 0;
+			for ( i = 1; i < atlas->num_colors; ++i ) {
+				if ( atlas->used[i] < atlas->used[slot] ) {
+					slot = i;
+				}
+			}
+		}
+		for ( i = 0; i < atlas->num_pages; ++i ) {
+			page = &atlas->pages[i];
+			Recolor_Page( page->surface[slot], page->surface[atlas->color], fg );
+		}
+		atlas->colors[slot] = fg;
+	}
+	atlas->color = slot;
+	atlas->used[slot] = ++atlas->clock;
+	return 0;
 }
 
-char *TTF_FontFaceStyleName(const TTF_Font *font)
+/* Set up the pages of an atlas to draw in the given colors */
+static int Color_Atlas( TTF_Font* font, int which, SDL_Color fg, SDL_Color bg )
 {
-	return(font->face->style_name);
-}
+	glyph_atlas* atlas = &font->atlas[which];
+	int i;
 
-int TTF_GlyphIsProvided(const TTF_Font *font, Uint16 ch)
-{
-  return(FT_Get_Char_Index(font->face, ch));
+	if ( which == ATLAS_BLENDED ) {
+		return Color_Blended( font, fg );
+	}
+	if ( atlas->colored &&
+	     atlas->fg.r == fg.r && atlas->fg.g == fg.g && atlas->fg.b == fg.b &&
+	     (which != ATLAS_SHADED ||
+	      (atlas->bg.r == bg.r && atlas->bg.g == bg.g && atlas->bg.b == bg.b)) ) {
+		return 0;
+	}
+	atlas->fg = fg;
+	atlas->bg = bg;
+	atlas->colored = 1;
+	for ( i = 0; i < atlas->num_pages; ++i ) {
+		Color_Page( font, which, atlas->pages[i].surface[0] );
+	}
+	return 0;
 }
 
-int TTF_GlyphMetrics(TTF_Font *font, Uint16 ch,
-                     int* minx, int* maxx, int* miny, int* maxy, int* advance)
+static int Add_Page( TTF_Font* font, int which )
 {
-	FT_Error error;
+	glyph_atlas* atlas = &font->atlas[which];
+	atlas_page* pages;
+	atlas_page* page;
+	int size, i, copies;
 
-	error = Find_Glyph(font, ch, CACHED_METRICS);
-	if ( error ) {
-		TTF_SetFTError("Couldn't find glyph", error);
+	/* Make the pages big enough for a few rows of the biggest glyphs */
+	if ( !font->atlas_size ) {
+		size = ATLAS_PAGE_SIZE;
+		while ( size < font->height * 4 ) {
+			size *= 2;
+		}
+		font->atlas_size = size;
+	}
+	size = font->atlas_size;
+
+	pages = (atlas_page *)realloc( atlas->pages, (atlas->num_pages + 1) * sizeof(*pages) );
+	if ( !pages ) {
+		TTF_SetError( "Out of memory" );
 		return -1;
 	}
+	atlas->pages = pages;
+	page = &pages[atlas->num_pages];
+	memset( page, 0, sizeof(*page) );
 
-	if ( minx ) {
-		*minx = font->current->minx;
+	page->shelves = (atlas_shelf *)malloc( size * sizeof(*page->shelves) );
+	if ( !page->shelves ) {
+		TTF_SetError( "Out of memory" );
+		return -1;
 	}
-	if ( maxx ) {
-		*maxx = font->current->maxx;
-		if( font->style & TTF_STYLE_BOLD ) {
-			*maxx += font->glyph_overhang;
+	/* A blended page is empty in every color */
+	copies = (which == ATLAS_BLENDED) ? atlas->num_colors : 1;
+	for ( i = 0; i < copies; ++i ) {
+		page->surface[i] = Create_Page( which, size );
+		if ( !page->surface[i] ) {
+			Free_Page( page );
+			return -1;
 		}
 	}
-	if ( miny ) {
-		*miny = font->current->miny;
-	}
-	if ( maxy ) {
-		*maxy = font->current->maxy;
+	if ( atlas->colored ) {
+		Color_Page( font, which, page->surface[0] );
 	}
-	if ( advance ) {
-		*advance = font->current->advance;
-		if( font->style & TTF_STYLE_BOLD ) {
-			*advance += font->glyph_overhang;
+	++atlas->num_pages;
+	return 0;
+}
+
+/* Find room for a glyph: the closest fitting shelf that isn't much
+   taller than it, else a new shelf, else any shelf it fits on */
+static int Pack_Glyph( TTF_Font* font, int which, int w, int h,
+                       int* page_index, int* x, int* y )
+{
+	glyph_atlas* atlas = &font->atlas[which];
+	atlas_page* page;
+	atlas_shelf* shelf;
+	atlas_shelf* best = NULL;
+	int size = font->atlas_size;
+	int pass, i, j;
+
+	for ( pass = 0; pass < 3 && !best; ++pass ) {
+		for ( i = 0; i < atlas->num_pages; ++i ) {
+			page = &atlas->pages[i];
+			if ( pass == 1 ) {
+				if ( page->bottom + h <= size && w <= size ) {
+					best = &page->shelves[page->num_shelves++];
+					best->y = page->bottom;
+					best->h = h;
+					best->x = 0;
+					page->bottom += h;
+					*page_index = i;
+					break;
+				}
+				continue;
+			}
+			for ( j = 0; j < page->num_shelves; ++j ) {
+				shelf = &page->shelves[j];
+				if ( shelf->h < h || shelf->x + w > size ) {
+					continue;
+				}
+				if ( pass == 0 && shelf->h > h + h / 4 + 1 ) {
+					continue;
+				}
+				if ( !best || shelf->h < best->h ) {
+					best = shelf;
+					*page_index = i;
+				}
+			}
 		}
 	}
+	if ( !best ) {
+		return -1;
+	}
+	*x = best->x;
+	*y = best->y;
+	best->x += w;
 	return 0;
 }
 
-int TTF_SizeText(TTF_Font *font, const char *text, int *w, int *h)
+/* Make sure the current glyph is in an atlas, rendered as it needs to be */
+static int Atlas_Glyph( TTF_Font* font, int which, c_glyph* glyph )
 {
-	Uint16 *unicode_text;
-	int unicode_len;
-	int status;
+	glyph_atlas* atlas = &font->atlas[which];
+	FT_Bitmap* current;
+	SDL_Surface* surface;
+	int width, row, col;
+	int page, x, y, i;
+	Uint8* src;
 
-	/* Copy the Latin-1 text to a UNICODE text buffer */
-	unicode_len = strlen(text);
-	unicode_text = (Uint16 *)ALLOCA((1+unicode_len+1)*(sizeof *unicode_text));
-	if ( unicode_text == NULL ) {
-		TTF_SetError("Out of memory");
-		return -1;
+	if ( glyph->atlas[which].page ) {
+		return 0;
 	}
-	*unicode_text = UNICODE_BOM_NATIVE;
-	LATIN1_to_UNICODE(unicode_text+1, text, unicode_len);
 
-	/* Render the new text */
-	status = TTF_SizeUNICODE(font, unicode_text, w, h);
+	current = (which == ATLAS_SOLID) ? &glyph->bitmap : &glyph->pixmap;
+	width = current->width;
+	if (width > glyph->maxx - glyph->minx) {
+		width = glyph->maxx - glyph->minx;
+	}
 
-	/* Free the text buffer and return */
-	FREEA(unicode_text);
-	return status;
-}
+	if ( Pack_Glyph( font, which, width, current->rows, &page, &x, &y ) < 0 ) {
+		/* Start over when every page is full */
+		if ( atlas->num_pages < font->atlas_limit ) {
+			if ( Add_Page( font, which ) < 0 ) {
+				return -1;
+			}
+		} else {
+			Reset_Atlas( font, which );
+		}
+		if ( Pack_Glyph( font, which, width, current->rows, &page, &x, &y ) < 0 ) {
+			TTF_SetError( "Glyph doesn't fit in the atlas" );
+			return -1;
+		}
+	}
 
-int TTF_SizeUTF8(TTF_Font *font, const char *text, int *w, int *h)
-{
-	Uint16 *unicode_text;
-	int unicode_len;
-	int status;
+	if ( which == ATLAS_BLENDED ) {
+		/* Into every copy of the page, each in its own color */
+		for ( i = 0; i < atlas->num_colors; ++i ) {
+			SDL_Color fg = atlas->colors[i];
+			Uint32 pixel = (fg.r<<16)|(fg.g<<8)|fg.b;
 
-	/* Copy the UTF-8 text to a UNICODE text buffer */
-	unicode_len = strlen(text);
-	unicode_text = (Uint16 *)ALLOCA((1+unicode_len+1)*(sizeof *unicode_text));
-	if ( unicode_text == NULL ) {
-		TTF_SetError("Out of memory");
-		return -1;
+			surface = atlas->pages[page].surface[i];
+			for ( row = 0; row < current->rows; ++row ) {
+				Uint32* dst = (Uint32*)((Uint8*)surface->pixels +
+				                        (y + row) * surface->pitch) + x;
+				src = current->buffer + row * current->pitch;
+				for ( col = 0; col < width; ++col ) {
+					dst[col] = pixel | ((Uint32)src[col] << 24);
+				}
+			}
+		}
+	} else {
+		surface = atlas->pages[page].surface[0];
+		for ( row = 0; row < current->rows; ++row ) {
+			src = current->buffer + row * current->pitch;
+			memcpy( (Uint8*)surface->pixels + (y + row) * surface->pitch + x,
+			        src, width );
+		}
 	}
-	*unicode_text = UNICODE_BOM_NATIVE;
-	UTF8_to_UNICODE(unicode_text+1, text, unicode_len);
+	glyph->atlas[which].page = page + 1;
+	glyph->atlas[which].x = x;
+	glyph->atlas[which].y = y;
+	return 0;
+}
 
-	/* Render the new text */
-	status = TTF_SizeUNICODE(font, unicode_text, w, h);
+/* Mix the text and everything it was rendered with into a hash */
+static Uint32 Hash_String( int kind, int encoding, int style,
+                           SDL_Color fg, SDL_Color bg,
+                           const void* text, int len )
+{
+	const Uint8* data = (const Uint8*)text;
+	Uint32 hash = 2166136261U;
+	int i;
 
-	/* Free the text buffer and return */
-	FREEA(unicode_text);
-	return status;
+	for ( i = 0; i < len; ++i ) {
+		hash = (hash ^ data[i]) * 16777619U;
+	}
+	hash ^= (Uint32)kind | ((Uint32)encoding << 4) | ((Uint32)style << 8);
+	hash = (hash ^ (((Uint32)fg.r<<16)|((Uint32)fg.g<<8)|fg.b)) * 16777619U;
+	hash = (hash ^ (((Uint32)bg.r<<16)|((Uint32)bg.g<<8)|bg.b)) * 16777619U;
+	return hash ^ (hash >> 16);
 }
 
-int TTF_SizeUNICODE(TTF_Font *font, const Uint16 *text, int *w, int *h)
+static void Remove_String( TTF_Font* font, string_entry* entry )
+{
+	string_entry** link;
+
+	link = &font->strings[entry->hash & (font->strings_size - 1)];
+	while ( *link != entry ) {
+		link = &(*link)->chain;
+	}
+	*link = entry->chain;
+	--font->strings_count;
+
+	if ( entry->prev ) {
+		entry->prev->next = entry->next;
+	} else {
+		font->strings_head = entry->next;
+	}
+	if ( entry->next ) {
+		entry->next->prev = entry->prev;
+	} else {
+		font->strings_tail = entry->prev;
+	}
+	font->strings_bytes -= entry->size;
+
+	/* Whoever else has the surface keeps it */
+	if ( entry->surface ) {
+		SDL_FreeSurface( entry->surface );
+	}
+	free( entry->text );
+	free( entry );
+}
+
+static void Trim_Strings( TTF_Font* font )
+{
+	while ( font->strings_bytes > font->strings_limit && font->strings_tail ) {
+		Remove_String( font, font->strings_tail );
+	}
+}
+
+static void Free_Strings( TTF_Font* font )
+{
+	while ( font->strings_tail ) {
+		Remove_String( font, font->strings_tail );
+	}
+	if ( font->strings ) {
+		free( font->strings );
+		font->strings = NULL;
+	}
+	font->strings_size = 0;
+}
+
+static string_entry* Find_String( TTF_Font* font, int kind, int encoding,
+                                  const void* text, int len,
+                                  SDL_Color fg, SDL_Color bg )
+{
+	string_entry* entry = NULL;
+	Uint32 hash;
+
+	if ( font->strings_size ) {
+		hash = Hash_String( kind, encoding, font->style, fg, bg, text, len );
+		for ( entry = font->strings[hash & (font->strings_size - 1)];
+		      entry; entry = entry->chain ) {
+			if ( entry->hash == hash && entry->kind == kind &&
+			     entry->encoding == encoding &&
+			     entry->style == font->style && entry->len == len &&
+			     entry->fg.r == fg.r && entry->fg.g == fg.g &&
+			     entry->fg.b == fg.b && entry->bg.r == bg.r &&
+			     entry->bg.g == bg.g && entry->bg.b == bg.b &&
+			     memcmp( entry->text, text, len ) == 0 ) {
+				break;
+			}
+		}
+	}
+	if ( !entry ) {
+		++font->strings_misses;
+		return NULL;
+	}
+	++font->strings_hits;
+
+	/* Move it to the front of the list */
+	if ( entry->prev ) {
+		entry->prev->next = entry->next;
+		if ( entry->next ) {
+			entry->next->prev = entry->prev;
+		} else {
+			font->strings_tail = entry->prev;
+		}
+		entry->prev = NULL;
+		entry->next = font->strings_head;
+		font->strings_head->prev = entry;
+		font->strings_head = entry;
+	}
+	return entry;
+}
+
+/* Keep a rendered string, or the size of one, if it fits in the cache.
+   Strings that can't be kept are just not cached.
+ */
+static void Add_String( TTF_Font* font, int kind, int encoding,
+                        const void* text, int len,
+                        SDL_Color fg, SDL_Color bg,
+                        int w, int h, SDL_Surface* surface )
+{
+	string_entry* entry;
+	string_entry* next;
+	string_entry** table;
+	int size, i;
+
+	size = sizeof(*entry) + len;
+	if ( surface ) {
+		size += sizeof(*surface) + surface->pitch * surface->h;
+	}
+	if ( size > font->strings_limit ) {
+		return;
+	}
+
+	/* Keep the buckets at most one string deep on average */
+	if ( font->strings_count >= font->strings_size ) {
+		int table_size = font->strings_size ? font->strings_size * 2 : 64;
+
+		table = (string_entry **)calloc(table_size, sizeof(*table));
+		if ( !table ) {
+			return;
+		}
+		for ( i = 0; i < font->strings_size; ++i ) {
+			for ( entry = font->strings[i]; entry; entry = next ) {
+				next = entry->chain;
+				entry->chain = table[entry->hash & (table_size - 1)];
+				table[entry->hash & (table_size - 1)] = entry;
+			}
+		}
+		if ( font->strings ) {
+			free( font->strings );
+		}
+		font->strings = table;
+		font->strings_size = table_size;
+	}
+
+	entry = (string_entry *)malloc(sizeof(*entry));
+	if ( !entry ) {
+		return;
+	}
+	entry->text = malloc(len ? len : 1);
+	if ( !entry->text ) {
+		free( entry );
+		return;
+	}
+	memcpy( entry->text, text, len );
+	entry->len = len;
+	entry->hash = Hash_String( kind, encoding, font->style, fg, bg, text, len );
+	entry->kind = kind;
+	entry->encoding = encoding;
+	entry->style = font->style;
+	entry->fg = fg;
+	entry->bg = bg;
+	entry->w = w;
+	entry->h = h;
+	entry->surface = surface;
+	if ( surface ) {
+		++surface->refcount;
+	}
+	entry->size = size;
+
+	i = entry->hash & (font->strings_size - 1);
+	entry->chain = font->strings[i];
+	font->strings[i] = entry;
+	++font->strings_count;
+
+	entry->prev = NULL;
+	entry->next = font->strings_head;
+	if ( font->strings_head ) {
+		font->strings_head->prev = entry;
+	} else {
+		font->strings_tail = entry;
+	}
+	font->strings_head = entry;
+	font->strings_bytes += size;
+	Trim_Strings( font );
+}
+
+void TTF_CloseFont( TTF_Font* font )
+{
+	if ( font ) {
+		Flush_Cache( font );
+		Free_Glyphs( font );
+		Free_Atlases( font );
+		Free_Strings( font );
+		if ( font->face ) {
+			FT_Done_Face( font->face );
+		}
+		if ( font->args.stream ) {
+			free( font->args.stream );
+		}
+		if ( font->freesrc ) {
+			SDL_RWclose( font->src );
+		}
+		free( font );
+	}
+}
+
+static Uint16 *LATIN1_to_UNICODE(Uint16 *unicode, const char *text, int len)
+{
+	int i;
+
+	for ( i=0; i < len; ++i ) {
+		unicode[i] = ((const unsigned char *)text)[i];
+	}
+	unicode[i] = 0;
+
+	return unicode;
+}
+
+static Uint16 *UTF8_to_UNICODE(Uint16 *unicode, const char *utf8, int len)
+{
+	int i, j;
+	Uint16 ch;
+
+	for ( i=0, j=0; i < len; ++i, ++j ) {
+		ch = ((const unsigned char *)utf8)[i];
+		if ( ch >= 0xF0 ) {
+			ch  =  (Uint16)(utf8[i]&0x07) << 18;
+			ch |=  (Uint16)(utf8[++i]&0x3F) << 12;
+			ch |=  (Uint16)(utf8[++i]&0x3F) << 6;
+			ch |=  (Uint16)(utf8[++i]&0x3F);
+		} else
+		if ( ch >= 0xE0 ) {
+			ch  =  (Uint16)(utf8[i]&0x0F) << 12;
+			ch |=  (Uint16)(utf8[++i]&0x3F) << 6;
+			ch |=  (Uint16)(utf8[++i]&0x3F);
+		} else
+		if ( ch >= 0xC0 ) {
+			ch  =  (Uint16)(utf8[i]&0x1F) << 6;
+			ch |=  (Uint16)(utf8[++i]&0x3F);
+		}
+		unicode[j] = ch;
+	}
+	unicode[j] = 0;
+
+	return unicode;
+}
+
+int TTF_FontHeight(const TTF_Font *font)
+{
+	return(font->height);
+}
+
+int TTF_FontAscent(const TTF_Font *font)
+{
+	return(font->ascent);
+}
+
+int TTF_FontDescent(const TTF_Font *font)
+{
+	return(font->descent);
+}
+
+int TTF_FontLineSkip(const TTF_Font *font)
+{
+	return(font->lineskip);
+}
+
+long TTF_FontFaces(const TTF_Font *font)
+{
+	return(font->face->num_faces);
+}
+
+int TTF_FontFaceIsFixedWidth(const TTF_Font *font)
+{
+	return(FT_IS_FIXED_WIDTH(font->face));
+}
+
+char *TTF_FontFaceFamilyName(const TTF_Font *font)
+{
+	return(font->face->family_name);
+}
+
+char *TTF_FontFaceStyleName(const TTF_Font *font)
+{
+	return(font->face->style_name);
+}
+
+int TTF_GlyphIsProvided(const TTF_Font *font, Uint16 ch)
+{
+  return(FT_Get_Char_Index(font->face, ch));
+}
+
+int TTF_GlyphMetrics(TTF_Font *font, Uint16 ch,
+                     int* minx, int* maxx, int* miny, int* maxy, int* advance)
+{
+	FT_Error error;
+
+	error = Find_Glyph(font, ch, CACHED_METRICS);
+	if ( error ) {
+		TTF_SetFTError("Couldn't find glyph", error);
+		return -1;
+	}
+
+	if ( minx ) {
+		*minx = font->current->minx;
+	}
+	if ( maxx ) {
+		*maxx = font->current->maxx;
+		if( font->style & TTF_STYLE_BOLD ) {
+			*maxx += font->glyph_overhang;
+		}
+	}
+	if ( miny ) {
+		*miny = font->current->miny;
+	}
+	if ( maxy ) {
+		*maxy = font->current->maxy;
+	}
+	if ( advance ) {
+		*advance = font->current->advance;
+		if( font->style & TTF_STYLE_BOLD ) {
+			*advance += font->glyph_overhang;
+		}
+	}
+	return 0;
+}
+
+static int Size_UNICODE(TTF_Font *font, const Uint16 *text, int *w, int *h)
 {
 	int status;
 	const Uint16 *ch;
@@ -1024,61 +1860,245 @@ int TTF_SizeUNICODE(TTF_Font *font, const Uint16 *text, int *w, int *h)
 	return status;
 }
 
-/* Convert the Latin-1 text to UNICODE and render it
-*/
-SDL_Surface *TTF_RenderText_Solid(TTF_Font *font,
-				const char *text, SDL_Color fg)
+/* Size a string in any encoding, from the string cache if it's there */
+static int Size_String(TTF_Font *font, int encoding, const void *text, int len,
+                       int *w, int *h)
 {
-	SDL_Surface *textbuf;
+	static const SDL_Color none = { 0, 0, 0, 0 };
+	string_entry *entry;
 	Uint16 *unicode_text;
-	int unicode_len;
+	int width, height;
+	int status;
 
-	/* Copy the Latin-1 text to a UNICODE text buffer */
-	unicode_len = strlen(text);
-	unicode_text = (Uint16 *)ALLOCA((1+unicode_len+1)*(sizeof *unicode_text));
-	if ( unicode_text == NULL ) {
-		TTF_SetError("Out of memory");
-		return(NULL);
+	if ( font->strings_limit ) {
+		entry = Find_String(font, STRING_SIZE, encoding, text, len, none, none);
+		if ( entry ) {
+			if ( w ) {
+				*w = entry->w;
+			}
+			if ( h ) {
+				*h = entry->h;
+			}
+			return 0;
+		}
 	}
-	*unicode_text = UNICODE_BOM_NATIVE;
-	LATIN1_to_UNICODE(unicode_text+1, text, unicode_len);
 
-	/* Render the new text */
-	textbuf = TTF_RenderUNICODE_Solid(font, unicode_text, fg);
+	/* Copy Latin-1 and UTF-8 text to a UNICODE text buffer */
+	if ( encoding == STRING_LATIN1 || encoding == STRING_UTF8 ) {
+		unicode_text = (Uint16 *)ALLOCA((1+len+1)*(sizeof *unicode_text));
+		if ( unicode_text == NULL ) {
+			TTF_SetError("Out of memory");
+			return -1;
+		}
+		*unicode_text = UNICODE_BOM_NATIVE;
+		if ( encoding == STRING_LATIN1 ) {
+			LATIN1_to_UNICODE(unicode_text+1, (const char *)text, len);
+		} else {
+			UTF8_to_UNICODE(unicode_text+1, (const char *)text, len);
+		}
+	} else {
+		unicode_text = (Uint16 *)text;
+	}
+
+	status = Size_UNICODE(font, unicode_text, &width, &height);
+	if ( status == 0 && font->strings_limit ) {
+		Add_String(font, STRING_SIZE, encoding, text, len, none, none,
+		           width, height, NULL);
+	}
+	if ( status == 0 ) {
+		if ( w ) {
+			*w = width;
+		}
+		if ( h ) {
+			*h = height;
+		}
+	}
 
 	/* Free the text buffer and return */
-	FREEA(unicode_text);
-	return(textbuf);
+	if ( unicode_text != (Uint16 *)text ) {
+		FREEA(unicode_text);
+	}
+	return status;
 }
 
-/* Convert the UTF-8 text to UNICODE and render it
-*/
-SDL_Surface *TTF_RenderUTF8_Solid(TTF_Font *font,
-				const char *text, SDL_Color fg)
+int TTF_SizeText(TTF_Font *font, const char *text, int *w, int *h)
 {
-	SDL_Surface *textbuf;
-	Uint16 *unicode_text;
-	int unicode_len;
+	return Size_String(font, STRING_LATIN1, text, strlen(text), w, h);
+}
 
-	/* Copy the UTF-8 text to a UNICODE text buffer */
-	unicode_len = strlen(text);
-	unicode_text = (Uint16 *)ALLOCA((1+unicode_len+1)*(sizeof *unicode_text));
-	if ( unicode_text == NULL ) {
-		TTF_SetError("Out of memory");
-		return(NULL);
+int TTF_SizeUTF8(TTF_Font *font, const char *text, int *w, int *h)
+{
+	return Size_String(font, STRING_UTF8, text, strlen(text), w, h);
+}
+
+int TTF_SizeUNICODE(TTF_Font *font, const Uint16 *text, int *w, int *h)
+{
+	return Size_String(font, TTF_byteswapped ? STRING_SWAPPED : STRING_UNICODE,
+	                   text, UNICODE_strlen(text) * sizeof(*text), w, h);
+}
+
+/* Merge a row of glyph coverage into 8-bit shaded text, keeping the larger
+   value where glyphs overlap */
+static void Merge_Row_Shaded(Uint8 *dst, const Uint8 *src, int len)
+{
+	int i = 0;
+
+#if TTF_SIMD_SSE2
+	if ( TTF_simd ) {
+		for ( ; i + 16 <= len; i += 16 ) {
+			__m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+			__m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+			_mm_storeu_si128((__m128i *)(dst + i), _mm_max_epu8(d, s));
+		}
 	}
-	*unicode_text = UNICODE_BOM_NATIVE;
-	UTF8_to_UNICODE(unicode_text, text, unicode_len);
+#elif TTF_SIMD_ALTIVEC
+	if ( TTF_simd ) {
+		vector unsigned char perm;
 
-	/* Render the new text */
-	textbuf = TTF_RenderUNICODE_Solid(font, unicode_text, fg);
+		/* Line up the text, and permute the unaligned glyph into place */
+		for ( ; i < len && ((size_t)(dst + i) & 15); ++i ) {
+			if ( src[i] > dst[i] ) {
+				dst[i] = src[i];
+			}
+		}
+		perm = vec_lvsl(0, src + i);
+		for ( ; i + 16 <= len; i += 16 ) {
+			vector unsigned char s = vec_perm(vec_ld(0, src + i),
+			                                  vec_ld(15, src + i), perm);
+			vec_st(vec_max(vec_ld(0, dst + i), s), 0, dst + i);
+		}
+	}
+#endif
+	for ( ; i < len; ++i ) {
+		if ( src[i] > dst[i] ) {
+			dst[i] = src[i];
+		}
+	}
+}
 
-	/* Free the text buffer and return */
-	FREEA(unicode_text);
-	return(textbuf);
+#if TTF_SIMD_SSE2
+static __inline__ void Merge_Pixels_SSE2(Uint32 *dst, __m128i alpha, __m128i color)
+{
+	__m128i d = _mm_loadu_si128((const __m128i *)dst);
+	_mm_storeu_si128((__m128i *)dst, _mm_max_epu8(d, _mm_or_si128(alpha, color)));
 }
+#endif
 
-SDL_Surface *TTF_RenderUNICODE_Solid(TTF_Font *font,
+/* Merge a row of glyph coverage into the alpha of 32-bit blended text,
+   every pixel of which already holds the color in pixel.  Because only
+   alpha differs, a bytewise maximum takes the larger alpha. */
+static void Merge_Row_Blended(Uint32 *dst, const Uint8 *src, int len,
+                              Uint32 pixel)
+{
+	Uint32 value;
+	int i = 0;
+
+#if TTF_SIMD_SSE2
+	if ( TTF_simd ) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i color = _mm_set1_epi32((int)pixel);
+		__m128i a, lo, hi;
+
+		for ( ; i + 16 <= len; i += 16 ) {
+			/* Each alpha to the top byte of its pixel */
+			a = _mm_loadu_si128((const __m128i *)(src + i));
+			lo = _mm_unpacklo_epi8(zero, a);
+			hi = _mm_unpackhi_epi8(zero, a);
+			Merge_Pixels_SSE2(dst + i, _mm_unpacklo_epi16(zero, lo), color);
+			Merge_Pixels_SSE2(dst + i + 4, _mm_unpackhi_epi16(zero, lo), color);
+			Merge_Pixels_SSE2(dst + i + 8, _mm_unpacklo_epi16(zero, hi), color);
+			Merge_Pixels_SSE2(dst + i + 12, _mm_unpackhi_epi16(zero, hi), color);
+		}
+	}
+#elif TTF_SIMD_ALTIVEC
+	if ( TTF_simd ) {
+		const vector unsigned char zero = vec_splat_u8(0);
+		vector unsigned char perm, a, lo, hi, color;
+		union {
+			vector unsigned int v;
+			Uint32 p[4];
+		} u;
+
+		for ( ; i < len && ((size_t)(dst + i) & 15); ++i ) {
+			value = pixel | ((Uint32)src[i] << 24);
+			if ( value > dst[i] ) {
+				dst[i] = value;
+			}
+		}
+		u.p[0] = u.p[1] = u.p[2] = u.p[3] = pixel;
+		color = (vector unsigned char)u.v;
+		perm = vec_lvsl(0, src + i);
+		for ( ; i + 16 <= len; i += 16 ) {
+			a = vec_perm(vec_ld(0, src + i), vec_ld(15, src + i), perm);
+			/* Each alpha to the top byte of its pixel */
+			lo = vec_mergeh(a, zero);
+			hi = vec_mergel(a, zero);
+			a = (vector unsigned char)vec_mergeh((vector unsigned short)lo,
+			                                     (vector unsigned short)zero);
+			vec_st(vec_max(vec_ld(0, dst + i), vec_or(a, color)), 0, dst + i);
+			a = (vector unsigned char)vec_mergel((vector unsigned short)lo,
+			                                     (vector unsigned short)zero);
+			vec_st(vec_max(vec_ld(16, dst + i), vec_or(a, color)), 16, dst + i);
+			a = (vector unsigned char)vec_mergeh((vector unsigned short)hi,
+			                                     (vector unsigned short)zero);
+			vec_st(vec_max(vec_ld(32, dst + i), vec_or(a, color)), 32, dst + i);
+			a = (vector unsigned char)vec_mergel((vector unsigned short)hi,
+			                                     (vector unsigned short)zero);
+			vec_st(vec_max(vec_ld(48, dst + i), vec_or(a, color)), 48, dst + i);
+		}
+	}
+#endif
+	for ( ; i < len; ++i ) {
+		value = pixel | ((Uint32)src[i] << 24);
+		if ( value > dst[i] ) {
+			dst[i] = value;
+		}
+	}
+}
+
+/* Merge a glyph into shaded or blended text with its left edge at x,
+   clipping it to the surface once rather than checking every pixel */
+static void Merge_Glyph(SDL_Surface *textbuf, const c_glyph *glyph,
+                        int x, int width, Uint32 pixel)
+{
+	const FT_Bitmap *pixmap = &glyph->pixmap;
+	Uint8 *dst;
+	const Uint8 *src;
+	int row, rows, col;
+
+	col = 0;
+	if ( x < 0 ) {
+		col = -x;
+	}
+	if ( x + width > textbuf->w ) {
+		width = textbuf->w - x;
+	}
+	row = 0;
+	if ( glyph->yoffset < 0 ) {
+		row = -glyph->yoffset;
+	}
+	rows = pixmap->rows;
+	if ( glyph->yoffset + rows > textbuf->h ) {
+		rows = textbuf->h - glyph->yoffset;
+	}
+	if ( col >= width ) {
+		return;
+	}
+
+	for ( ; row < rows; ++row ) {
+		src = pixmap->buffer + row * pixmap->pitch + col;
+		dst = (Uint8 *)textbuf->pixels +
+		      (row + glyph->yoffset) * textbuf->pitch;
+		if ( textbuf->format->BytesPerPixel == 1 ) {
+			Merge_Row_Shaded(dst + x + col, src, width - col);
+		} else {
+			Merge_Row_Blended((Uint32 *)dst + x + col, src,
+			                  width - col, pixel);
+		}
+	}
+}
+
+static SDL_Surface *Render_UNICODE_Solid(TTF_Font *font,
 				const Uint16 *text, SDL_Color fg)
 {
 	int xstart;
@@ -1100,7 +2120,7 @@ SDL_Surface *TTF_RenderUNICODE_Solid(TTF_Font *font,
 	FT_UInt prev_index = 0;
 
 	/* Get the dimensions of the text surface */
-	if( ( TTF_SizeUNICODE(font, text, &width, NULL) < 0 ) || !width ) {
+	if( ( Size_UNICODE(font, text, &width, NULL) < 0 ) || !width ) {
 		TTF_SetError( "Text has zero width" );
 		return NULL;
 	}
@@ -1279,61 +2299,7 @@ SDL_Surface *TTF_RenderGlyph_Solid(TTF_Font *font, Uint16 ch, SDL_Color fg)
 }
 
 
-/* Convert the Latin-1 text to UNICODE and render it
-*/
-SDL_Surface *TTF_RenderText_Shaded(TTF_Font *font,
-				const char *text, SDL_Color fg, SDL_Color bg)
-{
-	SDL_Surface *textbuf;
-	Uint16 *unicode_text;
-	int unicode_len;
-
-	/* Copy the Latin-1 text to a UNICODE text buffer */
-	unicode_len = strlen(text);
-	unicode_text = (Uint16 *)ALLOCA((1+unicode_len+1)*(sizeof *unicode_text));
-	if ( unicode_text == NULL ) {
-		TTF_SetError("Out of memory");
-		return(NULL);
-	}
-	*unicode_text = UNICODE_BOM_NATIVE;
-	LATIN1_to_UNICODE(unicode_text+1, text, unicode_len);
-
-	/* Render the new text */
-	textbuf = TTF_RenderUNICODE_Shaded(font, unicode_text, fg, bg);
-
-	/* Free the text buffer and return */
-	FREEA(unicode_text);
-	return(textbuf);
-}
-
-/* Convert the UTF-8 text to UNICODE and render it
-*/
-SDL_Surface *TTF_RenderUTF8_Shaded(TTF_Font *font,
-				const char *text, SDL_Color fg, SDL_Color bg)
-{
-	SDL_Surface *textbuf;
-	Uint16 *unicode_text;
-	int unicode_len;
-
-	/* Copy the UTF-8 text to a UNICODE text buffer */
-	unicode_len = strlen(text);
-	unicode_text = (Uint16 *)ALLOCA((1+unicode_len+1)*(sizeof *unicode_text));
-	if ( unicode_text == NULL ) {
-		TTF_SetError("Out of memory");
-		return(NULL);
-	}
-	*unicode_text = UNICODE_BOM_NATIVE;
-	UTF8_to_UNICODE(unicode_text+1, text, unicode_len);
-
-	/* Render the new text */
-	textbuf = TTF_RenderUNICODE_Shaded(font, unicode_text, fg, bg);
-
-	/* Free the text buffer and return */
-	FREEA(unicode_text);
-	return(textbuf);
-}
-
-SDL_Surface* TTF_RenderUNICODE_Shaded( TTF_Font* font,
+static SDL_Surface* Render_UNICODE_Shaded( TTF_Font* font,
 				       const Uint16* text,
 				       SDL_Color fg,
 				       SDL_Color bg )
@@ -1348,19 +2314,16 @@ SDL_Surface* TTF_RenderUNICODE_Shaded( TTF_Font* font,
 	int gdiff;
 	int bdiff;
 	const Uint16* ch;
-	Uint8* src;
 	Uint8* dst;
-	Uint8* dst_check;
 	int swapped;
-	int row, col;
-	FT_Bitmap* current;
+	int row;
 	c_glyph *glyph;
 	FT_Error error;
 	FT_Long use_kerning;
 	FT_UInt prev_index = 0;
 
 	/* Get the dimensions of the text surface */
-	if( ( TTF_SizeUNICODE(font, text, &width, NULL) < 0 ) || !width ) {
+	if( ( Size_UNICODE(font, text, &width, NULL) < 0 ) || !width ) {
 		TTF_SetError("Text has zero width");
 		return NULL;
 	}
@@ -1372,10 +2335,6 @@ SDL_Surface* TTF_RenderUNICODE_Shaded( TTF_Font* font,
 		return NULL;
 	}
 
-	/* Adding bound checking to avoid all kinds of memory corruption errors
-	   that may occur. */
-	dst_check = (Uint8*)textbuf->pixels + textbuf->pitch * textbuf->h;
-
 	/* Fill the palette with NUM_GRAYS levels of shading from bg to fg */
 	palette = textbuf->format->palette;
 	rdiff = fg.r - bg.r;
@@ -1437,24 +2396,7 @@ SDL_Surface* TTF_RenderUNICODE_Shaded( TTF_Font* font,
 			xstart -= glyph->minx;
 		}
 		
-		current = &glyph->pixmap;
-		for( row = 0; row < current->rows; ++row ) {
-			/* Make sure we don't go either over, or under the
-			 * limit */
-			if ( row+glyph->yoffset < 0 ) {
-				continue;
-			}
-			if ( row+glyph->yoffset >= textbuf->h ) {
-				continue;
-			}
-			dst = (Uint8*) textbuf->pixels +
-				(row+glyph->yoffset) * textbuf->pitch +
-				xstart + glyph->minx;
-			src = current->buffer + row * current->pitch;
-			for ( col=width; col>0 && dst < dst_check; --col ) {
-				*dst++ |= *src++;
-			}
-		}
+		Merge_Glyph(textbuf, glyph, xstart + glyph->minx, width, 0);
 
 		xstart += glyph->advance;
 		if( font->style & TTF_STYLE_BOLD ) {
@@ -1546,72 +2488,15 @@ SDL_Surface* TTF_RenderGlyph_Shaded( TTF_Font* font,
 	return textbuf;
 }
 
-/* Convert the Latin-1 text to UNICODE and render it
-*/
-SDL_Surface *TTF_RenderText_Blended(TTF_Font *font,
-				const char *text, SDL_Color fg)
-{
-	SDL_Surface *textbuf;
-	Uint16 *unicode_text;
-	int unicode_len;
-
-	/* Copy the Latin-1 text to a UNICODE text buffer */
-	unicode_len = strlen(text);
-	unicode_text = (Uint16 *)ALLOCA((1+unicode_len+1)*(sizeof *unicode_text));
-	if ( unicode_text == NULL ) {
-		TTF_SetError("Out of memory");
-		return(NULL);
-	}
-	*unicode_text = UNICODE_BOM_NATIVE;
-	LATIN1_to_UNICODE(unicode_text+1, text, unicode_len);
-
-	/* Render the new text */
-	textbuf = TTF_RenderUNICODE_Blended(font, unicode_text, fg);
-
-	/* Free the text buffer and return */
-	FREEA(unicode_text);
-	return(textbuf);
-}
-
-/* Convert the UTF-8 text to UNICODE and render it
-*/
-SDL_Surface *TTF_RenderUTF8_Blended(TTF_Font *font,
-				const char *text, SDL_Color fg)
-{
-	SDL_Surface *textbuf;
-	Uint16 *unicode_text;
-	int unicode_len;
-
-	/* Copy the UTF-8 text to a UNICODE text buffer */
-	unicode_len = strlen(text);
-	unicode_text = (Uint16 *)ALLOCA((1+unicode_len+1)*(sizeof *unicode_text));
-	if ( unicode_text == NULL ) {
-		TTF_SetError("Out of memory");
-		return(NULL);
-	}
-	*unicode_text = UNICODE_BOM_NATIVE;
-	UTF8_to_UNICODE(unicode_text+1, text, unicode_len);
-
-	/* Render the new text */
-	textbuf = TTF_RenderUNICODE_Blended(font, unicode_text, fg);
-
-	/* Free the text buffer and return */
-	FREEA(unicode_text);
-	return(textbuf);
-}
-
-SDL_Surface *TTF_RenderUNICODE_Blended(TTF_Font *font,
+static SDL_Surface *Render_UNICODE_Blended(TTF_Font *font,
 				const Uint16 *text, SDL_Color fg)
 {
 	int xstart;
 	int width, height;
 	SDL_Surface *textbuf;
-	Uint32 alpha;
 	Uint32 pixel;
 	const Uint16 *ch;
-	Uint8 *src;
 	Uint32 *dst;
-	Uint32 *dst_check;
 	int swapped;
 	int row, col;
 	c_glyph *glyph;
@@ -1620,7 +2505,7 @@ SDL_Surface *TTF_RenderUNICODE_Blended(TTF_Font *font,
 	FT_UInt prev_index = 0;
 
 	/* Get the dimensions of the text surface */
-	if ( (TTF_SizeUNICODE(font, text, &width, NULL) < 0) || !width ) {
+	if ( (Size_UNICODE(font, text, &width, NULL) < 0) || !width ) {
 		TTF_SetError("Text has zero width");
 		return(NULL);
 	}
@@ -1632,10 +2517,6 @@ SDL_Surface *TTF_RenderUNICODE_Blended(TTF_Font *font,
 		return(NULL);
 	}
 
-	/* Adding bound checking to avoid all kinds of memory corruption errors
-	   that may occur. */
-	dst_check = (Uint32*)textbuf->pixels + textbuf->pitch/4 * textbuf->h;
-
 	/* check kerning */
 	use_kerning = FT_HAS_KERNING( font->face );
 	
@@ -1688,28 +2569,7 @@ SDL_Surface *TTF_RenderUNICODE_Blended(TTF_Font *font,
 			xstart -= glyph->minx;
 		}
 
-		for ( row = 0; row < glyph->pixmap.rows; ++row ) {
-			/* Make sure we don't go either over, or under the
-			 * limit */
-			if ( row+glyph->yoffset < 0 ) {
-				continue;
-			}
-			if ( row+glyph->yoffset >= textbuf->h ) {
-				continue;
-			}
-			dst = (Uint32*) textbuf->pixels +
-				(row+glyph->yoffset) * textbuf->pitch/4 +
-				xstart + glyph->minx;
-
-			/* Added code to adjust src pointer for pixmaps to
-			 * account for pitch.
-			 * */
-			src = (Uint8*) (glyph->pixmap.buffer + glyph->pixmap.pitch * row);
-			for ( col = width; col>0 && dst < dst_check; --col) {
-				alpha = *src++;
-				*dst++ |= pixel | (alpha << 24);
-			}
-		}
+		Merge_Glyph(textbuf, glyph, xstart + glyph->minx, width, pixel);
 
 		xstart += glyph->advance;
 		if ( font->style & TTF_STYLE_BOLD ) {
@@ -1736,64 +2596,581 @@ SDL_Surface *TTF_RenderUNICODE_Blended(TTF_Font *font,
 	return(textbuf);
 }
 
-SDL_Surface *TTF_RenderGlyph_Blended(TTF_Font *font, Uint16 ch, SDL_Color fg)
+/* Render a string in any encoding, or share the surface from the string
+   cache if it's there */
+static SDL_Surface *Render_String(TTF_Font *font, int kind, int encoding,
+                                  const void *text, int len,
+                                  SDL_Color fg, SDL_Color bg)
 {
+	string_entry *entry;
 	SDL_Surface *textbuf;
-	Uint32 alpha;
-	Uint32 pixel;
-	Uint8 *src;
-	Uint32 *dst;
-	int row, col;
-	FT_Error error;
-	c_glyph *glyph;
-
-	/* Get the glyph itself */
-	error = Find_Glyph(font, ch, CACHED_METRICS|CACHED_PIXMAP);
-	if ( error ) {
-		return(NULL);
-	}
-	glyph = font->current;
-
-	textbuf = SDL_CreateRGBSurface(SDL_SWSURFACE,
-	              glyph->pixmap.width, glyph->pixmap.rows, 32,
-                  0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
-	if ( ! textbuf ) {
-		return(NULL);
-	}
-
-	/* Copy the character from the pixmap */
-	pixel = (fg.r<<16)|(fg.g<<8)|fg.b;
-	SDL_FillRect(textbuf, NULL, pixel);	/* Initialize with fg and 0 alpha */
+	Uint16 *unicode_text;
 
-	for ( row=0; row<textbuf->h; ++row ) {
-		/* Changed src to take pitch into account, not just width */
-		src = glyph->pixmap.buffer + row * glyph->pixmap.pitch;
-		dst = (Uint32 *)textbuf->pixels + row * textbuf->pitch/4;
-		for ( col=0; col<glyph->pixmap.width; ++col ) {
-			alpha = *src++;
-			*dst++ = pixel | (alpha << 24);
+	if ( font->strings_limit ) {
+		entry = Find_String(font, kind, encoding, text, len, fg, bg);
+		if ( entry ) {
+			++entry->surface->refcount;
+			return(entry->surface);
 		}
 	}
 
-	/* Handle the underline style */
-	if( font->style & TTF_STYLE_UNDERLINE ) {
-		row = font->ascent - font->underline_offset - 1;
-		if ( row >= textbuf->h) {
-			row = (textbuf->h-1) - font->underline_height;
+	/* Copy Latin-1 and UTF-8 text to a UNICODE text buffer */
+	if ( encoding == STRING_LATIN1 || encoding == STRING_UTF8 ) {
+		unicode_text = (Uint16 *)ALLOCA((1+len+1)*(sizeof *unicode_text));
+		if ( unicode_text == NULL ) {
+			TTF_SetError("Out of memory");
+			return(NULL);
 		}
-		dst = (Uint32 *)textbuf->pixels + row * textbuf->pitch/4;
-		pixel |= 0xFF000000; /* Amask */
-		for ( row=font->underline_height; row>0; --row ) {
-			for ( col=0; col < textbuf->w; ++col ) {
-				dst[col] = pixel;
-			}
-			dst += textbuf->pitch/4;
+		*unicode_text = UNICODE_BOM_NATIVE;
+		if ( encoding == STRING_LATIN1 ) {
+			LATIN1_to_UNICODE(unicode_text+1, (const char *)text, len);
+		} else {
+			UTF8_to_UNICODE(unicode_text+1, (const char *)text, len);
 		}
+	} else {
+		unicode_text = (Uint16 *)text;
 	}
-	return(textbuf);
-}
 
-void TTF_SetFontStyle( TTF_Font* font, int style )
+	/* Render the new text */
+	switch (kind) {
+	    case STRING_SOLID:
+		textbuf = Render_UNICODE_Solid(font, unicode_text, fg);
+		break;
+	    case STRING_SHADED:
+		textbuf = Render_UNICODE_Shaded(font, unicode_text, fg, bg);
+		break;
+	    default:
+		textbuf = Render_UNICODE_Blended(font, unicode_text, fg);
+		break;
+	}
+	if ( textbuf && font->strings_limit ) {
+		Add_String(font, kind, encoding, text, len, fg, bg,
+		           textbuf->w, textbuf->h, textbuf);
+	}
+
+	/* Free the text buffer and return */
+	if ( unicode_text != (Uint16 *)text ) {
+		FREEA(unicode_text);
+	}
+	return(textbuf);
+}
+
+/* Convert the Latin-1 text to UNICODE and render it
+*/
+SDL_Surface *TTF_RenderText_Solid(TTF_Font *font,
+				const char *text, SDL_Color fg)
+{
+	return(Render_String(font, STRING_SOLID, STRING_LATIN1,
+	                     text, strlen(text), fg, fg));
+}
+
+/* Convert the UTF-8 text to UNICODE and render it
+*/
+SDL_Surface *TTF_RenderUTF8_Solid(TTF_Font *font,
+				const char *text, SDL_Color fg)
+{
+	return(Render_String(font, STRING_SOLID, STRING_UTF8,
+	                     text, strlen(text), fg, fg));
+}
+
+SDL_Surface *TTF_RenderUNICODE_Solid(TTF_Font *font,
+				const Uint16 *text, SDL_Color fg)
+{
+	return(Render_String(font, STRING_SOLID,
+	                     TTF_byteswapped ? STRING_SWAPPED : STRING_UNICODE,
+	                     text, UNICODE_strlen(text) * sizeof(*text), fg, fg));
+}
+
+/* Convert the Latin-1 text to UNICODE and render it
+*/
+SDL_Surface *TTF_RenderText_Shaded(TTF_Font *font,
+				const char *text, SDL_Color fg, SDL_Color bg)
+{
+	return(Render_String(font, STRING_SHADED, STRING_LATIN1,
+	                     text, strlen(text), fg, bg));
+}
+
+/* Convert the UTF-8 text to UNICODE and render it
+*/
+SDL_Surface *TTF_RenderUTF8_Shaded(TTF_Font *font,
+				const char *text, SDL_Color fg, SDL_Color bg)
+{
+	return(Render_String(font, STRING_SHADED, STRING_UTF8,
+	                     text, strlen(text), fg, bg));
+}
+
+SDL_Surface *TTF_RenderUNICODE_Shaded(TTF_Font *font,
+				const Uint16 *text, SDL_Color fg, SDL_Color bg)
+{
+	return(Render_String(font, STRING_SHADED,
+	                     TTF_byteswapped ? STRING_SWAPPED : STRING_UNICODE,
+	                     text, UNICODE_strlen(text) * sizeof(*text), fg, bg));
+}
+
+/* Convert the Latin-1 text to UNICODE and render it
+*/
+SDL_Surface *TTF_RenderText_Blended(TTF_Font *font,
+				const char *text, SDL_Color fg)
+{
+	return(Render_String(font, STRING_BLENDED, STRING_LATIN1,
+	                     text, strlen(text), fg, fg));
+}
+
+/* Convert the UTF-8 text to UNICODE and render it
+*/
+SDL_Surface *TTF_RenderUTF8_Blended(TTF_Font *font,
+				const char *text, SDL_Color fg)
+{
+	return(Render_String(font, STRING_BLENDED, STRING_UTF8,
+	                     text, strlen(text), fg, fg));
+}
+
+SDL_Surface *TTF_RenderUNICODE_Blended(TTF_Font *font,
+				const Uint16 *text, SDL_Color fg)
+{
+	return(Render_String(font, STRING_BLENDED,
+	                     TTF_byteswapped ? STRING_SWAPPED : STRING_UNICODE,
+	                     text, UNICODE_strlen(text) * sizeof(*text), fg, fg));
+}
+
+SDL_Surface *TTF_RenderGlyph_Blended(TTF_Font *font, Uint16 ch, SDL_Color fg)
+{
+	SDL_Surface *textbuf;
+	Uint32 alpha;
+	Uint32 pixel;
+	Uint8 *src;
+	Uint32 *dst;
+	int row, col;
+	FT_Error error;
+	c_glyph *glyph;
+
+	/* Get the glyph itself */
+	error = Find_Glyph(font, ch, CACHED_METRICS|CACHED_PIXMAP);
+	if ( error ) {
+		return(NULL);
+	}
+	glyph = font->current;
+
+	textbuf = SDL_CreateRGBSurface(SDL_SWSURFACE,
+	              glyph->pixmap.width, glyph->pixmap.rows, 32,
+                  0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+	if ( ! textbuf ) {
+		return(NULL);
+	}
+
+	/* Copy the character from the pixmap */
+	pixel = (fg.r<<16)|(fg.g<<8)|fg.b;
+	SDL_FillRect(textbuf, NULL, pixel);	/* Initialize with fg and 0 alpha */
+
+	for ( row=0; row<textbuf->h; ++row ) {
+		/* Changed src to take pitch into account, not just width */
+		src = glyph->pixmap.buffer + row * glyph->pixmap.pitch;
+		dst = (Uint32 *)textbuf->pixels + row * textbuf->pitch/4;
+		for ( col=0; col<glyph->pixmap.width; ++col ) {
+			alpha = *src++;
+			*dst++ = pixel | (alpha << 24);
+		}
+	}
+
+	/* Handle the underline style */
+	if( font->style & TTF_STYLE_UNDERLINE ) {
+		row = font->ascent - font->underline_offset - 1;
+		if ( row >= textbuf->h) {
+			row = (textbuf->h-1) - font->underline_height;
+		}
+		dst = (Uint32 *)textbuf->pixels + row * textbuf->pitch/4;
+		pixel |= 0xFF000000; /* Amask */
+		for ( row=font->underline_height; row>0; --row ) {
+			for ( col=0; col < textbuf->w; ++col ) {
+				dst[col] = pixel;
+			}
+			dst += textbuf->pitch/4;
+		}
+	}
+	return(textbuf);
+}
+
+/* Draw text onto a surface by blitting its glyphs from an atlas */
+static int Draw_UNICODE(TTF_Font *font, const Uint16 *text, int which,
+                        SDL_Color fg, SDL_Color bg,
+                        SDL_Surface *surface, SDL_Rect *dstrect)
+{
+	int xstart;
+	int width, height;
+	int x, y, w;
+	int top, bottom;
+	const Uint16 *ch;
+	int swapped;
+	c_glyph *glyph;
+	FT_Bitmap *current;
+	FT_Error error;
+	FT_Long use_kerning;
+	FT_UInt prev_index = 0;
+	SDL_Rect srcrect, rect;
+	SDL_Surface *page;
+
+	/* Get the dimensions of the text */
+	if ( Size_UNICODE(font, text, &width, NULL) < 0 ) {
+		return -1;
+	}
+	height = font->height;
+	x = dstrect ? dstrect->x : 0;
+	y = dstrect ? dstrect->y : 0;
+	if ( dstrect ) {
+		dstrect->w = width;
+		dstrect->h = height;
+	}
+	if ( !width ) {
+		return 0;
+	}
+
+	if ( Color_Atlas( font, which, fg, bg ) < 0 ) {
+		return -1;
+	}
+	if ( which == ATLAS_SHADED ) {
+		rect.x = x;
+		rect.y = y;
+		rect.w = width;
+		rect.h = height;
+		SDL_FillRect( surface, &rect, SDL_MapRGB(surface->format, bg.r, bg.g, bg.b) );
+	}
+
+	/* check kerning */
+	use_kerning = FT_HAS_KERNING( font->face );
+
+	/* Load and draw each character */
+	xstart = 0;
+	swapped = TTF_byteswapped;
+	for ( ch=text; *ch; ++ch ) {
+		Uint16 c = *ch;
+		if ( c == UNICODE_BOM_NATIVE ) {
+			swapped = 0;
+			if ( text == ch ) {
+				++text;
+			}
+			continue;
+		}
+		if ( c == UNICODE_BOM_SWAPPED ) {
+			swapped = 1;
+			if ( text == ch ) {
+				++text;
+			}
+			continue;
+		}
+		if ( swapped ) {
+			c = SDL_Swap16(c);
+		}
+		error = Find_Glyph(font, c, CACHED_METRICS |
+		                   ((which == ATLAS_SOLID) ? CACHED_BITMAP : CACHED_PIXMAP));
+		if( error ) {
+			TTF_SetFTError("Couldn't find glyph", error);
+			return -1;
+		}
+		glyph = font->current;
+		current = (which == ATLAS_SOLID) ? &glyph->bitmap : &glyph->pixmap;
+
+		/* do kerning, if possible AC-Patch */
+		if ( use_kerning && prev_index && glyph->index ) {
+			FT_Vector delta; 
+			FT_Get_Kerning( font->face, prev_index, glyph->index, ft_kerning_default, &delta ); 
+			xstart += delta.x >> 6;
+		}
+
+		/* Compensate for the wrap around bug with negative minx's */
+		if ( (ch == text) && (glyph->minx < 0) ) {
+			xstart -= glyph->minx;
+		}
+
+		/* Ensure the width of the pixmap is correct. On some cases,
+		 * freetype may report a larger pixmap than possible.*/
+		w = current->width;
+		if ( w > glyph->maxx - glyph->minx ) {
+			w = glyph->maxx - glyph->minx;
+		}
+		/* Only the rows inside the text height are drawn */
+		top = (glyph->yoffset < 0) ? -glyph->yoffset : 0;
+		bottom = current->rows;
+		if ( bottom > height - glyph->yoffset ) {
+			bottom = height - glyph->yoffset;
+		}
+		if ( w > 0 && top < bottom ) {
+			if ( Atlas_Glyph( font, which, glyph ) < 0 ) {
+				return -1;
+			}
+			page = font->atlas[which].pages[glyph->atlas[which].page - 1].surface[font->atlas[which].color];
+			srcrect.x = glyph->atlas[which].x;
+			srcrect.y = glyph->atlas[which].y + top;
+			srcrect.w = w;
+			srcrect.h = bottom - top;
+			rect.x = x + xstart + glyph->minx;
+			rect.y = y + glyph->yoffset + top;
+			if ( SDL_BlitSurface( page, &srcrect, surface, &rect ) < 0 ) {
+				return -1;
+			}
+		}
+
+		xstart += glyph->advance;
+		if ( font->style & TTF_STYLE_BOLD ) {
+			xstart += font->glyph_overhang;
+		}
+		prev_index = glyph->index;
+	}
+
+	/* Handle the underline style */
+	if( font->style & TTF_STYLE_UNDERLINE ) {
+		top = font->ascent - font->underline_offset - 1;
+		if ( top >= height ) {
+			top = (height-1) - font->underline_height;
+		}
+		rect.x = x;
+		rect.y = y + top;
+		rect.w = width;
+		rect.h = font->underline_height;
+		SDL_FillRect( surface, &rect, SDL_MapRGB(surface->format, fg.r, fg.g, fg.b) );
+	}
+	return 0;
+}
+
+/* Convert the Latin-1 text to UNICODE and draw it
+*/
+int TTF_DrawText_Solid(TTF_Font *font,
+				const char *text, SDL_Color fg,
+				SDL_Surface *dst, SDL_Rect *dstrect)
+{
+	Uint16 *unicode_text;
+	int unicode_len;
+	int status;
+
+	/* Copy the Latin-1 text to a UNICODE text buffer */
+	unicode_len = strlen(text);
+	unicode_text = (Uint16 *)ALLOCA((1+unicode_len+1)*(sizeof *unicode_text));
+	if ( unicode_text == NULL ) {
+		TTF_SetError("Out of memory");
+		return(-1);
+	}
+	*unicode_text = UNICODE_BOM_NATIVE;
+	LATIN1_to_UNICODE(unicode_text+1, text, unicode_len);
+
+	/* Draw the new text */
+	status = TTF_DrawUNICODE_Solid(font, unicode_text, fg, dst, dstrect);
+
+	/* Free the text buffer and return */
+	FREEA(unicode_text);
+	return(status);
+}
+
+/* Convert the UTF-8 text to UNICODE and draw it
+*/
+int TTF_DrawUTF8_Solid(TTF_Font *font,
+				const char *text, SDL_Color fg,
+				SDL_Surface *dst, SDL_Rect *dstrect)
+{
+	Uint16 *unicode_text;
+	int unicode_len;
+	int status;
+
+	/* Copy the UTF-8 text to a UNICODE text buffer */
+	unicode_len = strlen(text);
+	unicode_text = (Uint16 *)ALLOCA((1+unicode_len+1)*(sizeof *unicode_text));
+	if ( unicode_text == NULL ) {
+		TTF_SetError("Out of memory");
+		return(-1);
+	}
+	*unicode_text = UNICODE_BOM_NATIVE;
+	UTF8_to_UNICODE(unicode_text+1, text, unicode_len);
+
+	/* Draw the new text */
+	status = TTF_DrawUNICODE_Solid(font, unicode_text, fg, dst, dstrect);
+
+	/* Free the text buffer and return */
+	FREEA(unicode_text);
+	return(status);
+}
+
+int TTF_DrawUNICODE_Solid(TTF_Font *font,
+				const Uint16 *text, SDL_Color fg,
+				SDL_Surface *dst, SDL_Rect *dstrect)
+{
+	return(Draw_UNICODE(font, text, ATLAS_SOLID, fg, fg, dst, dstrect));
+}
+
+/* Convert the Latin-1 text to UNICODE and draw it
+*/
+int TTF_DrawText_Shaded(TTF_Font *font,
+				const char *text, SDL_Color fg, SDL_Color bg,
+				SDL_Surface *dst, SDL_Rect *dstrect)
+{
+	Uint16 *unicode_text;
+	int unicode_len;
+	int status;
+
+	/* Copy the Latin-1 text to a UNICODE text buffer */
+	unicode_len = strlen(text);
+	unicode_text = (Uint16 *)ALLOCA((1+unicode_len+1)*(sizeof *unicode_text));
+	if ( unicode_text == NULL ) {
+		TTF_SetError("Out of memory");
+		return(-1);
+	}
+	*unicode_text = UNICODE_BOM_NATIVE;
+	LATIN1_to_UNICODE(unicode_text+1, text, unicode_len);
+
+	/* Draw the new text */
+	status = TTF_DrawUNICODE_Shaded(font, unicode_text, fg, bg, dst, dstrect);
+
+	/* Free the text buffer and return */
+	FREEA(unicode_text);
+	return(status);
+}
+
+/* Convert the UTF-8 text to UNICODE and draw it
+*/
+int TTF_DrawUTF8_Shaded(TTF_Font *font,
+				const char *text, SDL_Color fg, SDL_Color bg,
+				SDL_Surface *dst, SDL_Rect *dstrect)
+{
+	Uint16 *unicode_text;
+	int unicode_len;
+	int status;
+
+	/* Copy the UTF-8 text to a UNICODE text buffer */
+	unicode_len = strlen(text);
+	unicode_text = (Uint16 *)ALLOCA((1+unicode_len+1)*(sizeof *unicode_text));
+	if ( unicode_text == NULL ) {
+		TTF_SetError("Out of memory");
+		return(-1);
+	}
+	*unicode_text = UNICODE_BOM_NATIVE;
+	UTF8_to_UNICODE(unicode_text+1, text, unicode_len);
+
+	/* Draw the new text */
+	status = TTF_DrawUNICODE_Shaded(font, unicode_text, fg, bg, dst, dstrect);
+
+	/* Free the text buffer and return */
+	FREEA(unicode_text);
+	return(status);
+}
+
+int TTF_DrawUNICODE_Shaded(TTF_Font *font,
+				const Uint16 *text, SDL_Color fg, SDL_Color bg,
+				SDL_Surface *dst, SDL_Rect *dstrect)
+{
+	return(Draw_UNICODE(font, text, ATLAS_SHADED, fg, bg, dst, dstrect));
+}
+
+/* Convert the Latin-1 text to UNICODE and draw it
+*/
+int TTF_DrawText_Blended(TTF_Font *font,
+				const char *text, SDL_Color fg,
+				SDL_Surface *dst, SDL_Rect *dstrect)
+{
+	Uint16 *unicode_text;
+	int unicode_len;
+	int status;
+
+	/* Copy the Latin-1 text to a UNICODE text buffer */
+	unicode_len = strlen(text);
+	unicode_text = (Uint16 *)ALLOCA((1+unicode_len+1)*(sizeof *unicode_text));
+	if ( unicode_text == NULL ) {
+		TTF_SetError("Out of memory");
+		return(-1);
+	}
+	*unicode_text = UNICODE_BOM_NATIVE;
+	LATIN1_to_UNICODE(unicode_text+1, text, unicode_len);
+
+	/* Draw the new text */
+	status = TTF_DrawUNICODE_Blended(font, unicode_text, fg, dst, dstrect);
+
+	/* Free the text buffer and return */
+	FREEA(unicode_text);
+	return(status);
+}
+
+/* Convert the UTF-8 text to UNICODE and draw it
+*/
+int TTF_DrawUTF8_Blended(TTF_Font *font,
+				const char *text, SDL_Color fg,
+				SDL_Surface *dst, SDL_Rect *dstrect)
+{
+	Uint16 *unicode_text;
+	int unicode_len;
+	int status;
+
+	/* Copy the UTF-8 text to a UNICODE text buffer */
+	unicode_len = strlen(text);
+	unicode_text = (Uint16 *)ALLOCA((1+unicode_len+1)*(sizeof *unicode_text));
+	if ( unicode_text == NULL ) {
+		TTF_SetError("Out of memory");
+		return(-1);
+	}
+	*unicode_text = UNICODE_BOM_NATIVE;
+	UTF8_to_UNICODE(unicode_text+1, text, unicode_len);
+
+	/* Draw the new text */
+	status = TTF_DrawUNICODE_Blended(font, unicode_text, fg, dst, dstrect);
+
+	/* Free the text buffer and return */
+	FREEA(unicode_text);
+	return(status);
+}
+
+int TTF_DrawUNICODE_Blended(TTF_Font *font,
+				const Uint16 *text, SDL_Color fg,
+				SDL_Surface *dst, SDL_Rect *dstrect)
+{
+	return(Draw_UNICODE(font, text, ATLAS_BLENDED, fg, fg, dst, dstrect));
+}
+
+int TTF_SetStringCache( TTF_Font* font, int bytes )
+{
+	int prev_limit = font->strings_limit;
+
+	if ( bytes >= 0 ) {
+		font->strings_limit = bytes;
+		Trim_Strings( font );
+	}
+	return prev_limit;
+}
+
+void TTF_GetStringCacheStats( const TTF_Font* font, Uint32* hits,
+                              Uint32* misses, int* strings, int* bytes )
+{
+	if ( hits ) {
+		*hits = font->strings_hits;
+	}
+	if ( misses ) {
+		*misses = font->strings_misses;
+	}
+	if ( strings ) {
+		*strings = font->strings_count;
+	}
+	if ( bytes ) {
+		*bytes = font->strings_bytes;
+	}
+}
+
+int TTF_SetAtlasPages( TTF_Font* font, int pages )
+{
+	int prev_pages = font->atlas_limit;
+	glyph_atlas* atlas;
+	int i;
+
+	if ( pages > 0 ) {
+		font->atlas_limit = pages;
+		for ( i = 0; i < NUM_ATLASES; ++i ) {
+			atlas = &font->atlas[i];
+			if ( atlas->num_pages > pages ) {
+				Reset_Atlas( font, i );
+				while ( atlas->num_pages > pages ) {
+					--atlas->num_pages;
+					Free_Page( &atlas->pages[atlas->num_pages] );
+				}
+			}
+		}
+	}
+	return prev_pages;
+}
+
+void TTF_SetFontStyle( TTF_Font* font, int style )
 {
 	font->style = style;
 	Flush_Cache( font );
@@ -1804,6 +3181,34 @@ int TTF_GetFontStyle( const TTF_Font* font )
 	return font->style;
 }
 
+int TTF_SetGlyphCacheLimit( TTF_Font* font, int bytes )
+{
+	int prev_limit = font->cache_limit;
+
+	if ( bytes >= 0 ) {
+		font->cache_limit = bytes;
+		Trim_Glyphs( font, NULL );
+	}
+	return prev_limit;
+}
+
+void TTF_GetGlyphCacheStats( const TTF_Font* font, Uint32* hits,
+                             Uint32* misses, int* glyphs, int* bytes )
+{
+	if ( hits ) {
+		*hits = font->cache_hits;
+	}
+	if ( misses ) {
+		*misses = font->cache_misses;
+	}
+	if ( glyphs ) {
+		*glyphs = font->table_count;
+	}
+	if ( bytes ) {
+		*bytes = font->cache_bytes;
+	}
+}
+
 void TTF_Quit( void )
 {
 	if ( TTF_initialized ) {
@@ -82,6 +82,12 @@ typedef struct _TTF_Font TTF_Font;
 /* Initialize the TTF engine - returns 0 if successful, -1 on error */
 extern DECLSPEC int SDLCALL TTF_Init(void);
 
+/* Shaded and blended text is put together with the CPU's vector unit when
+   it has one.  Define the environment variable TTF_NOSIMD before the first
+   TTF_Init() to use the plain C loops instead; the text comes out the same.
+*/
+#define TTF_NOSIMD	"TTF_NOSIMD"
+
 /* Open a font file and create a font of the specified point size.
  * Some .fon fonts will have several sizes embedded in the file, so the
  * point size becomes the index of choosing which size.  If the value
@@ -102,6 +108,22 @@ extern DECLSPEC TTF_Font * SDLCALL TTF_OpenFontIndexRW(SDL_RWops *src, int frees
 extern DECLSPEC int SDLCALL TTF_GetFontStyle(const TTF_Font *font);
 extern DECLSPEC void SDLCALL TTF_SetFontStyle(TTF_Font *font, int style);
 
+/* Set the most memory, in bytes, used by the font's cache of glyphs
+   outside Latin-1.  Past it, the least recently used glyphs are freed.
+   Glyphs are cached for each style, so switching styles keeps them.
+   Returns the previous limit.
+   If the specified limit is -1, just return the current limit.
+*/
+extern DECLSPEC int SDLCALL TTF_SetGlyphCacheLimit(TTF_Font *font, int bytes);
+
+/* Get the number of glyph lookups that found the glyph already rendered
+   and that had to render it, and the number of glyphs outside Latin-1
+   cached and the memory they use.  Any of the pointers may be NULL.
+*/
+extern DECLSPEC void SDLCALL TTF_GetGlyphCacheStats(const TTF_Font *font,
+				Uint32 *hits, Uint32 *misses,
+				int *glyphs, int *bytes);
+
 /* Get the total height of the font - usually equal to point size */
 extern DECLSPEC int SDLCALL TTF_FontHeight(const TTF_Font *font);
 
@@ -207,6 +229,72 @@ extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderUNICODE_Blended(TTF_Font *font,
 extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderGlyph_Blended(TTF_Font *font,
 						Uint16 ch, SDL_Color fg);
 
+/* Draw text straight onto a surface at the position in 'dstrect', which
+   may be NULL for the top left corner, as rendering it with the function
+   of the same name and blitting the result would, without the surface in
+   between.  The glyphs are kept packed in atlas surfaces and blitted from
+   there.  The size of the text is returned in 'dstrect' if it isn't NULL.
+   Where glyphs overlap they are blended one after the other rather than
+   being merged first, so the overlap may come out a little differently.
+   These functions return 0 if successful, or -1 if there was an error.
+*/
+extern DECLSPEC int SDLCALL TTF_DrawText_Solid(TTF_Font *font,
+				const char *text, SDL_Color fg,
+				SDL_Surface *dst, SDL_Rect *dstrect);
+extern DECLSPEC int SDLCALL TTF_DrawUTF8_Solid(TTF_Font *font,
+				const char *text, SDL_Color fg,
+				SDL_Surface *dst, SDL_Rect *dstrect);
+extern DECLSPEC int SDLCALL TTF_DrawUNICODE_Solid(TTF_Font *font,
+				const Uint16 *text, SDL_Color fg,
+				SDL_Surface *dst, SDL_Rect *dstrect);
+extern DECLSPEC int SDLCALL TTF_DrawText_Shaded(TTF_Font *font,
+				const char *text, SDL_Color fg, SDL_Color bg,
+				SDL_Surface *dst, SDL_Rect *dstrect);
+extern DECLSPEC int SDLCALL TTF_DrawUTF8_Shaded(TTF_Font *font,
+				const char *text, SDL_Color fg, SDL_Color bg,
+				SDL_Surface *dst, SDL_Rect *dstrect);
+extern DECLSPEC int SDLCALL TTF_DrawUNICODE_Shaded(TTF_Font *font,
+				const Uint16 *text, SDL_Color fg, SDL_Color bg,
+				SDL_Surface *dst, SDL_Rect *dstrect);
+extern DECLSPEC int SDLCALL TTF_DrawText_Blended(TTF_Font *font,
+				const char *text, SDL_Color fg,
+				SDL_Surface *dst, SDL_Rect *dstrect);
+extern DECLSPEC int SDLCALL TTF_DrawUTF8_Blended(TTF_Font *font,
+				const char *text, SDL_Color fg,
+				SDL_Surface *dst, SDL_Rect *dstrect);
+extern DECLSPEC int SDLCALL TTF_DrawUNICODE_Blended(TTF_Font *font,
+				const Uint16 *text, SDL_Color fg,
+				SDL_Surface *dst, SDL_Rect *dstrect);
+
+/* Set the most atlas surfaces the font uses for each of solid, shaded
+   and blended text.  When they are all full they are emptied and filled
+   again with the glyphs being drawn.  Blended text keeps a copy of each
+   surface in each of the last four text colors it was drawn in.
+   Returns the previous number of pages.
+   If the specified number is -1, just return the current number.
+*/
+extern DECLSPEC int SDLCALL TTF_SetAtlasPages(TTF_Font *font, int pages);
+
+/* Keep up to 'bytes' of memory of rendered strings and string sizes for
+   the font, so that sizing or rendering the same text again with the same
+   style and colors doesn't redo it.  The cache is off (0 bytes) until this
+   is called, and the least recently used strings are dropped past the
+   limit.  While it's on, the render functions may return a surface that
+   is shared with the cache and with earlier calls: free it as usual, but
+   don't draw on it or change it.
+   Returns the previous limit.
+   If the specified limit is -1, just return the current limit.
+*/
+extern DECLSPEC int SDLCALL TTF_SetStringCache(TTF_Font *font, int bytes);
+
+/* Get the number of string sizes and renderings found in and missing from
+   the string cache, and the number of strings cached and the memory they
+   use.  Any of the pointers may be NULL.
+*/
+extern DECLSPEC void SDLCALL TTF_GetStringCacheStats(const TTF_Font *font,
+				Uint32 *hits, Uint32 *misses,
+				int *strings, int *bytes);
+
 /* For compatibility with previous versions, here are the old functions */
 #define TTF_RenderText(font, text, fg, bg)	\
 	TTF_RenderText_Shaded(font, text, fg, bg)
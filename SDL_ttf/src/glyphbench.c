@@ -0,0 +1,242 @@
+/*
+    glyphbench:  A benchmark of the SDL_ttf glyph cache.
+    Copyright (C) 1997-2009 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public
+    License along with this library; if not, write to the Free
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/* Renders paragraphs mixing Latin, Cyrillic, Greek, Japanese and symbols,
+   in normal and bold, with the glyph cache limited to nothing (a glyph
+   outside Latin-1 is kept only until the next one is needed) and with
+   the default limit, checking the text comes out the same and reporting
+   the glyphs rendered per second and the cache hits and misses.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "SDL_ttf.h"
+
+#define DEFAULT_PTSIZE	18
+#define ROUNDS		20
+
+static const char *paragraphs[] = {
+	"The quick brown fox jumps over the lazy dog. "
+	"Caf\xC3\xA9 na\xC3\xAFve r\xC3\xA9sum\xC3\xA9 \xC3\xBC" "ber Stra\xC3\x9F" "e.",
+	/* Cyrillic */
+	"\xD0\xA1\xD1\x8A\xD0\xB5\xD1\x88\xD1\x8C \xD0\xB6\xD0\xB5 "
+	"\xD0\xB5\xD1\x89\xD1\x91 \xD1\x8D\xD1\x82\xD0\xB8\xD1\x85 "
+	"\xD0\xBC\xD1\x8F\xD0\xB3\xD0\xBA\xD0\xB8\xD1\x85 "
+	"\xD1\x84\xD1\x80\xD0\xB0\xD0\xBD\xD1\x86\xD1\x83\xD0\xB7\xD1\x81"
+	"\xD0\xBA\xD0\xB8\xD1\x85 \xD0\xB1\xD1\x83\xD0\xBB\xD0\xBE\xD0\xBA, "
+	"\xD0\xB4\xD0\xB0 \xD0\xB2\xD1\x8B\xD0\xBF\xD0\xB5\xD0\xB9 "
+	"\xD1\x87\xD0\xB0\xD1\x8E.",
+	/* Greek */
+	"\xCE\x9E\xCE\xB5\xCF\x83\xCE\xBA\xCE\xB5\xCF\x80\xCE\xAC\xCE\xB6\xCF\x89 "
+	"\xCF\x84\xCE\xB7\xCE\xBD \xCF\x88\xCF\x85\xCF\x87\xCE\xBF\xCF\x86\xCE\xB8"
+	"\xCF\x8C\xCF\x81\xCE\xB1 \xCE\xB2\xCE\xB4\xCE\xB5\xCE\xBB\xCF\x85\xCE\xB3"
+	"\xCE\xBC\xCE\xAF\xCE\xB1.",
+	/* Japanese */
+	"\xE3\x81\x84\xE3\x82\x8D\xE3\x81\xAF\xE3\x81\xAB\xE3\x81\xBB\xE3\x81\xB8"
+	"\xE3\x81\xA8 \xE3\x81\xA1\xE3\x82\x8A\xE3\x81\xAC\xE3\x82\x8B\xE3\x82\x92 "
+	"\xE8\x89\xB2\xE3\x81\xAF\xE5\x8C\x82\xE3\x81\xB8\xE3\x81\xA9 "
+	"\xE6\x95\xA3\xE3\x82\x8A\xE3\x81\xAC\xE3\x82\x8B\xE3\x82\x92 "
+	"\xE6\x88\x91\xE3\x81\x8C\xE4\xB8\x96\xE8\xAA\xB0\xE3\x81\x9E "
+	"\xE5\xB8\xB8\xE3\x81\xAA\xE3\x82\x89\xE3\x82\x80",
+	/* Arrows, maths, box drawing and other symbols */
+	"\xE2\x86\x90\xE2\x86\x91\xE2\x86\x92\xE2\x86\x93 "
+	"\xE2\x88\x80x\xE2\x88\x88\xE2\x84\x9D: x\xC2\xB2 \xE2\x89\xA5 0 "
+	"\xE2\x88\x91\xE2\x88\x8F\xE2\x88\x9A\xE2\x88\x9E "
+	"\xE2\x94\x80\xE2\x94\x82\xE2\x94\x8C\xE2\x94\x90\xE2\x94\x94\xE2\x94\x98 "
+	"\xE2\x98\x85\xE2\x98\x86\xE2\x99\xA0\xE2\x99\xA3\xE2\x99\xA5\xE2\x99\xA6 "
+	"\xE2\x82\xAC\xE2\x84\xA2",
+	NULL
+};
+
+enum {
+	RENDER_SOLID,
+	RENDER_SHADED,
+	RENDER_BLENDED,
+	NUM_RENDER
+};
+static const char *render_names[NUM_RENDER] = { "solid", "shaded", "blended" };
+
+static SDL_Surface *render(TTF_Font *font, int mode, const char *text)
+{
+	SDL_Color fg = { 0xFF, 0xFF, 0xFF, 0 };
+	SDL_Color bg = { 0x00, 0x00, 0x00, 0 };
+
+	switch (mode) {
+	    case RENDER_SOLID:
+		return TTF_RenderUTF8_Solid(font, text, fg);
+	    case RENDER_SHADED:
+		return TTF_RenderUTF8_Shaded(font, text, fg, bg);
+	    default:
+		return TTF_RenderUTF8_Blended(font, text, fg);
+	}
+}
+
+static int same_surface(SDL_Surface *a, SDL_Surface *b)
+{
+	int row, len;
+
+	if ( a->w != b->w || a->h != b->h ||
+	     a->format->BytesPerPixel != b->format->BytesPerPixel ) {
+		return 0;
+	}
+	len = a->w * a->format->BytesPerPixel;
+	for ( row = 0; row < a->h; ++row ) {
+		if ( memcmp((Uint8 *)a->pixels + row * a->pitch,
+		            (Uint8 *)b->pixels + row * b->pitch, len) != 0 ) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* Render everything with no cache, then with it, twice over so the
+   second time comes from the cache, in each style */
+static int check_cache(TTF_Font *font)
+{
+	static const int styles[] = { TTF_STYLE_NORMAL, TTF_STYLE_BOLD, TTF_STYLE_NORMAL };
+	int i, mode, style, pass;
+	int limit, errors = 0;
+	SDL_Surface *expected, *got;
+
+	limit = TTF_SetGlyphCacheLimit(font, -1);
+	for ( mode = 0; mode < NUM_RENDER; ++mode ) {
+		for ( i = 0; paragraphs[i]; ++i ) {
+			for ( style = 0; style < 3; ++style ) {
+				TTF_SetGlyphCacheLimit(font, 0);
+				TTF_SetFontStyle(font, styles[style]);
+				expected = render(font, mode, paragraphs[i]);
+				TTF_SetGlyphCacheLimit(font, limit);
+				for ( pass = 0; pass < 2; ++pass ) {
+					got = render(font, mode, paragraphs[i]);
+					if ( !expected || !got || !same_surface(expected, got) ) {
+						printf("Paragraph %d %s %s differs from the cache\n",
+						       i, styles[style] ? "bold" : "normal",
+						       render_names[mode]);
+						++errors;
+					}
+					if ( got ) {
+						SDL_FreeSurface(got);
+					}
+				}
+				if ( expected ) {
+					SDL_FreeSurface(expected);
+				}
+			}
+		}
+	}
+	TTF_SetFontStyle(font, TTF_STYLE_NORMAL);
+	return errors;
+}
+
+static void bench(TTF_Font *font, int mode, int limit, int glyphs)
+{
+	Uint32 start, ms, hits, misses, hits0, misses0;
+	int i, round, cached, bytes;
+	SDL_Surface *text;
+
+	TTF_SetGlyphCacheLimit(font, limit);
+	TTF_GetGlyphCacheStats(font, &hits0, &misses0, NULL, NULL);
+	start = SDL_GetTicks();
+	for ( round = 0; round < ROUNDS; ++round ) {
+		/* Headings in bold among the body text */
+		TTF_SetFontStyle(font, (round & 3) ? TTF_STYLE_NORMAL : TTF_STYLE_BOLD);
+		for ( i = 0; paragraphs[i]; ++i ) {
+			text = render(font, mode, paragraphs[i]);
+			if ( text ) {
+				SDL_FreeSurface(text);
+			}
+		}
+	}
+	ms = SDL_GetTicks() - start;
+	TTF_GetGlyphCacheStats(font, &hits, &misses, &cached, &bytes);
+	if ( ms == 0 ) {
+		ms = 1;
+	}
+	printf("%-8s %7d byte cache: %8.0f glyphs/s, %7u hits, %6u misses, %4d glyphs in %d bytes\n",
+	       render_names[mode], limit, (double)glyphs * ROUNDS * 1000.0 / ms,
+	       (unsigned)(hits - hits0), (unsigned)(misses - misses0),
+	       cached, bytes);
+	TTF_SetFontStyle(font, TTF_STYLE_NORMAL);
+}
+
+int main(int argc, char *argv[])
+{
+	TTF_Font *font;
+	int ptsize, limit, mode;
+	int i, glyphs, errors;
+	const char *p;
+
+	if ( argc < 2 ) {
+		fprintf(stderr, "Usage: %s <font>.ttf [ptsize]\n", argv[0]);
+		return(1);
+	}
+	ptsize = (argc > 2) ? atoi(argv[2]) : DEFAULT_PTSIZE;
+
+	if ( SDL_Init(SDL_INIT_TIMER) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(2);
+	}
+	if ( TTF_Init() < 0 ) {
+		fprintf(stderr, "Couldn't initialize TTF: %s\n", SDL_GetError());
+		SDL_Quit();
+		return(2);
+	}
+	font = TTF_OpenFont(argv[1], ptsize);
+	if ( font == NULL ) {
+		fprintf(stderr, "Couldn't load %d pt font from %s: %s\n",
+					ptsize, argv[1], SDL_GetError());
+		TTF_Quit();
+		SDL_Quit();
+		return(2);
+	}
+
+	/* Count the characters, not the UTF-8 bytes */
+	glyphs = 0;
+	for ( i = 0; paragraphs[i]; ++i ) {
+		for ( p = paragraphs[i]; *p; ++p ) {
+			if ( (*p & 0xC0) != 0x80 ) {
+				++glyphs;
+			}
+		}
+	}
+
+	errors = check_cache(font);
+	if ( errors ) {
+		printf("%d glyph cache tests failed\n", errors);
+	} else {
+		printf("All glyph cache tests passed.\n");
+	}
+
+	limit = TTF_SetGlyphCacheLimit(font, -1);
+	for ( mode = 0; mode < NUM_RENDER; ++mode ) {
+		bench(font, mode, 0, glyphs);
+		bench(font, mode, limit, glyphs);
+	}
+
+	TTF_CloseFont(font);
+	TTF_Quit();
+	SDL_Quit();
+	return (errors ? 1 : 0);
+}
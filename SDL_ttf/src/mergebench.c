@@ -0,0 +1,283 @@
+/*
+    mergebench:  A test and benchmark of SDL_ttf glyph compositing.
+    Copyright (C) 1997-2009 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public
+    License along with this library; if not, write to the Free
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/* Renders shaded and blended text in several sizes and styles, italic
+   and bold among them so glyphs overlap, and checks that every blended
+   pixel has the foreground color with the alpha the shaded text has.
+   Then renders it all again with TTF_NOSIMD set, checking the plain C
+   compositing matches the vector unit's to the pixel, and reports the
+   glyphs per second of each.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "SDL_ttf.h"
+
+#define ROUNDS		200
+
+static const int sizes[] = { 11, 24, 64 };
+#define NUM_SIZES	(int)(sizeof(sizes)/sizeof(sizes[0]))
+
+static const int styles[] = {
+	TTF_STYLE_NORMAL, TTF_STYLE_BOLD, TTF_STYLE_ITALIC,
+	TTF_STYLE_BOLD|TTF_STYLE_ITALIC, TTF_STYLE_UNDERLINE
+};
+#define NUM_STYLES	(int)(sizeof(styles)/sizeof(styles[0]))
+
+static const char *strings[] = {
+	"The quick brown fox jumps over the lazy dog.",
+	"AVAWAY Type ffi fj 'quoted' \"text\" /slashes/ [brackets]",
+	"WWWWWWWWWWWWWWWW mmmmmmmmmmmmmmmm",
+	"0123456789 +-*/=<>() %$#@!&",
+	"i", "W", "Ty", "...",
+	NULL
+};
+#define NUM_STRINGS	(int)(sizeof(strings)/sizeof(strings[0]) - 1)
+
+enum {
+	RENDER_SHADED,
+	RENDER_BLENDED,
+	NUM_RENDER
+};
+static const char *render_names[NUM_RENDER] = { "shaded", "blended" };
+
+static SDL_Color fg = { 0xFF, 0xE0, 0x40, 0 };
+static SDL_Color bg = { 0x00, 0x00, 0x00, 0 };
+
+static SDL_Surface *results[NUM_SIZES][NUM_STYLES][NUM_STRINGS][NUM_RENDER];
+
+static SDL_Surface *render(TTF_Font *font, int mode, const char *text)
+{
+	if ( mode == RENDER_SHADED ) {
+		return TTF_RenderUTF8_Shaded(font, text, fg, bg);
+	} else {
+		return TTF_RenderUTF8_Blended(font, text, fg);
+	}
+}
+
+static int same_surface(SDL_Surface *a, SDL_Surface *b)
+{
+	int row, len;
+
+	if ( a->w != b->w || a->h != b->h ||
+	     a->format->BytesPerPixel != b->format->BytesPerPixel ) {
+		return 0;
+	}
+	len = a->w * a->format->BytesPerPixel;
+	for ( row = 0; row < a->h; ++row ) {
+		if ( memcmp((Uint8 *)a->pixels + row * a->pitch,
+		            (Uint8 *)b->pixels + row * b->pitch, len) != 0 ) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* Blended text is the foreground color everywhere, with the coverage the
+   shaded text has as its alpha */
+static int blended_matches_shaded(SDL_Surface *shaded, SDL_Surface *blended)
+{
+	Uint32 color = ((Uint32)fg.r << 16) | ((Uint32)fg.g << 8) | fg.b;
+	Uint8 *index;
+	Uint32 *pixel;
+	int row, col;
+
+	if ( shaded->w != blended->w || shaded->h != blended->h ) {
+		return 0;
+	}
+	for ( row = 0; row < shaded->h; ++row ) {
+		index = (Uint8 *)shaded->pixels + row * shaded->pitch;
+		pixel = (Uint32 *)((Uint8 *)blended->pixels + row * blended->pitch);
+		for ( col = 0; col < shaded->w; ++col ) {
+			if ( pixel[col] != (color | ((Uint32)index[col] << 24)) ) {
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+static TTF_Font *open_font(const char *file, int ptsize)
+{
+	TTF_Font *font = TTF_OpenFont(file, ptsize);
+	if ( font == NULL ) {
+		fprintf(stderr, "Couldn't load %d pt font from %s: %s\n",
+					ptsize, file, SDL_GetError());
+	}
+	return font;
+}
+
+/* Render everything, checking it against what was rendered before if
+   there is anything */
+static int check_text(const char *file)
+{
+	TTF_Font *font;
+	SDL_Surface *text[NUM_RENDER];
+	int size, style, i, mode;
+	int errors = 0;
+
+	for ( size = 0; size < NUM_SIZES; ++size ) {
+		font = open_font(file, sizes[size]);
+		if ( font == NULL ) {
+			return 1;
+		}
+		for ( style = 0; style < NUM_STYLES; ++style ) {
+			TTF_SetFontStyle(font, styles[style]);
+			for ( i = 0; strings[i]; ++i ) {
+				for ( mode = 0; mode < NUM_RENDER; ++mode ) {
+					text[mode] = render(font, mode, strings[i]);
+					if ( text[mode] == NULL ) {
+						printf("Couldn't render \"%s\": %s\n",
+						       strings[i], SDL_GetError());
+						++errors;
+						continue;
+					}
+					if ( results[size][style][i][mode] == NULL ) {
+						results[size][style][i][mode] = text[mode];
+						text[mode] = NULL;
+					} else if ( !same_surface(results[size][style][i][mode], text[mode]) ) {
+						printf("%d pt style %d %s \"%s\" differs without SIMD\n",
+						       sizes[size], styles[style],
+						       render_names[mode], strings[i]);
+						++errors;
+					}
+				}
+				for ( mode = 0; mode < NUM_RENDER; ++mode ) {
+					if ( text[mode] ) {
+						SDL_FreeSurface(text[mode]);
+					}
+				}
+				if ( !results[size][style][i][RENDER_SHADED] ||
+				     !results[size][style][i][RENDER_BLENDED] ) {
+					continue;
+				}
+				if ( !blended_matches_shaded(results[size][style][i][RENDER_SHADED],
+				                             results[size][style][i][RENDER_BLENDED]) ) {
+					printf("%d pt style %d blended \"%s\" doesn't match shaded\n",
+					       sizes[size], styles[style], strings[i]);
+					++errors;
+				}
+			}
+		}
+		TTF_CloseFont(font);
+	}
+	return errors;
+}
+
+static void bench(const char *file, const char *how, int glyphs)
+{
+	TTF_Font *font;
+	SDL_Surface *text;
+	Uint32 start, ms;
+	int size, mode, round, i;
+
+	for ( size = 0; size < NUM_SIZES; ++size ) {
+		font = open_font(file, sizes[size]);
+		if ( font == NULL ) {
+			return;
+		}
+		TTF_SetFontStyle(font, TTF_STYLE_ITALIC);
+		for ( mode = 0; mode < NUM_RENDER; ++mode ) {
+			start = SDL_GetTicks();
+			for ( round = 0; round < ROUNDS; ++round ) {
+				for ( i = 0; strings[i]; ++i ) {
+					text = render(font, mode, strings[i]);
+					if ( text ) {
+						SDL_FreeSurface(text);
+					}
+				}
+			}
+			ms = SDL_GetTicks() - start;
+			if ( ms == 0 ) {
+				ms = 1;
+			}
+			printf("%-8s %2d pt %-12s %9.0f glyphs/s\n",
+			       render_names[mode], sizes[size], how,
+			       (double)glyphs * ROUNDS * 1000.0 / ms);
+		}
+		TTF_CloseFont(font);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int size, style, i, mode;
+	int glyphs, errors;
+
+	if ( argc < 2 ) {
+		fprintf(stderr, "Usage: %s <font>.ttf\n", argv[0]);
+		return(1);
+	}
+
+	if ( SDL_Init(SDL_INIT_TIMER) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(2);
+	}
+	if ( TTF_Init() < 0 ) {
+		fprintf(stderr, "Couldn't initialize TTF: %s\n", SDL_GetError());
+		SDL_Quit();
+		return(2);
+	}
+
+	glyphs = 0;
+	for ( i = 0; strings[i]; ++i ) {
+		glyphs += strlen(strings[i]);
+	}
+
+	errors = check_text(argv[1]);
+	bench(argv[1], "with SIMD", glyphs);
+
+	/* Start over with the plain C loops */
+	TTF_Quit();
+	SDL_putenv(TTF_NOSIMD "=1");
+	if ( TTF_Init() < 0 ) {
+		fprintf(stderr, "Couldn't initialize TTF: %s\n", SDL_GetError());
+		SDL_Quit();
+		return(2);
+	}
+	errors += check_text(argv[1]);
+	bench(argv[1], "without SIMD", glyphs);
+
+	if ( errors ) {
+		printf("%d glyph compositing tests failed\n", errors);
+	} else {
+		printf("All glyph compositing tests passed.\n");
+	}
+
+	for ( size = 0; size < NUM_SIZES; ++size ) {
+		for ( style = 0; style < NUM_STYLES; ++style ) {
+			for ( i = 0; i < NUM_STRINGS; ++i ) {
+				for ( mode = 0; mode < NUM_RENDER; ++mode ) {
+					if ( results[size][style][i][mode] ) {
+						SDL_FreeSurface(results[size][style][i][mode]);
+					}
+				}
+			}
+		}
+	}
+	TTF_Quit();
+	SDL_Quit();
+	return (errors ? 1 : 0);
+}
@@ -0,0 +1,259 @@
+/*
+    stringbench:  A benchmark of the SDL_ttf string cache.
+    Copyright (C) 1997-2009 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public
+    License along with this library; if not, write to the Free
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/* Checks that strings from the string cache match freshly rendered ones,
+   are shared, and outlive being dropped from the cache while in use.
+   Then goes through the frames of a menu screen, sizing every item to lay
+   it out and rendering the items, the highlighted one in another color,
+   a tooltip and a counter that changes each frame, with the cache off
+   and on, and reports the frames per second and cache hits.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "SDL_ttf.h"
+
+#define DEFAULT_PTSIZE	16
+#define FRAMES		300
+#define CACHE_BYTES	(512*1024)
+
+static const char *items[] = {
+	"New Game", "Continue", "Load Game", "Options", "Controls",
+	"Audio", "Music Volume", "Effects Volume", "Video", "Fullscreen",
+	"Widescreen (16:9)", "Subtitles", "Language", "Difficulty: Normal",
+	"Credits", "Extras", "Achievements", "Leaderboards", "Help",
+	"Quit to Desktop", NULL
+};
+
+static const char *tooltips[] = {
+	"Start a new adventure from the beginning",
+	"Pick up where you left off",
+	"Change how the game looks and sounds",
+	"Are you sure? Unsaved progress will be lost",
+	NULL
+};
+
+static SDL_Color white = { 0xFF, 0xFF, 0xFF, 0 };
+static SDL_Color yellow = { 0xFF, 0xE0, 0x40, 0 };
+static SDL_Color navy = { 0x20, 0x20, 0x60, 0 };
+
+static int same_surface(SDL_Surface *a, SDL_Surface *b)
+{
+	int row, len;
+
+	if ( a->w != b->w || a->h != b->h ||
+	     a->format->BytesPerPixel != b->format->BytesPerPixel ) {
+		return 0;
+	}
+	len = a->w * a->format->BytesPerPixel;
+	for ( row = 0; row < a->h; ++row ) {
+		if ( memcmp((Uint8 *)a->pixels + row * a->pitch,
+		            (Uint8 *)b->pixels + row * b->pitch, len) != 0 ) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static int expect(const char *what, int ok)
+{
+	if ( !ok ) {
+		printf("%s failed\n", what);
+		return 1;
+	}
+	return 0;
+}
+
+static int check_cache(TTF_Font *font)
+{
+	SDL_Surface *fresh, *first, *second, *bold, *shaded;
+	int w, h, cw, ch, errors = 0;
+	Uint32 hits, misses;
+	int strings, bytes;
+
+	TTF_SetStringCache(font, 0);
+	fresh = TTF_RenderUTF8_Blended(font, items[0], white);
+	TTF_SizeUTF8(font, items[1], &w, &h);
+
+	TTF_SetStringCache(font, CACHE_BYTES);
+	first = TTF_RenderUTF8_Blended(font, items[0], white);
+	second = TTF_RenderUTF8_Blended(font, items[0], white);
+	errors += expect("Cached string is shared", first == second);
+	errors += expect("Cached string matches", same_surface(fresh, second));
+	SDL_FreeSurface(second);
+
+	TTF_SizeUTF8(font, items[1], &cw, &ch);
+	TTF_SizeUTF8(font, items[1], &cw, &ch);
+	errors += expect("Cached size matches", cw == w && ch == h);
+
+	TTF_SetFontStyle(font, TTF_STYLE_BOLD);
+	bold = TTF_RenderUTF8_Blended(font, items[0], white);
+	errors += expect("Style is part of the key", bold != first && bold->w > first->w);
+	TTF_SetFontStyle(font, TTF_STYLE_NORMAL);
+	shaded = TTF_RenderUTF8_Shaded(font, items[0], white, navy);
+	errors += expect("Render mode is part of the key", shaded != first);
+	second = TTF_RenderUTF8_Blended(font, items[0], yellow);
+	errors += expect("Color is part of the key", second != first);
+	SDL_FreeSurface(second);
+	second = TTF_RenderText_Blended(font, items[0], white);
+	errors += expect("Latin-1 and UTF-8 text are cached apart", second != first);
+	errors += expect("Latin-1 text matches", same_surface(fresh, second));
+	SDL_FreeSurface(second);
+
+	TTF_GetStringCacheStats(font, &hits, &misses, &strings, &bytes);
+	errors += expect("Cache statistics", hits == 2 && strings == 6 &&
+	                 bytes > 0 && bytes <= CACHE_BYTES);
+
+	/* Dropping everything leaves the surfaces in use alone */
+	TTF_SetStringCache(font, 0);
+	TTF_GetStringCacheStats(font, NULL, NULL, &strings, &bytes);
+	errors += expect("Cache emptied", strings == 0 && bytes == 0);
+	errors += expect("Dropped string still usable", same_surface(fresh, first));
+
+	SDL_FreeSurface(first);
+	SDL_FreeSurface(bold);
+	SDL_FreeSurface(shaded);
+	SDL_FreeSurface(fresh);
+	return errors;
+}
+
+static double bench(TTF_Font *font, SDL_Surface *screen, int bytes)
+{
+	char counter[64];
+	SDL_Surface *text;
+	SDL_Rect rect;
+	Uint32 start, ms;
+	int frame, i, w, h, y;
+
+	TTF_SetStringCache(font, bytes);
+	start = SDL_GetTicks();
+	for ( frame = 0; frame < FRAMES; ++frame ) {
+		SDL_FillRect(screen, NULL, 0);
+
+		/* Center the items, with the highlight moving down them */
+		y = 0;
+		for ( i = 0; items[i]; ++i ) {
+			TTF_SizeUTF8(font, items[i], &w, &h);
+			if ( i == (frame / 15) % 20 ) {
+				text = TTF_RenderUTF8_Shaded(font, items[i], yellow, navy);
+			} else {
+				text = TTF_RenderUTF8_Blended(font, items[i], white);
+			}
+			if ( text ) {
+				rect.x = (screen->w - w) / 2;
+				rect.y = y;
+				SDL_BlitSurface(text, NULL, screen, &rect);
+				SDL_FreeSurface(text);
+			}
+			y += h;
+		}
+
+		text = TTF_RenderUTF8_Blended(font, tooltips[(frame / 60) % 4], yellow);
+		if ( text ) {
+			rect.x = 0;
+			rect.y = y;
+			SDL_BlitSurface(text, NULL, screen, &rect);
+			SDL_FreeSurface(text);
+		}
+		sprintf(counter, "Frame %d", frame);
+		text = TTF_RenderUTF8_Solid(font, counter, white);
+		if ( text ) {
+			rect.x = 0;
+			rect.y = 0;
+			SDL_BlitSurface(text, NULL, screen, &rect);
+			SDL_FreeSurface(text);
+		}
+		SDL_UpdateRect(screen, 0, 0, 0, 0);
+	}
+	ms = SDL_GetTicks() - start;
+	if ( ms == 0 ) {
+		ms = 1;
+	}
+	return FRAMES * 1000.0 / ms;
+}
+
+int main(int argc, char *argv[])
+{
+	SDL_Surface *screen;
+	TTF_Font *font;
+	int ptsize, errors;
+	int strings, bytes;
+	Uint32 hits, misses, hits0, misses0;
+	double fps;
+
+	if ( argc < 2 ) {
+		fprintf(stderr, "Usage: %s <font>.ttf [ptsize]\n", argv[0]);
+		return(1);
+	}
+	ptsize = (argc > 2) ? atoi(argv[2]) : DEFAULT_PTSIZE;
+
+	if ( SDL_Init(SDL_INIT_VIDEO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(2);
+	}
+	if ( TTF_Init() < 0 ) {
+		fprintf(stderr, "Couldn't initialize TTF: %s\n", SDL_GetError());
+		SDL_Quit();
+		return(2);
+	}
+	font = TTF_OpenFont(argv[1], ptsize);
+	if ( font == NULL ) {
+		fprintf(stderr, "Couldn't load %d pt font from %s: %s\n",
+					ptsize, argv[1], SDL_GetError());
+		TTF_Quit();
+		SDL_Quit();
+		return(2);
+	}
+	screen = SDL_SetVideoMode(640, 480, 32, SDL_SWSURFACE);
+	if ( screen == NULL ) {
+		fprintf(stderr, "Couldn't set 640x480 video mode: %s\n",
+					SDL_GetError());
+		TTF_CloseFont(font);
+		TTF_Quit();
+		SDL_Quit();
+		return(2);
+	}
+
+	errors = check_cache(font);
+	if ( errors ) {
+		printf("%d string cache tests failed\n", errors);
+	} else {
+		printf("All string cache tests passed.\n");
+	}
+
+	fps = bench(font, screen, 0);
+	printf("Menu screen without the string cache: %6.1f fps\n", fps);
+	TTF_GetStringCacheStats(font, &hits0, &misses0, NULL, NULL);
+	fps = bench(font, screen, CACHE_BYTES);
+	TTF_GetStringCacheStats(font, &hits, &misses, &strings, &bytes);
+	printf("Menu screen with a %d byte cache:   %6.1f fps, %u hits, %u misses, %d strings in %d bytes\n",
+	       CACHE_BYTES, fps, (unsigned)(hits - hits0), (unsigned)(misses - misses0),
+	       strings, bytes);
+
+	TTF_CloseFont(font);
+	TTF_Quit();
+	SDL_Quit();
+	return (errors ? 1 : 0);
+}
@@ -0,0 +1,261 @@
+/*
+    textbench:  A benchmark of drawing text with SDL_ttf.
+    Copyright (C) 1997-2009 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public
+    License along with this library; if not, write to the Free
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/* Draws a HUD of a few dozen strings a frame, by rendering each string
+   to a surface and blitting it, and with the TTF_Draw functions that
+   blit glyphs from an atlas, checking both come out the same and
+   reporting the frames per second of each, with the strings in one
+   color and in three.  Set SDL_VIDEODRIVER=dummy
+   to run without a display.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "SDL_ttf.h"
+
+#define DEFAULT_PTSIZE	14
+#define FRAMES		100
+#define WIDTH		640
+#define HEIGHT		480
+
+static const char *labels[] = {
+	"Score", "Hi-Score", "Lives", "Level", "Time", "Ammo", "Health",
+	"Armor", "Shield", "Fuel", "Speed", "Altitude", "Heading", "Target",
+	"Distance", "Objective: reach the extraction point", "Press A to jump",
+	"Press B to fire", "Paused", "Checkpoint reached", "Combo x4",
+	"Bonus +1000", "Wave 7 of 12", "Enemies left", "Keys", "Coins",
+	"Gems", "Map", "Inventory", "Options", "Quit to title",
+	NULL
+};
+
+enum {
+	RENDER_SOLID,
+	RENDER_SHADED,
+	RENDER_BLENDED,
+	NUM_RENDER
+};
+static const char *render_names[NUM_RENDER] = { "solid", "shaded", "blended" };
+
+/* The strings take turns at the first num_colors of these */
+static SDL_Color colors[] = {
+	{ 0xFF, 0xE0, 0x40, 0 }, { 0xFF, 0x40, 0x40, 0 }, { 0x40, 0xFF, 0x80, 0 }
+};
+static int num_colors = 1;
+static SDL_Color bg = { 0x20, 0x20, 0x60, 0 };
+
+/* Text changing every frame, as counters in a HUD do */
+static void frame_text(char *text, int label, int frame)
+{
+	sprintf(text, "%s: %d", labels[label], (frame * 37 + label * 1009) % 100000);
+}
+
+static void render_frame(TTF_Font *font, int mode, SDL_Surface *screen, int frame)
+{
+	char text[128];
+	SDL_Surface *surface;
+	SDL_Rect rect;
+	SDL_Color fg;
+	int i;
+
+	for ( i = 0; labels[i]; ++i ) {
+		frame_text(text, i, frame);
+		fg = colors[i % num_colors];
+		switch (mode) {
+		    case RENDER_SOLID:
+			surface = TTF_RenderUTF8_Solid(font, text, fg);
+			break;
+		    case RENDER_SHADED:
+			surface = TTF_RenderUTF8_Shaded(font, text, fg, bg);
+			break;
+		    default:
+			surface = TTF_RenderUTF8_Blended(font, text, fg);
+			break;
+		}
+		if ( surface ) {
+			rect.x = (i & 1) * WIDTH / 2 + 8;
+			rect.y = (i / 2) * TTF_FontLineSkip(font);
+			SDL_BlitSurface(surface, NULL, screen, &rect);
+			SDL_FreeSurface(surface);
+		}
+	}
+}
+
+static void draw_frame(TTF_Font *font, int mode, SDL_Surface *screen, int frame)
+{
+	char text[128];
+	SDL_Rect rect;
+	SDL_Color fg;
+	int i;
+
+	for ( i = 0; labels[i]; ++i ) {
+		frame_text(text, i, frame);
+		fg = colors[i % num_colors];
+		rect.x = (i & 1) * WIDTH / 2 + 8;
+		rect.y = (i / 2) * TTF_FontLineSkip(font);
+		switch (mode) {
+		    case RENDER_SOLID:
+			TTF_DrawUTF8_Solid(font, text, fg, screen, &rect);
+			break;
+		    case RENDER_SHADED:
+			TTF_DrawUTF8_Shaded(font, text, fg, bg, screen, &rect);
+			break;
+		    default:
+			TTF_DrawUTF8_Blended(font, text, fg, screen, &rect);
+			break;
+		}
+	}
+}
+
+/* Returns the number of pixels that differ */
+static int compare(SDL_Surface *a, SDL_Surface *b)
+{
+	int row, col, diffs = 0;
+	Uint32 *pa, *pb;
+
+	for ( row = 0; row < a->h; ++row ) {
+		pa = (Uint32 *)((Uint8 *)a->pixels + row * a->pitch);
+		pb = (Uint32 *)((Uint8 *)b->pixels + row * b->pitch);
+		for ( col = 0; col < a->w; ++col ) {
+			if ( pa[col] != pb[col] ) {
+				++diffs;
+			}
+		}
+	}
+	return diffs;
+}
+
+static double bench(TTF_Font *font, int mode, SDL_Surface *screen,
+                    void (*frame)(TTF_Font *, int, SDL_Surface *, int))
+{
+	Uint32 start, ms;
+	int i;
+
+	start = SDL_GetTicks();
+	for ( i = 0; i < FRAMES; ++i ) {
+		SDL_FillRect(screen, NULL, 0);
+		frame(font, mode, screen, i);
+		SDL_UpdateRect(screen, 0, 0, 0, 0);
+	}
+	ms = SDL_GetTicks() - start;
+	if ( ms == 0 ) {
+		ms = 1;
+	}
+	return FRAMES * 1000.0 / ms;
+}
+
+int main(int argc, char *argv[])
+{
+	SDL_Surface *screen, *rendered, *drawn;
+	TTF_Font *font;
+	int ptsize, mode, style;
+	int diffs, errors = 0;
+	double render_fps, draw_fps;
+
+	if ( argc < 2 ) {
+		fprintf(stderr, "Usage: %s <font>.ttf [ptsize]\n", argv[0]);
+		return(1);
+	}
+	ptsize = (argc > 2) ? atoi(argv[2]) : DEFAULT_PTSIZE;
+
+	if ( SDL_Init(SDL_INIT_VIDEO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(2);
+	}
+	if ( TTF_Init() < 0 ) {
+		fprintf(stderr, "Couldn't initialize TTF: %s\n", SDL_GetError());
+		SDL_Quit();
+		return(2);
+	}
+	font = TTF_OpenFont(argv[1], ptsize);
+	if ( font == NULL ) {
+		fprintf(stderr, "Couldn't load %d pt font from %s: %s\n",
+					ptsize, argv[1], SDL_GetError());
+		TTF_Quit();
+		SDL_Quit();
+		return(2);
+	}
+	screen = SDL_SetVideoMode(WIDTH, HEIGHT, 32, SDL_SWSURFACE);
+	if ( screen == NULL ) {
+		fprintf(stderr, "Couldn't set %dx%d video mode: %s\n",
+					WIDTH, HEIGHT, SDL_GetError());
+		TTF_CloseFont(font);
+		TTF_Quit();
+		SDL_Quit();
+		return(2);
+	}
+	rendered = SDL_CreateRGBSurface(SDL_SWSURFACE, WIDTH, HEIGHT, 32,
+	                                0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+	drawn = SDL_CreateRGBSurface(SDL_SWSURFACE, WIDTH, HEIGHT, 32,
+	                             0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+	if ( !rendered || !drawn ) {
+		fprintf(stderr, "Out of memory\n");
+		return(2);
+	}
+
+	/* Drawing should look like rendering and blitting, but for pixels
+	   where glyphs overlap */
+	for ( num_colors = 1; num_colors <= 3; num_colors += 2 ) {
+	    for ( style = 0; style <= TTF_STYLE_UNDERLINE; style += TTF_STYLE_UNDERLINE ) {
+		TTF_SetFontStyle(font, style);
+		for ( mode = 0; mode < NUM_RENDER; ++mode ) {
+			SDL_FillRect(rendered, NULL, 0x404040);
+			SDL_FillRect(drawn, NULL, 0x404040);
+			render_frame(font, mode, rendered, 0);
+			draw_frame(font, mode, drawn, 0);
+			diffs = compare(rendered, drawn);
+			if ( diffs > WIDTH * HEIGHT / 1000 ) {
+				printf("Drawn %s%s text in %d colors differs from rendered in %d pixels\n",
+				       render_names[mode], style ? " underlined" : "",
+				       num_colors, diffs);
+				++errors;
+			}
+		}
+	    }
+	}
+	TTF_SetFontStyle(font, TTF_STYLE_NORMAL);
+	if ( errors ) {
+		printf("%d text drawing tests failed\n", errors);
+	} else {
+		printf("All text drawing tests passed.\n");
+	}
+
+	/* Then with every string in one color, and taking turns at three */
+	for ( num_colors = 1; num_colors <= 3; num_colors += 2 ) {
+		for ( mode = 0; mode < NUM_RENDER; ++mode ) {
+			render_fps = bench(font, mode, screen, render_frame);
+			draw_fps = bench(font, mode, screen, draw_frame);
+			printf("%-8s %d strings a frame in %d color%s: render and blit %6.1f fps, draw %6.1f fps\n",
+			       render_names[mode], (int)(sizeof(labels)/sizeof(labels[0])) - 1,
+			       num_colors, (num_colors > 1) ? "s" : "", render_fps, draw_fps);
+		}
+	}
+
+	SDL_FreeSurface(rendered);
+	SDL_FreeSurface(drawn);
+	TTF_CloseFont(font);
+	TTF_Quit();
+	SDL_Quit();
+	return (errors ? 1 : 0);
+}